@@ -2,6 +2,12 @@
 #include <structmember.h>
 
 #include "polynomials.h"
+#include "parallel.h"
+#include "modular.h"
+#include "polyarray.h"
+#include "multivariate.h"
+#include "rational.h"
+#include "matrix.h"
 
 /* Compatibility - taken from cPython 3.3 */
 #ifndef Py_RETURN_NOTIMPLEMENTED
@@ -9,12 +15,62 @@
     return Py_INCREF(Py_NotImplemented), Py_NotImplemented
 #endif
 
+/* Vectorcall protocol (PEP 590), used to evaluate polynomials */
+#if PY_VERSION_HEX >= 0x03080000
+#define PYPOLY_VECTORCALL
+#if PY_VERSION_HEX < 0x03090000
+#define Py_TPFLAGS_HAVE_VECTORCALL _Py_TPFLAGS_HAVE_VECTORCALL
+#endif
+#define PYPOLY_VECTORCALL_OFFSET(type)  offsetof(type, vectorcall)
+#define PYPOLY_VECTORCALL_FLAG          Py_TPFLAGS_HAVE_VECTORCALL |
+#else
+#define PYPOLY_VECTORCALL_OFFSET(type)  0
+#define PYPOLY_VECTORCALL_FLAG
+#endif
+
+/* Module functions taking several positional arguments use the METH_FASTCALL
+ * convention when available, which spares the creation of the arguments
+ * tuple. They are written against that convention, older Pythons go through
+ * a METH_VARARGS shim. */
+#if PY_VERSION_HEX >= 0x03070000
+#define PYPOLY_FASTCALL(func)           (PyCFunction)(void(*)(void))func, METH_FASTCALL
+#define PYPOLY_FASTCALL_SHIM(func)
+#else
+#define PYPOLY_FASTCALL(func)           func##_varargs, METH_VARARGS
+#define PYPOLY_FASTCALL_SHIM(func)                                          \
+static PyObject*                                                            \
+func##_varargs(PyObject *self, PyObject *args)                              \
+{                                                                           \
+    return func(self, &PyTuple_GET_ITEM(args, 0), PyTuple_GET_SIZE(args));  \
+}
+#endif
+
+/* Py_IsFinalizing() is public from Python 3.13 */
+#if PY_VERSION_HEX < 0x030D0000
+#if PY_VERSION_HEX >= 0x03070000
+#define Py_IsFinalizing()               _Py_IsFinalizing()
+#elif PY_MAJOR_VERSION >= 3
+#define Py_IsFinalizing()               (_Py_Finalizing != NULL)
+#else
+#define Py_IsFinalizing()               0
+#endif
+#endif
+
 /* A Python Polynomial Object */
 typedef struct {
     PyObject_HEAD
     Polynomial poly;
+    PyObject *base;     // Owner of the coefficients of a view, NULL otherwise
+#ifdef PYPOLY_VECTORCALL
+    vectorcallfunc vectorcall;
+#endif
 } PyPoly_PolynomialObject;
 
+#ifdef PYPOLY_VECTORCALL
+static PyObject* PyPoly_vectorcall(PyObject *self, PyObject *const *args,
+                                   size_t nargsf, PyObject *kwnames);
+#endif
+
 static PyTypeObject PyPoly_PolynomialType;  // Forward declaration
 
 /* Classic macro to check if a PyObject is a Polynomial */
@@ -33,6 +89,9 @@ new_poly_st(PyTypeObject *subtype, int deg, Polynomial *P)
     PyPoly_PolynomialObject *self;
     self = (PyPoly_PolynomialObject *) (subtype->tp_alloc(subtype, 0));
     if (self != NULL) {
+#ifdef PYPOLY_VECTORCALL
+        self->vectorcall = PyPoly_vectorcall;
+#endif
         if (P == NULL) {
             if(!poly_init(&(self->poly), deg)) {
                 Py_DECREF(self);
@@ -58,8 +117,8 @@ return p;
  * of an arbitrary PyObject.
  *
  * The macro ExtractOrBorrowPoly(obj, P, status) will try to borrow a Polynomial
- * from "obj", if "obj" is a Python Polynomial.
- * Otherwise, it will try and create a new Polynomial, if possible
+ * from "obj", if "obj" is a Python Polynomial or an evaluated LazyPolynomial
+ * (which is evaluated if needed). Otherwise, it will try and create a new Polynomial, if possible
  * (a Python number will give a constant Polynomial).
  * The "extracted" Polynomial will be stored in destination pointed by "P"
  * and the status flag will be set accordingly.
@@ -110,6 +169,67 @@ extract_complex(PyObject *obj, Py_complex *dest)
     return EXTRACT_CREATED;
 }
 
+/* Convert "obj" into a newly allocated array of complex numbers, to be
+ * released with free(). Objects exposing a contiguous float64 or complex128
+ * buffer are copied directly, any other iterable is converted item by item.
+ * Returns NULL (with an exception set) on failure. */
+static Py_complex*
+extract_complex_array(PyObject *obj, Py_ssize_t *size)
+{
+    Py_complex *array;
+    Py_ssize_t i, n;
+    Py_buffer view;
+    if (PyObject_CheckBuffer(obj)
+            && PyObject_GetBuffer(obj, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) == 0) {
+        const char *format = view.format;
+        if (*format == '@' || *format == '=') ++format;
+        if (view.ndim == 1 && (!strcmp(format, "d") || !strcmp(format, "Zd"))) {
+            int is_complex = (format[0] == 'Z');
+            n = view.len / view.itemsize;
+            if ((array = malloc((n ? n : 1) * sizeof(Py_complex))) == NULL) {
+                PyBuffer_Release(&view);
+                return (Py_complex*)PyErr_NoMemory();
+            }
+            if (is_complex) {
+                memcpy(array, view.buf, n * sizeof(Py_complex));
+            } else {
+                for (i = 0; i < n; ++i) {
+                    array[i].real = ((double*)view.buf)[i];
+                    array[i].imag = 0.;
+                }
+            }
+            PyBuffer_Release(&view);
+            *size = n;
+            return array;
+        }
+        PyBuffer_Release(&view);
+    }
+    PyErr_Clear();
+    PyObject *seq = PySequence_Fast(obj, "expected a sequence or a buffer of numbers");
+    if (seq == NULL) {
+        return NULL;
+    }
+    n = PySequence_Fast_GET_SIZE(seq);
+    if ((array = malloc((n ? n : 1) * sizeof(Py_complex))) == NULL) {
+        Py_DECREF(seq);
+        return (Py_complex*)PyErr_NoMemory();
+    }
+    for (i = 0; i < n; ++i) {
+        if (extract_complex(PySequence_Fast_GET_ITEM(seq, i), array + i) != EXTRACT_CREATED) {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_TypeError,
+                                "expected a sequence or a buffer of numbers");
+            }
+            free(array);
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+    *size = n;
+    return array;
+}
+
 static inline ExtractionStatus
 extract_poly(PyObject *obj, Polynomial *P)
 {
@@ -124,10 +244,742 @@ extract_poly(PyObject *obj, Polynomial *P)
     return status;
 }
 
+/**
+ * Lazy evaluation
+ * In lazy mode (see lazy()), the arithmetic operators build a graph of
+ * LazyPolynomial nodes instead of computing their results. A node is only
+ * evaluated on first use:
+ *  - nested sums are flattened into a single linear combination, accumulated
+ *    in one pass into the result,
+ *  - products and powers of monomials (such as X**k) are accumulated as
+ *    monomials, without being allocated,
+ *  - identical sub-expressions are computed once.
+ * The Polynomial operands are snapshots taken when the graph is built: a node
+ * shares their coefficients (see poly_copy), so that modifying an operand
+ * afterwards copies them and leaves the expression unchanged.
+ */
+typedef enum {
+    LAZY_SUM,           // ca * a + cb * b + c, b may be NULL
+    LAZY_PRODUCT,       // a * b
+    LAZY_POWER          // a ** exp
+} LazyKind;
+
+typedef struct {
+    PyObject_HEAD
+    LazyKind kind;
+    PyObject *a, *b;        // Polynomial or LazyPolynomial operands
+    Polynomial pa, pb;      // Snapshots of the Polynomial operands
+    Py_complex ca, cb, c;
+    unsigned long exp;
+    int depth;              // Products and powers on the longest path below
+    PyObject *value;        // Resulting Polynomial, once evaluated
+} PyPoly_LazyObject;
+
+static PyTypeObject PyPoly_LazyType;    // Forward declaration
+
+#define PyLazy_Check(op) PyObject_TypeCheck((op), &PyPoly_LazyType)
+
+static int lazy_mode = 0;
+
+static PyObject*
+lazy_new(LazyKind kind, PyObject *a, Py_complex ca, PyObject *b, Py_complex cb,
+         Py_complex c, unsigned long exp)
+{
+    PyPoly_LazyObject *self;
+    self = (PyPoly_LazyObject*)PyPoly_LazyType.tp_alloc(&PyPoly_LazyType, 0);
+    if (self != NULL) {
+        self->kind = kind;
+        Py_INCREF(a);
+        self->a = a;
+        Py_XINCREF(b);
+        self->b = b;
+        self->ca = ca;
+        self->cb = cb;
+        self->c = c;
+        self->exp = exp;
+        poly_init(&(self->pa), -1);
+        poly_init(&(self->pb), -1);
+        if ((PyPolynomial_Check(a)
+                    && !poly_copy(&(((PyPoly_PolynomialObject*)a)->poly), &(self->pa)))
+                || (b != NULL && PyPolynomial_Check(b)
+                    && !poly_copy(&(((PyPoly_PolynomialObject*)b)->poly), &(self->pb)))) {
+            Py_DECREF(self);
+            return PyErr_NoMemory();
+        }
+        self->depth = (kind != LAZY_SUM);
+        if (PyLazy_Check(a)) {
+            self->depth += ((PyPoly_LazyObject*)a)->depth;
+        }
+        if (b != NULL && PyLazy_Check(b)
+                && ((PyPoly_LazyObject*)b)->depth + (kind != LAZY_SUM) > self->depth) {
+            self->depth = ((PyPoly_LazyObject*)b)->depth + (kind != LAZY_SUM);
+        }
+    }
+    return (PyObject*)self;
+}
+
+/* Build the node for "self op other", op being one of '+', '-', '*', '/' */
+static PyObject*
+lazy_binaryop(PyObject *self, PyObject *other, int op)
+{
+    PyObject *P;
+    Py_complex x, sign = {op == '-' ? -1. : 1., 0.};
+    int self_poly = PyPolynomial_Check(self) || PyLazy_Check(self);
+    int other_poly = PyPolynomial_Check(other) || PyLazy_Check(other);
+    ExtractionStatus status = EXTRACT_CREATED;
+    if (self_poly && other_poly) {
+        if (op == '/') {
+            Py_RETURN_NOTIMPLEMENTED;
+        }
+        if (op == '*') {
+            return lazy_new(LAZY_PRODUCT, self, COne, other, COne, CZero, 0);
+        }
+        return lazy_new(LAZY_SUM, self, COne, other, sign, CZero, 0);
+    }
+    if (self_poly) {
+        P = self;
+        status = extract_complex(other, &x);
+    } else if (other_poly && op != '/') {
+        P = other;
+        status = extract_complex(self, &x);
+    } else {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (status == EXTRACT_ERRTYPE) {
+        Py_RETURN_NOTIMPLEMENTED;
+    } else if (status != EXTRACT_CREATED) {
+        return NULL;
+    }
+    switch (op) {
+        case '*':
+            return lazy_new(LAZY_SUM, P, x, NULL, CZero, CZero, 0);
+        case '/':
+            if (x.real == 0. && x.imag == 0.) {
+                PyErr_SetString(PyExc_ZeroDivisionError,
+                                "Cannot divide Polynomial by zero");
+                return NULL;
+            }
+            return lazy_new(LAZY_SUM, P, _Py_c_quot(COne, x), NULL, CZero, CZero, 0);
+        case '-':
+            /* P - x or x - P */
+            if (self_poly) {
+                return lazy_new(LAZY_SUM, P, COne, NULL, CZero, _Py_c_neg(x), 0);
+            }
+            return lazy_new(LAZY_SUM, P, sign, NULL, CZero, x, 0);
+        default:
+            return lazy_new(LAZY_SUM, P, COne, NULL, CZero, x, 0);
+    }
+}
+
+/* Results of the current evaluation, by operation and operands.
+ * The addresses of the operands are part of the keys, so the entries also
+ * hold references to the operands: the (result, operand, ...) tuples.
+ * The dictionary is only created when a first result is stored. */
+static PyObject*
+memo_get(PyObject *memo, PyObject *key)
+{
+    PyObject *entry = (memo == NULL) ? NULL : PyDict_GetItem(memo, key);
+    return (entry == NULL) ? NULL : PyTuple_GET_ITEM(entry, 0);
+}
+
+static int
+memo_set(PyObject **memo, PyObject *key, PyObject **items, Py_ssize_t n)
+{
+    Py_ssize_t i;
+    int ret;
+    PyObject *entry;
+    if (*memo == NULL && (*memo = PyDict_New()) == NULL) {
+        return -1;
+    }
+    if ((entry = PyTuple_New(n)) == NULL) {
+        return -1;
+    }
+    for (i = 0; i < n; ++i) {
+        Py_INCREF(items[i]);
+        PyTuple_SET_ITEM(entry, i, items[i]);
+    }
+    ret = PyDict_SetItem(*memo, key, entry);
+    Py_DECREF(entry);
+    return ret;
+}
+
+/* Build a Python object for R, or free it on failure */
+static PyObject*
+lazy_result(Polynomial *R)
+{
+    PyObject *value = (PyObject*)NewPoly(0, R);
+    if (value == NULL) {
+        poly_free(R);
+    }
+    return value;
+}
+
+static PyObject* lazy_evaluate(PyObject *obj, PyObject **memo, int cache);
+
+/* Complex products of the coefficients, inlined: the evaluation of small
+ * expressions is dominated by them otherwise */
+static inline Py_complex
+lazy_c_prod(Py_complex a, Py_complex b)
+{
+    return (Py_complex){a.real * b.real - a.imag * b.imag,
+                        a.real * b.imag + a.imag * b.real};
+}
+
+#define LAZY_ADDMUL(s, a, b)                                                \
+    do {                                                                    \
+        Py_complex _p = lazy_c_prod((a), (b));                              \
+        (s).real += _p.real;                                                \
+        (s).imag += _p.imag;                                                \
+    } while (0)
+
+/* The Polynomial operands of node modified since it was built are replaced
+ * by Polynomials of their snapshots. As long as a snapshot is shared, the
+ * operand keeps the same coefficients pointer: the check is cheap. */
+#define LazyOperandChanged(obj, snapshot)                                   \
+    ((obj) != NULL && PyPolynomial_Check(obj)                               \
+     && (((PyPoly_PolynomialObject*)(obj))->poly.coef != (snapshot).coef    \
+         || ((PyPoly_PolynomialObject*)(obj))->poly.deg != (snapshot).deg))
+
+static int
+lazy_refresh(PyPoly_LazyObject *node)
+{
+    Polynomial P;
+    PyObject *value;
+    int i;
+    for (i = 0; i < 2; ++i) {
+        PyObject **obj = i ? &(node->b) : &(node->a);
+        Polynomial *snapshot = i ? &(node->pb) : &(node->pa);
+        if (!LazyOperandChanged(*obj, *snapshot)) continue;
+        if (!poly_copy(snapshot, &P)) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        if ((value = lazy_result(&P)) == NULL) {
+            return -1;
+        }
+        Py_SETREF(*obj, value);
+    }
+    return 0;
+}
+
+/* If obj is a monomial expression (a Polynomial c * X**k, a power of it or a
+ * product of two of them), stores c into "c" and returns k. Returns -1
+ * otherwise, without evaluating anything. The snapshot of obj is read if
+ * given, obj being an operand. */
+static int
+lazy_monomial(PyObject *obj, Polynomial *snapshot, Py_complex *c, int depth)
+{
+    PyPoly_LazyObject *node = (PyPoly_LazyObject*)obj;
+    Py_complex d;
+    int k, l;
+    if (PyLazy_Check(obj) && node->value != NULL) {
+        obj = node->value;
+    }
+    if (PyPolynomial_Check(obj)) {
+        return poly_monomial_pow((snapshot != NULL) ? snapshot
+                                 : &(((PyPoly_PolynomialObject*)obj)->poly), 1, c);
+    }
+    if (depth == 0 || node->kind == LAZY_SUM) {
+        return -1;
+    }
+    if (node->kind == LAZY_POWER) {
+        if (!PyPolynomial_Check(node->a)) {
+            return -1;
+        }
+        return poly_monomial_pow(&(node->pa), node->exp, c);
+    }
+    if ((k = lazy_monomial(node->a, &(node->pa), c, depth - 1)) == -1
+            || (l = lazy_monomial(node->b, &(node->pb), &d, depth - 1)) == -1) {
+        return -1;
+    }
+    *c = lazy_c_prod(*c, d);
+    return k + l;
+}
+
+typedef struct {
+    PyObject *obj;          // Node or Polynomial
+    Py_complex coef;        // Accumulated coefficient of obj
+    Py_ssize_t pending;     // Sum nodes still to contribute to coef
+} LazyTerm;
+
+typedef struct {
+    Py_complex coef;
+    int deg;
+} LazyMonomial;
+
+/* The terms of a sum, indexed by an open addressing table on their address.
+ * The terms hold references to their objects, as evaluating a node releases
+ * its operands. Small sums fit in the inline buffers. */
+#define LAZY_INLINE_TERMS   16
+
+typedef struct {
+    LazyTerm *terms;
+    Py_ssize_t n;
+    Py_ssize_t *slots;      // Index of the terms, -1 for empty slots
+    Py_ssize_t mask;        // Size of the table - 1, twice the capacity of terms
+    LazyTerm inline_terms[LAZY_INLINE_TERMS];
+    Py_ssize_t inline_slots[2 * LAZY_INLINE_TERMS];
+} LazyTerms;
+
+#define LAZY_SLOT(obj, mask)    ((Py_ssize_t)((uintptr_t)(obj) >> 4) & (mask))
+
+static void
+lazy_terms_release(LazyTerms *T)
+{
+    if (T->terms != T->inline_terms) {
+        PyMem_Free(T->terms);
+        PyMem_Free(T->slots);
+    }
+}
+
+/* Index of obj in T, added if needed. Returns -1 on error. */
+static Py_ssize_t
+lazy_terms_index(LazyTerms *T, PyObject *obj)
+{
+    Py_ssize_t i, h, mask;
+    if (2 * (T->n + 1) > T->mask + 1) {
+        LazyTerm *terms;
+        Py_ssize_t *slots;
+        if (T->terms == NULL) {
+            terms = T->inline_terms;
+            slots = T->inline_slots;
+            mask = 2 * LAZY_INLINE_TERMS - 1;
+        } else {
+            mask = 2 * T->mask + 1;
+            terms = PyMem_Malloc((mask + 1) / 2 * sizeof(LazyTerm));
+            slots = PyMem_Malloc((mask + 1) * sizeof(Py_ssize_t));
+            if (terms == NULL || slots == NULL) {
+                PyMem_Free(terms);
+                PyMem_Free(slots);
+                PyErr_NoMemory();
+                return -1;
+            }
+            memcpy(terms, T->terms, T->n * sizeof(LazyTerm));
+        }
+        for (h = 0; h <= mask; ++h) {
+            slots[h] = -1;
+        }
+        for (i = 0; i < T->n; ++i) {
+            h = LAZY_SLOT(terms[i].obj, mask);
+            while (slots[h] != -1) {
+                h = (h + 1) & mask;
+            }
+            slots[h] = i;
+        }
+        lazy_terms_release(T);
+        T->terms = terms;
+        T->slots = slots;
+        T->mask = mask;
+    }
+    for (h = LAZY_SLOT(obj, T->mask); (i = T->slots[h]) != -1; h = (h + 1) & T->mask) {
+        if (T->terms[i].obj == obj) return i;
+    }
+    Py_INCREF(obj);
+    T->terms[T->n] = (LazyTerm){obj, CZero, 0};
+    return T->slots[h] = T->n++;
+}
+
+static int
+lazy_term_cmp(const void *x, const void *y)
+{
+    uintptr_t a = (uintptr_t)((const LazyTerm*)x)->obj, b = (uintptr_t)((const LazyTerm*)y)->obj;
+    return (a > b) - (a < b);
+}
+
+static int
+lazy_monomial_cmp(const void *x, const void *y)
+{
+    return ((const LazyMonomial*)x)->deg - ((const LazyMonomial*)y)->deg;
+}
+
+/* Sorts of the terms and of the monomials, by insertion below
+ * LAZY_INLINE_TERMS elements: qsort dominates the small sums otherwise */
+static void
+lazy_sort_terms(LazyTerm *terms, Py_ssize_t n)
+{
+    Py_ssize_t i, j;
+    LazyTerm x;
+    if (n > LAZY_INLINE_TERMS) {
+        qsort(terms, n, sizeof(LazyTerm), lazy_term_cmp);
+        return;
+    }
+    for (i = 1; i < n; ++i) {
+        x = terms[i];
+        for (j = i; j > 0 && (uintptr_t)terms[j - 1].obj > (uintptr_t)x.obj; --j) {
+            terms[j] = terms[j - 1];
+        }
+        terms[j] = x;
+    }
+}
+
+static void
+lazy_sort_monomials(LazyMonomial *monomials, Py_ssize_t n)
+{
+    Py_ssize_t i, j;
+    LazyMonomial x;
+    if (n > LAZY_INLINE_TERMS) {
+        qsort(monomials, n, sizeof(LazyMonomial), lazy_monomial_cmp);
+        return;
+    }
+    for (i = 1; i < n; ++i) {
+        x = monomials[i];
+        for (j = i; j > 0 && monomials[j - 1].deg > x.deg; --j) {
+            monomials[j] = monomials[j - 1];
+        }
+        monomials[j] = x;
+    }
+}
+
+#define LazyIsSum(obj)                                                      \
+    (PyLazy_Check(obj) && ((PyPoly_LazyObject*)(obj))->value == NULL        \
+     && ((PyPoly_LazyObject*)(obj))->kind == LAZY_SUM)
+
+/* Evaluate a sum node as a single linear combination.
+ * The nodes of the nested sums are listed first, then the coefficients are
+ * propagated in topological order, so that a sum shared by several others
+ * is expanded once. The remaining terms are either monomials or evaluated
+ * polynomials, merged by identity before the accumulation. */
+static PyObject*
+lazy_sum(PyPoly_LazyObject *root, PyObject **memo, int cache)
+{
+    LazyTerms T;
+    LazyTerm *evaluated;
+    LazyMonomial *monomials;
+    PyObject *key = NULL, *value = NULL, **items, *children[2];
+    Polynomial **Ps, R;
+    Py_complex *cs, *ms, c;
+    Py_ssize_t *queue, head, tail, i, j, t, np = 0, nm = 0;
+    char *block = NULL;
+    double inline_block[LAZY_INLINE_TERMS * 16];
+    size_t block_size;
+    int *ks, child, k;
+    T.terms = NULL;
+    T.slots = NULL;
+    T.n = 0;
+    T.mask = -1;
+    if (lazy_terms_index(&T, (PyObject*)root) < 0) {
+        goto fail;
+    }
+    for (i = 0; i < T.n; ++i) {
+        PyPoly_LazyObject *node = (PyPoly_LazyObject*)T.terms[i].obj;
+        if (!LazyIsSum((PyObject*)node)) continue;
+        if (lazy_refresh(node) < 0) goto fail;
+        children[0] = node->a;
+        children[1] = node->b;
+        for (child = 0; child < 2 && children[child] != NULL; ++child) {
+            if ((j = lazy_terms_index(&T, children[child])) < 0) goto fail;
+            T.terms[j].pending++;
+        }
+    }
+    block_size = T.n * (sizeof(Py_ssize_t) + sizeof(LazyTerm) + sizeof(LazyMonomial)
+                        + sizeof(Polynomial*) + 2 * sizeof(Py_complex)
+                        + sizeof(PyObject*) + sizeof(int)) + sizeof(PyObject*);
+    if (block_size <= sizeof(inline_block)) {
+        block = (char*)inline_block;
+    } else if ((block = PyMem_Malloc(block_size)) == NULL) {
+        PyErr_NoMemory();
+        goto fail;
+    }
+    queue = (Py_ssize_t*)block;
+    evaluated = (LazyTerm*)(queue + T.n);
+    monomials = (LazyMonomial*)(evaluated + T.n);
+    Ps = (Polynomial**)(monomials + T.n);
+    cs = (Py_complex*)(Ps + T.n);
+    ms = cs + T.n;
+    items = (PyObject**)(ms + T.n);
+    ks = (int*)(items + T.n + 1);
+    /* Propagation of the coefficients */
+    T.terms[0].coef = COne;
+    queue[0] = 0;
+    for (head = 0, tail = 1; head < tail; ++head) {
+        PyPoly_LazyObject *node = (PyPoly_LazyObject*)T.terms[queue[head]].obj;
+        Py_complex coef = T.terms[queue[head]].coef;
+        if (!LazyIsSum((PyObject*)node)) continue;
+        children[0] = node->a;
+        children[1] = node->b;
+        for (child = 0; child < 2 && children[child] != NULL; ++child) {
+            j = lazy_terms_index(&T, children[child]);
+            LAZY_ADDMUL(T.terms[j].coef, coef, child ? node->cb : node->ca);
+            if (--T.terms[j].pending == 0) {
+                queue[tail++] = j;
+            }
+        }
+    }
+    /* Constants, monomials and evaluated terms. The evaluations may turn sum
+     * nodes into evaluated nodes, so those are flagged beforehand. */
+    for (i = 0; i < T.n; ++i) {
+        T.terms[i].pending = LazyIsSum(T.terms[i].obj);
+    }
+    for (i = 0, t = 0; i < T.n; ++i) {
+        if (complex_iszero(T.terms[i].coef)) continue;
+        if (T.terms[i].pending) {
+            c = lazy_c_prod(T.terms[i].coef, ((PyPoly_LazyObject*)T.terms[i].obj)->c);
+            if (!complex_iszero(c)) monomials[nm++] = (LazyMonomial){c, 0};
+        } else if ((k = lazy_monomial(T.terms[i].obj, NULL, &c, 2)) != -1) {
+            monomials[nm++] = (LazyMonomial){lazy_c_prod(T.terms[i].coef, c), k};
+        } else {
+            evaluated[t].obj = lazy_evaluate(T.terms[i].obj, memo, 1);
+            if (evaluated[t].obj == NULL) goto fail;
+            evaluated[t].coef = T.terms[i].coef;
+            evaluated[t++].pending = 0;
+        }
+    }
+    /* Canonical form, also used as key of the memo */
+    lazy_sort_terms(evaluated, t);
+    for (i = 0; i < t; ++i) {
+        if (np > 0 && evaluated[np - 1].obj == evaluated[i].obj) {
+            evaluated[np - 1].coef = _Py_c_sum(evaluated[np - 1].coef, evaluated[i].coef);
+        } else {
+            evaluated[np++] = evaluated[i];
+        }
+    }
+    lazy_sort_monomials(monomials, nm);
+    for (i = 0, t = nm, nm = 0; i < t; ++i) {
+        if (nm > 0 && monomials[nm - 1].deg == monomials[i].deg) {
+            monomials[nm - 1].coef = _Py_c_sum(monomials[nm - 1].coef, monomials[i].coef);
+        } else {
+            monomials[nm++] = monomials[i];
+        }
+    }
+    for (i = 0; i < np; ++i) {
+        Ps[i] = &(((PyPoly_PolynomialObject*)evaluated[i].obj)->poly);
+        cs[i] = evaluated[i].coef;
+        items[i + 1] = evaluated[i].obj;
+    }
+    for (i = 0; i < nm; ++i) {
+        ms[i] = monomials[i].coef;
+        ks[i] = monomials[i].deg;
+    }
+    if (cache) {
+        key = PyBytes_FromStringAndSize(NULL, np * sizeof(LazyTerm)
+                                        + nm * (sizeof(Py_complex) + sizeof(int)));
+        if (key == NULL) goto fail;
+        memcpy(PyBytes_AS_STRING(key), evaluated, np * sizeof(LazyTerm));
+        memcpy(PyBytes_AS_STRING(key) + np * sizeof(LazyTerm), ms, nm * sizeof(Py_complex));
+        memcpy(PyBytes_AS_STRING(key) + np * sizeof(LazyTerm) + nm * sizeof(Py_complex),
+               ks, nm * sizeof(int));
+        if ((value = memo_get(*memo, key)) != NULL) {
+            Py_INCREF(value);
+            goto fail;
+        }
+    }
+    if (!poly_linear_combination(Ps, cs, (int)np, ms, ks, (int)nm, &R)) {
+        PyErr_NoMemory();
+    } else if ((items[0] = value = lazy_result(&R)) != NULL
+               && cache && memo_set(memo, key, items, np + 1) < 0) {
+        Py_CLEAR(value);
+    }
+fail:
+    for (i = 0; i < T.n; ++i) {
+        Py_DECREF(T.terms[i].obj);
+    }
+    Py_XDECREF(key);
+    lazy_terms_release(&T);
+    if (block != (char*)inline_block) {
+        PyMem_Free(block);
+    }
+    return value;
+}
+
+/* Evaluate a product or power node */
+static PyObject*
+lazy_product(PyPoly_LazyObject *node, PyObject **memo, int cache)
+{
+    PyObject *items[3], *key = NULL, *value;
+    Polynomial R;
+    int res;
+    struct {
+        LazyKind kind;
+        unsigned long exp;
+        PyObject *a, *b;
+    } k;
+    if (lazy_refresh(node) < 0 || (items[1] = lazy_evaluate(node->a, memo, 1)) == NULL) {
+        return NULL;
+    }
+    items[2] = items[1];
+    if (node->kind == LAZY_PRODUCT && (items[2] = lazy_evaluate(node->b, memo, 1)) == NULL) {
+        return NULL;
+    }
+    if (cache) {
+        memset(&k, 0, sizeof(k));
+        k.kind = node->kind;
+        k.exp = node->exp;
+        k.a = ((uintptr_t)items[1] < (uintptr_t)items[2]) ? items[1] : items[2];
+        k.b = ((uintptr_t)items[1] < (uintptr_t)items[2]) ? items[2] : items[1];
+        if ((key = PyBytes_FromStringAndSize((const char*)&k, sizeof(k))) == NULL) {
+            return NULL;
+        }
+        if ((value = memo_get(*memo, key)) != NULL) {
+            Py_INCREF(value);
+            Py_DECREF(key);
+            return value;
+        }
+    }
+    if (node->kind == LAZY_PRODUCT) {
+        res = poly_multiply(&(((PyPoly_PolynomialObject*)items[1])->poly),
+                            &(((PyPoly_PolynomialObject*)items[2])->poly), &R);
+    } else {
+        res = poly_pow(&(((PyPoly_PolynomialObject*)items[1])->poly), node->exp, &R);
+    }
+    if (!res) {
+        Py_XDECREF(key);
+        return PyErr_NoMemory();
+    }
+    if ((items[0] = value = lazy_result(&R)) != NULL
+            && cache && memo_set(memo, key, items, 3) < 0) {
+        Py_CLEAR(value);
+    }
+    Py_XDECREF(key);
+    return value;
+}
+
+/* Evaluate obj, a Polynomial or a LazyPolynomial, sharing the results
+ * of "memo" when "cache" is set. Returns a borrowed reference to the
+ * resulting Polynomial. */
+static PyObject*
+lazy_evaluate(PyObject *obj, PyObject **memo, int cache)
+{
+    PyPoly_LazyObject *node = (PyPoly_LazyObject*)obj;
+    PyObject *value;
+    if (PyPolynomial_Check(obj)) {
+        return obj;
+    }
+    if (node->value != NULL) {
+        return node->value;
+    }
+    if (Py_EnterRecursiveCall(" while evaluating a LazyPolynomial")) {
+        return NULL;
+    }
+    if (node->kind == LAZY_SUM) {
+        value = lazy_sum(node, memo, cache);
+    } else {
+        value = lazy_product(node, memo, cache);
+    }
+    Py_LeaveRecursiveCall();
+    if (value == NULL) {
+        return NULL;
+    }
+    /* The operands are not needed anymore */
+    node->value = value;
+    Py_CLEAR(node->a);
+    Py_CLEAR(node->b);
+    poly_free(&(node->pa));
+    poly_free(&(node->pb));
+    return value;
+}
+
+#define LazyIsPending(obj)                                                  \
+    (PyLazy_Check(obj) && ((PyPoly_LazyObject*)(obj))->value == NULL)
+
+/* Graphs of up to LAZY_MAX_DEPTH nested products are evaluated recursively:
+ * listing their nodes would cost more than evaluating small expressions */
+#define LAZY_MAX_DEPTH  32
+
+/* Evaluate the products and powers below root, children first, so that the
+ * evaluation of root recurses no further than a monomial or a sum of
+ * evaluated terms. The nodes are listed and sorted in topological order as
+ * in lazy_sum; the sums and the monomials are left to their parents. */
+static int
+lazy_prepare(PyObject *root, PyObject **memo)
+{
+    LazyTerms T;
+    PyObject *children[2];
+    Py_ssize_t *queue = NULL, head, tail, i, j;
+    Py_complex c;
+    int child, ret = -1;
+    T.terms = NULL;
+    T.slots = NULL;
+    T.n = 0;
+    T.mask = -1;
+    if (lazy_terms_index(&T, root) < 0) {
+        goto fail;
+    }
+    for (i = 0; i < T.n; ++i) {
+        PyPoly_LazyObject *node = (PyPoly_LazyObject*)T.terms[i].obj;
+        children[0] = node->a;
+        children[1] = node->b;
+        for (child = 0; child < 2 && children[child] != NULL; ++child) {
+            if (!LazyIsPending(children[child])) continue;
+            if ((j = lazy_terms_index(&T, children[child])) < 0) goto fail;
+            T.terms[j].pending++;
+        }
+    }
+    if (T.n == 1) {
+        ret = 0;
+        goto fail;
+    }
+    if ((queue = PyMem_Malloc(T.n * sizeof(Py_ssize_t))) == NULL) {
+        PyErr_NoMemory();
+        goto fail;
+    }
+    queue[0] = 0;
+    for (head = 0, tail = 1; head < tail; ++head) {
+        PyPoly_LazyObject *node = (PyPoly_LazyObject*)T.terms[queue[head]].obj;
+        children[0] = node->a;
+        children[1] = node->b;
+        for (child = 0; child < 2 && children[child] != NULL; ++child) {
+            if (!LazyIsPending(children[child])) continue;
+            j = lazy_terms_index(&T, children[child]);
+            if (--T.terms[j].pending == 0) {
+                queue[tail++] = j;
+            }
+        }
+    }
+    for (head = tail - 1; head > 0; --head) {
+        PyPoly_LazyObject *node = (PyPoly_LazyObject*)T.terms[queue[head]].obj;
+        if (node->kind == LAZY_SUM || lazy_monomial((PyObject*)node, NULL, &c, 2) != -1) {
+            continue;
+        }
+        if (lazy_evaluate((PyObject*)node, memo, 1) == NULL) goto fail;
+    }
+    ret = 0;
+fail:
+    for (i = 0; i < T.n; ++i) {
+        Py_DECREF(T.terms[i].obj);
+    }
+    lazy_terms_release(&T);
+    PyMem_Free(queue);
+    return ret;
+}
+
+/* Returns a borrowed reference to the value of obj if it is a LazyPolynomial,
+ * to obj itself otherwise. */
+static PyObject*
+lazy_value(PyObject *obj)
+{
+    PyObject *memo = NULL, *value;
+    if (!PyLazy_Check(obj)) {
+        return obj;
+    }
+    /* The whole graph is evaluated at once: results of the sub-expressions
+     * are shared, the root itself cannot appear twice */
+    if (((PyPoly_LazyObject*)obj)->depth > LAZY_MAX_DEPTH
+            && lazy_prepare(obj, &memo) < 0) {
+        Py_XDECREF(memo);
+        return NULL;
+    }
+    value = lazy_evaluate(obj, &memo, 0);
+    Py_XDECREF(memo);
+    return value;
+}
+
+static ExtractionStatus
+borrow_lazy(PyObject *obj, Polynomial *P)
+{
+    PyObject *value = lazy_value(obj);
+    if (value == NULL) {
+        return EXTRACT_ERR;
+    }
+    *P = ((PyPoly_PolynomialObject*)value)->poly;
+    return EXTRACT_BORROWED;
+}
+
 #define ExtractOrBorrowPoly(obj, P, status)             \
     if (PyPolynomial_Check(obj)) {                      \
         P = ((PyPoly_PolynomialObject*)obj)->poly;      \
         status = EXTRACT_BORROWED;                      \
+    } else if (PyLazy_Check(obj)) {                     \
+        status = borrow_lazy(obj, &P);                  \
     } else {                                            \
         status = extract_poly(obj, &P);                 \
     }
@@ -164,7 +1016,11 @@ PyPoly_new(PyTypeObject *subtype, PyObject *args, PyObject *kwds)
 static void
 PyPoly_dealloc(PyPoly_PolynomialObject *self)
 {
-    poly_free(&(self->poly));
+    if (self->base != NULL) {
+        Py_DECREF(self->base);
+    } else {
+        poly_free(&(self->poly));
+    }
     Py_TYPE(self)->tp_free((PyObject*)self);
 }
 
@@ -183,6 +1039,9 @@ PyPoly_repr(PyPoly_PolynomialObject *self)
 {
     char* str = poly_to_string(&(self->poly));
     PyObject* ret;
+    if (str == NULL) {
+        return PyErr_NoMemory();
+    }
 #if PY_VERSION_HEX >= 0x03030000
     ret = PyUnicode_FromKindAndData(PyUnicode_1BYTE_KIND, str, strlen(str));
 #else
@@ -192,10 +1051,45 @@ PyPoly_repr(PyPoly_PolynomialObject *self)
     return ret;
 }
 
-/* Macro for converting the arguments of a function into
- * into two Polynomial objects, in order to perform some operation
- * Assumes: PyObject *self, *other are the arguments
- * Constructs: Polynomial A, B; ExtractionStatus A_status, B_status
+/* poly_writer callback forwarding each chunk to the "write" method
+ * of a Python file-like object. */
+static int
+pyfile_writer(void *ctx, const char *data, size_t len)
+{
+    PyObject *chunk, *ret;
+#if PY_VERSION_HEX >= 0x03030000
+    chunk = PyUnicode_FromKindAndData(PyUnicode_1BYTE_KIND, data, len);
+#else
+    chunk = PyUnicode_FromStringAndSize(data, len);
+#endif
+    if (chunk == NULL) {
+        return 0;
+    }
+    ret = PyObject_CallMethod((PyObject*)ctx, "write", "O", chunk);
+    Py_DECREF(chunk);
+    if (ret == NULL) {
+        return 0;
+    }
+    Py_DECREF(ret);
+    return 1;
+}
+
+static PyObject*
+PyPoly_write(PyPoly_PolynomialObject *self, PyObject *file)
+{
+    if (!poly_write(&(self->poly), pyfile_writer, file)) {
+        if (!PyErr_Occurred()) {
+            PyErr_NoMemory();
+        }
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+/* Macro for converting the arguments of a function into
+ * into two Polynomial objects, in order to perform some operation
+ * Assumes: PyObject *self, *other are the arguments
+ * Constructs: Polynomial A, B; ExtractionStatus A_status, B_status
  */
 #define PYPOLY_BINARYFUNC_HEADER                            \
     int A_status, B_status;                                 \
@@ -211,6 +1105,8 @@ PyPoly_repr(PyPoly_PolynomialObject *self)
             ||                                              \
             B_status == EXTRACT_ERRTYPE) {                  \
             Py_RETURN_NOTIMPLEMENTED;                       \
+        } else if (PyErr_Occurred()) {                      \
+            return NULL;                                    \
         } else {                                            \
             return PyErr_NoMemory();                        \
         }                                                   \
@@ -222,6 +1118,9 @@ PyPoly_repr(PyPoly_PolynomialObject *self)
 static PyObject*
 PyPoly_add(PyObject *self, PyObject *other)
 {
+    if (lazy_mode) {
+        return lazy_binaryop(self, other, '+');
+    }
     PYPOLY_BINARYFUNC_HEADER
     Polynomial R;
     if (!poly_add(&A, &B, &R)) {
@@ -236,6 +1135,9 @@ PyPoly_add(PyObject *self, PyObject *other)
 static PyObject*
 PyPoly_sub(PyObject *self, PyObject *other)
 {
+    if (lazy_mode) {
+        return lazy_binaryop(self, other, '-');
+    }
     PYPOLY_BINARYFUNC_HEADER
     Polynomial R;
     if (!poly_sub(&A, &B, &R)) {
@@ -250,6 +1152,9 @@ PyPoly_sub(PyObject *self, PyObject *other)
 static PyObject*
 PyPoly_mult(PyObject *self, PyObject *other)
 {
+    if (lazy_mode) {
+        return lazy_binaryop(self, other, '*');
+    }
     PYPOLY_BINARYFUNC_HEADER
     Polynomial R;
     if (!poly_multiply(&A, &B, &R)) {
@@ -264,6 +1169,9 @@ PyPoly_mult(PyObject *self, PyObject *other)
 static PyObject*
 PyPoly_div(PyObject *self, PyObject *other)
 {
+    if (lazy_mode) {
+        return lazy_binaryop(self, other, '/');
+    }
     if(!PyPolynomial_Check(self)) {
         Py_RETURN_NOTIMPLEMENTED;
     }
@@ -297,6 +1205,9 @@ PyPoly_div(PyObject *self, PyObject *other)
 static PyObject*
 PyPoly_neg(PyPoly_PolynomialObject *self)
 {
+    if (lazy_mode) {
+        return lazy_new(LAZY_SUM, (PyObject*)self, (Py_complex){-1., 0.}, NULL, CZero, CZero, 0);
+    }
     Polynomial P;
     if (!poly_neg(&(self->poly), &P)) {
         return PyErr_NoMemory();
@@ -304,19 +1215,478 @@ PyPoly_neg(PyPoly_PolynomialObject *self)
     ReturnPyPolyOrFree(P)
 }
 
+static PyObject*
+number_from_complex(Py_complex c)
+{
+    if (c.imag == 0) {
+        return PyFloat_FromDouble(c.real);
+    }
+    return PyComplex_FromCComplex(c);
+}
+
+static PyObject*
+number_array_to_list(Py_complex *array, int n)
+{
+    int i;
+    PyObject *list, *item;
+    if ((list = PyList_New(n)) == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < n; ++i) {
+        if ((item = number_from_complex(array[i])) == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+/* Evaluate P at the Python number x.
+ * Exact floats and ints skip the complex conversion and the complex
+ * multiplications of Horner's method. */
+static PyObject*
+eval_number(Polynomial *P, PyObject *x)
+{
+    Py_complex c;
+    if (PyFloat_CheckExact(x)) {
+        return number_from_complex(poly_eval_real(P, PyFloat_AS_DOUBLE(x)));
+    }
+    if (PyLong_CheckExact(x)) {
+        c.real = PyLong_AsDouble(x);
+        if (c.real == -1. && PyErr_Occurred()) {
+            return NULL;
+        }
+        return number_from_complex(poly_eval_real(P, c.real));
+    }
+    c = PyComplex_AsCComplex(x);
+    if (c.real == -1. && PyErr_Occurred()) {
+        return NULL;
+    }
+    return number_from_complex(poly_eval(P, c));
+}
+
 static PyObject*
 PyPoly_call(PyPoly_PolynomialObject *self, PyObject *args, PyObject *kwds)
 {
-    Py_complex x;
+    PyObject *x;
+    if (!_PyArg_NoKeywords("__call__()", kwds) || !PyArg_UnpackTuple(args, "__call__", 1, 1, &x)) {
+        return NULL;
+    }
+    return eval_number(&(self->poly), x);
+}
 
-    if (!_PyArg_NoKeywords("__call__()", kwds) || !PyArg_ParseTuple(args, "D", &x)) {
+#ifdef PYPOLY_VECTORCALL
+static int
+check_call_args(size_t nargsf, PyObject *kwnames)
+{
+    if (kwnames != NULL && PyTuple_GET_SIZE(kwnames) > 0) {
+        PyErr_SetString(PyExc_TypeError, "__call__() takes no keyword arguments");
+        return 0;
+    }
+    if (PyVectorcall_NARGS(nargsf) != 1) {
+        PyErr_Format(PyExc_TypeError, "__call__ expected 1 argument, got %zd",
+                     PyVectorcall_NARGS(nargsf));
+        return 0;
+    }
+    return 1;
+}
+
+static PyObject*
+PyPoly_vectorcall(PyObject *self, PyObject *const *args, size_t nargsf, PyObject *kwnames)
+{
+    if (!check_call_args(nargsf, kwnames)) {
+        return NULL;
+    }
+    return eval_number(&(((PyPoly_PolynomialObject*)self)->poly), args[0]);
+}
+#endif
+
+static PyObject*
+PyPoly_shift(PyPoly_PolynomialObject *self, PyObject *arg)
+{
+    Py_complex a;
+    if (extract_complex(arg, &a) != EXTRACT_CREATED) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "shift() argument must be a number");
+        }
+        return NULL;
+    }
+    Polynomial P;
+    if (!poly_shift(&(self->poly), a, &P)) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyPolyOrFree(P)
+}
+
+static PyObject*
+PyPoly_taylor(PyPoly_PolynomialObject *self, PyObject *args)
+{
+    PyObject *arg, *list;
+    Py_complex a, *ds;
+    int k;
+    if (!PyArg_ParseTuple(args, "Oi", &arg, &k)) {
+        return NULL;
+    }
+    if (extract_complex(arg, &a) != EXTRACT_CREATED) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "taylor() point must be a number");
+        }
+        return NULL;
+    }
+    if (k < 0) {
+        PyErr_SetString(PyExc_ValueError, "The derivation order must be non-negative");
+        return NULL;
+    }
+    if (k == INT_MAX || (ds = malloc(((size_t)k + 1) * sizeof(Py_complex))) == NULL) {
+        return PyErr_NoMemory();
+    }
+    list = poly_taylor(&(self->poly), a, k, ds) ? number_array_to_list(ds, k + 1) : PyErr_NoMemory();
+    free(ds);
+    return list;
+}
+
+static PyObject*
+PyPoly_taylor_many(PyPoly_PolynomialObject *self, PyObject *args)
+{
+    PyObject *arg, *list = NULL, *item;
+    Py_complex *xs, *ds = NULL;
+    Py_ssize_t i, n;
+    Polynomial P;
+    int k, res = 0;
+    if (!PyArg_ParseTuple(args, "Oi", &arg, &k)) {
+        return NULL;
+    }
+    if (k < 0) {
+        PyErr_SetString(PyExc_ValueError, "The derivation order must be non-negative");
+        return NULL;
+    }
+    if ((xs = extract_complex_array(arg, &n)) == NULL) {
+        return NULL;
+    }
+    /* Work on a copy, the Polynomial may be modified while the GIL is released */
+    if (n > INT_MAX || k == INT_MAX || (double)n * (k + 1) > PY_SSIZE_T_MAX / sizeof(Py_complex)
+            || (ds = malloc((n ? n : 1) * ((size_t)k + 1) * sizeof(Py_complex))) == NULL
+            || !poly_copy(&(self->poly), &P)) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = poly_taylor_many(&P, xs, (int)n, k, ds);
+    Py_END_ALLOW_THREADS
+    poly_free(&P);
+    if (!res) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    if ((list = PyList_New(n)) == NULL) {
+        goto done;
+    }
+    for (i = 0; i < n; ++i) {
+        if ((item = number_array_to_list(ds + i * (k + 1), k + 1)) == NULL) {
+            Py_CLEAR(list);
+            goto done;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+done:
+    free(xs);
+    free(ds);
+    return list;
+}
+
+static PyObject*
+PyPoly_compose(PyPoly_PolynomialObject *self, PyObject *other)
+{
+    ExtractionStatus B_status;
+    Polynomial B, P;
+    ExtractOrBorrowPoly(other, B, B_status)
+    if (PolyExtractionFailure(B_status)) {
+        if (B_status == EXTRACT_ERRTYPE) {
+            PyErr_SetString(PyExc_TypeError,
+                            "compose() argument must be a Polynomial or a number");
+        } else if (!PyErr_Occurred()) {
+            PyErr_NoMemory();
+        }
+        return NULL;
+    }
+    int res = poly_compose(&(self->poly), &B, &P);
+    if (B_status == EXTRACT_CREATED) poly_free(&B);
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyPolyOrFree(P)
+}
+
+static PyObject*
+PyPoly_resultant(PyPoly_PolynomialObject *self, PyObject *other)
+{
+    ExtractionStatus B_status;
+    Polynomial B;
+    Py_complex r;
+    ExtractOrBorrowPoly(other, B, B_status)
+    if (PolyExtractionFailure(B_status)) {
+        if (B_status == EXTRACT_ERRTYPE) {
+            PyErr_SetString(PyExc_TypeError,
+                            "resultant() argument must be a Polynomial or a number");
+        } else if (!PyErr_Occurred()) {
+            PyErr_NoMemory();
+        }
+        return NULL;
+    }
+    int res = poly_resultant(&(self->poly), &B, &r);
+    if (B_status == EXTRACT_CREATED) poly_free(&B);
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    return number_from_complex(r);
+}
+
+static PyObject*
+PyPoly_discriminant(PyPoly_PolynomialObject *self)
+{
+    Py_complex d;
+    int res = poly_discriminant(&(self->poly), &d);
+    if (res == -1) {
+        PyErr_SetString(PyExc_ValueError,
+                        "The discriminant of a constant Polynomial is undefined");
+        return NULL;
+    }
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    return number_from_complex(d);
+}
+
+static PyObject*
+PyPoly_interpolate(PyTypeObject *type, PyObject *args)
+{
+    PyObject *pyxs, *pyys;
+    Py_complex *xs, *ys;
+    Py_ssize_t n, nys;
+    if (!PyArg_ParseTuple(args, "OO:interpolate", &pyxs, &pyys)) {
+        return NULL;
+    }
+    if ((xs = extract_complex_array(pyxs, &n)) == NULL) {
+        return NULL;
+    }
+    if ((ys = extract_complex_array(pyys, &nys)) == NULL) {
+        free(xs);
+        return NULL;
+    }
+    if (n != nys || n > INT_MAX) {
+        free(xs);
+        free(ys);
+        PyErr_SetString(PyExc_ValueError,
+                        "interpolate() expects as many abscissas as values");
+        return NULL;
+    }
+    Polynomial P;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = poly_interpolate(xs, ys, (int)n, &P);
+    Py_END_ALLOW_THREADS
+    free(xs);
+    free(ys);
+    if (res != 1) {
+        if (res == -1) {
+            PyErr_SetString(PyExc_ValueError,
+                            "interpolate() abscissas must be distinct");
+            return NULL;
+        }
+        return PyErr_NoMemory();
+    }
+    PyObject *p;
+    if ((p = (PyObject*)new_poly_st(type, 0, &P)) == NULL) {
+        poly_free(&P);
+        return PyErr_NoMemory();
+    }
+    return p;
+}
+
+static PyObject*
+complex_array_to_list(Py_complex *array, int n)
+{
+    int i;
+    PyObject *list, *item;
+    if ((list = PyList_New(n)) == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < n; ++i) {
+        if ((item = PyComplex_FromCComplex(array[i])) == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+
+static PyObject*
+PyPoly_roots(PyPoly_PolynomialObject *self)
+{
+    Polynomial P;
+    Py_complex *roots;
+    int res;
+    if (self->poly.deg == -1) {
+        PyErr_SetString(PyExc_ValueError,
+                        "The roots of the zero Polynomial are undefined");
+        return NULL;
+    }
+    /* Work on a copy, the Polynomial may be modified while the GIL is released */
+    if (!poly_copy(&(self->poly), &P)) {
+        return PyErr_NoMemory();
+    }
+    if ((roots = malloc((P.deg + 1) * sizeof(Py_complex))) == NULL) {
+        poly_free(&P);
+        return PyErr_NoMemory();
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = poly_roots(&P, roots, 1);
+    Py_END_ALLOW_THREADS
+    PyObject *list = res ? complex_array_to_list(roots, P.deg) : PyErr_NoMemory();
+    poly_free(&P);
+    free(roots);
+    return list;
+}
+
+static PyObject*
+PyPoly_squarefree(PyPoly_PolynomialObject *self, PyObject *args)
+{
+    Polynomial P, *factors;
+    PyObject *list, *item, *F;
+    double tol = POLY_SQUAREFREE_TOL;
+    int *mult, count, i, res;
+    if (!PyArg_ParseTuple(args, "|d:squarefree", &tol)) {
+        return NULL;
+    }
+    if (self->poly.deg == -1) {
+        PyErr_SetString(PyExc_ValueError,
+                        "The zero Polynomial has no square-free factorization");
+        return NULL;
+    }
+    /* Work on a copy, the Polynomial may be modified while the GIL is released */
+    if (!poly_copy(&(self->poly), &P)) {
+        return PyErr_NoMemory();
+    }
+    factors = malloc((P.deg + 1) * sizeof(Polynomial));
+    mult = malloc((P.deg + 1) * sizeof(int));
+    if (factors == NULL || mult == NULL) {
+        poly_free(&P);
+        free(factors);
+        free(mult);
+        return PyErr_NoMemory();
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = poly_squarefree(&P, tol, factors, mult, &count);
+    Py_END_ALLOW_THREADS
+    poly_free(&P);
+    list = res ? PyList_New(count) : PyErr_NoMemory();
+    for (i = 0; i < count; ++i) {
+        if (list == NULL || (F = (PyObject*)NewPoly(0, factors + i)) == NULL) {
+            poly_free(factors + i);
+            Py_CLEAR(list);
+            continue;
+        }
+        if ((item = Py_BuildValue("(Ni)", F, mult[i])) == NULL) {
+            Py_CLEAR(list);
+            continue;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    free(factors);
+    free(mult);
+    return list;
+}
+
+/* Square matrix given as a 2-D float64 or complex128 buffer, of any strides,
+ * copied into a newly allocated row-major array to be released with free() */
+static Py_complex*
+extract_square_matrix(PyObject *obj, int *order)
+{
+    Py_complex *M;
+    Py_buffer view;
+    Py_ssize_t i, j, n;
+    const char *format;
+    if (!PyObject_CheckBuffer(obj)
+            || PyObject_GetBuffer(obj, &view, PyBUF_RECORDS_RO) != 0) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError,
+                        "eval_matrix() argument must be a 2-D float64 or complex128 buffer");
+        return NULL;
+    }
+    format = view.format;
+    if (*format == '@' || *format == '=') ++format;
+    if (view.ndim != 2 || (strcmp(format, "d") && strcmp(format, "Zd"))) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_TypeError,
+                        "eval_matrix() argument must be a 2-D float64 or complex128 buffer");
+        return NULL;
+    }
+    n = view.shape[0];
+    if (view.shape[1] != n || n > 46340) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError, "eval_matrix() expects a square matrix");
+        return NULL;
+    }
+    if ((M = malloc((n ? n * n : 1) * sizeof(Py_complex))) == NULL) {
+        PyBuffer_Release(&view);
+        return (Py_complex*)PyErr_NoMemory();
+    }
+    for (i = 0; i < n; ++i) {
+        for (j = 0; j < n; ++j) {
+            const char *item = (const char*)view.buf + i * view.strides[0] + j * view.strides[1];
+            if (format[0] == 'Z') {
+                memcpy(M + i * n + j, item, sizeof(Py_complex));
+            } else {
+                memcpy(&(M[i * n + j].real), item, sizeof(double));
+                M[i * n + j].imag = 0.;
+            }
+        }
+    }
+    PyBuffer_Release(&view);
+    *order = (int)n;
+    return M;
+}
+
+static PyObject*
+PyPoly_eval_matrix(PyPoly_PolynomialObject *self, PyObject *arg)
+{
+    Polynomial P;
+    Py_complex *M, *R;
+    PyObject *rows, *row;
+    int n = 0, i, res;
+    if ((M = extract_square_matrix(arg, &n)) == NULL) {
         return NULL;
     }
-    Py_complex y = poly_eval(&(self->poly), x);
-    if (y.imag == 0) {
-        return PyFloat_FromDouble(y.real);
+    if ((R = malloc((n ? (size_t)n * n : 1) * sizeof(Py_complex))) == NULL) {
+        free(M);
+        return PyErr_NoMemory();
+    }
+    /* Work on a copy, the Polynomial may be modified while the GIL is released */
+    if (!poly_copy(&(self->poly), &P)) {
+        free(M);
+        free(R);
+        return PyErr_NoMemory();
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = poly_eval_matrix(&P, M, n, R);
+    Py_END_ALLOW_THREADS
+    poly_free(&P);
+    free(M);
+    rows = res ? PyList_New(n) : PyErr_NoMemory();
+    for (i = 0; rows != NULL && i < n; ++i) {
+        if ((row = number_array_to_list(R + (size_t)i * n, n)) == NULL) {
+            Py_CLEAR(rows);
+            break;
+        }
+        PyList_SET_ITEM(rows, i, row);
     }
-    return PyComplex_FromCComplex(y);
+    free(R);
+    return rows;
 }
 
 /* Very high exponents are not supported since:
@@ -337,6 +1707,9 @@ PyPoly_pow(PyPoly_PolynomialObject *self, PyObject *pyexp, PyObject *pymod)
                             "Polynomial exponentiation with exponents higher"
                             " than %d is not supported", PYPOLY_MAX_EXPONENT);
     }
+    if (lazy_mode) {
+        return lazy_new(LAZY_POWER, (PyObject*)self, COne, NULL, CZero, CZero, exponent);
+    }
     Polynomial P;
     if (!poly_pow(&(self->poly), exponent, &P)) {
         return PyErr_NoMemory();
@@ -421,11 +1794,9 @@ PyPoly_divmod(PyObject *self, PyObject *other)
         Py_DECREF(p1);
         return NULL;
     }
-    if ((t = PyTuple_Pack(2, p1, p2)) == NULL) {
-        Py_DECREF(p1);
-        Py_DECREF(p2);
-        return NULL;
-    }
+    t = PyTuple_Pack(2, p1, p2);
+    Py_DECREF(p1);
+    Py_DECREF(p2);
     return t;
 }
 
@@ -490,42 +1861,141 @@ PyPoly_setitem(PyPoly_PolynomialObject *self, Py_ssize_t i, PyObject *v)
                         "Incorrect argument for item assignment.");
         return -1;
     }
-    if (i > self->poly.deg && !poly_realloc(&(self->poly), i)) {
+    /* Views and copies get their own coefficients before being modified */
+    if (i > self->poly.deg ? !poly_realloc(&(self->poly), i) : !poly_unshare(&(self->poly))) {
         PyErr_SetString(PyExc_MemoryError,
                         "Failed to allocate memory.");
         return -1;
     }
+    Py_CLEAR(self->base);
     poly_set_coef(&(self->poly), i, c);
     return 0;
 }
 
-/* Module methods */
-
+/* P[start:stop:step] is the Polynomial of the selected coefficients, taken
+ * as in the list of the deg + 1 coefficients of P: P[::-1] is the reciprocal
+ * polynomial for instance. */
 static PyObject*
-PyPoly_gcd(PyObject *self, PyObject *args)
+PyPoly_subscript(PyPoly_PolynomialObject *self, PyObject *key)
 {
-    int i = PyTuple_GET_SIZE(args);
-    if (i < 2) {
-        PyErr_SetString(PyExc_TypeError,
-                        "'gcd' takes two or more polynomials as arguments");
+    Py_ssize_t start, stop, step, n;
+    Polynomial P;
+    if (!PySlice_Check(key)) {
+        if ((n = PyNumber_AsSsize_t(key, PyExc_IndexError)) == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (n < 0) {
+            PyErr_SetString(PyExc_IndexError, "Polynomial index out of range");
+            return NULL;
+        }
+        return PyPoly_getitem(self, (n > INT_MAX) ? INT_MAX : n);
+    }
+    if (PySlice_Unpack(key, &start, &stop, &step) < 0) {
         return NULL;
     }
-
-    PyObject* item;
-    Polynomial P, T;
-    poly_init(&P, -1);
-    poly_init(&T, -1);
-    while (--i >= 0) {
-        item = PyTuple_GET_ITEM(args, i);
-        if(!PyPolynomial_Check(item)) {
-            poly_free(&P);
-            poly_free(&T);
-            Py_RETURN_NOTIMPLEMENTED;
-        }
-        if (!poly_gcd(&P, &(((PyPoly_PolynomialObject*)item)->poly), &T)) goto memerror;
-        poly_free(&P);
-        if (!poly_copy(&T, &P)) goto memerror;
-        poly_free(&T);
+    n = PySlice_AdjustIndices(self->poly.deg + 1, &start, &stop, step);
+    if (!poly_slice(&(self->poly), (int)start, (int)step, (int)n, &P)) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyPolyOrFree(P)
+}
+
+/* Assignments of slices set the coefficients from a sequence or a buffer of
+ * numbers (see extract_complex_array) at once. With a positive step, the
+ * slice may go past the degree and a missing stop is deduced from the number
+ * of values: P[n:] = values sets the coefficients n, n + 1, ... */
+static int
+PyPoly_ass_subscript(PyPoly_PolynomialObject *self, PyObject *key, PyObject *v)
+{
+    Py_ssize_t start, stop, step, n, count;
+    Py_complex *values;
+    int res;
+    if (v == NULL) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Polynomial coefficients cannot be deleted");
+        return -1;
+    }
+    if (!PySlice_Check(key)) {
+        if ((n = PyNumber_AsSsize_t(key, PyExc_IndexError)) == -1 && PyErr_Occurred()) {
+            return -1;
+        }
+        if (n < 0 || n >= INT_MAX) {
+            PyErr_SetString(PyExc_IndexError, "Polynomial index out of range");
+            return -1;
+        }
+        return PyPoly_setitem(self, n, v);
+    }
+    if (PySlice_Unpack(key, &start, &stop, &step) < 0
+            || (values = extract_complex_array(v, &count)) == NULL) {
+        return -1;
+    }
+    if (step > 0) {
+        if (start < 0 && (start += self->poly.deg + 1) < 0) start = 0;
+        if (stop == PY_SSIZE_T_MAX) {
+            stop = start + count * step;
+        } else if (stop < 0 && (stop += self->poly.deg + 1) < 0) {
+            stop = 0;
+        }
+        n = (stop > start) ? (stop - start - 1) / step + 1 : 0;
+    } else {
+        n = PySlice_AdjustIndices(self->poly.deg + 1, &start, &stop, step);
+    }
+    if (n != count) {
+        PyErr_Format(PyExc_ValueError,
+                     "attempt to assign %zd coefficients to a slice of size %zd",
+                     count, n);
+        free(values);
+        return -1;
+    }
+    if (n > 0 && (start >= INT_MAX || start + (n - 1) * step >= INT_MAX)) {
+        PyErr_SetString(PyExc_IndexError, "Polynomial index out of range");
+        free(values);
+        return -1;
+    }
+    res = poly_set_slice(&(self->poly), (int)start, (int)step, values, (int)n);
+    free(values);
+    if (!res) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    Py_CLEAR(self->base);
+    return 0;
+}
+
+/* Module methods */
+
+static PyObject*
+PyPoly_allocated_bytes(PyObject *self)
+{
+    return PyLong_FromSize_t(poly_allocated_bytes());
+}
+
+static PyObject*
+PyPoly_gcd(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    int i = (int)nargs;
+    if (i < 2) {
+        PyErr_SetString(PyExc_TypeError,
+                        "'gcd' takes two or more polynomials as arguments");
+        return NULL;
+    }
+
+    PyObject* item;
+    Polynomial P, T;
+    poly_init(&P, -1);
+    poly_init(&T, -1);
+    while (--i >= 0) {
+        item = lazy_value(args[i]);
+        if (item == NULL || !PyPolynomial_Check(item)) {
+            poly_free(&P);
+            poly_free(&T);
+            if (item == NULL) return NULL;
+            Py_RETURN_NOTIMPLEMENTED;
+        }
+        if (!poly_gcd(&P, &(((PyPoly_PolynomialObject*)item)->poly), &T)) goto memerror;
+        poly_free(&P);
+        if (!poly_copy(&T, &P)) goto memerror;
+        poly_free(&T);
     }
     ReturnPyPolyOrFree(P)
 memerror:
@@ -533,30 +2003,3613 @@ memerror:
     poly_free(&T);
     return PyErr_NoMemory();
 }
+PYPOLY_FASTCALL_SHIM(PyPoly_gcd)
+
+/* A Python CompiledPolynomial Object, see PolyEvaluator */
+typedef struct {
+    PyObject_HEAD
+    PolyEvaluator eval;
+#ifdef PYPOLY_VECTORCALL
+    vectorcallfunc vectorcall;
+#endif
+} PyPoly_CompiledObject;
+
+static PyTypeObject PyPoly_CompiledType;
+
+/* Same as eval_number, for a CompiledPolynomial */
+static PyObject*
+eval_compiled_number(PolyEvaluator *E, PyObject *x)
+{
+    Py_complex c = {0., 0.};
+    if (PyFloat_CheckExact(x)) {
+        c.real = PyFloat_AS_DOUBLE(x);
+    } else if (PyLong_CheckExact(x)) {
+        c.real = PyLong_AsDouble(x);
+    } else {
+        c = PyComplex_AsCComplex(x);
+    }
+    if (c.real == -1. && PyErr_Occurred()) {
+        return NULL;
+    }
+    return number_from_complex(poly_evaluator_eval(E, c));
+}
+
+#ifdef PYPOLY_VECTORCALL
+static PyObject*
+PyCompiled_vectorcall(PyObject *self, PyObject *const *args, size_t nargsf, PyObject *kwnames)
+{
+    if (!check_call_args(nargsf, kwnames)) {
+        return NULL;
+    }
+    return eval_compiled_number(&(((PyPoly_CompiledObject*)self)->eval), args[0]);
+}
+#endif
+
+static PyObject*
+PyPoly_compile(PyPoly_PolynomialObject *self)
+{
+    PyPoly_CompiledObject *c;
+    c = (PyPoly_CompiledObject*)PyPoly_CompiledType.tp_alloc(&PyPoly_CompiledType, 0);
+    if (c == NULL) {
+        return NULL;
+    }
+#ifdef PYPOLY_VECTORCALL
+    c->vectorcall = PyCompiled_vectorcall;
+#endif
+    if (!poly_evaluator_init(&(self->poly), &(c->eval))) {
+        c->eval.re = NULL;
+        Py_DECREF(c);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)c;
+}
+
+static void
+PyCompiled_dealloc(PyPoly_CompiledObject *self)
+{
+    poly_evaluator_free(&(self->eval));
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject*
+PyCompiled_call(PyPoly_CompiledObject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *x;
+    if (!_PyArg_NoKeywords("__call__()", kwds) || !PyArg_UnpackTuple(args, "__call__", 1, 1, &x)) {
+        return NULL;
+    }
+    return eval_compiled_number(&(self->eval), x);
+}
+
+static PyObject*
+PyCompiled_eval_many(PyPoly_CompiledObject *self, PyObject *arg)
+{
+    Py_ssize_t n;
+    Py_complex *xs = extract_complex_array(arg, &n), *ys;
+    PyObject *list;
+    if (xs == NULL) {
+        return NULL;
+    }
+    if ((ys = malloc((n ? n : 1) * sizeof(Py_complex))) == NULL) {
+        free(xs);
+        return PyErr_NoMemory();
+    }
+    Py_BEGIN_ALLOW_THREADS
+    poly_evaluator_eval_many(&(self->eval), xs, ys, (int)n);
+    Py_END_ALLOW_THREADS
+    list = number_array_to_list(ys, (int)n);
+    free(xs);
+    free(ys);
+    return list;
+}
+
+static PyObject*
+PyCompiled_sizeof(PyPoly_CompiledObject *self)
+{
+    return PyLong_FromSize_t(Py_TYPE(self)->tp_basicsize + poly_evaluator_sizeof(&(self->eval)));
+}
+
+static PyMethodDef PyCompiled_methods[] = {
+    {"eval_many", (PyCFunction)PyCompiled_eval_many, METH_O,
+     "Evaluate the polynomial at each point of a sequence."},
+    {"__sizeof__", (PyCFunction)PyCompiled_sizeof, METH_NOARGS,
+     "Return the size of the CompiledPolynomial in memory, in bytes."},
+    {NULL, NULL, 0, NULL}        /* Sentinel */
+};
+
+static PyMemberDef PyCompiled_members[] = {
+    {"degree", T_INT, offsetof(PyPoly_CompiledObject, eval) + offsetof(PolyEvaluator, deg),
+     READONLY, "The degree of the compiled Polynomial."},
+    { NULL, 0, 0, 0, NULL }
+};
+
+static PyTypeObject PyPoly_CompiledType = {
+#if PY_MAJOR_VERSION >= 3
+    PyVarObject_HEAD_INIT(NULL, 0)
+#else
+    PyObject_HEAD_INIT(NULL)
+    0,
+#endif
+    "CompiledPolynomial",               /* tp_name */
+    sizeof(PyPoly_CompiledObject),      /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    (destructor)PyCompiled_dealloc,     /* tp_dealloc */
+    PYPOLY_VECTORCALL_OFFSET(PyPoly_CompiledObject), /* tp_vectorcall_offset */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_reserved */
+    0,                                  /* tp_repr */
+    0,                                  /* tp_as_number */
+    0,                                  /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash  */
+    (ternaryfunc)PyCompiled_call,       /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+    PYPOLY_VECTORCALL_FLAG
+    Py_TPFLAGS_DEFAULT,                 /* tp_flags */
+    "Polynomial prepared for fast repeated evaluations", /* tp_doc */
+    0,                                  /* tp_traverse */
+    0,                                  /* tp_clear */
+    0,                                  /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    PyCompiled_methods,                 /* tp_methods */
+    PyCompiled_members,                 /* tp_members */
+};
+
+static PyObject*
+PyPoly_sizeof(PyPoly_PolynomialObject *self)
+{
+    return PyLong_FromSize_t(Py_TYPE(self)->tp_basicsize + poly_sizeof(&(self->poly)));
+}
+
+static PyMethodDef PyPoly_methods[] = {
+    {"write", (PyCFunction)PyPoly_write, METH_O,
+     "Write the string representation of the Polynomial to a file object."},
+    {"shift", (PyCFunction)PyPoly_shift, METH_O,
+     "Return the Polynomial P(X + a)."},
+    {"compose", (PyCFunction)PyPoly_compose, METH_O,
+     "Return the composed Polynomial P(Q(X))."},
+    {"taylor", (PyCFunction)PyPoly_taylor, METH_VARARGS,
+     "Return the derivatives of orders 0 to k of the Polynomial at a point."},
+    {"taylor_many", (PyCFunction)PyPoly_taylor_many, METH_VARARGS,
+     "Return the derivatives of orders 0 to k of the Polynomial at each point of a sequence."},
+    {"resultant", (PyCFunction)PyPoly_resultant, METH_O,
+     "Return the resultant of two Polynomials."},
+    {"discriminant", (PyCFunction)PyPoly_discriminant, METH_NOARGS,
+     "Return the discriminant of the Polynomial."},
+    {"interpolate", (PyCFunction)PyPoly_interpolate, METH_VARARGS | METH_CLASS,
+     "Return the Polynomial of lowest degree taking the values ys at xs."},
+    {"roots", (PyCFunction)PyPoly_roots, METH_NOARGS,
+     "Return the list of the complex roots of the Polynomial."},
+    {"squarefree", (PyCFunction)PyPoly_squarefree, METH_VARARGS,
+     "Return the square-free factorization of the Polynomial, as (factor, multiplicity) pairs."},
+    {"eval_matrix", (PyCFunction)PyPoly_eval_matrix, METH_O,
+     "Return P(M) for a square matrix M given as a 2-D float64 or complex128 buffer, as a list of rows."},
+    {"compile", (PyCFunction)PyPoly_compile, METH_NOARGS,
+     "Return an evaluator of the Polynomial, prepared for repeated evaluations."},
+    {"__sizeof__", (PyCFunction)PyPoly_sizeof, METH_NOARGS,
+     "Size of the Polynomial in memory, coefficients included, in bytes."},
+    {NULL, NULL, 0, NULL}        /* Sentinel */
+};
+
+typedef struct {
+    Polynomial *polys;
+    Py_complex **roots;
+    int failed;
+} RootsBatch;
+
+static void
+roots_batch_task(void *ctx, int start, int end)
+{
+    RootsBatch *batch = ctx;
+    int i;
+    for (i = start; i < end; ++i) {
+        if (poly_roots(batch->polys + i, batch->roots[i], 0) != 1) {
+            batch->failed = 1;
+        }
+    }
+}
+
+static PyObject*
+PyPoly_roots_many(PyObject *self, PyObject *arg)
+{
+    PyObject *seq, *item, *list = NULL, *roots;
+    Py_ssize_t i, n;
+    RootsBatch batch = {NULL, NULL, 0};
+    if ((seq = PySequence_Fast(arg, "roots_many() expects a sequence of polynomials")) == NULL) {
+        return NULL;
+    }
+    n = PySequence_Fast_GET_SIZE(seq);
+    batch.polys = calloc(n ? n : 1, sizeof(Polynomial));
+    batch.roots = calloc(n ? n : 1, sizeof(Py_complex*));
+    if (batch.polys == NULL || batch.roots == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (i = 0; i < n; ++i) {
+        if ((item = lazy_value(PySequence_Fast_GET_ITEM(seq, i))) == NULL) {
+            goto done;
+        }
+        if (!PyPolynomial_Check(item)) {
+            PyErr_SetString(PyExc_TypeError,
+                            "roots_many() expects a sequence of polynomials");
+            goto done;
+        }
+        if (((PyPoly_PolynomialObject*)item)->poly.deg == -1) {
+            PyErr_SetString(PyExc_ValueError,
+                            "The roots of the zero Polynomial are undefined");
+            goto done;
+        }
+        if (!poly_copy(&(((PyPoly_PolynomialObject*)item)->poly), batch.polys + i)
+                ||
+            (batch.roots[i] = malloc((batch.polys[i].deg + 1) * sizeof(Py_complex))) == NULL) {
+            PyErr_NoMemory();
+            goto done;
+        }
+    }
+    Py_BEGIN_ALLOW_THREADS
+    poly_parallel_for(roots_batch_task, &batch, (int)n, 1);
+    Py_END_ALLOW_THREADS
+    if (batch.failed) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    if ((list = PyList_New(n)) == NULL) {
+        goto done;
+    }
+    for (i = 0; i < n; ++i) {
+        if ((roots = complex_array_to_list(batch.roots[i], batch.polys[i].deg)) == NULL) {
+            Py_CLEAR(list);
+            goto done;
+        }
+        PyList_SET_ITEM(list, i, roots);
+    }
+done:
+    for (i = 0; batch.polys != NULL && i < n; ++i) {
+        poly_free(batch.polys + i);
+        if (batch.roots != NULL) free(batch.roots[i]);
+    }
+    free(batch.polys);
+    free(batch.roots);
+    Py_DECREF(seq);
+    return list;
+}
+
+/* Orthogonal polynomials families.
+ * The rows computed for each family are kept up to ORTHOGONAL_CACHE_DEGREE,
+ * higher degrees continue the recurrence from the last cached rows. */
+#define ORTHOGONAL_CACHE_DEGREE 1024
+
+typedef struct {
+    Polynomial *rows;
+    int count;
+} OrthogonalCache;
+
+static OrthogonalCache orthogonal_caches[POLY_HERMITE + 1];
+
+static int
+orthogonal_cache_fill(OrthogonalFamily family, int n)
+{
+    OrthogonalCache *cache = orthogonal_caches + family;
+    if (cache->rows == NULL) {
+        cache->rows = malloc((ORTHOGONAL_CACHE_DEGREE + 1) * sizeof(Polynomial));
+        if (cache->rows == NULL) {
+            return 0;
+        }
+        if (!poly_init(cache->rows, 0) || !poly_init(cache->rows + 1, 1)) {
+            poly_free(cache->rows);
+            free(cache->rows);
+            cache->rows = NULL;
+            return 0;
+        }
+        poly_set_coef(cache->rows, 0, COne);
+        poly_set_coef(cache->rows + 1, 1, COne);
+        cache->count = 2;
+    }
+    for (; cache->count <= n; ++cache->count) {
+        if (!poly_orthogonal_next(family, cache->count - 1, cache->rows + cache->count - 2,
+                                  cache->rows + cache->count - 1,
+                                  cache->rows + cache->count)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static PyObject*
+new_poly_copy(Polynomial *A)
+{
+    Polynomial P;
+    if (!poly_copy(A, &P)) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyPolyOrFree(P)
+}
+
+/* Returns P_n, or the list [P_0, ..., P_n] if "upto" is set */
+static PyObject*
+orthogonal_family(OrthogonalFamily family, PyObject *arg, int upto)
+{
+    long n = PyLong_AsLong(arg);
+    int i, cached;
+    PyObject *list = NULL, *item = NULL;
+    Polynomial U, V, W;
+    if (n == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (n < 0 || n >= INT_MAX) {
+        PyErr_SetString(PyExc_ValueError,
+                        "The degree must be a non-negative integer");
+        return NULL;
+    }
+    cached = (n < ORTHOGONAL_CACHE_DEGREE) ? (int)n : ORTHOGONAL_CACHE_DEGREE;
+    if (!orthogonal_cache_fill(family, cached)) {
+        return PyErr_NoMemory();
+    }
+    if (upto && (list = PyList_New(n + 1)) == NULL) {
+        return NULL;
+    }
+    for (i = upto ? 0 : cached; i <= cached; ++i) {
+        if ((item = new_poly_copy(orthogonal_caches[family].rows + i)) == NULL) {
+            Py_XDECREF(list);
+            return NULL;
+        }
+        if (upto) PyList_SET_ITEM(list, i, item);
+    }
+    if (n == cached) {
+        return upto ? list : item;
+    }
+    if (!upto) Py_DECREF(item);
+    if (!poly_copy(orthogonal_caches[family].rows + cached - 1, &U)) {
+        Py_XDECREF(list);
+        return PyErr_NoMemory();
+    }
+    if (!poly_copy(orthogonal_caches[family].rows + cached, &V)) {
+        poly_free(&U);
+        Py_XDECREF(list);
+        return PyErr_NoMemory();
+    }
+    for (i = cached; i < n; ++i) {
+        if (!poly_orthogonal_next(family, i, &U, &V, &W)) {
+            poly_free(&U);
+            poly_free(&V);
+            Py_XDECREF(list);
+            return PyErr_NoMemory();
+        }
+        poly_free(&U);
+        U = V;
+        V = W;
+        if (upto) {
+            if ((item = new_poly_copy(&V)) == NULL) {
+                poly_free(&U);
+                poly_free(&V);
+                Py_DECREF(list);
+                return NULL;
+            }
+            PyList_SET_ITEM(list, i + 1, item);
+        }
+    }
+    poly_free(&U);
+    if (upto) {
+        poly_free(&V);
+        return list;
+    }
+    ReturnPyPolyOrFree(V)
+}
+
+static PyObject*
+PyPoly_chebyshev(PyObject *self, PyObject *arg)
+{
+    return orthogonal_family(POLY_CHEBYSHEV, arg, 0);
+}
+
+static PyObject*
+PyPoly_chebyshev_upto(PyObject *self, PyObject *arg)
+{
+    return orthogonal_family(POLY_CHEBYSHEV, arg, 1);
+}
+
+static PyObject*
+PyPoly_legendre(PyObject *self, PyObject *arg)
+{
+    return orthogonal_family(POLY_LEGENDRE, arg, 0);
+}
+
+static PyObject*
+PyPoly_legendre_upto(PyObject *self, PyObject *arg)
+{
+    return orthogonal_family(POLY_LEGENDRE, arg, 1);
+}
+
+static PyObject*
+PyPoly_hermite(PyObject *self, PyObject *arg)
+{
+    return orthogonal_family(POLY_HERMITE, arg, 0);
+}
+
+static PyObject*
+PyPoly_hermite_upto(PyObject *self, PyObject *arg)
+{
+    return orthogonal_family(POLY_HERMITE, arg, 1);
+}
+
+/* Cyclotomic polynomials are kept in a dictionary indexed by n, which is
+ * cleared when it grows above CYCLOTOMIC_CACHE_SIZE entries. */
+#define CYCLOTOMIC_CACHE_SIZE 4096
+
+static PyObject *cyclotomic_cache = NULL;
+
+static PyObject*
+PyPoly_cyclotomic(PyObject *self, PyObject *arg)
+{
+    long n = PyLong_AsLong(arg);
+    PyObject *cached;
+    Polynomial P;
+    int res;
+    if (n == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (n < 1 || n > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Cyclotomic Polynomials are defined for positive integers only");
+        return NULL;
+    }
+    if (cyclotomic_cache == NULL && (cyclotomic_cache = PyDict_New()) == NULL) {
+        return NULL;
+    }
+    if ((cached = PyDict_GetItem(cyclotomic_cache, arg)) != NULL) {
+        return new_poly_copy(&(((PyPoly_PolynomialObject*)cached)->poly));
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = poly_cyclotomic((int)n, &P);
+    Py_END_ALLOW_THREADS
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    if ((cached = (PyObject*)NewPoly(0, &P)) == NULL) {
+        poly_free(&P);
+        return NULL;
+    }
+    if (PyDict_Size(cyclotomic_cache) >= CYCLOTOMIC_CACHE_SIZE) {
+        PyDict_Clear(cyclotomic_cache);
+    }
+    PyObject *copy = NULL;
+    if (PyDict_SetItem(cyclotomic_cache, arg, cached) == 0) {
+        copy = new_poly_copy(&(((PyPoly_PolynomialObject*)cached)->poly));
+    }
+    Py_DECREF(cached);
+    return copy;
+}
+
+static PyMemberDef PyPoly_members[] = {
+    {"degree", T_INT, offsetof(PyPoly_PolynomialObject, poly) + offsetof(Polynomial, deg),
+     READONLY, "The degree of the Polynomial instance."},
+    { NULL, 0, 0, 0, NULL }
+};
+
+static PyNumberMethods PyPoly_NumberMethods = {
+    (binaryfunc)PyPoly_add,         /* nb_add */
+    (binaryfunc)PyPoly_sub,         /* nb_subtract */
+    (binaryfunc)PyPoly_mult,        /* nb_multiply */
+#if PY_MAJOR_VERSION < 3
+    (binaryfunc)PyPoly_div,         /* nb_divide; */
+#endif
+    (binaryfunc)PyPoly_remain,      /* nb_remainder */
+    (binaryfunc)PyPoly_divmod,      /* nb_divmod */
+    (ternaryfunc)PyPoly_pow,        /* nb_power */
+    (unaryfunc)PyPoly_neg,          /* nb_negative */
+    (unaryfunc)PyPoly_copy,         /* nb_positive */
+    0,                              /* nb_absolute */
+    0,                              /* nb_bool; */
+    0,                              /* nb_invert; */
+    (binaryfunc)PyPoly_integrate,   /* nb_lshift; */
+    (binaryfunc)PyPoly_derive,      /* nb_rshift; */
+    0,                              /* nb_and; */
+    0,                              /* nb_xor; */
+    0,                              /* nb_or; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_coerce; */
+#endif
+    0,                              /* nb_int; */
+    0,                              /* nb_reserved; */
+    0,                              /* nb_float; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_oct; */
+    0,                              /* nb_hex; */
+#endif
+    0,                              /* nb_inplace_add; */
+    0,                              /* nb_inplace_subtract; */
+    0,                              /* nb_inplace_multiply; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_inplace_divide; */
+#endif
+    0,                              /* nb_inplace_remainder; */
+    0,                              /* nb_inplace_power; */
+    0,                              /* nb_inplace_lshift; */
+    0,                              /* nb_inplace_rshift; */
+    0,                              /* nb_inplace_and; */
+    0,                              /* nb_inplace_xor; */
+    0,                              /* nb_inplace_or; */
+    (binaryfunc)PyPoly_floordiv,    /* nb_floor_divide; */
+    (binaryfunc)PyPoly_div,         /* nb_true_divide; */
+    0,                              /* nb_inplace_floor_divide; */
+    0,                              /* nb_inplace_true_divide; */
+    0                               /* nb_index; */
+};
+
+static PySequenceMethods PyPoly_as_sequence = {
+    0,                                  /* sq_length */
+    0,                                  /* sq_concat */
+    0,                                  /* sq_repeat */
+    (ssizeargfunc)PyPoly_getitem,       /* sq_item */
+    0,                                  /* sq_slice */
+    (ssizeobjargproc)PyPoly_setitem,    /* sq_ass_item */
+    0,                                  /* sq_ass_slice */
+    0,                                  /* sq_contains */
+    0,                                  /* sq_inplace_concat */
+    0                                   /* sq_inplace_repeat */
+};
+
+static PyMappingMethods PyPoly_as_mapping = {
+    0,                                      /* mp_length */
+    (binaryfunc)PyPoly_subscript,           /* mp_subscript */
+    (objobjargproc)PyPoly_ass_subscript     /* mp_ass_subscript */
+};
+
+static PyTypeObject PyPoly_PolynomialType = {
+#if PY_MAJOR_VERSION >= 3
+    PyVarObject_HEAD_INIT(NULL, 0)
+#else
+    PyObject_HEAD_INIT(NULL)
+    0,
+#endif
+    "Polynomial",                       /* tp_name */
+    sizeof(PyPoly_PolynomialObject),    /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    (destructor)PyPoly_dealloc,         /* tp_dealloc */
+    PYPOLY_VECTORCALL_OFFSET(PyPoly_PolynomialObject), /* tp_vectorcall_offset */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_reserved */
+    (reprfunc)PyPoly_repr,              /* tp_repr */
+    &PyPoly_NumberMethods,              /* tp_as_number */
+    &PyPoly_as_sequence,                /* tp_as_sequence */
+    &PyPoly_as_mapping,                 /* tp_as_mapping */
+    0,                                  /* tp_hash  */
+    (ternaryfunc)PyPoly_call,           /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+#if PY_MAJOR_VERSION < 3
+    Py_TPFLAGS_CHECKTYPES |
+    Py_TPFLAGS_HAVE_RICHCOMPARE |
+#endif
+    PYPOLY_VECTORCALL_FLAG
+    Py_TPFLAGS_DEFAULT,                 /* tp_flags */
+    "Polynomial objects",               /* tp_doc */
+    0,                                  /* tp_traverse */
+    0,                                  /* tp_clear */
+    (richcmpfunc)PyPoly_compare,        /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    PyPoly_methods,                     /* tp_methods */
+    PyPoly_members,                     /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    0,                                  /* tp_alloc */
+    (newfunc)PyPoly_new,                /* tp_new */
+};
+
+/**
+ * Lazy polynomials
+ * The nodes built in lazy mode (see "Lazy evaluation" above). Sums, products,
+ * powers and negations extend the graph while the mode is on, anything else
+ * is performed on the evaluated value.
+ */
+
+static PyObject*
+PyPoly_lazy(PyObject *self, PyObject *arg)
+{
+    int previous = lazy_mode, enabled = PyObject_IsTrue(arg);
+    if (enabled < 0) {
+        return NULL;
+    }
+    lazy_mode = enabled;
+    return PyBool_FromLong(previous);
+}
+
+static void
+PyLazy_dealloc(PyPoly_LazyObject *self)
+{
+    Py_XDECREF(self->a);
+    Py_XDECREF(self->b);
+    poly_free(&(self->pa));
+    poly_free(&(self->pb));
+    Py_XDECREF(self->value);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject*
+PyLazy_evaluate(PyObject *self)
+{
+    PyObject *value = lazy_value(self);
+    Py_XINCREF(value);
+    return value;
+}
+
+static PyObject*
+PyLazy_repr(PyObject *self)
+{
+    PyObject *value = lazy_value(self);
+    return (value == NULL) ? NULL : PyObject_Repr(value);
+}
+
+static PyObject*
+PyLazy_call(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *value = lazy_value(self);
+    return (value == NULL) ? NULL : PyObject_Call(value, args, kwds);
+}
+
+static PyObject*
+PyLazy_getitem(PyObject *self, Py_ssize_t i)
+{
+    PyObject *value = lazy_value(self);
+    return (value == NULL) ? NULL : PySequence_GetItem(value, i);
+}
+
+static PyObject*
+PyLazy_subscript(PyObject *self, PyObject *key)
+{
+    PyObject *value = lazy_value(self);
+    return (value == NULL) ? NULL : PyObject_GetItem(value, key);
+}
+
+/* Attributes and methods of Polynomial objects are those of the value */
+static PyObject*
+PyLazy_getattro(PyObject *self, PyObject *name)
+{
+    PyObject *value, *attr = PyObject_GenericGetAttr(self, name);
+    if (attr != NULL || !PyErr_ExceptionMatches(PyExc_AttributeError)) {
+        return attr;
+    }
+    PyErr_Clear();
+    if ((value = lazy_value(self)) == NULL) {
+        return NULL;
+    }
+    return PyObject_GetAttr(value, name);
+}
+
+#define LAZY_DELEGATE_BINARYFUNC(name, func)                                \
+static PyObject*                                                            \
+PyLazy_##name(PyObject *self, PyObject *other)                              \
+{                                                                           \
+    if ((self = lazy_value(self)) == NULL                                   \
+            || (other = lazy_value(other)) == NULL) {                       \
+        return NULL;                                                        \
+    }                                                                       \
+    return func(self, other);                                               \
+}
+
+LAZY_DELEGATE_BINARYFUNC(integrate, PyNumber_Lshift)
+LAZY_DELEGATE_BINARYFUNC(derive, PyNumber_Rshift)
+LAZY_DELEGATE_BINARYFUNC(true_divide, PyNumber_TrueDivide)
+
+static PyObject*
+PyLazy_div(PyObject *self, PyObject *other)
+{
+    if (lazy_mode) {
+        return PyPoly_div(self, other);
+    }
+    return PyLazy_true_divide(self, other);
+}
+
+static PyObject*
+PyLazy_pow(PyObject *self, PyObject *exponent, PyObject *mod)
+{
+    if (lazy_mode) {
+        return PyPoly_pow((PyPoly_PolynomialObject*)self, exponent, mod);
+    }
+    if ((self = lazy_value(self)) == NULL || (exponent = lazy_value(exponent)) == NULL) {
+        return NULL;
+    }
+    return PyNumber_Power(self, exponent, mod);
+}
+
+static PyObject*
+PyLazy_neg(PyObject *self)
+{
+    PyObject *value;
+    if (lazy_mode) {
+        return PyPoly_neg((PyPoly_PolynomialObject*)self);
+    }
+    return ((value = lazy_value(self)) == NULL) ? NULL : PyNumber_Negative(value);
+}
+
+static PyObject*
+PyLazy_pos(PyObject *self)
+{
+    PyObject *value = lazy_value(self);
+    return (value == NULL) ? NULL : PyNumber_Positive(value);
+}
+
+static PyMethodDef PyLazy_methods[] = {
+    {"evaluate", (PyCFunction)PyLazy_evaluate, METH_NOARGS,
+     "Return the value of the expression, as a Polynomial."},
+    {NULL, NULL, 0, NULL}        /* Sentinel */
+};
+
+static PyNumberMethods PyLazy_NumberMethods = {
+    (binaryfunc)PyPoly_add,         /* nb_add */
+    (binaryfunc)PyPoly_sub,         /* nb_subtract */
+    (binaryfunc)PyPoly_mult,        /* nb_multiply */
+#if PY_MAJOR_VERSION < 3
+    (binaryfunc)PyLazy_div,         /* nb_divide; */
+#endif
+    (binaryfunc)PyPoly_remain,      /* nb_remainder */
+    (binaryfunc)PyPoly_divmod,      /* nb_divmod */
+    (ternaryfunc)PyLazy_pow,        /* nb_power */
+    (unaryfunc)PyLazy_neg,          /* nb_negative */
+    (unaryfunc)PyLazy_pos,          /* nb_positive */
+    0,                              /* nb_absolute */
+    0,                              /* nb_bool; */
+    0,                              /* nb_invert; */
+    (binaryfunc)PyLazy_integrate,   /* nb_lshift; */
+    (binaryfunc)PyLazy_derive,      /* nb_rshift; */
+    0,                              /* nb_and; */
+    0,                              /* nb_xor; */
+    0,                              /* nb_or; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_coerce; */
+#endif
+    0,                              /* nb_int; */
+    0,                              /* nb_reserved; */
+    0,                              /* nb_float; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_oct; */
+    0,                              /* nb_hex; */
+#endif
+    0,                              /* nb_inplace_add; */
+    0,                              /* nb_inplace_subtract; */
+    0,                              /* nb_inplace_multiply; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_inplace_divide; */
+#endif
+    0,                              /* nb_inplace_remainder; */
+    0,                              /* nb_inplace_power; */
+    0,                              /* nb_inplace_lshift; */
+    0,                              /* nb_inplace_rshift; */
+    0,                              /* nb_inplace_and; */
+    0,                              /* nb_inplace_xor; */
+    0,                              /* nb_inplace_or; */
+    (binaryfunc)PyPoly_floordiv,    /* nb_floor_divide; */
+    (binaryfunc)PyLazy_div,         /* nb_true_divide; */
+};
+
+static PySequenceMethods PyLazy_as_sequence = {
+    0,                                  /* sq_length */
+    0,                                  /* sq_concat */
+    0,                                  /* sq_repeat */
+    (ssizeargfunc)PyLazy_getitem,       /* sq_item */
+};
+
+static PyMappingMethods PyLazy_as_mapping = {
+    0,                                  /* mp_length */
+    (binaryfunc)PyLazy_subscript,       /* mp_subscript */
+    0                                   /* mp_ass_subscript */
+};
+
+static PyTypeObject PyPoly_LazyType = {
+#if PY_MAJOR_VERSION >= 3
+    PyVarObject_HEAD_INIT(NULL, 0)
+#else
+    PyObject_HEAD_INIT(NULL)
+    0,
+#endif
+    "LazyPolynomial",                   /* tp_name */
+    sizeof(PyPoly_LazyObject),          /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    (destructor)PyLazy_dealloc,         /* tp_dealloc */
+    0,                                  /* tp_print */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_reserved */
+    (reprfunc)PyLazy_repr,              /* tp_repr */
+    &PyLazy_NumberMethods,              /* tp_as_number */
+    &PyLazy_as_sequence,                /* tp_as_sequence */
+    &PyLazy_as_mapping,                 /* tp_as_mapping */
+    0,                                  /* tp_hash  */
+    (ternaryfunc)PyLazy_call,           /* tp_call */
+    0,                                  /* tp_str */
+    (getattrofunc)PyLazy_getattro,      /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+#if PY_MAJOR_VERSION < 3
+    Py_TPFLAGS_CHECKTYPES |
+    Py_TPFLAGS_HAVE_RICHCOMPARE |
+#endif
+    Py_TPFLAGS_DEFAULT,                 /* tp_flags */
+    "Polynomial expressions built in lazy mode, evaluated on first use", /* tp_doc */
+    0,                                  /* tp_traverse */
+    0,                                  /* tp_clear */
+    (richcmpfunc)PyPoly_compare,        /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    PyLazy_methods,                     /* tp_methods */
+};
+
+/**
+ * Polynomial arrays
+ */
+
+/* A Python PolynomialArray Object. It is immutable, so that its rows can be
+ * shared by Polynomial views. */
+typedef struct {
+    PyObject_HEAD
+    PolyArray array;
+} PyPoly_ArrayObject;
+
+static PyTypeObject PyPoly_ArrayType;   // Forward declaration
+
+#define PyPolynomialArray_Check(op) PyObject_TypeCheck((op), &PyPoly_ArrayType)
+
+/* Same as NewPoly: transfers ownership of the coefficients pointer */
+static PyObject*
+new_array(PolyArray *A)
+{
+    PyPoly_ArrayObject *self;
+    self = (PyPoly_ArrayObject*)PyPoly_ArrayType.tp_alloc(&PyPoly_ArrayType, 0);
+    if (self == NULL) {
+        polyarray_free(A);
+        return NULL;
+    }
+    self->array = *A;
+    return (PyObject*)self;
+}
+
+/* Get a PolyArray out of "obj": PolynomialArray objects are borrowed, while
+ * Polynomials and numbers are copied into a new array of a single row, which
+ * the operators broadcast. */
+static ExtractionStatus
+extract_polyarray(PyObject *obj, PolyArray *A)
+{
+    Polynomial P;
+    int status;
+    if (PyPolynomialArray_Check(obj)) {
+        *A = ((PyPoly_ArrayObject*)obj)->array;
+        return EXTRACT_BORROWED;
+    }
+    ExtractOrBorrowPoly(obj, P, status)
+    if (PolyExtractionFailure(status)) {
+        return (ExtractionStatus)status;
+    }
+    if (polyarray_init(A, 1, P.deg) && P.deg >= 0) {
+        memcpy(A->coef, P.coef, (P.deg + 1) * sizeof(Complex));
+    }
+    if (status == EXTRACT_CREATED) poly_free(&P);
+    return (P.deg >= 0 && A->coef == NULL) ? EXTRACT_ERRMEM : EXTRACT_CREATED;
+}
+
+static PyObject*
+PyArray_new(PyTypeObject *subtype, PyObject *args, PyObject *kwds)
+{
+    PyObject *items, *seq, *item;
+    PolyArray A;
+    Polynomial *P;
+    Py_complex c;
+    Py_ssize_t i, n;
+    int deg = -1;
+    (void)subtype;
+    if (!_PyArg_NoKeywords("__new__()", kwds)
+            || !PyArg_UnpackTuple(args, "PolynomialArray", 1, 1, &items)) {
+        return NULL;
+    }
+    if ((seq = PySequence_Fast(items, "expected a sequence of polynomials")) == NULL) {
+        return NULL;
+    }
+    n = PySequence_Fast_GET_SIZE(seq);
+    for (i = 0; i < n; ++i) {
+        if ((item = lazy_value(PySequence_Fast_GET_ITEM(seq, i))) == NULL) {
+            Py_DECREF(seq);
+            return NULL;
+        }
+        if (PyPolynomial_Check(item)) {
+            P = &(((PyPoly_PolynomialObject*)item)->poly);
+            if (P->deg > deg) deg = P->deg;
+        } else if (extract_complex(item, &c) == EXTRACT_CREATED) {
+            if (deg < 0 && !complex_iszero(c)) deg = 0;
+        } else {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_TypeError, "expected a sequence of polynomials");
+            }
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    if (n > INT_MAX || !polyarray_init(&A, (int)n, deg)) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+    for (i = 0; i < n && deg >= 0; ++i) {
+        item = lazy_value(PySequence_Fast_GET_ITEM(seq, i));    // Already evaluated
+        if (PyPolynomial_Check(item)) {
+            P = &(((PyPoly_PolynomialObject*)item)->poly);
+            if (P->deg >= 0) {
+                memcpy(PolyArray_Row(&A, i), P->coef, (P->deg + 1) * sizeof(Complex));
+            }
+        } else {
+            extract_complex(item, PolyArray_Row(&A, i));
+        }
+    }
+    Py_DECREF(seq);
+    return new_array(&A);
+}
+
+static void
+PyArray_dealloc(PyPoly_ArrayObject *self)
+{
+    polyarray_free(&(self->array));
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static Py_ssize_t
+PyArray_length(PyPoly_ArrayObject *self)
+{
+    return self->array.count;
+}
+
+/* Rows are returned as Polynomial views on the array */
+static PyObject*
+PyArray_getitem(PyPoly_ArrayObject *self, Py_ssize_t i)
+{
+    PyPoly_PolynomialObject *view;
+    if (i < 0 || i >= self->array.count) {
+        PyErr_SetString(PyExc_IndexError, "PolynomialArray index out of range");
+        return NULL;
+    }
+    if ((view = NewPoly(-1, NULL)) == NULL) {
+        return NULL;
+    }
+    poly_view(&(view->poly), PolyArray_Row(&(self->array), i), self->array.deg);
+    Py_INCREF(self);
+    view->base = (PyObject*)self;
+    return (PyObject*)view;
+}
+
+static PyObject*
+PyArray_repr(PyPoly_ArrayObject *self)
+{
+    PyObject *list, *repr, *ret = NULL;
+    if ((list = PySequence_List((PyObject*)self)) == NULL) {
+        return NULL;
+    }
+    if ((repr = PyObject_Repr(list)) != NULL) {
+#if PY_MAJOR_VERSION >= 3
+        ret = PyUnicode_FromFormat("PolynomialArray(%U)", repr);
+#else
+        ret = PyString_FromFormat("PolynomialArray(%s)", PyString_AS_STRING(repr));
+#endif
+        Py_DECREF(repr);
+    }
+    Py_DECREF(list);
+    return ret;
+}
+
+/* Binary operators, with the same conventions as PYPOLY_BINARYFUNC_HEADER.
+ * Two arrays must have the same length. */
+static PyObject*
+array_binaryfunc(PyObject *self, PyObject *other,
+                 int (*op)(PolyArray*, PolyArray*, PolyArray*))
+{
+    PolyArray A, B, R;
+    ExtractionStatus A_status, B_status;
+    int res = 0;
+    A_status = extract_polyarray(self, &A);
+    B_status = PolyExtractionFailure(A_status) ? EXTRACT_ERR : extract_polyarray(other, &B);
+    if (PolyExtractionFailure(A_status) || PolyExtractionFailure(B_status)) {
+        if (A_status == EXTRACT_CREATED) polyarray_free(&A);
+        if (A_status == EXTRACT_ERRTYPE || B_status == EXTRACT_ERRTYPE) {
+            Py_RETURN_NOTIMPLEMENTED;
+        }
+        return (A_status == EXTRACT_ERR || B_status == EXTRACT_ERR) ? NULL : PyErr_NoMemory();
+    }
+    if (A_status == EXTRACT_BORROWED && B_status == EXTRACT_BORROWED && A.count != B.count) {
+        PyErr_SetString(PyExc_ValueError, "PolynomialArray operands must have the same length");
+    } else {
+        Py_BEGIN_ALLOW_THREADS
+        res = op(&A, &B, &R);
+        Py_END_ALLOW_THREADS
+        if (!res) PyErr_NoMemory();
+    }
+    if (A_status == EXTRACT_CREATED) polyarray_free(&A);
+    if (B_status == EXTRACT_CREATED) polyarray_free(&B);
+    return res ? new_array(&R) : NULL;
+}
+
+static PyObject*
+PyArray_add(PyObject *self, PyObject *other)
+{
+    return array_binaryfunc(self, other, polyarray_add);
+}
+
+static PyObject*
+PyArray_sub(PyObject *self, PyObject *other)
+{
+    return array_binaryfunc(self, other, polyarray_sub);
+}
+
+static PyObject*
+PyArray_mult(PyObject *self, PyObject *other)
+{
+    return array_binaryfunc(self, other, polyarray_multiply);
+}
+
+static PyObject*
+PyArray_neg(PyPoly_ArrayObject *self)
+{
+    PolyArray R;
+    if (!polyarray_neg(&(self->array), &R)) {
+        return PyErr_NoMemory();
+    }
+    return new_array(&R);
+}
+
+static PyObject*
+array_scale(PyObject *self, PyObject *other,
+            int (*op)(PolyArray*, unsigned int, PolyArray*))
+{
+    PolyArray R;
+    unsigned long steps;
+    int res;
+    if (!PyPolynomialArray_Check(self)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    steps = PyLong_AsUnsignedLong(other);
+    if (PyErr_Occurred()) {
+        PyErr_Clear();
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = op(&(((PyPoly_ArrayObject*)self)->array), steps, &R);
+    Py_END_ALLOW_THREADS
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    return new_array(&R);
+}
+
+static PyObject*
+PyArray_derive(PyObject *self, PyObject *other)
+{
+    return array_scale(self, other, polyarray_derive);
+}
+
+static PyObject*
+PyArray_integrate(PyObject *self, PyObject *other)
+{
+    return array_scale(self, other, polyarray_integrate);
+}
+
+/* Evaluate the rows at xs[i * step] */
+static PyObject*
+array_eval(PyPoly_ArrayObject *self, Py_complex *xs, int step)
+{
+    PyObject *list;
+    Py_complex *ys;
+    if ((ys = malloc((self->array.count ? self->array.count : 1) * sizeof(Py_complex))) == NULL) {
+        return PyErr_NoMemory();
+    }
+    Py_BEGIN_ALLOW_THREADS
+    polyarray_eval(&(self->array), xs, step, ys);
+    Py_END_ALLOW_THREADS
+    list = number_array_to_list(ys, self->array.count);
+    free(ys);
+    return list;
+}
+
+static PyObject*
+PyArray_call(PyPoly_ArrayObject *self, PyObject *args, PyObject *kwds)
+{
+    Py_complex x;
+    if (!_PyArg_NoKeywords("__call__()", kwds) || !PyArg_ParseTuple(args, "D", &x)) {
+        return NULL;
+    }
+    return array_eval(self, &x, 0);
+}
+
+static PyObject*
+PyArray_eval_points(PyPoly_ArrayObject *self, PyObject *arg)
+{
+    PyObject *list = NULL;
+    Py_ssize_t n;
+    Py_complex *xs = extract_complex_array(arg, &n);
+    if (xs == NULL) {
+        return NULL;
+    }
+    if (n != self->array.count) {
+        PyErr_SetString(PyExc_ValueError,
+                        "eval_points() expects one point per polynomial");
+    } else {
+        list = array_eval(self, xs, 1);
+    }
+    free(xs);
+    return list;
+}
+
+static PyObject*
+PyArray_sizeof(PyPoly_ArrayObject *self)
+{
+    return PyLong_FromSize_t(Py_TYPE(self)->tp_basicsize + self->array.size * sizeof(Py_complex));
+}
+
+static PyMethodDef PyArray_methods[] = {
+    {"eval_points", (PyCFunction)PyArray_eval_points, METH_O,
+     "Evaluate each polynomial at the corresponding point of a sequence."},
+    {"__sizeof__", (PyCFunction)PyArray_sizeof, METH_NOARGS,
+     "Size of the array in memory, coefficients included, in bytes."},
+    {NULL, NULL, 0, NULL}        /* Sentinel */
+};
+
+static PyMemberDef PyArray_members[] = {
+    {"degree", T_INT, offsetof(PyPoly_ArrayObject, array) + offsetof(PolyArray, deg),
+     READONLY, "The largest degree of the polynomials."},
+    { NULL, 0, 0, 0, NULL }
+};
+
+static PyNumberMethods PyArray_NumberMethods = {
+    (binaryfunc)PyArray_add,        /* nb_add */
+    (binaryfunc)PyArray_sub,        /* nb_subtract */
+    (binaryfunc)PyArray_mult,       /* nb_multiply */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_divide; */
+#endif
+    0,                              /* nb_remainder */
+    0,                              /* nb_divmod */
+    0,                              /* nb_power */
+    (unaryfunc)PyArray_neg,         /* nb_negative */
+    0,                              /* nb_positive */
+    0,                              /* nb_absolute */
+    0,                              /* nb_bool; */
+    0,                              /* nb_invert; */
+    (binaryfunc)PyArray_integrate,  /* nb_lshift; */
+    (binaryfunc)PyArray_derive,     /* nb_rshift; */
+};
+
+static PySequenceMethods PyArray_as_sequence = {
+    (lenfunc)PyArray_length,            /* sq_length */
+    0,                                  /* sq_concat */
+    0,                                  /* sq_repeat */
+    (ssizeargfunc)PyArray_getitem,      /* sq_item */
+};
+
+static PyTypeObject PyPoly_ArrayType = {
+#if PY_MAJOR_VERSION >= 3
+    PyVarObject_HEAD_INIT(NULL, 0)
+#else
+    PyObject_HEAD_INIT(NULL)
+    0,
+#endif
+    "PolynomialArray",                  /* tp_name */
+    sizeof(PyPoly_ArrayObject),         /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    (destructor)PyArray_dealloc,        /* tp_dealloc */
+    0,                                  /* tp_print */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_reserved */
+    (reprfunc)PyArray_repr,             /* tp_repr */
+    &PyArray_NumberMethods,             /* tp_as_number */
+    &PyArray_as_sequence,               /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash  */
+    (ternaryfunc)PyArray_call,          /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+#if PY_MAJOR_VERSION < 3
+    Py_TPFLAGS_CHECKTYPES |
+#endif
+    Py_TPFLAGS_DEFAULT,                 /* tp_flags */
+    "Arrays of polynomials, stored contiguously", /* tp_doc */
+    0,                                  /* tp_traverse */
+    0,                                  /* tp_clear */
+    0,                                  /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    PyArray_methods,                    /* tp_methods */
+    PyArray_members,                    /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    0,                                  /* tp_alloc */
+    (newfunc)PyArray_new,               /* tp_new */
+};
+
+/**
+ * Chebyshev series
+ */
+
+/* A Python ChebyshevSeries Object, sum(coef[k] * T_k) */
+typedef struct {
+    PyObject_HEAD
+    Polynomial series;
+} PyPoly_ChebyshevObject;
+
+static PyTypeObject PyPoly_ChebyshevType;   // Forward declaration
+
+#define PyChebyshev_Check(op) PyObject_TypeCheck((op), &PyPoly_ChebyshevType)
+
+/* Same as NewPoly: transfers ownership of the coefficients pointer */
+static PyObject*
+new_cheb_st(PyTypeObject *subtype, Polynomial *C)
+{
+    PyPoly_ChebyshevObject *self;
+    self = (PyPoly_ChebyshevObject*)subtype->tp_alloc(subtype, 0);
+    if (self != NULL) {
+        self->series = *C;
+    }
+    return (PyObject*)self;
+}
+#define ReturnPyChebOrFree(type, C)                 \
+PyObject *p;                                        \
+if ((p = new_cheb_st(type, &C)) == NULL) {          \
+    poly_free(&C);                                  \
+    return PyErr_NoMemory();                        \
+}                                                   \
+return p;
+
+static PyObject*
+PyCheb_new(PyTypeObject *subtype, PyObject *args, PyObject *kwds)
+{
+    if (!_PyArg_NoKeywords("__new__()", kwds)) {
+        return NULL;
+    }
+    Polynomial C;
+    int i, size = PyTuple_GET_SIZE(args);
+    if (!poly_init(&C, size - 1)) {
+        return PyErr_NoMemory();
+    }
+    for (i = 0; i < size; ++i) {
+        Py_complex c = PyComplex_AsCComplex(PyTuple_GET_ITEM(args, i));
+        if (c.real == -1.0 && PyErr_Occurred()) {
+            poly_free(&C);
+            return NULL;
+        }
+        poly_set_coef(&C, i, c);
+    }
+    ReturnPyChebOrFree(subtype, C)
+}
+
+static void
+PyCheb_dealloc(PyPoly_ChebyshevObject *self)
+{
+    poly_free(&(self->series));
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject*
+PyCheb_repr(PyPoly_ChebyshevObject *self)
+{
+    PyObject *list, *args, *sep, *ret = NULL;
+    if ((list = number_array_to_list(self->series.coef, self->series.deg + 1)) == NULL) {
+        return NULL;
+    }
+#if PY_VERSION_HEX >= 0x03030000
+    Py_ssize_t i;
+    for (i = 0; i < PyList_GET_SIZE(list); ++i) {
+        PyObject *r = PyObject_Repr(PyList_GET_ITEM(list, i));
+        if (r == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SetItem(list, i, r);
+    }
+    if ((sep = PyUnicode_FromString(", ")) != NULL) {
+        if ((args = PyUnicode_Join(sep, list)) != NULL) {
+            ret = PyUnicode_FromFormat("ChebyshevSeries(%U)", args);
+            Py_DECREF(args);
+        }
+        Py_DECREF(sep);
+    }
+#else
+    if ((args = PyList_AsTuple(list)) != NULL) {
+        if ((sep = PyObject_Repr(args)) != NULL) {
+            ret = PyString_FromFormat("ChebyshevSeries%s", PyString_AS_STRING(sep));
+            Py_DECREF(sep);
+        }
+        Py_DECREF(args);
+    }
+#endif
+    Py_DECREF(list);
+    return ret;
+}
+
+static PyObject*
+PyCheb_call(PyPoly_ChebyshevObject *self, PyObject *args, PyObject *kwds)
+{
+    Py_complex x;
+    if (!_PyArg_NoKeywords("__call__()", kwds) || !PyArg_ParseTuple(args, "D", &x)) {
+        return NULL;
+    }
+    return number_from_complex(cheb_eval(&(self->series), x));
+}
+
+static PyObject*
+PyCheb_eval_many(PyPoly_ChebyshevObject *self, PyObject *arg)
+{
+    Py_ssize_t n;
+    Py_complex *xs = extract_complex_array(arg, &n), *ys;
+    PyObject *list;
+    if (xs == NULL) {
+        return NULL;
+    }
+    if ((ys = malloc((n ? n : 1) * sizeof(Py_complex))) == NULL) {
+        free(xs);
+        return PyErr_NoMemory();
+    }
+    Py_BEGIN_ALLOW_THREADS
+    cheb_eval_many(&(self->series), xs, ys, (int)n);
+    Py_END_ALLOW_THREADS
+    list = number_array_to_list(ys, (int)n);
+    free(xs);
+    free(ys);
+    return list;
+}
+
+static PyObject*
+PyCheb_points(PyTypeObject *type, PyObject *arg)
+{
+    long i, n = PyLong_AsLong(arg);
+    PyObject *list, *item;
+    if (n == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (n < 0 || n > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "The number of points must be non-negative");
+        return NULL;
+    }
+    if ((list = PyList_New(n)) == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < n; ++i) {
+        if ((item = PyFloat_FromDouble(cos(Py_MATH_PI * (i + .5) / n))) == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+static PyObject*
+PyCheb_values(PyPoly_ChebyshevObject *self, PyObject *args)
+{
+    int i, res = 1, n = self->series.deg + 1;
+    Py_complex *ys;
+    PyObject *list;
+    if (!PyArg_ParseTuple(args, "|i", &n)) {
+        return NULL;
+    }
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "The number of points must be non-negative");
+        return NULL;
+    }
+    if ((ys = malloc((n ? n : 1) * sizeof(Py_complex))) == NULL) {
+        return PyErr_NoMemory();
+    }
+    Py_BEGIN_ALLOW_THREADS
+    if (n > self->series.deg) {
+        res = cheb_values(&(self->series), n, ys);
+    } else {    // Fewer points than coefficients, no aliasing in Clenshaw's algorithm
+        for (i = 0; i < n; ++i) {
+            ys[i] = (Py_complex){cos(Py_MATH_PI * (i + .5) / n), 0.};
+        }
+        cheb_eval_many(&(self->series), ys, ys, n);
+    }
+    Py_END_ALLOW_THREADS
+    list = res ? number_array_to_list(ys, n) : PyErr_NoMemory();
+    free(ys);
+    return list;
+}
+
+static PyObject*
+PyCheb_from_values(PyTypeObject *type, PyObject *arg)
+{
+    Py_ssize_t n;
+    Py_complex *ys = extract_complex_array(arg, &n);
+    Polynomial C;
+    int res;
+    if (ys == NULL) {
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = cheb_from_values(ys, (int)n, &C);
+    Py_END_ALLOW_THREADS
+    free(ys);
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyChebOrFree(type, C)
+}
+
+static PyObject*
+PyCheb_from_polynomial(PyTypeObject *type, PyObject *arg)
+{
+    Polynomial C;
+    int res;
+    if ((arg = lazy_value(arg)) == NULL) {
+        return NULL;
+    }
+    if (!PyPolynomial_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "from_polynomial() argument must be a Polynomial");
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = cheb_from_poly(&(((PyPoly_PolynomialObject*)arg)->poly), &C);
+    Py_END_ALLOW_THREADS
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyChebOrFree(type, C)
+}
+
+static PyObject*
+PyCheb_to_polynomial(PyPoly_ChebyshevObject *self)
+{
+    Polynomial P;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = cheb_to_poly(&(self->series), &P);
+    Py_END_ALLOW_THREADS
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyPolyOrFree(P)
+}
+
+static PyObject*
+PyCheb_from_legendre(PyTypeObject *type, PyObject *arg)
+{
+    Py_ssize_t n;
+    Py_complex *ls = extract_complex_array(arg, &n);
+    Polynomial C;
+    int res;
+    if (ls == NULL) {
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = cheb_from_legendre(ls, (int)n, &C);
+    Py_END_ALLOW_THREADS
+    free(ls);
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyChebOrFree(type, C)
+}
+
+static PyObject*
+PyCheb_to_legendre(PyPoly_ChebyshevObject *self)
+{
+    int res, n = self->series.deg + 1;
+    Py_complex *ls = malloc((n ? n : 1) * sizeof(Py_complex));
+    PyObject *list;
+    if (ls == NULL) {
+        return PyErr_NoMemory();
+    }
+    Py_BEGIN_ALLOW_THREADS
+    res = cheb_to_legendre(&(self->series), ls);
+    Py_END_ALLOW_THREADS
+    list = res ? number_array_to_list(ls, n) : PyErr_NoMemory();
+    free(ls);
+    return list;
+}
+
+static PyObject*
+PyCheb_getitem(PyPoly_ChebyshevObject *self, Py_ssize_t i)
+{
+    if (i < 0) {
+        PyErr_SetString(PyExc_IndexError, "ChebyshevSeries index out of range");
+        return NULL;
+    }
+    return number_from_complex(Poly_GetCoef(&(self->series), (i > INT_MAX) ? INT_MAX : i));
+}
+
+static PyObject*
+PyCheb_compare(PyObject *self, PyObject *other, int opid)
+{
+    if (opid != Py_EQ && opid != Py_NE) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Unsupported operation on Chebyshev series");
+        return NULL;
+    }
+    if (!PyChebyshev_Check(self) || !PyChebyshev_Check(other)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    int eq = poly_equal(&(((PyPoly_ChebyshevObject*)self)->series),
+                        &(((PyPoly_ChebyshevObject*)other)->series));
+    if (eq == (opid == Py_EQ)) {
+        Py_RETURN_TRUE;
+    } else {
+        Py_RETURN_FALSE;
+    }
+}
+
+static PyObject*
+PyCheb_sizeof(PyPoly_ChebyshevObject *self)
+{
+    return PyLong_FromSize_t(Py_TYPE(self)->tp_basicsize + poly_sizeof(&(self->series)));
+}
+
+static PyMethodDef PyCheb_methods[] = {
+    {"eval_many", (PyCFunction)PyCheb_eval_many, METH_O,
+     "Evaluate the series at each point of a sequence."},
+    {"values", (PyCFunction)PyCheb_values, METH_VARARGS,
+     "Return the values of the series at the n Chebyshev points."},
+    {"to_polynomial", (PyCFunction)PyCheb_to_polynomial, METH_NOARGS,
+     "Return the series as a Polynomial."},
+    {"__sizeof__", (PyCFunction)PyCheb_sizeof, METH_NOARGS,
+     "Size of the series in memory, coefficients included, in bytes."},
+    {"to_legendre", (PyCFunction)PyCheb_to_legendre, METH_NOARGS,
+     "Return the coefficients of the series in the Legendre basis."},
+    {"points", (PyCFunction)PyCheb_points, METH_O | METH_CLASS,
+     "Return the n Chebyshev points cos(pi (j + 1/2) / n)."},
+    {"from_values", (PyCFunction)PyCheb_from_values, METH_O | METH_CLASS,
+     "Return the series interpolating values given at the Chebyshev points."},
+    {"from_polynomial", (PyCFunction)PyCheb_from_polynomial, METH_O | METH_CLASS,
+     "Return the Chebyshev series of a Polynomial."},
+    {"from_legendre", (PyCFunction)PyCheb_from_legendre, METH_O | METH_CLASS,
+     "Return the Chebyshev series of a Legendre series."},
+    {NULL, NULL, 0, NULL}        /* Sentinel */
+};
+
+static PyMemberDef PyCheb_members[] = {
+    {"degree", T_INT, offsetof(PyPoly_ChebyshevObject, series) + offsetof(Polynomial, deg),
+     READONLY, "The degree of the series."},
+    { NULL, 0, 0, 0, NULL }
+};
+
+static PySequenceMethods PyCheb_as_sequence = {
+    0,                                  /* sq_length */
+    0,                                  /* sq_concat */
+    0,                                  /* sq_repeat */
+    (ssizeargfunc)PyCheb_getitem,       /* sq_item */
+    0,                                  /* sq_slice */
+    0,                                  /* sq_ass_item */
+    0,                                  /* sq_ass_slice */
+    0,                                  /* sq_contains */
+    0,                                  /* sq_inplace_concat */
+    0                                   /* sq_inplace_repeat */
+};
+
+static PyTypeObject PyPoly_ChebyshevType = {
+#if PY_MAJOR_VERSION >= 3
+    PyVarObject_HEAD_INIT(NULL, 0)
+#else
+    PyObject_HEAD_INIT(NULL)
+    0,
+#endif
+    "ChebyshevSeries",                  /* tp_name */
+    sizeof(PyPoly_ChebyshevObject),     /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    (destructor)PyCheb_dealloc,         /* tp_dealloc */
+    0,                                  /* tp_print */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_reserved */
+    (reprfunc)PyCheb_repr,              /* tp_repr */
+    0,                                  /* tp_as_number */
+    &PyCheb_as_sequence,                /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash  */
+    (ternaryfunc)PyCheb_call,           /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+#if PY_MAJOR_VERSION < 3
+    Py_TPFLAGS_HAVE_RICHCOMPARE |
+#endif
+    Py_TPFLAGS_DEFAULT,                 /* tp_flags */
+    "Chebyshev series sum(c[k] * T_k)", /* tp_doc */
+    0,                                  /* tp_traverse */
+    0,                                  /* tp_clear */
+    (richcmpfunc)PyCheb_compare,        /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    PyCheb_methods,                     /* tp_methods */
+    PyCheb_members,                     /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    0,                                  /* tp_alloc */
+    (newfunc)PyCheb_new,                /* tp_new */
+};
+
+/**
+ * Polynomials over Z/pZ
+ */
+
+/* A Python ModPolynomial Object */
+typedef struct {
+    PyObject_HEAD
+    ModPolynomial poly;
+} PyPoly_ModPolynomialObject;
+
+static PyTypeObject PyPoly_ModPolynomialType;   // Forward declaration
+
+#define PyModPolynomial_Check(op) PyObject_TypeCheck((op), &PyPoly_ModPolynomialType)
+
+/* Same as NewPoly: transfers ownership of the coefficients pointer */
+static PyObject*
+new_mpoly(ModPolynomial *P)
+{
+    PyPoly_ModPolynomialObject *self;
+    self = (PyPoly_ModPolynomialObject*)PyPoly_ModPolynomialType.tp_alloc(&PyPoly_ModPolynomialType, 0);
+    if (self != NULL) {
+        self->poly = *P;
+    }
+    return (PyObject*)self;
+}
+#define ReturnPyModPolyOrFree(P)                    \
+PyObject *p;                                        \
+if ((p = new_mpoly(&P)) == NULL) {                  \
+    mpoly_free(&P);                                 \
+    return PyErr_NoMemory();                        \
+}                                                   \
+return p;
+
+/* Reduce a Python integer modulo p, into Montgomery form */
+static ExtractionStatus
+extract_residue(PyObject *obj, const Modulus *m, uint64_t *dest)
+{
+    PyObject *n, *p, *r;
+    long long v;
+    int overflow;
+    if (!PyIndex_Check(obj) || PyModPolynomial_Check(obj)) {
+        return EXTRACT_ERRTYPE;
+    }
+    if ((n = PyNumber_Index(obj)) == NULL) {
+        return EXTRACT_ERR;
+    }
+    v = PyLong_AsLongLongAndOverflow(n, &overflow);
+    if (!overflow) {
+        Py_DECREF(n);
+        if (v == -1 && PyErr_Occurred()) {
+            return EXTRACT_ERR;
+        }
+        if (v >= 0) {
+            *dest = mod_from_uint(m, (uint64_t)v);
+        } else {    // Avoids overflowing on -v
+            *dest = mod_from_uint(m, m->p - 1 - (uint64_t)(-(v + 1)) % m->p);
+        }
+        return EXTRACT_CREATED;
+    }
+    if ((p = PyLong_FromUnsignedLongLong(m->p)) == NULL) {
+        Py_DECREF(n);
+        return EXTRACT_ERR;
+    }
+    r = PyNumber_Remainder(n, p);
+    Py_DECREF(n);
+    Py_DECREF(p);
+    if (r == NULL) {
+        return EXTRACT_ERR;
+    }
+    *dest = mod_from_uint(m, PyLong_AsUnsignedLongLong(r));
+    Py_DECREF(r);
+    return EXTRACT_CREATED;
+}
+
+static PyObject*
+residue_to_pylong(const Modulus *m, uint64_t x)
+{
+    return PyLong_FromUnsignedLongLong(mod_to_uint(m, x));
+}
+
+/* Borrow the ModPolynomial of "obj", or create a constant one over the
+ * same ring from an integer */
+static ExtractionStatus
+extract_mpoly(PyObject *obj, const Modulus *m, ModPolynomial *P)
+{
+    uint64_t c;
+    ExtractionStatus status;
+    if (PyModPolynomial_Check(obj)) {
+        *P = ((PyPoly_ModPolynomialObject*)obj)->poly;
+        return EXTRACT_BORROWED;
+    }
+    if ((status = extract_residue(obj, m, &c)) != EXTRACT_CREATED) {
+        return status;
+    }
+    if (!mpoly_init(P, m, (c == 0) ? -1 : 0)) {
+        return EXTRACT_ERRMEM;
+    }
+    if (c != 0) P->coef[0] = c;
+    return EXTRACT_CREATED;
+}
+
+/* Same as PYPOLY_BINARYFUNC_HEADER, both operands must share the modulus */
+#define PYPOLY_MOD_BINARYFUNC_HEADER                                    \
+    int A_status, B_status;                                             \
+    ModPolynomial A, B;                                                 \
+    const Modulus *mod = PyModPolynomial_Check(self)                    \
+        ? &(((PyPoly_ModPolynomialObject*)self)->poly.mod)              \
+        : &(((PyPoly_ModPolynomialObject*)other)->poly.mod);            \
+    A_status = extract_mpoly(self, mod, &A);                            \
+    B_status = extract_mpoly(other, mod, &B);                           \
+    if (PolyExtractionFailure(A_status)                                 \
+        ||                                                              \
+        PolyExtractionFailure(B_status)) {                              \
+        if (A_status == EXTRACT_CREATED) mpoly_free(&A);                \
+        if (B_status == EXTRACT_CREATED) mpoly_free(&B);                \
+        if (A_status == EXTRACT_ERRTYPE                                 \
+            ||                                                          \
+            B_status == EXTRACT_ERRTYPE) {                              \
+            Py_RETURN_NOTIMPLEMENTED;                                   \
+        } else if (A_status == EXTRACT_ERR || B_status == EXTRACT_ERR) { \
+            return NULL;                                                \
+        } else {                                                        \
+            return PyErr_NoMemory();                                    \
+        }                                                               \
+    }                                                                   \
+    if (A.mod.p != B.mod.p) {                                           \
+        PyErr_SetString(PyExc_ValueError,                               \
+                        "ModPolynomial operands have different moduli"); \
+        return NULL;                                                    \
+    }
+#define PYPOLY_MOD_BINARYFUNC_FOOTER                        \
+    if (A_status == EXTRACT_CREATED) mpoly_free(&A);        \
+    if (B_status == EXTRACT_CREATED) mpoly_free(&B);
+
+static PyObject*
+PyModPoly_new(PyTypeObject *subtype, PyObject *args, PyObject *kwds)
+{
+    if (!_PyArg_NoKeywords("__new__()", kwds)) {
+        return NULL;
+    }
+    int i, size = PyTuple_GET_SIZE(args);
+    unsigned long long p;
+    Modulus m;
+    ModPolynomial P;
+    if (size < 1) {
+        PyErr_SetString(PyExc_TypeError,
+                        "ModPolynomial() takes a modulus and the coefficients");
+        return NULL;
+    }
+    p = PyLong_AsUnsignedLongLong(PyTuple_GET_ITEM(args, 0));
+    if (p == (unsigned long long)-1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (!modulus_init(&m, p)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "The modulus must be an odd prime lower than 2**63");
+        return NULL;
+    }
+    if (!mpoly_init(&P, &m, size - 2)) {
+        return PyErr_NoMemory();
+    }
+    for (i = 1; i < size; ++i) {
+        if (extract_residue(PyTuple_GET_ITEM(args, i), &m, P.coef + i - 1) != EXTRACT_CREATED) {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_TypeError,
+                                "ModPolynomial coefficients must be integers");
+            }
+            mpoly_free(&P);
+            return NULL;
+        }
+    }
+    mpoly_normalize(&P);
+    PyPoly_ModPolynomialObject *self = (PyPoly_ModPolynomialObject*)subtype->tp_alloc(subtype, 0);
+    if (self == NULL) {
+        mpoly_free(&P);
+        return NULL;
+    }
+    self->poly = P;
+    return (PyObject*)self;
+}
+
+static void
+PyModPoly_dealloc(PyPoly_ModPolynomialObject *self)
+{
+    mpoly_free(&(self->poly));
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject*
+PyModPoly_repr(PyPoly_ModPolynomialObject *self)
+{
+    ModPolynomial *P = &(self->poly);
+    char *str, *s;
+    int i;
+    if ((str = malloc(((size_t)P->deg + 2) * 48 + 32)) == NULL) {
+        return PyErr_NoMemory();
+    }
+    s = str;
+    for (i = 0; i <= P->deg; ++i) {
+        unsigned long long c = mod_to_uint(&(P->mod), P->coef[i]);
+        if (c == 0) continue;
+        if (s != str) s += sprintf(s, " + ");
+        if (i == 0 || c != 1) s += sprintf(s, (i == 0) ? "%llu" : "%llu * ", c);
+        if (i == 1) s += sprintf(s, "X");
+        else if (i > 1) s += sprintf(s, "X**%d", i);
+    }
+    if (s == str) s += sprintf(s, "0");
+    sprintf(s, " (mod %llu)", (unsigned long long)P->mod.p);
+#if PY_VERSION_HEX >= 0x03030000
+    PyObject *ret = PyUnicode_FromString(str);
+#else
+    PyObject *ret = PyString_FromString(str);
+#endif
+    free(str);
+    return ret;
+}
+
+static PyObject*
+PyModPoly_add(PyObject *self, PyObject *other)
+{
+    PYPOLY_MOD_BINARYFUNC_HEADER
+    ModPolynomial R;
+    int res = mpoly_add(&A, &B, &R);
+    PYPOLY_MOD_BINARYFUNC_FOOTER
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyModPolyOrFree(R)
+}
+
+static PyObject*
+PyModPoly_sub(PyObject *self, PyObject *other)
+{
+    PYPOLY_MOD_BINARYFUNC_HEADER
+    ModPolynomial R;
+    int res = mpoly_sub(&A, &B, &R);
+    PYPOLY_MOD_BINARYFUNC_FOOTER
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyModPolyOrFree(R)
+}
+
+static PyObject*
+PyModPoly_mult(PyObject *self, PyObject *other)
+{
+    PYPOLY_MOD_BINARYFUNC_HEADER
+    ModPolynomial R;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = mpoly_multiply(&A, &B, &R);
+    Py_END_ALLOW_THREADS
+    PYPOLY_MOD_BINARYFUNC_FOOTER
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyModPolyOrFree(R)
+}
+
+static PyObject*
+PyModPoly_neg(PyPoly_ModPolynomialObject *self)
+{
+    ModPolynomial P;
+    if (!mpoly_neg(&(self->poly), &P)) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyModPolyOrFree(P)
+}
+
+static PyObject*
+PyModPoly_copy(PyPoly_ModPolynomialObject *self)
+{
+    Py_INCREF(self);    // ModPolynomial objects are immutable
+    return (PyObject*)self;
+}
+
+/* Euclidean division, the quotient or the remainder may be discarded */
+static PyObject*
+mpoly_divmod_objects(PyObject *self, PyObject *other, int want_q, int want_r)
+{
+    PYPOLY_MOD_BINARYFUNC_HEADER
+    ModPolynomial Q, R;
+    PyObject *q = NULL, *r = NULL, *t;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = mpoly_div(&A, &B, want_q ? &Q : NULL, &R);
+    Py_END_ALLOW_THREADS
+    PYPOLY_MOD_BINARYFUNC_FOOTER
+    if (res != 1) {
+        if (res == -1) {
+            PyErr_SetString(PyExc_ZeroDivisionError,
+                            "Polynomial Euclidean division by"
+                            " zero is undefined");
+            return NULL;
+        }
+        return PyErr_NoMemory();
+    }
+    if (want_q && (q = new_mpoly(&Q)) == NULL) {
+        mpoly_free(&Q);
+        mpoly_free(&R);
+        return NULL;
+    }
+    if (!want_r) {
+        mpoly_free(&R);
+        return q;
+    }
+    if ((r = new_mpoly(&R)) == NULL) {
+        mpoly_free(&R);
+        Py_XDECREF(q);
+        return NULL;
+    }
+    if (!want_q) {
+        return r;
+    }
+    if ((t = PyTuple_Pack(2, q, r)) == NULL) {
+        Py_DECREF(q);
+        Py_DECREF(r);
+        return NULL;
+    }
+    Py_DECREF(q);
+    Py_DECREF(r);
+    return t;
+}
+
+static PyObject*
+PyModPoly_divmod(PyObject *self, PyObject *other)
+{
+    return mpoly_divmod_objects(self, other, 1, 1);
+}
+
+static PyObject*
+PyModPoly_floordiv(PyObject *self, PyObject *other)
+{
+    return mpoly_divmod_objects(self, other, 1, 0);
+}
+
+static PyObject*
+PyModPoly_remain(PyObject *self, PyObject *other)
+{
+    return mpoly_divmod_objects(self, other, 0, 1);
+}
+
+/* Exact arithmetic makes high exponents meaningful, only the size of the
+ * result is limited */
+#define PYPOLY_MOD_MAX_DEGREE (1 << 28)
+
+static PyObject*
+PyModPoly_pow(PyPoly_ModPolynomialObject *self, PyObject *pyexp, PyObject *pymod)
+{
+    unsigned long exponent = PyLong_AsUnsignedLong(pyexp);
+    if (PyErr_Occurred()) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (self->poly.deg > 0 && exponent > PYPOLY_MOD_MAX_DEGREE / (unsigned long)self->poly.deg) {
+        return PyErr_Format(PyExc_ValueError,
+                            "ModPolynomial exponentiation with degrees higher"
+                            " than %d is not supported", PYPOLY_MOD_MAX_DEGREE);
+    }
+    ModPolynomial P;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = mpoly_pow(&(self->poly), exponent, &P);
+    Py_END_ALLOW_THREADS
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    mpoly_normalize(&P);
+    ReturnPyModPolyOrFree(P)
+}
+
+static PyObject*
+PyModPoly_compare(PyObject *self, PyObject *other, int opid)
+{
+    if (opid != Py_EQ && opid != Py_NE) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Unsupported operation on polynomials");
+        return NULL;
+    }
+    if (!PyModPolynomial_Check(self) || !PyModPolynomial_Check(other)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    int eq = mpoly_equal(&(((PyPoly_ModPolynomialObject*)self)->poly),
+                         &(((PyPoly_ModPolynomialObject*)other)->poly));
+    if (eq == (opid == Py_EQ)) {
+        Py_RETURN_TRUE;
+    } else {
+        Py_RETURN_FALSE;
+    }
+}
+
+static PyObject*
+PyModPoly_call(PyPoly_ModPolynomialObject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *x;
+    uint64_t r;
+    if (!_PyArg_NoKeywords("__call__()", kwds) || !PyArg_ParseTuple(args, "O", &x)) {
+        return NULL;
+    }
+    if (extract_residue(x, &(self->poly.mod), &r) != EXTRACT_CREATED) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "ModPolynomial can only be evaluated at integers");
+        }
+        return NULL;
+    }
+    return residue_to_pylong(&(self->poly.mod), mpoly_eval(&(self->poly), r));
+}
+
+static PyObject*
+PyModPoly_getitem(PyPoly_ModPolynomialObject *self, Py_ssize_t i)
+{
+    if (i < 0 || i > self->poly.deg) {
+        return PyLong_FromLong(0);
+    }
+    return residue_to_pylong(&(self->poly.mod), self->poly.coef[i]);
+}
+
+static PyObject*
+PyModPoly_gcd(PyPoly_ModPolynomialObject *self, PyObject *other)
+{
+    if (!PyModPolynomial_Check(other)) {
+        PyErr_SetString(PyExc_TypeError, "gcd() argument must be a ModPolynomial");
+        return NULL;
+    }
+    ModPolynomial *B = &(((PyPoly_ModPolynomialObject*)other)->poly), P;
+    if (self->poly.mod.p != B->mod.p) {
+        PyErr_SetString(PyExc_ValueError,
+                        "ModPolynomial operands have different moduli");
+        return NULL;
+    }
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = mpoly_gcd(&(self->poly), B, &P);
+    Py_END_ALLOW_THREADS
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyModPolyOrFree(P)
+}
+
+static PyObject*
+PyModPoly_resultant(PyPoly_ModPolynomialObject *self, PyObject *other)
+{
+    if (!PyModPolynomial_Check(other)) {
+        PyErr_SetString(PyExc_TypeError, "resultant() argument must be a ModPolynomial");
+        return NULL;
+    }
+    ModPolynomial *B = &(((PyPoly_ModPolynomialObject*)other)->poly);
+    if (self->poly.mod.p != B->mod.p) {
+        PyErr_SetString(PyExc_ValueError,
+                        "ModPolynomial operands have different moduli");
+        return NULL;
+    }
+    uint64_t r;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = mpoly_resultant(&(self->poly), B, &r);
+    Py_END_ALLOW_THREADS
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    return residue_to_pylong(&(self->poly.mod), r);
+}
+
+static PyObject*
+PyModPoly_discriminant(PyPoly_ModPolynomialObject *self)
+{
+    uint64_t d;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = mpoly_discriminant(&(self->poly), &d);
+    Py_END_ALLOW_THREADS
+    if (res == -1) {
+        PyErr_SetString(PyExc_ValueError,
+                        "The discriminant of a constant ModPolynomial is undefined");
+        return NULL;
+    }
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    return residue_to_pylong(&(self->poly.mod), d);
+}
+
+static PyObject*
+PyModPoly_get_modulus(PyPoly_ModPolynomialObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLongLong(self->poly.mod.p);
+}
+
+static PyObject*
+PyModPoly_sizeof(PyPoly_ModPolynomialObject *self)
+{
+    return PyLong_FromSize_t(Py_TYPE(self)->tp_basicsize + self->poly.size * sizeof(uint64_t));
+}
+
+static PyMethodDef PyModPoly_methods[] = {
+    {"gcd", (PyCFunction)PyModPoly_gcd, METH_O,
+     "Return the monic GCD of two ModPolynomial objects."},
+    {"resultant", (PyCFunction)PyModPoly_resultant, METH_O,
+     "Return the resultant of two ModPolynomial objects, as an integer."},
+    {"discriminant", (PyCFunction)PyModPoly_discriminant, METH_NOARGS,
+     "Return the discriminant of the ModPolynomial, as an integer."},
+    {"__sizeof__", (PyCFunction)PyModPoly_sizeof, METH_NOARGS,
+     "Return the size of the ModPolynomial in memory, in bytes."},
+    {NULL, NULL, 0, NULL}        /* Sentinel */
+};
+
+static PyMemberDef PyModPoly_members[] = {
+    {"degree", T_INT, offsetof(PyPoly_ModPolynomialObject, poly) + offsetof(ModPolynomial, deg),
+     READONLY, "The degree of the ModPolynomial instance."},
+    { NULL, 0, 0, 0, NULL }
+};
+
+static PyGetSetDef PyModPoly_getset[] = {
+    {"modulus", (getter)PyModPoly_get_modulus, NULL,
+     "The prime modulus of the coefficients.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyNumberMethods PyModPoly_NumberMethods = {
+    (binaryfunc)PyModPoly_add,      /* nb_add */
+    (binaryfunc)PyModPoly_sub,      /* nb_subtract */
+    (binaryfunc)PyModPoly_mult,     /* nb_multiply */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_divide; */
+#endif
+    (binaryfunc)PyModPoly_remain,   /* nb_remainder */
+    (binaryfunc)PyModPoly_divmod,   /* nb_divmod */
+    (ternaryfunc)PyModPoly_pow,     /* nb_power */
+    (unaryfunc)PyModPoly_neg,       /* nb_negative */
+    (unaryfunc)PyModPoly_copy,      /* nb_positive */
+    0,                              /* nb_absolute */
+    0,                              /* nb_bool; */
+    0,                              /* nb_invert; */
+    0,                              /* nb_lshift; */
+    0,                              /* nb_rshift; */
+    0,                              /* nb_and; */
+    0,                              /* nb_xor; */
+    0,                              /* nb_or; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_coerce; */
+#endif
+    0,                              /* nb_int; */
+    0,                              /* nb_reserved; */
+    0,                              /* nb_float; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_oct; */
+    0,                              /* nb_hex; */
+#endif
+    0,                              /* nb_inplace_add; */
+    0,                              /* nb_inplace_subtract; */
+    0,                              /* nb_inplace_multiply; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_inplace_divide; */
+#endif
+    0,                              /* nb_inplace_remainder; */
+    0,                              /* nb_inplace_power; */
+    0,                              /* nb_inplace_lshift; */
+    0,                              /* nb_inplace_rshift; */
+    0,                              /* nb_inplace_and; */
+    0,                              /* nb_inplace_xor; */
+    0,                              /* nb_inplace_or; */
+    (binaryfunc)PyModPoly_floordiv, /* nb_floor_divide; */
+    0,                              /* nb_true_divide; */
+    0,                              /* nb_inplace_floor_divide; */
+    0,                              /* nb_inplace_true_divide; */
+    0                               /* nb_index; */
+};
+
+static PySequenceMethods PyModPoly_as_sequence = {
+    0,                                  /* sq_length */
+    0,                                  /* sq_concat */
+    0,                                  /* sq_repeat */
+    (ssizeargfunc)PyModPoly_getitem,    /* sq_item */
+    0,                                  /* sq_slice */
+    0,                                  /* sq_ass_item */
+    0,                                  /* sq_ass_slice */
+    0,                                  /* sq_contains */
+    0,                                  /* sq_inplace_concat */
+    0                                   /* sq_inplace_repeat */
+};
+
+static PyTypeObject PyPoly_ModPolynomialType = {
+#if PY_MAJOR_VERSION >= 3
+    PyVarObject_HEAD_INIT(NULL, 0)
+#else
+    PyObject_HEAD_INIT(NULL)
+    0,
+#endif
+    "ModPolynomial",                    /* tp_name */
+    sizeof(PyPoly_ModPolynomialObject), /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    (destructor)PyModPoly_dealloc,      /* tp_dealloc */
+    0,                                  /* tp_print */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_reserved */
+    (reprfunc)PyModPoly_repr,           /* tp_repr */
+    &PyModPoly_NumberMethods,           /* tp_as_number */
+    &PyModPoly_as_sequence,             /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash  */
+    (ternaryfunc)PyModPoly_call,        /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+#if PY_MAJOR_VERSION < 3
+    Py_TPFLAGS_CHECKTYPES |
+    Py_TPFLAGS_HAVE_RICHCOMPARE |
+#endif
+    Py_TPFLAGS_DEFAULT,                 /* tp_flags */
+    "Polynomials with coefficients in Z/pZ", /* tp_doc */
+    0,                                  /* tp_traverse */
+    0,                                  /* tp_clear */
+    (richcmpfunc)PyModPoly_compare,     /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    PyModPoly_methods,                  /* tp_methods */
+    PyModPoly_members,                  /* tp_members */
+    PyModPoly_getset,                   /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    0,                                  /* tp_alloc */
+    (newfunc)PyModPoly_new,             /* tp_new */
+};
+
+/* Multi-modular reconstruction of the integer sum(d[i] * m[0]...m[i-1]),
+ * in the symmetric range (-M/2, M/2] where M = m[0]...m[k-1] */
+static PyObject*
+crt_to_pylong(const uint64_t *digits, PyObject **moduli, int k,
+              PyObject *M, PyObject *half)
+{
+    PyObject *x, *t, *d;
+    int i;
+    if ((x = PyLong_FromUnsignedLongLong(digits[k - 1])) == NULL) {
+        return NULL;
+    }
+    for (i = k - 2; i >= 0; --i) {
+        t = PyNumber_Multiply(x, moduli[i]);
+        Py_DECREF(x);
+        if (t == NULL || (d = PyLong_FromUnsignedLongLong(digits[i])) == NULL) {
+            Py_XDECREF(t);
+            return NULL;
+        }
+        x = PyNumber_Add(t, d);
+        Py_DECREF(t);
+        Py_DECREF(d);
+        if (x == NULL) {
+            return NULL;
+        }
+    }
+    if (PyObject_RichCompareBool(x, half, Py_GT) == 1) {
+        t = PyNumber_Subtract(x, M);
+        Py_DECREF(x);
+        x = t;
+    }
+    return x;
+}
+
+/* List of the n integer coefficients whose residues modulo the k distinct
+ * primes are given by the coefficients (Montgomery form) coefs[j] */
+static PyObject*
+crt_coefficients(const Modulus *moduli, int k, uint64_t **coefs, const int *degs, int n)
+{
+    PyObject *list = NULL, *M = NULL, *half = NULL, *one = NULL, *c, *pyp[NTT_PRIMES_COUNT];
+    uint64_t *inverses, residues[NTT_PRIMES_COUNT], digits[NTT_PRIMES_COUNT];
+    int i, j, nm = 0;
+    if ((inverses = malloc((size_t)k * k * sizeof(uint64_t))) == NULL) {
+        return PyErr_NoMemory();
+    }
+    if (!crt_inverses(moduli, k, inverses)) {
+        PyErr_SetString(PyExc_ValueError, "crt() expects distinct moduli");
+        goto done;
+    }
+    if ((one = PyLong_FromLong(1)) == NULL || (M = PyLong_FromLong(1)) == NULL) goto done;
+    for (nm = 0; nm < k; ++nm) {
+        if ((pyp[nm] = PyLong_FromUnsignedLongLong(moduli[nm].p)) == NULL) goto done;
+        if ((c = PyNumber_Multiply(M, pyp[nm])) == NULL) {
+            Py_DECREF(pyp[nm]);
+            goto done;
+        }
+        Py_DECREF(M);
+        M = c;
+    }
+    if ((half = PyNumber_Rshift(M, one)) == NULL) goto done;
+    if ((list = PyList_New(n)) == NULL) goto done;
+    for (i = 0; i < n; ++i) {
+        for (j = 0; j < k; ++j) {
+            residues[j] = (i <= degs[j]) ? mod_to_uint(moduli + j, coefs[j][i]) : 0;
+        }
+        crt_digits(moduli, k, inverses, residues, digits);
+        if ((c = crt_to_pylong(digits, pyp, k, M, half)) == NULL) {
+            Py_CLEAR(list);
+            goto done;
+        }
+        PyList_SET_ITEM(list, i, c);
+    }
+done:
+    while (--nm >= 0) Py_DECREF(pyp[nm]);
+    Py_XDECREF(one);
+    Py_XDECREF(M);
+    Py_XDECREF(half);
+    free(inverses);
+    return list;
+}
+
+static PyObject*
+PyPoly_crt(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    Modulus moduli[NTT_PRIMES_COUNT];
+    uint64_t *coefs[NTT_PRIMES_COUNT];
+    int i, degs[NTT_PRIMES_COUNT], n = 0, k = (int)nargs;
+    PyObject *item;
+    if (k < 1 || k > NTT_PRIMES_COUNT) {
+        return PyErr_Format(PyExc_TypeError,
+                            "'crt' takes from 1 to %d ModPolynomial arguments",
+                            NTT_PRIMES_COUNT);
+    }
+    for (i = 0; i < k; ++i) {
+        item = args[i];
+        if (!PyModPolynomial_Check(item)) {
+            PyErr_SetString(PyExc_TypeError, "crt() arguments must be ModPolynomial objects");
+            return NULL;
+        }
+        moduli[i] = ((PyPoly_ModPolynomialObject*)item)->poly.mod;
+        coefs[i] = ((PyPoly_ModPolynomialObject*)item)->poly.coef;
+        degs[i] = ((PyPoly_ModPolynomialObject*)item)->poly.deg;
+        if (degs[i] + 1 > n) n = degs[i] + 1;
+    }
+    return crt_coefficients(moduli, k, coefs, degs, n);
+}
+PYPOLY_FASTCALL_SHIM(PyPoly_crt)
+
+/* Number of bits of the largest absolute value of a sequence of integers */
+static int
+int_max_bits(PyObject *seq, size_t *bits)
+{
+    Py_ssize_t i;
+    PyObject *n, *nbits;
+    long long v;
+    int overflow;
+    size_t b;
+    *bits = 0;
+    for (i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i) {
+        if ((n = PyNumber_Index(PySequence_Fast_GET_ITEM(seq, i))) == NULL) {
+            return 0;
+        }
+        v = PyLong_AsLongLongAndOverflow(n, &overflow);
+        if (!overflow) {
+            unsigned long long u = (v < 0) ? -(unsigned long long)v : (unsigned long long)v;
+            for (b = 0; u; u >>= 1) ++b;
+        } else {
+            if ((nbits = PyObject_CallMethod(n, "bit_length", NULL)) == NULL) {
+                Py_DECREF(n);
+                return 0;
+            }
+            b = PyLong_AsSize_t(nbits);
+            Py_DECREF(nbits);
+        }
+        Py_DECREF(n);
+        if (b == (size_t)-1 && PyErr_Occurred()) {
+            return 0;
+        }
+        if (b > *bits) *bits = b;
+    }
+    return 1;
+}
+
+/* Reduce a sequence of integers modulo each of the k moduli */
+static int
+int_residues(PyObject *seq, const Modulus *moduli, int k, ModPolynomial *P)
+{
+    int i, t, n = (int)PySequence_Fast_GET_SIZE(seq);
+    for (t = 0; t < k; ++t) {
+        if (!mpoly_init(P + t, moduli + t, n - 1)) {
+            PyErr_NoMemory();
+            return 0;
+        }
+        for (i = 0; i < n; ++i) {
+            if (extract_residue(PySequence_Fast_GET_ITEM(seq, i), moduli + t,
+                                P[t].coef + i) != EXTRACT_CREATED) {
+                if (!PyErr_Occurred()) {
+                    PyErr_SetString(PyExc_TypeError, "expected a sequence of integers");
+                }
+                return 0;
+            }
+        }
+        mpoly_normalize(P + t);
+    }
+    return 1;
+}
+
+typedef struct {
+    ModPolynomial *A, *B, *R;
+    int failed;
+} MultiModBatch;
+
+static void
+multimod_batch_task(void *ctx, int start, int end)
+{
+    MultiModBatch *batch = ctx;
+    int t;
+    for (t = start; t < end; ++t) {
+        if (!mpoly_multiply(batch->A + t, batch->B + t, batch->R + t)) {
+            batch->failed = 1;
+        }
+    }
+}
+
+/* Each NTT prime brings a little less than 62 bits */
+#define NTT_PRIME_BITS 61
+
+static PyObject*
+PyPoly_int_multiply(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *a, *b, *sa = NULL, *sb = NULL, *list = NULL;
+    ModPolynomial A[NTT_PRIMES_COUNT], B[NTT_PRIMES_COUNT], R[NTT_PRIMES_COUNT];
+    Modulus moduli[NTT_PRIMES_COUNT];
+    uint64_t *coefs[NTT_PRIMES_COUNT];
+    int t, k = 0, degs[NTT_PRIMES_COUNT];
+    size_t abits, bbits, bits;
+    Py_ssize_t na, nb, n;
+    MultiModBatch batch = {A, B, R, 0};
+    if (nargs != 2) {
+        PyErr_Format(PyExc_TypeError,
+                     "int_multiply() takes exactly 2 arguments (%zd given)", nargs);
+        return NULL;
+    }
+    a = args[0];
+    b = args[1];
+    memset(A, 0, sizeof(A));
+    memset(B, 0, sizeof(B));
+    memset(R, 0, sizeof(R));
+    if ((sa = PySequence_Fast(a, "int_multiply() expects sequences of integers")) == NULL
+            ||
+        (sb = PySequence_Fast(b, "int_multiply() expects sequences of integers")) == NULL) {
+        goto done;
+    }
+    na = PySequence_Fast_GET_SIZE(sa);
+    nb = PySequence_Fast_GET_SIZE(sb);
+    if (na == 0 || nb == 0) {
+        list = PyList_New(0);
+        goto done;
+    }
+    if ((size_t)na + nb > INT_MAX / 2) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    if (!int_max_bits(sa, &abits) || !int_max_bits(sb, &bbits)) {
+        goto done;
+    }
+    /* |c| <= min(na, nb) * max|a| * max|b|, plus a sign bit */
+    for (bits = abits + bbits + 1, n = (na < nb) ? na : nb; n; n >>= 1) ++bits;
+    if (bits / NTT_PRIME_BITS + 1 > NTT_PRIMES_COUNT) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "int_multiply() coefficients are too large");
+        goto done;
+    }
+    k = (int)(bits / NTT_PRIME_BITS) + 1;
+    for (t = 0; t < k; ++t) {
+        modulus_init(moduli + t, ntt_primes[t]);
+    }
+    if (!int_residues(sa, moduli, k, A) || !int_residues(sb, moduli, k, B)) {
+        goto done;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    poly_parallel_for(multimod_batch_task, &batch, k, 1);
+    Py_END_ALLOW_THREADS
+    if (batch.failed) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (t = 0; t < k; ++t) {
+        coefs[t] = R[t].coef;
+        degs[t] = R[t].deg;
+    }
+    list = crt_coefficients(moduli, k, coefs, degs, (int)(na + nb - 1));
+done:
+    for (t = 0; t < NTT_PRIMES_COUNT; ++t) {
+        mpoly_free(A + t);
+        mpoly_free(B + t);
+        mpoly_free(R + t);
+    }
+    Py_XDECREF(sa);
+    Py_XDECREF(sb);
+    return list;
+}
+PYPOLY_FASTCALL_SHIM(PyPoly_int_multiply)
+
+/**
+ * Sparse multivariate polynomials
+ */
+
+/* A Python MultiPolynomial Object */
+typedef struct {
+    PyObject_HEAD
+    MVPolynomial poly;
+} PyPoly_MultiPolynomialObject;
+
+static PyTypeObject PyPoly_MultiPolynomialType;   // Forward declaration
+
+#define PyMultiPolynomial_Check(op) PyObject_TypeCheck((op), &PyPoly_MultiPolynomialType)
+
+/* Same as NewPoly: transfers ownership of the terms */
+static PyObject*
+new_mvpoly(MVPolynomial *P)
+{
+    PyPoly_MultiPolynomialObject *self;
+    self = (PyPoly_MultiPolynomialObject*)PyPoly_MultiPolynomialType.tp_alloc(&PyPoly_MultiPolynomialType, 0);
+    if (self != NULL) {
+        self->poly = *P;
+    }
+    return (PyObject*)self;
+}
+#define ReturnPyMultiPolyOrFree(P)                  \
+PyObject *p;                                        \
+if ((p = new_mvpoly(&P)) == NULL) {                 \
+    mvpoly_free(&P);                                \
+    return PyErr_NoMemory();                        \
+}                                                   \
+return p;
+
+/* Raise the exception matching a failure status of the mvpoly functions */
+static PyObject*
+mvpoly_error(int res, int nvars)
+{
+    if (res == -1) {
+        return PyErr_Format(PyExc_OverflowError,
+                            "MultiPolynomial exponents in %d variables are"
+                            " limited to %d", nvars, MVPOLY_MAX_EXP(nvars));
+    }
+    return PyErr_NoMemory();
+}
+
+/* Borrow the MultiPolynomial of "obj" if it has nvars variables, otherwise
+ * create it in nvars variables from a MultiPolynomial with less of them
+ * or from a number */
+static ExtractionStatus
+extract_mvpoly(PyObject *obj, int nvars, MVPolynomial *P)
+{
+    Py_complex c;
+    ExtractionStatus status;
+    int res, exps[MVPOLY_MAX_VARS] = {0};
+    if (PyMultiPolynomial_Check(obj)) {
+        MVPolynomial *A = &(((PyPoly_MultiPolynomialObject*)obj)->poly);
+        if (A->nvars == nvars) {
+            *P = *A;
+            return EXTRACT_BORROWED;
+        }
+        if ((res = mvpoly_extend(A, nvars, P)) != 1) {
+            mvpoly_error(res, nvars);
+            return EXTRACT_ERR;
+        }
+        return EXTRACT_CREATED;
+    }
+    if ((status = extract_complex(obj, &c)) != EXTRACT_CREATED) {
+        return status;
+    }
+    if (!mvpoly_from_terms(P, nvars, exps, &c, 1)) {
+        return EXTRACT_ERRMEM;
+    }
+    return EXTRACT_CREATED;
+}
+
+/* Same as PYPOLY_BINARYFUNC_HEADER, the operand with less variables is
+ * extended to the variables of the other one */
+#define PYPOLY_MULTI_BINARYFUNC_HEADER                                  \
+    int A_status, B_status, nvars = 1;                                  \
+    MVPolynomial A, B;                                                  \
+    if (PyMultiPolynomial_Check(self)) {                                \
+        nvars = ((PyPoly_MultiPolynomialObject*)self)->poly.nvars;      \
+    }                                                                   \
+    if (PyMultiPolynomial_Check(other)                                  \
+        && ((PyPoly_MultiPolynomialObject*)other)->poly.nvars > nvars) { \
+        nvars = ((PyPoly_MultiPolynomialObject*)other)->poly.nvars;     \
+    }                                                                   \
+    A_status = extract_mvpoly(self, nvars, &A);                         \
+    B_status = PolyExtractionFailure(A_status)                          \
+        ? EXTRACT_ERRTYPE : extract_mvpoly(other, nvars, &B);           \
+    if (PolyExtractionFailure(A_status)                                 \
+        ||                                                              \
+        PolyExtractionFailure(B_status)) {                              \
+        if (A_status == EXTRACT_CREATED) mvpoly_free(&A);               \
+        if (B_status == EXTRACT_CREATED) mvpoly_free(&B);               \
+        if (A_status == EXTRACT_ERR || B_status == EXTRACT_ERR) {       \
+            return NULL;                                                \
+        } else if (A_status == EXTRACT_ERRTYPE                          \
+                   ||                                                   \
+                   B_status == EXTRACT_ERRTYPE) {                       \
+            Py_RETURN_NOTIMPLEMENTED;                                   \
+        } else {                                                        \
+            return PyErr_NoMemory();                                    \
+        }                                                               \
+    }
+#define PYPOLY_MULTI_BINARYFUNC_FOOTER                      \
+    if (A_status == EXTRACT_CREATED) mvpoly_free(&A);       \
+    if (B_status == EXTRACT_CREATED) mvpoly_free(&B);
+
+/* Number of variables, between 1 and MVPOLY_MAX_VARS */
+static int
+parse_nvars(PyObject *obj, int *nvars)
+{
+    long n = PyLong_AsLong(obj);
+    if (n == -1 && PyErr_Occurred()) {
+        return 0;
+    }
+    if (n < 1 || n > MVPOLY_MAX_VARS) {
+        PyErr_Format(PyExc_ValueError,
+                     "MultiPolynomial supports from 1 to %d variables",
+                     MVPOLY_MAX_VARS);
+        return 0;
+    }
+    *nvars = (int)n;
+    return 1;
+}
+
+/* MultiPolynomial(nvars, terms) where terms maps the tuples of the nvars
+ * exponents of the monomials (or the exponent alone for nvars = 1) to their
+ * coefficients */
+static PyObject*
+PyMultiPoly_new(PyTypeObject *subtype, PyObject *args, PyObject *kwds)
+{
+    if (!_PyArg_NoKeywords("__new__()", kwds)) {
+        return NULL;
+    }
+    PyObject *pynvars, *pyterms = NULL, *items, *key, *seq;
+    Py_ssize_t i, n;
+    int v, nvars, res, *exps = NULL;
+    Py_complex *coefs = NULL;
+    MVPolynomial P;
+    if (!PyArg_UnpackTuple(args, "MultiPolynomial", 1, 2, &pynvars, &pyterms)
+            || !parse_nvars(pynvars, &nvars)) {
+        return NULL;
+    }
+    if (pyterms == NULL) {
+        items = PyList_New(0);
+    } else {
+        items = PyMapping_Items(pyterms);
+    }
+    if (items == NULL) {
+        return NULL;
+    }
+    n = PyList_GET_SIZE(items);
+    exps = malloc((n ? n : 1) * nvars * sizeof(int));
+    coefs = malloc((n ? n : 1) * sizeof(Py_complex));
+    if (exps == NULL || coefs == NULL) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    for (i = 0; i < n; ++i) {
+        key = PyTuple_GET_ITEM(PyList_GET_ITEM(items, i), 0);
+        if (nvars == 1 && PyIndex_Check(key)) {
+            seq = PyTuple_Pack(1, key);
+        } else {
+            seq = PySequence_Fast(key, "MultiPolynomial terms must be indexed"
+                                       " by tuples of exponents");
+        }
+        if (seq == NULL) {
+            goto error;
+        }
+        if (PySequence_Fast_GET_SIZE(seq) != nvars) {
+            Py_DECREF(seq);
+            PyErr_Format(PyExc_ValueError,
+                         "MultiPolynomial terms must have %d exponents", nvars);
+            goto error;
+        }
+        for (v = 0; v < nvars; ++v) {
+            long e = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, v));
+            if (e == -1 && PyErr_Occurred()) {
+                Py_DECREF(seq);
+                goto error;
+            }
+            exps[i * nvars + v] = (e < 0 || e > INT_MAX) ? -1 : (int)e;
+        }
+        Py_DECREF(seq);
+        if (extract_complex(PyTuple_GET_ITEM(PyList_GET_ITEM(items, i), 1),
+                            coefs + i) != EXTRACT_CREATED) {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_TypeError,
+                                "MultiPolynomial coefficients must be numbers");
+            }
+            goto error;
+        }
+    }
+    if ((res = mvpoly_from_terms(&P, nvars, exps, coefs, n)) != 1) {
+        if (res == -1) {
+            PyErr_Format(PyExc_ValueError,
+                         "MultiPolynomial exponents in %d variables must be"
+                         " between 0 and %d", nvars, MVPOLY_MAX_EXP(nvars));
+        } else {
+            PyErr_NoMemory();
+        }
+        goto error;
+    }
+    free(exps);
+    free(coefs);
+    Py_DECREF(items);
+    PyPoly_MultiPolynomialObject *self = (PyPoly_MultiPolynomialObject*)subtype->tp_alloc(subtype, 0);
+    if (self == NULL) {
+        mvpoly_free(&P);
+        return NULL;
+    }
+    self->poly = P;
+    return (PyObject*)self;
+error:
+    free(exps);
+    free(coefs);
+    Py_DECREF(items);
+    return NULL;
+}
+
+static void
+PyMultiPoly_dealloc(PyPoly_MultiPolynomialObject *self)
+{
+    mvpoly_free(&(self->poly));
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject*
+PyMultiPoly_repr(PyPoly_MultiPolynomialObject *self)
+{
+    char* str = mvpoly_to_string(&(self->poly));
+    PyObject* ret;
+    if (str == NULL) {
+        return PyErr_NoMemory();
+    }
+#if PY_VERSION_HEX >= 0x03030000
+    ret = PyUnicode_FromKindAndData(PyUnicode_1BYTE_KIND, str, strlen(str));
+#else
+    ret = PyUnicode_FromStringAndSize(str, strlen(str));
+#endif
+    free(str);
+    return ret;
+}
+
+static PyObject*
+PyMultiPoly_add(PyObject *self, PyObject *other)
+{
+    PYPOLY_MULTI_BINARYFUNC_HEADER
+    MVPolynomial R;
+    int res = mvpoly_add(&A, &B, &R);
+    PYPOLY_MULTI_BINARYFUNC_FOOTER
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyMultiPolyOrFree(R)
+}
+
+static PyObject*
+PyMultiPoly_sub(PyObject *self, PyObject *other)
+{
+    PYPOLY_MULTI_BINARYFUNC_HEADER
+    MVPolynomial R;
+    int res = mvpoly_sub(&A, &B, &R);
+    PYPOLY_MULTI_BINARYFUNC_FOOTER
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyMultiPolyOrFree(R)
+}
+
+static PyObject*
+PyMultiPoly_mult(PyObject *self, PyObject *other)
+{
+    PYPOLY_MULTI_BINARYFUNC_HEADER
+    MVPolynomial R;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = mvpoly_multiply(&A, &B, &R);
+    Py_END_ALLOW_THREADS
+    PYPOLY_MULTI_BINARYFUNC_FOOTER
+    if (res != 1) {
+        return mvpoly_error(res, nvars);
+    }
+    ReturnPyMultiPolyOrFree(R)
+}
+
+static PyObject*
+PyMultiPoly_pow(PyPoly_MultiPolynomialObject *self, PyObject *pyexp, PyObject *pymod)
+{
+    unsigned long exponent = PyLong_AsUnsignedLong(pyexp);
+    if (PyErr_Occurred()) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (exponent > UINT_MAX) {
+        return mvpoly_error(-1, self->poly.nvars);
+    }
+    MVPolynomial P;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = mvpoly_pow(&(self->poly), (unsigned int)exponent, &P);
+    Py_END_ALLOW_THREADS
+    if (res != 1) {
+        return mvpoly_error(res, self->poly.nvars);
+    }
+    ReturnPyMultiPolyOrFree(P)
+}
+
+static PyObject*
+PyMultiPoly_neg(PyPoly_MultiPolynomialObject *self)
+{
+    MVPolynomial P;
+    if (!mvpoly_neg(&(self->poly), &P)) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyMultiPolyOrFree(P)
+}
+
+static PyObject*
+PyMultiPoly_copy(PyPoly_MultiPolynomialObject *self)
+{
+    Py_INCREF(self);    // MultiPolynomial objects are immutable
+    return (PyObject*)self;
+}
+
+static int
+PyMultiPoly_bool(PyPoly_MultiPolynomialObject *self)
+{
+    return self->poly.len > 0;
+}
+
+static Py_ssize_t
+PyMultiPoly_len(PyPoly_MultiPolynomialObject *self)
+{
+    return (Py_ssize_t)self->poly.len;
+}
+
+static PyObject*
+PyMultiPoly_compare(PyObject *self, PyObject *other, int opid)
+{
+    if (opid != Py_EQ && opid != Py_NE) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Unsupported operation on polynomials");
+        return NULL;
+    }
+    PYPOLY_MULTI_BINARYFUNC_HEADER
+    int eq = mvpoly_equal(&A, &B);
+    PYPOLY_MULTI_BINARYFUNC_FOOTER
+    if (eq == (opid == Py_EQ)) {
+        Py_RETURN_TRUE;
+    } else {
+        Py_RETURN_FALSE;
+    }
+}
+
+/* P(x0, x1, ...), the values being given either as arguments or as a single
+ * sequence */
+static PyObject*
+PyMultiPoly_call(PyPoly_MultiPolynomialObject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *seq;
+    Py_complex xs[MVPOLY_MAX_VARS], y;
+    int v, res;
+    if (!_PyArg_NoKeywords("__call__()", kwds)) {
+        return NULL;
+    }
+    if (PyTuple_GET_SIZE(args) == 1 && self->poly.nvars > 1) {
+        seq = PySequence_Fast(PyTuple_GET_ITEM(args, 0),
+                              "MultiPolynomial expects the values of its variables");
+    } else {
+        seq = PySequence_Fast(args, "");
+    }
+    if (seq == NULL) {
+        return NULL;
+    }
+    if (PySequence_Fast_GET_SIZE(seq) != self->poly.nvars) {
+        Py_DECREF(seq);
+        return PyErr_Format(PyExc_TypeError,
+                            "MultiPolynomial expects the values of its %d variables",
+                            self->poly.nvars);
+    }
+    for (v = 0; v < self->poly.nvars; ++v) {
+        if (extract_complex(PySequence_Fast_GET_ITEM(seq, v), xs + v) != EXTRACT_CREATED) {
+            Py_DECREF(seq);
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_TypeError,
+                                "MultiPolynomial can only be evaluated at numbers");
+            }
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+    Py_BEGIN_ALLOW_THREADS
+    res = mvpoly_eval(&(self->poly), xs, &y);
+    Py_END_ALLOW_THREADS
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    return number_from_complex(y);
+}
+
+/* Tuple of the variables x0, ..., x{n - 1} */
+static PyObject*
+PyMultiPoly_variables(PyTypeObject *type, PyObject *arg)
+{
+    PyObject *tuple, *x;
+    MVPolynomial P;
+    int v, nvars, exps[MVPOLY_MAX_VARS] = {0};
+    if (!parse_nvars(arg, &nvars) || (tuple = PyTuple_New(nvars)) == NULL) {
+        return NULL;
+    }
+    for (v = 0; v < nvars; ++v) {
+        exps[v] = 1;
+        if (!mvpoly_from_terms(&P, nvars, exps, &COne, 1)) {
+            Py_DECREF(tuple);
+            return PyErr_NoMemory();
+        }
+        exps[v] = 0;
+        if ((x = new_mvpoly(&P)) == NULL) {
+            mvpoly_free(&P);
+            Py_DECREF(tuple);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(tuple, v, x);
+    }
+    return tuple;
+}
+
+/* The variable index "var" of a polynomial in nvars variables */
+static int
+check_var(int var, int nvars)
+{
+    if (var < 0 || var >= nvars) {
+        PyErr_Format(PyExc_ValueError,
+                     "The variables of the MultiPolynomial are x0 to x%d", nvars - 1);
+        return 0;
+    }
+    return 1;
+}
+
+static PyObject*
+PyMultiPoly_from_polynomial(PyTypeObject *type, PyObject *args)
+{
+    PyObject *obj, *pynvars = NULL;
+    Polynomial A;
+    MVPolynomial P;
+    ExtractionStatus status;
+    int res, nvars = 1, var = 0;
+    if (!PyArg_ParseTuple(args, "O|Oi:from_polynomial", &obj, &pynvars, &var)
+            || (pynvars != NULL && !parse_nvars(pynvars, &nvars))
+            || !check_var(var, nvars)) {
+        return NULL;
+    }
+    ExtractOrBorrowPoly(obj, A, status)
+    if (PolyExtractionFailure(status)) {
+        if (status == EXTRACT_ERRTYPE) {
+            PyErr_SetString(PyExc_TypeError,
+                            "from_polynomial() expects a Polynomial");
+            return NULL;
+        }
+        return PyErr_Occurred() ? NULL : PyErr_NoMemory();
+    }
+    res = mvpoly_from_poly(&A, nvars, var, &P);
+    if (status == EXTRACT_CREATED) poly_free(&A);
+    if (res != 1) {
+        return mvpoly_error(res, nvars);
+    }
+    ReturnPyMultiPolyOrFree(P)
+}
+
+static PyObject*
+PyMultiPoly_to_polynomial(PyPoly_MultiPolynomialObject *self, PyObject *args)
+{
+    Polynomial P;
+    int res, var = 0;
+    if (!PyArg_ParseTuple(args, "|i:to_polynomial", &var)
+            || !check_var(var, self->poly.nvars)) {
+        return NULL;
+    }
+    if ((res = mvpoly_to_poly(&(self->poly), var, &P)) != 1) {
+        if (res == -1) {
+            return PyErr_Format(PyExc_ValueError,
+                                "The MultiPolynomial depends on other variables"
+                                " than x%d", var);
+        }
+        return PyErr_NoMemory();
+    }
+    ReturnPyPolyOrFree(P)
+}
+
+static PyObject*
+PyMultiPoly_derive(PyPoly_MultiPolynomialObject *self, PyObject *args)
+{
+    MVPolynomial P;
+    int var, n = 1;
+    if (!PyArg_ParseTuple(args, "i|i:derive", &var, &n)
+            || !check_var(var, self->poly.nvars)) {
+        return NULL;
+    }
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "derive() order must be non-negative");
+        return NULL;
+    }
+    if (!mvpoly_derive(&(self->poly), var, (unsigned int)n, &P)) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyMultiPolyOrFree(P)
+}
+
+/* Dictionary of the terms, as taken by the constructor */
+static PyObject*
+PyMultiPoly_terms(PyPoly_MultiPolynomialObject *self)
+{
+    MVPolynomial *P = &(self->poly);
+    PyObject *dict, *key, *c;
+    int v, exps[MVPOLY_MAX_VARS];
+    size_t i;
+    if ((dict = PyDict_New()) == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < P->len; ++i) {
+        mvpoly_exponents(P, i, exps);
+        if ((key = PyTuple_New(P->nvars)) == NULL) {
+            Py_DECREF(dict);
+            return NULL;
+        }
+        for (v = 0; v < P->nvars; ++v) {
+            PyObject *e = PyLong_FromLong(exps[v]);
+            if (e == NULL) {
+                Py_DECREF(key);
+                Py_DECREF(dict);
+                return NULL;
+            }
+            PyTuple_SET_ITEM(key, v, e);
+        }
+        if ((c = number_from_complex(P->coef[i])) == NULL
+                || PyDict_SetItem(dict, key, c) < 0) {
+            Py_XDECREF(c);
+            Py_DECREF(key);
+            Py_DECREF(dict);
+            return NULL;
+        }
+        Py_DECREF(c);
+        Py_DECREF(key);
+    }
+    return dict;
+}
+
+static PyObject*
+PyMultiPoly_get_degree(PyPoly_MultiPolynomialObject *self, void *closure)
+{
+    return PyLong_FromLong(mvpoly_degree(&(self->poly)));
+}
+
+static PyObject*
+PyMultiPoly_sizeof(PyPoly_MultiPolynomialObject *self)
+{
+    return PyLong_FromSize_t(Py_TYPE(self)->tp_basicsize
+                             + self->poly.size * (sizeof(uint64_t) + sizeof(Complex)));
+}
+
+static PyMethodDef PyMultiPoly_methods[] = {
+    {"variables", (PyCFunction)PyMultiPoly_variables, METH_O | METH_CLASS,
+     "Return the tuple of the n variables x0, ..., x{n - 1}."},
+    {"from_polynomial", (PyCFunction)PyMultiPoly_from_polynomial, METH_VARARGS | METH_CLASS,
+     "Return the Polynomial P as a MultiPolynomial in nvars variables, P(x{var})."},
+    {"to_polynomial", (PyCFunction)PyMultiPoly_to_polynomial, METH_VARARGS,
+     "Return the MultiPolynomial as a Polynomial in the variable x{var}."},
+    {"derive", (PyCFunction)PyMultiPoly_derive, METH_VARARGS,
+     "Return the n-th partial derivative with respect to x{var}."},
+    {"terms", (PyCFunction)PyMultiPoly_terms, METH_NOARGS,
+     "Return the dictionary mapping the exponents of the monomials to their coefficients."},
+    {"__sizeof__", (PyCFunction)PyMultiPoly_sizeof, METH_NOARGS,
+     "Return the size of the MultiPolynomial in memory, in bytes."},
+    {NULL, NULL, 0, NULL}        /* Sentinel */
+};
+
+static PyMemberDef PyMultiPoly_members[] = {
+    {"nvars", T_INT, offsetof(PyPoly_MultiPolynomialObject, poly) + offsetof(MVPolynomial, nvars),
+     READONLY, "The number of variables of the MultiPolynomial instance."},
+    { NULL, 0, 0, 0, NULL }
+};
+
+static PyGetSetDef PyMultiPoly_getset[] = {
+    {"degree", (getter)PyMultiPoly_get_degree, NULL,
+     "The total degree of the MultiPolynomial instance.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyNumberMethods PyMultiPoly_NumberMethods = {
+    (binaryfunc)PyMultiPoly_add,    /* nb_add */
+    (binaryfunc)PyMultiPoly_sub,    /* nb_subtract */
+    (binaryfunc)PyMultiPoly_mult,   /* nb_multiply */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_divide; */
+#endif
+    0,                              /* nb_remainder */
+    0,                              /* nb_divmod */
+    (ternaryfunc)PyMultiPoly_pow,   /* nb_power */
+    (unaryfunc)PyMultiPoly_neg,     /* nb_negative */
+    (unaryfunc)PyMultiPoly_copy,    /* nb_positive */
+    0,                              /* nb_absolute */
+    (inquiry)PyMultiPoly_bool,      /* nb_bool; */
+    0,                              /* nb_invert; */
+    0,                              /* nb_lshift; */
+    0,                              /* nb_rshift; */
+    0,                              /* nb_and; */
+    0,                              /* nb_xor; */
+    0,                              /* nb_or; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_coerce; */
+#endif
+    0,                              /* nb_int; */
+    0,                              /* nb_reserved; */
+    0,                              /* nb_float; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_oct; */
+    0,                              /* nb_hex; */
+#endif
+    0,                              /* nb_inplace_add; */
+    0,                              /* nb_inplace_subtract; */
+    0,                              /* nb_inplace_multiply; */
+#if PY_MAJOR_VERSION < 3
+    0,                              /* nb_inplace_divide; */
+#endif
+    0,                              /* nb_inplace_remainder; */
+    0,                              /* nb_inplace_power; */
+    0,                              /* nb_inplace_lshift; */
+    0,                              /* nb_inplace_rshift; */
+    0,                              /* nb_inplace_and; */
+    0,                              /* nb_inplace_xor; */
+    0,                              /* nb_inplace_or; */
+    0,                              /* nb_floor_divide; */
+    0,                              /* nb_true_divide; */
+    0,                              /* nb_inplace_floor_divide; */
+    0,                              /* nb_inplace_true_divide; */
+    0                               /* nb_index; */
+};
+
+static PyMappingMethods PyMultiPoly_as_mapping = {
+    (lenfunc)PyMultiPoly_len,           /* mp_length */
+    0,                                  /* mp_subscript */
+    0,                                  /* mp_ass_subscript */
+};
+
+static PyTypeObject PyPoly_MultiPolynomialType = {
+#if PY_MAJOR_VERSION >= 3
+    PyVarObject_HEAD_INIT(NULL, 0)
+#else
+    PyObject_HEAD_INIT(NULL)
+    0,
+#endif
+    "MultiPolynomial",                  /* tp_name */
+    sizeof(PyPoly_MultiPolynomialObject), /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    (destructor)PyMultiPoly_dealloc,    /* tp_dealloc */
+    0,                                  /* tp_print */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_reserved */
+    (reprfunc)PyMultiPoly_repr,         /* tp_repr */
+    &PyMultiPoly_NumberMethods,         /* tp_as_number */
+    0,                                  /* tp_as_sequence */
+    &PyMultiPoly_as_mapping,            /* tp_as_mapping */
+    0,                                  /* tp_hash  */
+    (ternaryfunc)PyMultiPoly_call,      /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+#if PY_MAJOR_VERSION < 3
+    Py_TPFLAGS_CHECKTYPES |
+    Py_TPFLAGS_HAVE_RICHCOMPARE |
+#endif
+    Py_TPFLAGS_DEFAULT,                 /* tp_flags */
+    "Sparse polynomials in several variables", /* tp_doc */
+    0,                                  /* tp_traverse */
+    0,                                  /* tp_clear */
+    (richcmpfunc)PyMultiPoly_compare,   /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    PyMultiPoly_methods,                /* tp_methods */
+    PyMultiPoly_members,                /* tp_members */
+    PyMultiPoly_getset,                 /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    0,                                  /* tp_alloc */
+    (newfunc)PyMultiPoly_new,           /* tp_new */
+};
+
+/**
+ * Rational functions
+ * The operators do not reduce their results (see rational.h), equality
+ * checks and evaluations reduce the RationalFunction objects in place, which
+ * does not change their values.
+ */
+
+/* A Python RationalFunction Object */
+typedef struct {
+    PyObject_HEAD
+    RationalFunction f;
+} PyPoly_RationalFunctionObject;
+
+static PyTypeObject PyPoly_RationalType;   // Forward declaration
+
+#define PyRationalFunction_Check(op) PyObject_TypeCheck((op), &PyPoly_RationalType)
+
+/* Same as NewPoly: transfers ownership of the polynomials */
+static PyObject*
+new_ratfunc(RationalFunction *F)
+{
+    PyPoly_RationalFunctionObject *self;
+    self = (PyPoly_RationalFunctionObject*)PyPoly_RationalType.tp_alloc(&PyPoly_RationalType, 0);
+    if (self != NULL) {
+        self->f = *F;
+    }
+    return (PyObject*)self;
+}
+#define ReturnPyRationalOrFree(F)                   \
+PyObject *p;                                        \
+if ((p = new_ratfunc(&F)) == NULL) {                \
+    ratfunc_free(&F);                               \
+    return PyErr_NoMemory();                        \
+}                                                   \
+return p;
+
+/* Point "F" to the RationalFunction of "obj", or create P / 1 into "*F" from
+ * anything accepted as a Polynomial. Borrowed fractions are not copied, so
+ * that reducing them updates their object. */
+static ExtractionStatus
+extract_ratfunc(PyObject *obj, RationalFunction **F)
+{
+    Polynomial P, one;
+    ExtractionStatus status;
+    int res, failure = 0;
+    if (PyRationalFunction_Check(obj)) {
+        *F = &(((PyPoly_RationalFunctionObject*)obj)->f);
+        return EXTRACT_BORROWED;
+    }
+    ExtractOrBorrowPoly(obj, P, status)
+    if (PolyExtractionFailure(status)) {
+        return status;
+    }
+    Poly_InitConst(&one, COne, failure)
+    res = !failure && ratfunc_init(*F, &P, &one);
+    if (status == EXTRACT_CREATED) poly_free(&P);
+    if (!failure) poly_free(&one);
+    return res ? EXTRACT_CREATED : EXTRACT_ERRMEM;
+}
+
+/* Same as PYPOLY_BINARYFUNC_HEADER, with RationalFunction pointers A and B */
+#define PYPOLY_RATIONAL_BINARYFUNC_HEADER                               \
+    int A_status, B_status;                                             \
+    RationalFunction A_value, B_value, *A = &A_value, *B = &B_value;    \
+    A_status = extract_ratfunc(self, &A);                               \
+    B_status = extract_ratfunc(other, &B);                              \
+    if (PolyExtractionFailure(A_status)                                 \
+        ||                                                              \
+        PolyExtractionFailure(B_status)) {                              \
+        if (A_status == EXTRACT_CREATED) ratfunc_free(A);               \
+        if (B_status == EXTRACT_CREATED) ratfunc_free(B);               \
+        if (A_status == EXTRACT_ERRTYPE                                 \
+            ||                                                          \
+            B_status == EXTRACT_ERRTYPE) {                              \
+            Py_RETURN_NOTIMPLEMENTED;                                   \
+        } else if (PyErr_Occurred()) {                                  \
+            return NULL;                                                \
+        } else {                                                        \
+            return PyErr_NoMemory();                                    \
+        }                                                               \
+    }
+#define PYPOLY_RATIONAL_BINARYFUNC_FOOTER                   \
+    if (A_status == EXTRACT_CREATED) ratfunc_free(A);       \
+    if (B_status == EXTRACT_CREATED) ratfunc_free(B);
+
+static PyObject*
+PyRational_new(PyTypeObject *subtype, PyObject *args, PyObject *kwds)
+{
+    if (!_PyArg_NoKeywords("__new__()", kwds)) {
+        return NULL;
+    }
+    PyObject *pynum, *pyden = NULL;
+    RationalFunction N, D, *pN = &N, *pD = &D, F;
+    ExtractionStatus N_status, D_status = EXTRACT_CREATED;
+    int res;
+    if (!PyArg_UnpackTuple(args, "RationalFunction", 1, 2, &pynum, &pyden)) {
+        return NULL;
+    }
+    N_status = extract_ratfunc(pynum, &pN);
+    if (!PolyExtractionFailure(N_status) && pyden != NULL) {
+        D_status = extract_ratfunc(pyden, &pD);
+    }
+    if (PolyExtractionFailure(N_status) || PolyExtractionFailure(D_status)) {
+        if (N_status == EXTRACT_CREATED) ratfunc_free(pN);
+        if (N_status == EXTRACT_ERRTYPE || D_status == EXTRACT_ERRTYPE) {
+            PyErr_SetString(PyExc_TypeError,
+                            "RationalFunction() expects polynomials or numbers");
+            return NULL;
+        }
+        return PyErr_Occurred() ? NULL : PyErr_NoMemory();
+    }
+    if (pyden == NULL) {
+        res = (N_status == EXTRACT_CREATED) ? (F = N, 1) : ratfunc_copy(pN, &F);
+    } else {
+        res = ratfunc_divide(pN, pD, &F);
+        if (N_status == EXTRACT_CREATED) ratfunc_free(pN);
+        if (D_status == EXTRACT_CREATED) ratfunc_free(pD);
+    }
+    if (res != 1) {
+        if (res == -1) {
+            PyErr_SetString(PyExc_ZeroDivisionError,
+                            "RationalFunction denominator is zero");
+            return NULL;
+        }
+        return PyErr_NoMemory();
+    }
+    PyPoly_RationalFunctionObject *self = (PyPoly_RationalFunctionObject*)subtype->tp_alloc(subtype, 0);
+    if (self == NULL) {
+        ratfunc_free(&F);
+        return NULL;
+    }
+    self->f = F;
+    return (PyObject*)self;
+}
+
+static void
+PyRational_dealloc(PyPoly_RationalFunctionObject *self)
+{
+    ratfunc_free(&(self->f));
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject*
+PyRational_repr(PyPoly_RationalFunctionObject *self)
+{
+    char* str = ratfunc_to_string(&(self->f));
+    PyObject* ret;
+    if (str == NULL) {
+        return PyErr_NoMemory();
+    }
+#if PY_VERSION_HEX >= 0x03030000
+    ret = PyUnicode_FromKindAndData(PyUnicode_1BYTE_KIND, str, strlen(str));
+#else
+    ret = PyUnicode_FromStringAndSize(str, strlen(str));
+#endif
+    free(str);
+    return ret;
+}
+
+/* Binary operators: "op" is one of ratfunc_add, ratfunc_sub,
+ * ratfunc_multiply and ratfunc_divide */
+static PyObject*
+rational_binaryop(PyObject *self, PyObject *other,
+                  int (*op)(RationalFunction*, RationalFunction*, RationalFunction*))
+{
+    PYPOLY_RATIONAL_BINARYFUNC_HEADER
+    RationalFunction R;
+    int res = op(A, B, &R);
+    PYPOLY_RATIONAL_BINARYFUNC_FOOTER
+    if (res != 1) {
+        if (res == -1) {
+            PyErr_SetString(PyExc_ZeroDivisionError,
+                            "Cannot divide RationalFunction by zero");
+            return NULL;
+        }
+        return PyErr_NoMemory();
+    }
+    ReturnPyRationalOrFree(R)
+}
+
+static PyObject*
+PyRational_add(PyObject *self, PyObject *other)
+{
+    return rational_binaryop(self, other, ratfunc_add);
+}
+
+static PyObject*
+PyRational_sub(PyObject *self, PyObject *other)
+{
+    return rational_binaryop(self, other, ratfunc_sub);
+}
+
+static PyObject*
+PyRational_mult(PyObject *self, PyObject *other)
+{
+    return rational_binaryop(self, other, ratfunc_multiply);
+}
+
+static PyObject*
+PyRational_div(PyObject *self, PyObject *other)
+{
+    return rational_binaryop(self, other, ratfunc_divide);
+}
+
+static PyObject*
+PyRational_pow(PyPoly_RationalFunctionObject *self, PyObject *pyexp, PyObject *pymod)
+{
+    long exponent = PyLong_AsLong(pyexp);
+    if (PyErr_Occurred()) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (exponent > PYPOLY_MAX_EXPONENT || exponent < -PYPOLY_MAX_EXPONENT) {
+        return PyErr_Format(PyExc_ValueError,
+                            "RationalFunction exponentiation with exponents"
+                            " higher than %d is not supported", PYPOLY_MAX_EXPONENT);
+    }
+    RationalFunction F;
+    int res = ratfunc_pow(&(self->f), (int)exponent, &F);
+    if (res != 1) {
+        if (res == -1) {
+            PyErr_SetString(PyExc_ZeroDivisionError,
+                            "Cannot invert a zero RationalFunction");
+            return NULL;
+        }
+        return PyErr_NoMemory();
+    }
+    ReturnPyRationalOrFree(F)
+}
+
+static PyObject*
+PyRational_neg(PyPoly_RationalFunctionObject *self)
+{
+    RationalFunction F;
+    if (!ratfunc_neg(&(self->f), &F)) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyRationalOrFree(F)
+}
 
-static PyMemberDef PyPoly_members[] = {
-    {"degree", T_INT, offsetof(PyPoly_PolynomialObject, poly) + offsetof(Polynomial, deg),
-     READONLY, "The degree of the Polynomial instance."},
-    { NULL, 0, 0, 0, NULL }
+static PyObject*
+PyRational_copy(PyPoly_RationalFunctionObject *self)
+{
+    Py_INCREF(self);    // RationalFunction objects are immutable
+    return (PyObject*)self;
+}
+
+static int
+PyRational_bool(PyPoly_RationalFunctionObject *self)
+{
+    return self->f.num.deg != -1;
+}
+
+static PyObject*
+PyRational_compare(PyObject *self, PyObject *other, int opid)
+{
+    if (opid != Py_EQ && opid != Py_NE) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Unsupported operation on polynomials");
+        return NULL;
+    }
+    PYPOLY_RATIONAL_BINARYFUNC_HEADER
+    int eq, res = ratfunc_equal(A, B, &eq);
+    PYPOLY_RATIONAL_BINARYFUNC_FOOTER
+    if (!res) {
+        return PyErr_NoMemory();
+    }
+    if (eq == (opid == Py_EQ)) {
+        Py_RETURN_TRUE;
+    } else {
+        Py_RETURN_FALSE;
+    }
+}
+
+static PyObject*
+PyRational_call(PyPoly_RationalFunctionObject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *x;
+    Py_complex c, y;
+    int res;
+    if (!_PyArg_NoKeywords("__call__()", kwds) || !PyArg_ParseTuple(args, "O", &x)) {
+        return NULL;
+    }
+    if (extract_complex(x, &c) != EXTRACT_CREATED) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "RationalFunction can only be evaluated at numbers");
+        }
+        return NULL;
+    }
+    if ((res = ratfunc_eval(&(self->f), c, &y)) != 1) {
+        if (res == -1) {
+            PyErr_SetString(PyExc_ZeroDivisionError,
+                            "RationalFunction evaluated at a pole");
+            return NULL;
+        }
+        return PyErr_NoMemory();
+    }
+    return number_from_complex(y);
+}
+
+static PyObject*
+PyRational_reduce(PyPoly_RationalFunctionObject *self)
+{
+    if (!ratfunc_reduce(&(self->f))) {
+        return PyErr_NoMemory();
+    }
+    Py_INCREF(self);
+    return (PyObject*)self;
+}
+
+static PyObject*
+PyRational_get_numerator(PyPoly_RationalFunctionObject *self, void *closure)
+{
+    Polynomial P;
+    if (!poly_copy(&(self->f.num), &P)) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyPolyOrFree(P)
+}
+
+static PyObject*
+PyRational_get_denominator(PyPoly_RationalFunctionObject *self, void *closure)
+{
+    Polynomial P;
+    if (!poly_copy(&(self->f.den), &P)) {
+        return PyErr_NoMemory();
+    }
+    ReturnPyPolyOrFree(P)
+}
+
+static PyObject*
+PyRational_sizeof(PyPoly_RationalFunctionObject *self)
+{
+    return PyLong_FromSize_t(Py_TYPE(self)->tp_basicsize
+                             + poly_sizeof(&(self->f.num)) + poly_sizeof(&(self->f.den)));
+}
+
+static PyMethodDef PyRational_methods[] = {
+    {"reduce", (PyCFunction)PyRational_reduce, METH_NOARGS,
+     "Remove the common factors of the numerator and denominator, making the latter monic."},
+    {"__sizeof__", (PyCFunction)PyRational_sizeof, METH_NOARGS,
+     "Return the size of the RationalFunction in memory, in bytes."},
+    {NULL, NULL, 0, NULL}        /* Sentinel */
 };
 
-static PyNumberMethods PyPoly_NumberMethods = {
-    (binaryfunc)PyPoly_add,         /* nb_add */
-    (binaryfunc)PyPoly_sub,         /* nb_subtract */
-    (binaryfunc)PyPoly_mult,        /* nb_multiply */
+static PyGetSetDef PyRational_getset[] = {
+    {"numerator", (getter)PyRational_get_numerator, NULL,
+     "The numerator of the RationalFunction, as currently stored.", NULL},
+    {"denominator", (getter)PyRational_get_denominator, NULL,
+     "The denominator of the RationalFunction, as currently stored.", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyNumberMethods PyRational_NumberMethods = {
+    (binaryfunc)PyRational_add,     /* nb_add */
+    (binaryfunc)PyRational_sub,     /* nb_subtract */
+    (binaryfunc)PyRational_mult,    /* nb_multiply */
 #if PY_MAJOR_VERSION < 3
-    (binaryfunc)PyPoly_div,         /* nb_divide; */
+    (binaryfunc)PyRational_div,     /* nb_divide; */
 #endif
-    (binaryfunc)PyPoly_remain,      /* nb_remainder */
-    (binaryfunc)PyPoly_divmod,      /* nb_divmod */
-    (ternaryfunc)PyPoly_pow,        /* nb_power */
-    (unaryfunc)PyPoly_neg,          /* nb_negative */
-    (unaryfunc)PyPoly_copy,         /* nb_positive */
+    0,                              /* nb_remainder */
+    0,                              /* nb_divmod */
+    (ternaryfunc)PyRational_pow,    /* nb_power */
+    (unaryfunc)PyRational_neg,      /* nb_negative */
+    (unaryfunc)PyRational_copy,     /* nb_positive */
     0,                              /* nb_absolute */
-    0,                              /* nb_bool; */
+    (inquiry)PyRational_bool,       /* nb_bool; */
     0,                              /* nb_invert; */
-    (binaryfunc)PyPoly_integrate,   /* nb_lshift; */
-    (binaryfunc)PyPoly_derive,      /* nb_rshift; */
+    0,                              /* nb_lshift; */
+    0,                              /* nb_rshift; */
     0,                              /* nb_and; */
     0,                              /* nb_xor; */
     0,                              /* nb_or; */
@@ -583,47 +5636,34 @@ static PyNumberMethods PyPoly_NumberMethods = {
     0,                              /* nb_inplace_and; */
     0,                              /* nb_inplace_xor; */
     0,                              /* nb_inplace_or; */
-    (binaryfunc)PyPoly_floordiv,    /* nb_floor_divide; */
-    (binaryfunc)PyPoly_div,         /* nb_true_divide; */
+    0,                              /* nb_floor_divide; */
+    (binaryfunc)PyRational_div,     /* nb_true_divide; */
     0,                              /* nb_inplace_floor_divide; */
     0,                              /* nb_inplace_true_divide; */
     0                               /* nb_index; */
 };
 
-static PySequenceMethods PyPoly_as_sequence = {
-    0,                                  /* sq_length */
-    0,                                  /* sq_concat */
-    0,                                  /* sq_repeat */
-    (ssizeargfunc)PyPoly_getitem,       /* sq_item */
-    0,                                  /* sq_slice */
-    (ssizeobjargproc)PyPoly_setitem,    /* sq_ass_item */
-    0,                                  /* sq_ass_slice */
-    0,                                  /* sq_contains */
-    0,                                  /* sq_inplace_concat */
-    0                                   /* sq_inplace_repeat */
-};
-
-static PyTypeObject PyPoly_PolynomialType = {
+static PyTypeObject PyPoly_RationalType = {
 #if PY_MAJOR_VERSION >= 3
     PyVarObject_HEAD_INIT(NULL, 0)
 #else
     PyObject_HEAD_INIT(NULL)
     0,
 #endif
-    "Polynomial",                       /* tp_name */
-    sizeof(PyPoly_PolynomialObject),    /* tp_basicsize */
+    "RationalFunction",                 /* tp_name */
+    sizeof(PyPoly_RationalFunctionObject), /* tp_basicsize */
     0,                                  /* tp_itemsize */
-    (destructor)PyPoly_dealloc,         /* tp_dealloc */
+    (destructor)PyRational_dealloc,     /* tp_dealloc */
     0,                                  /* tp_print */
     0,                                  /* tp_getattr */
     0,                                  /* tp_setattr */
     0,                                  /* tp_reserved */
-    (reprfunc)PyPoly_repr,              /* tp_repr */
-    &PyPoly_NumberMethods,              /* tp_as_number */
-    &PyPoly_as_sequence,                /* tp_as_sequence */
+    (reprfunc)PyRational_repr,          /* tp_repr */
+    &PyRational_NumberMethods,          /* tp_as_number */
+    0,                                  /* tp_as_sequence */
     0,                                  /* tp_as_mapping */
     0,                                  /* tp_hash  */
-    (ternaryfunc)PyPoly_call,           /* tp_call */
+    (ternaryfunc)PyRational_call,       /* tp_call */
     0,                                  /* tp_str */
     0,                                  /* tp_getattro */
     0,                                  /* tp_setattro */
@@ -633,16 +5673,16 @@ static PyTypeObject PyPoly_PolynomialType = {
     Py_TPFLAGS_HAVE_RICHCOMPARE |
 #endif
     Py_TPFLAGS_DEFAULT,                 /* tp_flags */
-    "Polynomial objects",               /* tp_doc */
+    "Quotients of polynomials",         /* tp_doc */
     0,                                  /* tp_traverse */
     0,                                  /* tp_clear */
-    (richcmpfunc)PyPoly_compare,        /* tp_richcompare */
+    (richcmpfunc)PyRational_compare,    /* tp_richcompare */
     0,                                  /* tp_weaklistoffset */
     0,                                  /* tp_iter */
     0,                                  /* tp_iternext */
-    NULL,                               /* tp_methods */
-    PyPoly_members,                     /* tp_members */
-    0,                                  /* tp_getset */
+    PyRational_methods,                 /* tp_methods */
+    0,                                  /* tp_members */
+    PyRational_getset,                  /* tp_getset */
     0,                                  /* tp_base */
     0,                                  /* tp_dict */
     0,                                  /* tp_descr_get */
@@ -650,12 +5690,403 @@ static PyTypeObject PyPoly_PolynomialType = {
     0,                                  /* tp_dictoffset */
     0,                                  /* tp_init */
     0,                                  /* tp_alloc */
-    (newfunc)PyPoly_new,                /* tp_new */
+    (newfunc)PyRational_new,            /* tp_new */
+};
+
+/**
+ * Background jobs
+ * submit(op, *args) runs one of the operations below on the worker pool of
+ * parallel.h, without the GIL, and returns a concurrent.futures.Future (which
+ * asyncio code awaits through asyncio.wrap_future). The future is only
+ * marked as running once the result is ready: cancel() thus succeeds until
+ * then, raising the cancellation flag polled by the long kernels.
+ */
+typedef enum {
+    JOB_MULTIPLY,
+    JOB_DIVMOD,
+    JOB_POW,
+    JOB_GCD,
+    JOB_EVAL_MANY,
+    JOB_COUNT
+} JobOp;
+
+static const char *const job_names[JOB_COUNT] = {
+    "multiply", "divmod", "pow", "gcd", "eval_many"
 };
 
+typedef struct {
+    JobOp op;
+    Polynomial *polys;          // Operands
+    int count;
+    unsigned long exponent;
+    Py_complex *xs, *ys;
+    Py_ssize_t n;
+    Polynomial Q, R;            // Results
+    int status;
+    volatile int *cancelled;
+    PyObject *future, *flag;    // flag is the capsule owning *cancelled
+} PolyJob;
+
+static PyObject *future_type = NULL;    // concurrent.futures.Future
+
+static void
+job_free(PolyJob *J)
+{
+    int i;
+    for (i = 0; i < J->count; ++i) {
+        poly_free(J->polys + i);
+    }
+    poly_free(&(J->Q));
+    poly_free(&(J->R));
+    free(J->polys);
+    free(J->xs);
+    free(J->ys);
+    Py_XDECREF(J->future);
+    Py_XDECREF(J->flag);
+    free(J);
+}
+
+/* Runs without the GIL */
+static int
+job_compute(PolyJob *J)
+{
+    Polynomial *P = J->polys, T;
+    PolyEvaluator E;
+    int i, res = 1;
+    switch (J->op) {
+    case JOB_MULTIPLY:
+        return poly_multiply(P, P + 1, &(J->R));
+    case JOB_DIVMOD:
+        return poly_div(P, P + 1, &(J->Q), &(J->R));
+    case JOB_POW:
+        return poly_pow(P, (unsigned int)J->exponent, &(J->R));
+    case JOB_GCD:
+        for (i = J->count - 1; i >= 0 && res; --i) {
+            res = poly_gcd(&(J->R), P + i, &T);
+            poly_free(&(J->R));
+            J->R = T;
+        }
+        return res;
+    case JOB_EVAL_MANY:
+        if ((J->ys = malloc((J->n ? J->n : 1) * sizeof(Py_complex))) == NULL
+                || !poly_evaluator_init(P, &E)) {
+            return 0;
+        }
+        poly_evaluator_eval_many(&E, J->xs, J->ys, (int)J->n);
+        poly_evaluator_free(&E);
+        return !poly_cancelled();
+    default:
+        return 0;
+    }
+}
+
+/* Python result of a successful job, taking the result Polynomials over */
+static PyObject*
+job_result(PolyJob *J)
+{
+    PyObject *q, *r;
+    if (J->status == -1) {
+        PyErr_SetString(PyExc_ZeroDivisionError,
+                        "Polynomial Euclidean division by zero is undefined");
+        return NULL;
+    }
+    if (J->status != 1) {
+        return PyErr_NoMemory();
+    }
+    if (J->op == JOB_EVAL_MANY) {
+        return number_array_to_list(J->ys, (int)J->n);
+    }
+    if ((r = (PyObject*)NewPoly(0, &(J->R))) == NULL) {
+        return NULL;
+    }
+    poly_init(&(J->R), -1);
+    if (J->op != JOB_DIVMOD) {
+        return r;
+    }
+    if ((q = (PyObject*)NewPoly(0, &(J->Q))) == NULL) {
+        Py_DECREF(r);
+        return NULL;
+    }
+    poly_init(&(J->Q), -1);
+    return Py_BuildValue("(NN)", q, r);
+}
+
+static void
+job_resolve(PolyJob *J)
+{
+    PyObject *running, *result, *ret = NULL, *type, *value, *tb;
+    if ((running = PyObject_CallMethod(J->future, "set_running_or_notify_cancel", NULL)) == NULL) {
+        PyErr_WriteUnraisable(J->future);
+        return;
+    }
+    if (running == Py_True) {
+        if ((result = job_result(J)) != NULL) {
+            ret = PyObject_CallMethod(J->future, "set_result", "(O)", result);
+            Py_DECREF(result);
+        } else {
+            PyErr_Fetch(&type, &value, &tb);
+            PyErr_NormalizeException(&type, &value, &tb);
+            ret = PyObject_CallMethod(J->future, "set_exception", "(O)", value);
+            Py_XDECREF(type);
+            Py_XDECREF(value);
+            Py_XDECREF(tb);
+        }
+        if (ret == NULL) {
+            PyErr_WriteUnraisable(J->future);
+        }
+        Py_XDECREF(ret);
+    }
+    Py_DECREF(running);
+}
+
+static void
+job_run(void *ctx)
+{
+    PolyJob *J = ctx;
+    PyGILState_STATE gil;
+    J->status = *(J->cancelled) ? 0 : job_compute(J);
+    if (Py_IsFinalizing()) {
+        /* Too late to take the GIL: the job and its future are leaked */
+        return;
+    }
+    gil = PyGILState_Ensure();
+    job_resolve(J);
+    job_free(J);
+    PyGILState_Release(gil);
+}
+
+/* Done callback of the futures, bound to the flag of their job */
+static PyObject*
+job_done(PyObject *flag, PyObject *future)
+{
+    int *cancelled = PyCapsule_GetPointer(flag, NULL);
+    PyObject *ret;
+    if (cancelled == NULL || (ret = PyObject_CallMethod(future, "cancelled", NULL)) == NULL) {
+        return NULL;
+    }
+    if (ret == Py_True) {
+        *cancelled = 1;
+    }
+    Py_DECREF(ret);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef job_done_def = {"_job_done", job_done, METH_O, NULL};
+
+/* Exit handler completing the pending jobs, whose workers need the GIL */
+static PyObject*
+job_shutdown(PyObject *self, PyObject *unused)
+{
+    Py_BEGIN_ALLOW_THREADS
+    poly_pool_shutdown();
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef job_shutdown_def = {"_job_shutdown", job_shutdown, METH_NOARGS, NULL};
+
+static int
+job_register_shutdown(void)
+{
+    PyObject *atexit, *func, *ret = NULL;
+    if ((atexit = PyImport_ImportModule("atexit")) == NULL) {
+        return 0;
+    }
+    if ((func = PyCFunction_New(&job_shutdown_def, NULL)) != NULL) {
+        ret = PyObject_CallMethod(atexit, "register", "(O)", func);
+        Py_DECREF(func);
+    }
+    Py_DECREF(atexit);
+    Py_XDECREF(ret);
+    return ret != NULL;
+}
+
+static void
+job_flag_free(PyObject *capsule)
+{
+    free(PyCapsule_GetPointer(capsule, NULL));
+}
+
+/* Operand of a job: borrowed Polynomials are copied, which only shares
+ * their coefficients, since their owner may be modified meanwhile */
+static int
+job_extract_poly(PyObject *obj, Polynomial *P)
+{
+    ExtractionStatus status;
+    Polynomial T;
+    ExtractOrBorrowPoly(obj, T, status)
+    if (PolyExtractionFailure(status)) {
+        if (status == EXTRACT_ERRTYPE) {
+            PyErr_SetString(PyExc_TypeError,
+                            "submit() operands must be Polynomials or numbers");
+        } else if (!PyErr_Occurred()) {
+            PyErr_NoMemory();
+        }
+        return 0;
+    }
+    if (status == EXTRACT_CREATED) {
+        *P = T;
+        return 1;
+    }
+    if (!poly_copy(&T, P)) {
+        PyErr_NoMemory();
+        return 0;
+    }
+    return 1;
+}
+
+/* Check the arguments of the operation and convert them into J */
+static int
+job_parse_args(PolyJob *J, PyObject *const *args, Py_ssize_t nargs)
+{
+    int i, npolys = (int)nargs;
+    if (J->op == JOB_GCD ? nargs < 2 : nargs != 2) {
+        PyErr_Format(PyExc_TypeError, "submit('%s') takes %s2 arguments",
+                     job_names[J->op], (J->op == JOB_GCD) ? "at least " : "");
+        return 0;
+    }
+    if (J->op == JOB_POW || J->op == JOB_EVAL_MANY) {
+        npolys = 1;
+    }
+    if (J->op == JOB_POW) {
+        J->exponent = PyLong_AsUnsignedLong(args[1]);
+        if (PyErr_Occurred()) {
+            return 0;
+        }
+        if (J->exponent > PYPOLY_MAX_EXPONENT) {
+            PyErr_Format(PyExc_ValueError,
+                         "Polynomial exponentiation with exponents higher"
+                         " than %d is not supported", PYPOLY_MAX_EXPONENT);
+            return 0;
+        }
+    } else if (J->op == JOB_EVAL_MANY) {
+        if ((J->xs = extract_complex_array(args[1], &(J->n))) == NULL) {
+            return 0;
+        }
+        if (J->n > INT_MAX) {
+            PyErr_SetString(PyExc_OverflowError, "too many points");
+            return 0;
+        }
+    }
+    if ((J->polys = malloc(npolys * sizeof(Polynomial))) == NULL) {
+        PyErr_NoMemory();
+        return 0;
+    }
+    for (i = 0; i < npolys; ++i) {
+        if (!job_extract_poly(args[i], J->polys + i)) {
+            return 0;
+        }
+        J->count = i + 1;
+    }
+    return 1;
+}
+
+static PyObject*
+PyPoly_submit(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PolyJob *J;
+    PyObject *module, *callback, *ret;
+    const char *name;
+    int op, status;
+    if (nargs < 1 || !PyArg_Parse(args[0], "s", &name)) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError, "submit() expects an operation name");
+        return NULL;
+    }
+    for (op = 0; op < JOB_COUNT && strcmp(name, job_names[op]); ++op);
+    if (op == JOB_COUNT) {
+        return PyErr_Format(PyExc_ValueError, "submit(): unknown operation '%s'", name);
+    }
+    if (future_type == NULL) {
+        if ((module = PyImport_ImportModule("concurrent.futures")) == NULL) {
+            return NULL;
+        }
+        future_type = PyObject_GetAttrString(module, "Future");
+        Py_DECREF(module);
+        if (future_type == NULL) {
+            return NULL;
+        }
+    }
+#if PY_VERSION_HEX < 0x03070000
+    PyEval_InitThreads();
+#endif
+    if ((J = calloc(1, sizeof(PolyJob))) == NULL) {
+        return PyErr_NoMemory();
+    }
+    J->op = (JobOp)op;
+    poly_init(&(J->Q), -1);
+    poly_init(&(J->R), -1);
+    if (!job_parse_args(J, args + 1, nargs - 1)) {
+        job_free(J);
+        return NULL;
+    }
+    if ((J->cancelled = calloc(1, sizeof(int))) == NULL) {
+        job_free(J);
+        return PyErr_NoMemory();
+    }
+    if ((J->flag = PyCapsule_New((void*)J->cancelled, NULL, job_flag_free)) == NULL) {
+        free((void*)J->cancelled);
+        job_free(J);
+        return NULL;
+    }
+    if ((J->future = PyObject_CallObject(future_type, NULL)) == NULL
+            || (callback = PyCFunction_New(&job_done_def, J->flag)) == NULL) {
+        job_free(J);
+        return NULL;
+    }
+    ret = PyObject_CallMethod(J->future, "add_done_callback", "(O)", callback);
+    Py_DECREF(callback);
+    if (ret == NULL) {
+        job_free(J);
+        return NULL;
+    }
+    Py_DECREF(ret);
+    /* The job keeps its own reference, released by the worker */
+    ret = J->future;
+    Py_INCREF(ret);
+    if ((status = poly_pool_submit(job_run, J, J->cancelled)) != 1) {
+        job_free(J);
+        Py_DECREF(ret);
+        if (status == -1) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "cannot submit new jobs after interpreter shutdown");
+            return NULL;
+        }
+        return PyErr_NoMemory();
+    }
+    return ret;
+}
+PYPOLY_FASTCALL_SHIM(PyPoly_submit)
+
 static PyMethodDef PyPolymethods[] = {
-    {"gcd", PyPoly_gcd, METH_VARARGS,
+    {"gcd", PYPOLY_FASTCALL(PyPoly_gcd),
      "Compute the GCD of two or more polynomials."},
+    {"roots_many", PyPoly_roots_many, METH_O,
+     "Compute the roots of each polynomial of a sequence."},
+    {"chebyshev", PyPoly_chebyshev, METH_O,
+     "Return the Chebyshev polynomial of the first kind of degree n."},
+    {"chebyshev_upto", PyPoly_chebyshev_upto, METH_O,
+     "Return the list of the Chebyshev polynomials of degrees 0 to n."},
+    {"legendre", PyPoly_legendre, METH_O,
+     "Return the Legendre polynomial of degree n."},
+    {"legendre_upto", PyPoly_legendre_upto, METH_O,
+     "Return the list of the Legendre polynomials of degrees 0 to n."},
+    {"hermite", PyPoly_hermite, METH_O,
+     "Return the (probabilists') Hermite polynomial of degree n."},
+    {"hermite_upto", PyPoly_hermite_upto, METH_O,
+     "Return the list of the Hermite polynomials of degrees 0 to n."},
+    {"cyclotomic", PyPoly_cyclotomic, METH_O,
+     "Return the n-th cyclotomic polynomial."},
+    {"allocated_bytes", (PyCFunction)PyPoly_allocated_bytes, METH_NOARGS,
+     "Return the number of bytes currently allocated for polynomial coefficients."},
+    {"lazy", PyPoly_lazy, METH_O,
+     "Turn the lazy evaluation of polynomial operators on or off, returning the previous setting."},
+    {"crt", PYPOLY_FASTCALL(PyPoly_crt),
+     "Reconstruct an integer polynomial from its images modulo distinct primes."},
+    {"int_multiply", PYPOLY_FASTCALL(PyPoly_int_multiply),
+     "Exact product of two integer polynomials given by their coefficients."},
+    {"submit", PYPOLY_FASTCALL(PyPoly_submit),
+     "Run multiply, divmod, pow, gcd or eval_many in the background, returning a concurrent.futures.Future."},
     {NULL, NULL, 0, NULL}        /* Sentinel */
 };
 
@@ -677,14 +6108,46 @@ PyInit__pypoly(void)
 
     if (PyType_Ready(&PyPoly_PolynomialType) < 0)
         return NULL;
+    if (PyType_Ready(&PyPoly_ModPolynomialType) < 0)
+        return NULL;
+    if (PyType_Ready(&PyPoly_MultiPolynomialType) < 0)
+        return NULL;
+    if (PyType_Ready(&PyPoly_RationalType) < 0)
+        return NULL;
+    if (PyType_Ready(&PyPoly_ChebyshevType) < 0)
+        return NULL;
+    if (PyType_Ready(&PyPoly_CompiledType) < 0)
+        return NULL;
+    if (PyType_Ready(&PyPoly_ArrayType) < 0)
+        return NULL;
+    if (PyType_Ready(&PyPoly_LazyType) < 0)
+        return NULL;
 
     m = PyModule_Create(&PyPolymodule);
     if (m == NULL)
         return NULL;
+    if (!job_register_shutdown()) {
+        Py_DECREF(m);
+        return NULL;
+    }
 
     /* Add "Polynomial" type to module */
     Py_INCREF(&PyPoly_PolynomialType);
     PyModule_AddObject(m, "Polynomial", (PyObject *)&PyPoly_PolynomialType);
+    Py_INCREF(&PyPoly_ModPolynomialType);
+    PyModule_AddObject(m, "ModPolynomial", (PyObject *)&PyPoly_ModPolynomialType);
+    Py_INCREF(&PyPoly_MultiPolynomialType);
+    PyModule_AddObject(m, "MultiPolynomial", (PyObject *)&PyPoly_MultiPolynomialType);
+    Py_INCREF(&PyPoly_RationalType);
+    PyModule_AddObject(m, "RationalFunction", (PyObject *)&PyPoly_RationalType);
+    Py_INCREF(&PyPoly_ChebyshevType);
+    PyModule_AddObject(m, "ChebyshevSeries", (PyObject *)&PyPoly_ChebyshevType);
+    Py_INCREF(&PyPoly_CompiledType);
+    PyModule_AddObject(m, "CompiledPolynomial", (PyObject *)&PyPoly_CompiledType);
+    Py_INCREF(&PyPoly_ArrayType);
+    PyModule_AddObject(m, "PolynomialArray", (PyObject *)&PyPoly_ArrayType);
+    Py_INCREF(&PyPoly_LazyType);
+    PyModule_AddObject(m, "LazyPolynomial", (PyObject *)&PyPoly_LazyType);
 
     return m;
 }
@@ -696,14 +6159,44 @@ init_pypoly(void)
 
     if (PyType_Ready(&PyPoly_PolynomialType) < 0)
         return;
+    if (PyType_Ready(&PyPoly_ModPolynomialType) < 0)
+        return;
+    if (PyType_Ready(&PyPoly_MultiPolynomialType) < 0)
+        return;
+    if (PyType_Ready(&PyPoly_RationalType) < 0)
+        return;
+    if (PyType_Ready(&PyPoly_ChebyshevType) < 0)
+        return;
+    if (PyType_Ready(&PyPoly_CompiledType) < 0)
+        return;
+    if (PyType_Ready(&PyPoly_ArrayType) < 0)
+        return;
+    if (PyType_Ready(&PyPoly_LazyType) < 0)
+        return;
 
     m = Py_InitModule3("_pypoly",
         PyPolymethods, PYPOLY_MODULE_DESC);
     if (m == NULL)
         return;
+    if (!job_register_shutdown())
+        return;
 
     /* Add "Polynomial" type to module */
     Py_INCREF(&PyPoly_PolynomialType);
     PyModule_AddObject(m, "Polynomial", (PyObject *)&PyPoly_PolynomialType);
+    Py_INCREF(&PyPoly_ModPolynomialType);
+    PyModule_AddObject(m, "ModPolynomial", (PyObject *)&PyPoly_ModPolynomialType);
+    Py_INCREF(&PyPoly_MultiPolynomialType);
+    PyModule_AddObject(m, "MultiPolynomial", (PyObject *)&PyPoly_MultiPolynomialType);
+    Py_INCREF(&PyPoly_RationalType);
+    PyModule_AddObject(m, "RationalFunction", (PyObject *)&PyPoly_RationalType);
+    Py_INCREF(&PyPoly_ChebyshevType);
+    PyModule_AddObject(m, "ChebyshevSeries", (PyObject *)&PyPoly_ChebyshevType);
+    Py_INCREF(&PyPoly_CompiledType);
+    PyModule_AddObject(m, "CompiledPolynomial", (PyObject *)&PyPoly_CompiledType);
+    Py_INCREF(&PyPoly_ArrayType);
+    PyModule_AddObject(m, "PolynomialArray", (PyObject *)&PyPoly_ArrayType);
+    Py_INCREF(&PyPoly_LazyType);
+    PyModule_AddObject(m, "LazyPolynomial", (PyObject *)&PyPoly_LazyType);
 }
 #endif
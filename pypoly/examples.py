@@ -1,4 +1,4 @@
-from pypoly import Polynomial, X
+from pypoly import Polynomial, X, chebyshev, legendre, hermite, cyclotomic
 
 #
 # 1 + X + X**2 + ...
@@ -12,75 +12,43 @@ def Ones(n):
 #
 
 def ChebyshevIterator():
-    U = 1
-    yield U
-    V = X
-    yield V
+    n = 0
     while True:
-        U, V = V, 2 * X * V - U
-        yield V
+        yield chebyshev(n)
+        n += 1
 
 def Chebyshev(n):
-    it = ChebyshevIterator()
-    for i in range(n):
-        next(it)
-    return next(it)
+    return chebyshev(n)
 
 #
 # Legendre polynomials
 #
 
 def LegendreIterator():
-    U = 1
-    yield U
-    V = X
-    yield V
-    n = 1
+    n = 0
     while True:
-        U, V = V, 1. / (n + 1) * ((2 * n + 1) * X * V - n * U)
-        yield V
+        yield legendre(n)
         n += 1
 
 def Legendre(n):
-    it = LegendreIterator()
-    for i in range(n):
-        next(it)
-    return next(it)
+    return legendre(n)
 
 #
 # Hermite polynomials
 #
 
 def HermiteIterator():
-    U = 1
-    yield U
-    V = X
-    yield V
-    n = 1
+    n = 0
     while True:
-        U, V = V, X * V - n * U
-        yield V
+        yield hermite(n)
         n += 1
 
 def Hermite(n):
-    it = HermiteIterator()
-    for i in range(n):
-        next(it)
-    return next(it)
+    return hermite(n)
 
 #
 # Cyclotomic polynomials
-#  
-    
-def Cyclotomic(n):
-    if n < 1:
-        raise ValueError("Cyclotomic Polynomials are defined for positive integers only") 
-    elif n == 1:
-        return X - 1
-
-    denominator = X - 1
-    for d in range(2, n):
-        if n % d == 0:
-           denominator *= Cyclotomic(d)
+#
 
-    return (X**n - 1) // denominator
+def Cyclotomic(n):
+    return cyclotomic(n)
@@ -0,0 +1,188 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "matrix.h"
+#include "parallel.h"
+
+/* The product kernel walks MATRIX_BLOCK x MATRIX_BLOCK tiles of the right
+ * operand (32 KB), which stay in cache while they are used for every row of
+ * the left one. Orders from MATRIX_PARALLEL_ORDER split the rows between
+ * threads. */
+#define MATRIX_BLOCK            64
+#define MATRIX_PARALLEL_ORDER   128
+
+/* Real and imaginary planes of a matrix, im being NULL in real mode */
+typedef struct {
+    double *re, *im;
+} Matrix;
+
+/* Rows i0 to i1 of C += sign * A * B.
+ * Four rows of B are combined per pass over a row of C, which quarters the
+ * loads and stores of C. */
+static void
+_matmul_rows(const double *restrict A, const double *restrict B, double *restrict C,
+             int n, int i0, int i1, double sign)
+{
+    int i, j, k, kk, jj, kend, jend;
+    for (kk = 0; kk < n; kk += MATRIX_BLOCK) {
+        kend = (kk + MATRIX_BLOCK < n) ? kk + MATRIX_BLOCK : n;
+        for (jj = 0; jj < n; jj += MATRIX_BLOCK) {
+            jend = (jj + MATRIX_BLOCK < n) ? jj + MATRIX_BLOCK : n;
+            for (i = i0; i < i1; ++i) {
+                double *restrict c = C + (size_t)i * n;
+                const double *a = A + (size_t)i * n;
+                for (k = kk; k + 3 < kend; k += 4) {
+                    const double a0 = sign * a[k], a1 = sign * a[k + 1],
+                                 a2 = sign * a[k + 2], a3 = sign * a[k + 3];
+                    const double *restrict b0 = B + (size_t)k * n;
+                    const double *restrict b1 = b0 + n, *restrict b2 = b1 + n,
+                                 *restrict b3 = b2 + n;
+                    for (j = jj; j < jend; ++j) {
+                        c[j] += a0 * b0[j] + a1 * b1[j] + a2 * b2[j] + a3 * b3[j];
+                    }
+                }
+                for (; k < kend; ++k) {
+                    const double a0 = sign * a[k];
+                    const double *restrict b0 = B + (size_t)k * n;
+                    for (j = jj; j < jend; ++j) {
+                        c[j] += a0 * b0[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+typedef struct {
+    const Matrix *A, *B;
+    Matrix *C;
+    int n;
+} MatmulTask;
+
+static void
+_matmul_chunk(void *ctx, int start, int end)
+{
+    const MatmulTask *T = ctx;
+    const Matrix *A = T->A, *B = T->B;
+    const int n = T->n;
+    const size_t off = (size_t)start * n, len = (size_t)(end - start) * n;
+    memset(T->C->re + off, 0, len * sizeof(double));
+    _matmul_rows(A->re, B->re, T->C->re, n, start, end, 1.);
+    if (T->C->im != NULL) {
+        memset(T->C->im + off, 0, len * sizeof(double));
+        _matmul_rows(A->im, B->im, T->C->re, n, start, end, -1.);
+        _matmul_rows(A->re, B->im, T->C->im, n, start, end, 1.);
+        _matmul_rows(A->im, B->re, T->C->im, n, start, end, 1.);
+    }
+}
+
+/* C = A * B, C overlapping neither A nor B */
+static void
+_mat_multiply(const Matrix *A, const Matrix *B, Matrix *C, int n)
+{
+    MatmulTask T = {A, B, C, n};
+    if (n >= MATRIX_PARALLEL_ORDER) {
+        poly_parallel_for(_matmul_chunk, &T, n, 16);
+    } else {
+        _matmul_chunk(&T, 0, n);
+    }
+}
+
+/* R += c * A */
+static void
+_mat_axpy(Matrix *R, Complex c, const Matrix *A, int n)
+{
+    const size_t len = (size_t)n * n;
+    size_t k;
+    if (R->im == NULL) {
+        for (k = 0; k < len; ++k) {
+            R->re[k] += c.real * A->re[k];
+        }
+        return;
+    }
+    for (k = 0; k < len; ++k) {
+        R->re[k] += c.real * A->re[k] - c.imag * A->im[k];
+        R->im[k] += c.real * A->im[k] + c.imag * A->re[k];
+    }
+}
+
+/* R += B_j(M) = sum(c[i] * M**i, i < len), powers[i - 1] being M**i */
+static void
+_add_block(Matrix *R, const Complex *c, int len, Matrix *powers, int n)
+{
+    int i;
+    for (i = 1; i < len; ++i) {
+        if (c[i].real != 0. || c[i].imag != 0.) {
+            _mat_axpy(R, c[i], powers + i - 1, n);
+        }
+    }
+    for (i = 0; i < n; ++i) {
+        R->re[(size_t)i * n + i] += c[0].real;
+        if (R->im != NULL) R->im[(size_t)i * n + i] += c[0].imag;
+    }
+}
+
+int
+poly_eval_matrix(Polynomial *P, const Complex *M, int n, Complex *R)
+{
+    const int d = P->deg;
+    const size_t len = (size_t)n * n;
+    Matrix *mats, *powers, Acc, Tmp, Swap;
+    double *mem;
+    int s, r, i, j, planes = 1;
+    size_t k;
+    if (d == -1 || n == 0) {
+        memset(R, 0, len * sizeof(Complex));
+        return 1;
+    }
+    for (k = 0; k < len && planes == 1; ++k) {
+        if (M[k].imag != 0.) planes = 2;
+    }
+    for (i = 0; i <= d && planes == 1; ++i) {
+        if (P->coef[i].imag != 0.) planes = 2;
+    }
+    s = (int)ceil(sqrt((double)d + 1.));
+    if (s < 1) s = 1;
+    r = (d + s) / s;
+    /* M, ..., M**s, the accumulator and a temporary */
+    if ((mats = malloc((s + 2) * sizeof(Matrix))) == NULL) {
+        return 0;
+    }
+    if ((mem = poly_mem_calloc((s + 2) * planes * len, sizeof(double))) == NULL) {
+        free(mats);
+        return 0;
+    }
+    for (i = 0; i < s + 2; ++i) {
+        mats[i].re = mem + (size_t)i * planes * len;
+        mats[i].im = (planes == 2) ? mats[i].re + len : NULL;
+    }
+    powers = mats;
+    for (k = 0; k < len; ++k) {
+        mem[k] = M[k].real;
+        if (planes == 2) mem[len + k] = M[k].imag;
+    }
+    for (i = 1; i < ((r > 1) ? s : s - 1); ++i) {
+        _mat_multiply(powers + i - 1, powers, powers + i, n);
+    }
+
+    /* Horner's method in M**s on the blocks */
+    Acc = mats[s];
+    Tmp = mats[s + 1];
+    memset(Acc.re, 0, planes * len * sizeof(double));
+    _add_block(&Acc, P->coef + (r - 1) * s, d + 1 - (r - 1) * s, powers, n);
+    for (j = r - 2; j >= 0; --j) {
+        _mat_multiply(&Acc, powers + s - 1, &Tmp, n);
+        Swap = Acc;
+        Acc = Tmp;
+        Tmp = Swap;
+        _add_block(&Acc, P->coef + j * s, s, powers, n);
+    }
+    for (k = 0; k < len; ++k) {
+        R[k].real = Acc.re[k];
+        R[k].imag = (planes == 2) ? Acc.im[k] : 0.;
+    }
+    poly_mem_free(mem, (s + 2) * planes * len * sizeof(double));
+    free(mats);
+    return 1;
+}
@@ -0,0 +1,22 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "polynomials.h"
+
+/* Evaluation of polynomials at square matrices.
+ * Matrices are stored row by row. The Paterson-Stockmeyer scheme splits P
+ * into blocks of s ~ sqrt(deg P) coefficients:
+ *      P(M) = sum(B_j(M) * (M**s)**j),  B_j(M) = sum(c[j s + i] * M**i, i < s)
+ * the powers M**2, ..., M**s being computed once, and the B_j combined by
+ * Horner's method in M**s: about 2 sqrt(deg P) matrix products instead of
+ * deg P.
+ *
+ * The products work on separate real and imaginary planes, with a cache
+ * blocked kernel run in parallel (see parallel.h) for large orders. Real
+ * matrices with real coefficients only use the real planes. */
+
+/* R = P(M), for a matrix M of order n. R must not overlap M.
+ * Returns 0 on memory allocation error. */
+int poly_eval_matrix(Polynomial *P, const Complex *M, int n, Complex *R);
+
+#endif
@@ -0,0 +1,1037 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "modular.h"
+#include "polynomials.h"
+
+/**
+ * Modular arithmetic
+ */
+
+const uint64_t ntt_primes[NTT_PRIMES_COUNT] = {
+    4611615649683210241ULL, 4611613450659954689ULL, 4611549678985543681ULL,
+    4611546380450660353ULL, 4611524390218104833ULL, 4611496902427410433ULL,
+    4611480409752993793ULL, 4611468315125088257ULL, 4611467215613460481ULL,
+    4611458419520438273ULL, 4611454021473927169ULL, 4611368259566960641ULL,
+    4611359463473938433ULL, 4611355065427427329ULL, 4611277000101855233ULL,
+    4611266004985577473ULL, 4611253910357671937ULL, 4611239616706510849ULL,
+    4611200034287910913ULL, 4611170347473960961ULL, 4611154954311172097ULL,
+    4611127466520477697ULL, 4611115371892572161ULL, 4611105476287922177ULL
+};
+
+/* 64 x 64 -> 128 bits multiplication, returns the high word */
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 uint128;
+
+static inline uint64_t
+mul_wide(uint64_t a, uint64_t b, uint64_t *lo)
+{
+    uint128 t = (uint128)a * b;
+    *lo = (uint64_t)t;
+    return (uint64_t)(t >> 64);
+}
+#else
+static inline uint64_t
+mul_wide(uint64_t a, uint64_t b, uint64_t *lo)
+{
+    uint64_t a0 = (uint32_t)a, a1 = a >> 32, b0 = (uint32_t)b, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+    *lo = (mid << 32) | (uint32_t)p00;
+    return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+#endif
+
+/* Montgomery product: a * b / 2**64 mod p.
+ * Since p < 2**63, no intermediate sum can overflow. */
+static inline uint64_t
+mod_mul(uint64_t a, uint64_t b, const Modulus *m)
+{
+    uint64_t lo, ulo, hi = mul_wide(a, b, &lo);
+    uint64_t r = hi + mul_wide(lo * m->pinv, m->p, &ulo) + (lo != 0);
+    return (r >= m->p) ? r - m->p : r;
+}
+
+static inline uint64_t
+mod_add(uint64_t a, uint64_t b, const Modulus *m)
+{
+    uint64_t r = a + b;
+    return (r >= m->p) ? r - m->p : r;
+}
+
+static inline uint64_t
+mod_sub(uint64_t a, uint64_t b, const Modulus *m)
+{
+    return (a >= b) ? a - b : a + m->p - b;
+}
+
+static uint64_t
+mod_pow(uint64_t a, uint64_t e, const Modulus *m)
+{
+    uint64_t r = m->one;
+    while (e) {
+        if (e & 1) r = mod_mul(r, a, m);
+        a = mod_mul(a, a, m);
+        e >>= 1;
+    }
+    return r;
+}
+
+/* Inverse of a non-zero residue, by Fermat's little theorem */
+static inline uint64_t
+mod_inv(uint64_t a, const Modulus *m)
+{
+    return mod_pow(a, m->p - 2, m);
+}
+
+uint64_t
+mod_from_uint(const Modulus *m, uint64_t a)
+{
+    return mod_mul(a % m->p, m->r2, m);
+}
+
+uint64_t
+mod_to_uint(const Modulus *m, uint64_t a)
+{
+    return mod_mul(a, 1, m);
+}
+
+/* Montgomery constants and NTT root of unity, assuming p is an odd prime */
+static void
+_modulus_setup(Modulus *m, uint64_t p)
+{
+    int i;
+    uint64_t inv = p, x, g;
+    for (i = 0; i < 6; ++i) {
+        inv *= 2 - p * inv;     // Newton's iteration, doubling the exact bits
+    }
+    m->p = p;
+    m->pinv = -inv;
+    x = (-p) % p;               // 2**64 mod p
+    m->one = x;
+    for (i = 0; i < 64; ++i) {
+        x = (x << 1) % p;
+    }
+    m->r2 = x;
+    for (m->ntt_order = 0; !(((p - 1) >> m->ntt_order) & 1); ++m->ntt_order);
+    /* A quadratic non-residue g gives a root of order exactly 2**ntt_order */
+    for (g = 2; g < p; ++g) {
+        x = mod_from_uint(m, g);
+        if (mod_pow(x, (p - 1) >> 1, m) == p - m->one) break;
+    }
+    m->root = mod_pow(x, (p - 1) >> m->ntt_order, m);
+}
+
+/* Deterministic Miller-Rabin test for 64 bits integers */
+static int
+_is_prime(const Modulus *m)
+{
+    static const uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    uint64_t d = m->p - 1, x, minus_one = m->p - m->one;
+    int i, j, s = 0;
+    while (!(d & 1)) {
+        d >>= 1;
+        ++s;
+    }
+    for (i = 0; i < (int)(sizeof(bases) / sizeof(bases[0])); ++i) {
+        if (bases[i] % m->p == 0) continue;
+        x = mod_pow(mod_from_uint(m, bases[i]), d, m);
+        if (x == m->one || x == minus_one) continue;
+        for (j = 1; j < s && x != minus_one; ++j) {
+            x = mod_mul(x, x, m);
+        }
+        if (x != minus_one) return 0;
+    }
+    return 1;
+}
+
+/* Returns 0 if p is not an odd prime lower than 2**63 */
+int
+modulus_init(Modulus *m, uint64_t p)
+{
+    if (p < 3 || !(p & 1) || p >> 63) {
+        return 0;
+    }
+    _modulus_setup(m, p);
+    if (!_is_prime(m)) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Multiplication kernels
+ */
+
+#define MOD_SCHOOLBOOK_CUTOFF   32
+
+static void
+_mod_mul_schoolbook(const uint64_t *a, int na, const uint64_t *b, int nb,
+                    uint64_t *r, const Modulus *m)
+{
+    int i, j;
+    memset(r, 0, (na + nb - 1) * sizeof(uint64_t));
+    for (i = 0; i < na; ++i) {
+        if (a[i] == 0) continue;
+        for (j = 0; j < nb; ++j) {
+            r[i + j] = mod_add(r[i + j], mod_mul(a[i], b[j], m), m);
+        }
+    }
+}
+
+/* In-place number theoretic transform of size 2**logn <= 2**ntt_order */
+static int
+_ntt(uint64_t *a, int logn, const Modulus *m, int inverse)
+{
+    size_t n = (size_t)1 << logn, i, j, k, len, half, step;
+    uint64_t u, v, omega = m->root, *w;
+    if ((w = poly_mem_calloc(n / 2 + 1, sizeof(uint64_t))) == NULL) {
+        return 0;
+    }
+    for (i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            u = a[i];
+            a[i] = a[j];
+            a[j] = u;
+        }
+    }
+    for (k = logn; (int)k < m->ntt_order; ++k) {
+        omega = mod_mul(omega, omega, m);
+    }
+    if (inverse) omega = mod_inv(omega, m);
+    w[0] = m->one;
+    for (k = 1; k < n / 2; ++k) {
+        w[k] = mod_mul(w[k - 1], omega, m);
+    }
+    for (len = 2; len <= n; len <<= 1) {
+        half = len >> 1;
+        step = n / len;
+        for (i = 0; i < n; i += len) {
+            for (j = 0; j < half; ++j) {
+                u = a[i + j];
+                v = mod_mul(a[i + j + half], w[j * step], m);
+                a[i + j] = mod_add(u, v, m);
+                a[i + j + half] = mod_sub(u, v, m);
+            }
+        }
+    }
+    if (inverse) {
+        u = mod_inv(mod_from_uint(m, n), m);
+        for (i = 0; i < n; ++i) {
+            a[i] = mod_mul(a[i], u, m);
+        }
+    }
+    poly_mem_free(w, (n / 2 + 1) * sizeof(uint64_t));
+    return 1;
+}
+
+static int
+_mod_mul_ntt(const uint64_t *a, int na, const uint64_t *b, int nb,
+             uint64_t *r, const Modulus *m, int logn)
+{
+    size_t i, n = (size_t)1 << logn;
+    int square = (a == b && na == nb);
+    size_t size = square ? n : 2 * n;
+    uint64_t *fa = poly_mem_calloc(size, sizeof(uint64_t)), *fb;
+    if (fa == NULL) {
+        return 0;
+    }
+    fb = square ? fa : fa + n;
+    memcpy(fa, a, na * sizeof(uint64_t));
+    if (!square) memcpy(fb, b, nb * sizeof(uint64_t));
+    if (!_ntt(fa, logn, m, 0) || (!square && !_ntt(fb, logn, m, 0))) {
+        poly_mem_free(fa, size * sizeof(uint64_t));
+        return 0;
+    }
+    for (i = 0; i < n; ++i) {
+        fa[i] = mod_mul(fa[i], fb[i], m);
+    }
+    if (!_ntt(fa, logn, m, 1)) {
+        poly_mem_free(fa, size * sizeof(uint64_t));
+        return 0;
+    }
+    memcpy(r, fa, (na + nb - 1) * sizeof(uint64_t));
+    poly_mem_free(fa, size * sizeof(uint64_t));
+    return 1;
+}
+
+/* Moduli whose NTT order is too small: the exact integer product of the
+ * representatives (< n p**2 < 2**186) is computed modulo three NTT primes,
+ * then reconstructed modulo p with Garner's formula. */
+static int
+_mod_mul_crt(const uint64_t *a, int na, const uint64_t *b, int nb,
+             uint64_t *r, const Modulus *m, int logn)
+{
+    Modulus q[3];
+    uint64_t inverses[9], res[3], digits[3], q0, q01;
+    int i, t, nr = na + nb - 1;
+    size_t size = (size_t)3 * nr + na + nb;
+    uint64_t *mem = poly_mem_calloc(size, sizeof(uint64_t));
+    if (mem == NULL) {
+        return 0;
+    }
+    uint64_t *ra = mem + 3 * (size_t)nr, *rb = ra + na;
+    for (t = 0; t < 3; ++t) {
+        _modulus_setup(q + t, ntt_primes[t]);
+        for (i = 0; i < na; ++i) ra[i] = mod_from_uint(q + t, mod_to_uint(m, a[i]));
+        for (i = 0; i < nb; ++i) rb[i] = mod_from_uint(q + t, mod_to_uint(m, b[i]));
+        if (!_mod_mul_ntt(ra, na, (a == b && na == nb) ? ra : rb, nb,
+                          mem + (size_t)t * nr, q + t, logn)) {
+            poly_mem_free(mem, size * sizeof(uint64_t));
+            return 0;
+        }
+    }
+    crt_inverses(q, 3, inverses);
+    q0 = mod_from_uint(m, ntt_primes[0]);
+    q01 = mod_mul(q0, mod_from_uint(m, ntt_primes[1]), m);
+    for (i = 0; i < nr; ++i) {
+        for (t = 0; t < 3; ++t) {
+            res[t] = mod_to_uint(q + t, mem[(size_t)t * nr + i]);
+        }
+        crt_digits(q, 3, inverses, res, digits);
+        r[i] = mod_add(mod_from_uint(m, digits[0]),
+                       mod_add(mod_mul(mod_from_uint(m, digits[1]), q0, m),
+                               mod_mul(mod_from_uint(m, digits[2]), q01, m), m), m);
+    }
+    poly_mem_free(mem, size * sizeof(uint64_t));
+    return 1;
+}
+
+/* r (na + nb - 1 coefficients) = a * b, r must not overlap a or b */
+static int
+_mod_mul_kernel(const uint64_t *a, int na, const uint64_t *b, int nb,
+                uint64_t *r, const Modulus *m)
+{
+    int logn = 0;
+    if (na < MOD_SCHOOLBOOK_CUTOFF || nb < MOD_SCHOOLBOOK_CUTOFF) {
+        _mod_mul_schoolbook(a, na, b, nb, r, m);
+        return 1;
+    }
+    while (((size_t)1 << logn) < (size_t)(na + nb - 1)) ++logn;
+    if (logn <= m->ntt_order) {
+        return _mod_mul_ntt(a, na, b, nb, r, m, logn);
+    }
+    return _mod_mul_crt(a, na, b, nb, r, m, logn);
+}
+
+/**
+ * Chinese remainders
+ */
+
+/* inverses[i * k + j] = m[j]**-1 mod m[i] (Montgomery form), for j < i.
+ * Returns 0 if two moduli are equal. */
+int
+crt_inverses(const Modulus *m, int k, uint64_t *inverses)
+{
+    int i, j;
+    for (i = 0; i < k; ++i) {
+        for (j = 0; j < i; ++j) {
+            uint64_t x = mod_from_uint(m + i, m[j].p);
+            if (x == 0) {
+                return 0;
+            }
+            inverses[i * k + j] = mod_inv(x, m + i);
+        }
+    }
+    return 1;
+}
+
+/* Garner's algorithm */
+void
+crt_digits(const Modulus *m, int k, const uint64_t *inverses,
+           const uint64_t *residues, uint64_t *digits)
+{
+    int i, j;
+    uint64_t v;
+    for (i = 0; i < k; ++i) {
+        v = mod_from_uint(m + i, residues[i]);
+        for (j = 0; j < i; ++j) {
+            v = mod_mul(mod_sub(v, mod_from_uint(m + i, digits[j]), m + i),
+                        inverses[i * k + j], m + i);
+        }
+        digits[i] = mod_to_uint(m + i, v);
+    }
+}
+
+/**
+ * Polynomials over Z/pZ
+ * Same naming conventions as in polynomials.c: the destination polynomials
+ * are initialized by the operators.
+ */
+
+int
+mpoly_init(ModPolynomial *P, const Modulus *m, int deg)
+{
+    P->mod = *m;
+    P->deg = deg;
+    P->size = deg + 1;
+    if (deg == -1) {
+        P->coef = NULL;
+    } else if ((P->coef = poly_mem_calloc(deg + 1, sizeof(uint64_t))) == NULL) {
+        P->size = 0;
+        return 0;
+    }
+    return 1;
+}
+
+void
+mpoly_free(ModPolynomial *P)
+{
+    poly_mem_free(P->coef, (size_t)P->size * sizeof(uint64_t));
+    P->coef = NULL;
+    P->size = 0;
+}
+
+void
+mpoly_normalize(ModPolynomial *P)
+{
+    while (P->deg != -1 && P->coef[P->deg] == 0) {
+        --(P->deg);
+    }
+}
+
+int
+mpoly_copy(ModPolynomial *A, ModPolynomial *P)
+{
+    if (!mpoly_init(P, &(A->mod), A->deg)) {
+        return 0;
+    }
+    if (A->deg != -1) {
+        memcpy(P->coef, A->coef, (A->deg + 1) * sizeof(uint64_t));
+    }
+    return 1;
+}
+
+int
+mpoly_equal(ModPolynomial *A, ModPolynomial *B)
+{
+    return A->mod.p == B->mod.p && A->deg == B->deg
+        && (A->deg == -1 || !memcmp(A->coef, B->coef, (A->deg + 1) * sizeof(uint64_t)));
+}
+
+uint64_t
+mpoly_eval(ModPolynomial *P, uint64_t x)
+{
+    uint64_t r = 0;
+    int i;
+    for (i = P->deg; i >= 0; --i) {
+        r = mod_add(mod_mul(r, x, &(P->mod)), P->coef[i], &(P->mod));
+    }
+    return r;
+}
+
+static int
+_mpoly_addsub(ModPolynomial *A, ModPolynomial *B, ModPolynomial *R, int sub)
+{
+    int i, deg = (A->deg > B->deg) ? A->deg : B->deg;
+    if (!mpoly_init(R, &(A->mod), deg)) {
+        return 0;
+    }
+    for (i = 0; i <= deg; ++i) {
+        uint64_t a = (i <= A->deg) ? A->coef[i] : 0, b = (i <= B->deg) ? B->coef[i] : 0;
+        R->coef[i] = sub ? mod_sub(a, b, &(A->mod)) : mod_add(a, b, &(A->mod));
+    }
+    mpoly_normalize(R);
+    return 1;
+}
+
+int
+mpoly_add(ModPolynomial *A, ModPolynomial *B, ModPolynomial *R)
+{
+    return _mpoly_addsub(A, B, R, 0);
+}
+
+int
+mpoly_sub(ModPolynomial *A, ModPolynomial *B, ModPolynomial *R)
+{
+    return _mpoly_addsub(A, B, R, 1);
+}
+
+int
+mpoly_neg(ModPolynomial *A, ModPolynomial *R)
+{
+    int i;
+    if (!mpoly_init(R, &(A->mod), A->deg)) {
+        return 0;
+    }
+    for (i = 0; i <= A->deg; ++i) {
+        R->coef[i] = mod_sub(0, A->coef[i], &(A->mod));
+    }
+    return 1;
+}
+
+/* c is in Montgomery form */
+int
+mpoly_scal_multiply(ModPolynomial *A, uint64_t c, ModPolynomial *R)
+{
+    int i;
+    if (!mpoly_init(R, &(A->mod), (c == 0) ? -1 : A->deg)) {
+        return 0;
+    }
+    for (i = 0; i <= R->deg; ++i) {
+        R->coef[i] = mod_mul(A->coef[i], c, &(A->mod));
+    }
+    return 1;
+}
+
+int
+mpoly_multiply(ModPolynomial *A, ModPolynomial *B, ModPolynomial *R)
+{
+    if (A->deg == -1 || B->deg == -1) {
+        return mpoly_init(R, &(A->mod), -1);
+    }
+    if (!mpoly_init(R, &(A->mod), A->deg + B->deg)) {
+        return 0;
+    }
+    if (!_mod_mul_kernel(A->coef, A->deg + 1, B->coef, B->deg + 1, R->coef, &(A->mod))) {
+        mpoly_free(R);
+        return 0;
+    }
+    mpoly_normalize(R);
+    return 1;
+}
+
+int
+mpoly_pow(ModPolynomial *A, unsigned long n, ModPolynomial *R)
+{
+    ModPolynomial S, T;
+    if (!mpoly_init(R, &(A->mod), 0)) {
+        return 0;
+    }
+    R->coef[0] = A->mod.one;
+    if (!mpoly_copy(A, &S)) {
+        mpoly_free(R);
+        return 0;
+    }
+    while (n) {
+        if (n & 1) {
+            if (!mpoly_multiply(R, &S, &T)) goto error;
+            mpoly_free(R);
+            *R = T;
+        }
+        n >>= 1;
+        if (n) {
+            if (!mpoly_multiply(&S, &S, &T)) goto error;
+            mpoly_free(&S);
+            S = T;
+        }
+    }
+    mpoly_free(&S);
+    return 1;
+error:
+    mpoly_free(R);
+    mpoly_free(&S);
+    return 0;
+}
+
+/* Division kernel: long division for short divisors or quotients,
+ * Newton's iteration on the reversed polynomials otherwise (see
+ * _poly_divrem_kernel in polynomials.c). */
+#define MOD_NEWTON_DIV_CUTOFF   64
+
+/* g = f**-1 mod X**k, with f[0] != 0 */
+static int
+_mod_series_inverse(const uint64_t *f, int nf, uint64_t *g, int k, const Modulus *m)
+{
+    int i, len = 1, nl, lf;
+    uint64_t *t = poly_mem_calloc(4 * (size_t)k, sizeof(uint64_t)), *u;
+    if (t == NULL) {
+        return 0;
+    }
+    u = t + 2 * k;
+    g[0] = mod_inv(f[0], m);
+    while (len < k) {
+        nl = (2 * len < k) ? 2 * len : k;
+        lf = (nf < nl) ? nf : nl;
+        if (!_mod_mul_kernel(f, lf, g, len, t, m)) goto error;
+        for (i = len; i < nl; ++i) {
+            t[i] = (i < lf + len - 1) ? mod_sub(0, t[i], m) : 0;
+        }
+        if (!_mod_mul_kernel(g, nl - len, t + len, nl - len, u, m)) goto error;
+        memcpy(g + len, u, (nl - len) * sizeof(uint64_t));
+        len = nl;
+    }
+    poly_mem_free(t, 4 * (size_t)k * sizeof(uint64_t));
+    return 1;
+error:
+    poly_mem_free(t, 4 * (size_t)k * sizeof(uint64_t));
+    return 0;
+}
+
+/* Reduces a (na coefficients) modulo b in place, storing the quotient
+ * in q if not NULL. */
+static int
+_mod_divrem(uint64_t *a, int na, const uint64_t *b, int nb, uint64_t *q,
+            const Modulus *m)
+{
+    int i, j, dq = na - nb + 1;
+    if (dq <= 0) {
+        return 1;
+    }
+    if (nb - 1 < MOD_NEWTON_DIV_CUTOFF || dq < MOD_NEWTON_DIV_CUTOFF) {
+        uint64_t c, linv = mod_inv(b[nb - 1], m);
+        for (i = na - 1; i >= nb - 1; --i) {
+            c = mod_mul(a[i], linv, m);
+            if (q != NULL) q[i - nb + 1] = c;
+            a[i] = 0;
+            if (c == 0) continue;
+            for (j = 0; j < nb - 1; ++j) {
+                a[i - nb + 1 + j] = mod_sub(a[i - nb + 1 + j], mod_mul(c, b[j], m), m);
+            }
+        }
+        return 1;
+    }
+    size_t size = (size_t)4 * dq + na;
+    uint64_t *mem = poly_mem_calloc(size, sizeof(uint64_t));
+    if (mem == NULL) {
+        return 0;
+    }
+    uint64_t *rb = mem, *inv = rb + dq, *ra = inv + dq, *t = ra + dq;
+    for (i = 0; i < dq; ++i) {
+        rb[i] = (i < nb) ? b[nb - 1 - i] : 0;
+        ra[i] = a[na - 1 - i];
+    }
+    if (!_mod_series_inverse(rb, dq, inv, dq, m)
+            || !_mod_mul_kernel(ra, dq, inv, dq, t, m)) {
+        poly_mem_free(mem, size * sizeof(uint64_t));
+        return 0;
+    }
+    for (i = 0; i < dq; ++i) {
+        ra[i] = t[dq - 1 - i];      // The quotient
+    }
+    if (q != NULL) {
+        memcpy(q, ra, dq * sizeof(uint64_t));
+    }
+    if (!_mod_mul_kernel(b, nb, ra, dq, t, m)) {
+        poly_mem_free(mem, size * sizeof(uint64_t));
+        return 0;
+    }
+    for (i = 0; i < na; ++i) {
+        a[i] = (i < nb - 1) ? mod_sub(a[i], t[i], m) : 0;
+    }
+    poly_mem_free(mem, size * sizeof(uint64_t));
+    return 1;
+}
+
+/* Euclidean division, returns -1 if B is zero */
+int
+mpoly_div(ModPolynomial *A, ModPolynomial *B, ModPolynomial *Q, ModPolynomial *R)
+{
+    if (B->deg == -1) {
+        return -1;
+    }
+    int dq = A->deg - B->deg;
+    if (Q != NULL && !mpoly_init(Q, &(A->mod), (dq < 0) ? -1 : dq)) {
+        return 0;
+    }
+    if (!mpoly_copy(A, R)) {
+        if (Q != NULL) mpoly_free(Q);
+        return 0;
+    }
+    if (!_mod_divrem(R->coef, A->deg + 1, B->coef, B->deg + 1,
+                     (Q != NULL) ? Q->coef : NULL, &(A->mod))) {
+        if (Q != NULL) mpoly_free(Q);
+        mpoly_free(R);
+        return 0;
+    }
+    mpoly_normalize(R);
+    return 1;
+}
+
+/* Monic greatest common divisor, with Euclid's algorithm performed in place
+ * on two buffers. */
+int
+mpoly_gcd(ModPolynomial *A, ModPolynomial *B, ModPolynomial *P)
+{
+    ModPolynomial U, V, T;
+    int i;
+    if (!mpoly_copy(A, &U)) {
+        return 0;
+    }
+    if (!mpoly_copy(B, &V)) {
+        mpoly_free(&U);
+        return 0;
+    }
+    while (V.deg != -1) {
+        if (!_mod_divrem(U.coef, U.deg + 1, V.coef, V.deg + 1, NULL, &(A->mod))) {
+            mpoly_free(&U);
+            mpoly_free(&V);
+            return 0;
+        }
+        if (U.deg >= V.deg) U.deg = V.deg - 1;
+        mpoly_normalize(&U);
+        T = U;
+        U = V;
+        V = T;
+    }
+    mpoly_free(&V);
+    if (U.deg != -1) {
+        uint64_t linv = mod_inv(U.coef[U.deg], &(A->mod));
+        for (i = 0; i <= U.deg; ++i) {
+            U.coef[i] = mod_mul(U.coef[i], linv, &(A->mod));
+        }
+    }
+    *P = U;
+    return 1;
+}
+
+/**
+ * Resultants
+ * Along the remainder sequence r[0] = A, r[1] = B, r[i+1] = r[i-1] % r[i]
+ * of degrees d[i]:
+ *      res(r[i-1], r[i]) = (-1)**(d[i-1] d[i]) lc(r[i])**(d[i-1] - d[i+1]) res(r[i], r[i+1])
+ * The factor of r[i] is known once d[i+1] is, that is after the quotient of
+ * the next Euclidean step: the product is accumulated step by step, which
+ * lets the half-GCD algorithm skip most of the remainders.
+ */
+typedef struct {
+    const Modulus *m;
+    int prev, cur;      // Degrees of r[i-1] (-1 before r[1]) and r[i]
+    uint64_t lc;        // Leading coefficient of r[i]
+    uint64_t res;
+} ResultantSteps;
+
+/* Euclidean step of quotient degree dq, by a divisor of leading coefficient lc */
+static void
+_res_step(ResultantSteps *S, int dq, uint64_t lc)
+{
+    int next = S->cur - dq;
+    if (S->prev >= 0) {
+        if (S->prev & S->cur & 1) S->res = mod_sub(0, S->res, S->m);
+        S->res = mod_mul(S->res, mod_pow(S->lc, S->prev - next, S->m), S->m);
+    }
+    S->prev = S->cur;
+    S->cur = next;
+    S->lc = lc;
+}
+
+/* Half-GCD: the matrix M = [[a, b], [c, d]] of the first Euclidean steps
+ * from (u, v), such that (a u + b v, c u + d v) are the two consecutive
+ * remainders around degree (deg u + 1) / 2. Quotients only depend on the
+ * high coefficients: the first half of the steps is computed recursively on
+ * the high halves of u and v, and so is the second one, so that the whole
+ * costs O(M(n) log n) operations.
+ * Below MOD_HGCD_CUTOFF, the steps are plain Euclidean divisions. The
+ * matrix products have a high constant factor (three NTT primes for most
+ * moduli): mpoly_resultant only uses the algorithm from degree
+ * MOD_HGCD_THRESHOLD. */
+#define MOD_HGCD_CUTOFF     1024
+#define MOD_HGCD_THRESHOLD  4096
+
+typedef struct {
+    ModPolynomial a, b, c, d;
+} MPolyMatrix;
+
+static void
+_mmat_free(MPolyMatrix *M)
+{
+    mpoly_free(&M->a);
+    mpoly_free(&M->b);
+    mpoly_free(&M->c);
+    mpoly_free(&M->d);
+}
+
+static int
+_mmat_identity(MPolyMatrix *M, const Modulus *m)
+{
+    mpoly_init(&M->b, m, -1);
+    mpoly_init(&M->c, m, -1);
+    if (!mpoly_init(&M->a, m, 0)) {
+        return 0;
+    }
+    if (!mpoly_init(&M->d, m, 0)) {
+        mpoly_free(&M->a);
+        return 0;
+    }
+    M->a.coef[0] = M->d.coef[0] = m->one;
+    return 1;
+}
+
+/* R = X u + Y v */
+static int
+_mpoly_combine(ModPolynomial *X, ModPolynomial *u, ModPolynomial *Y, ModPolynomial *v,
+               ModPolynomial *R)
+{
+    ModPolynomial T1, T2;
+    int res;
+    if (!mpoly_multiply(X, u, &T1)) {
+        return 0;
+    }
+    if (!mpoly_multiply(Y, v, &T2)) {
+        mpoly_free(&T1);
+        return 0;
+    }
+    res = mpoly_add(&T1, &T2, R);
+    mpoly_free(&T1);
+    mpoly_free(&T2);
+    return res;
+}
+
+/* (c, d) = M (u, v) */
+static int
+_mmat_apply(MPolyMatrix *M, ModPolynomial *u, ModPolynomial *v,
+            ModPolynomial *c, ModPolynomial *d)
+{
+    if (!_mpoly_combine(&M->a, u, &M->b, v, c)) {
+        return 0;
+    }
+    if (!_mpoly_combine(&M->c, u, &M->d, v, d)) {
+        mpoly_free(c);
+        return 0;
+    }
+    return 1;
+}
+
+/* R = M N */
+static int
+_mmat_multiply(MPolyMatrix *M, MPolyMatrix *N, MPolyMatrix *R)
+{
+    if (!_mmat_apply(M, &N->a, &N->c, &R->a, &R->c)) {
+        return 0;
+    }
+    if (!_mmat_apply(M, &N->b, &N->d, &R->b, &R->d)) {
+        mpoly_free(&R->a);
+        mpoly_free(&R->c);
+        return 0;
+    }
+    return 1;
+}
+
+/* M = [[0, 1], [1, -q]] M, in place */
+static int
+_mmat_step(MPolyMatrix *M, ModPolynomial *q)
+{
+    ModPolynomial T, c, d;
+    if (!mpoly_multiply(q, &M->c, &T)) {
+        return 0;
+    }
+    if (!mpoly_sub(&M->a, &T, &c)) {
+        mpoly_free(&T);
+        return 0;
+    }
+    mpoly_free(&T);
+    if (!mpoly_multiply(q, &M->d, &T)) {
+        mpoly_free(&c);
+        return 0;
+    }
+    if (!mpoly_sub(&M->b, &T, &d)) {
+        mpoly_free(&T);
+        mpoly_free(&c);
+        return 0;
+    }
+    mpoly_free(&T);
+    mpoly_free(&M->a);
+    mpoly_free(&M->b);
+    M->a = M->c;
+    M->b = M->d;
+    M->c = c;
+    M->d = d;
+    return 1;
+}
+
+/* R = P / X**k, rounded down */
+static int
+_mpoly_shift_down(ModPolynomial *P, int k, ModPolynomial *R)
+{
+    if (!mpoly_init(R, &(P->mod), (P->deg >= k) ? P->deg - k : -1)) {
+        return 0;
+    }
+    if (R->deg != -1) {
+        memcpy(R->coef, P->coef + k, (R->deg + 1) * sizeof(uint64_t));
+    }
+    return 1;
+}
+
+/* Requires deg u > deg v */
+static int
+_mpoly_hgcd(ModPolynomial *u, ModPolynomial *v, ResultantSteps *S, MPolyMatrix *M)
+{
+    const Modulus *mod = &(u->mod);
+    const int m = (u->deg + 1) / 2;
+    ModPolynomial c, d, q, e, u0, v0;
+    MPolyMatrix R, T, QR;
+    int k, ok = 0;
+    if (!_mmat_identity(M, mod)) {
+        return 0;
+    }
+    if (v->deg < m) {
+        return 1;
+    }
+    mpoly_init(&c, mod, -1);
+    mpoly_init(&d, mod, -1);
+    mpoly_init(&q, mod, -1);
+    mpoly_init(&e, mod, -1);
+    if (u->deg < MOD_HGCD_CUTOFF) {
+        if (!mpoly_copy(u, &c) || !mpoly_copy(v, &d)) goto end;
+        while (d.deg >= m) {
+            if (mpoly_div(&c, &d, &q, &e) != 1) goto end;
+            _res_step(S, q.deg, d.coef[d.deg]);
+            if (!_mmat_step(M, &q)) goto end;
+            mpoly_free(&q);
+            mpoly_free(&c);
+            c = d;
+            d = e;
+            mpoly_init(&e, mod, -1);
+        }
+        ok = 1;
+        goto end;
+    }
+
+    /* First half, on u / X**m and v / X**m */
+    if (!_mpoly_shift_down(u, m, &u0)) goto end;
+    if (!_mpoly_shift_down(v, m, &v0)) {
+        mpoly_free(&u0);
+        goto end;
+    }
+    k = _mpoly_hgcd(&u0, &v0, S, &R);
+    mpoly_free(&u0);
+    mpoly_free(&v0);
+    if (!k) goto end;
+    if (!_mmat_apply(&R, u, v, &c, &d)) {
+        _mmat_free(&R);
+        goto end;
+    }
+    if (d.deg < m) {
+        _mmat_free(M);
+        *M = R;
+        ok = 1;
+        goto end;
+    }
+
+    /* One plain step, then the second half on d / X**k and e / X**k */
+    if (mpoly_div(&c, &d, &q, &e) != 1 || !_mmat_step(&R, &q)) {
+        _mmat_free(&R);
+        goto end;
+    }
+    _res_step(S, q.deg, d.coef[d.deg]);
+    k = 2 * m - d.deg;
+    if (!_mpoly_shift_down(&d, k, &u0)) {
+        _mmat_free(&R);
+        goto end;
+    }
+    if (!_mpoly_shift_down(&e, k, &v0)) {
+        mpoly_free(&u0);
+        _mmat_free(&R);
+        goto end;
+    }
+    k = _mpoly_hgcd(&u0, &v0, S, &T);
+    mpoly_free(&u0);
+    mpoly_free(&v0);
+    if (!k) {
+        _mmat_free(&R);
+        goto end;
+    }
+    QR = R;
+    k = _mmat_multiply(&T, &QR, &R);
+    _mmat_free(&T);
+    _mmat_free(&QR);
+    if (!k) goto end;
+    _mmat_free(M);
+    *M = R;
+    ok = 1;
+end:
+    mpoly_free(&c);
+    mpoly_free(&d);
+    mpoly_free(&q);
+    mpoly_free(&e);
+    if (!ok) _mmat_free(M);
+    return ok;
+}
+
+int
+mpoly_resultant(ModPolynomial *A, ModPolynomial *B, uint64_t *r)
+{
+    const Modulus *mod = &(A->mod);
+    ModPolynomial U, V, C, D;
+    MPolyMatrix M;
+    ResultantSteps S;
+    int ok;
+    if (A->deg == -1 || B->deg == -1) {
+        *r = 0;
+        return 1;
+    }
+    if (A->deg < B->deg) {
+        if (!mpoly_resultant(B, A, r)) {
+            return 0;
+        }
+        if (A->deg & B->deg & 1) *r = mod_sub(0, *r, mod);
+        return 1;
+    }
+    if (!mpoly_copy(A, &U)) {
+        return 0;
+    }
+    if (!mpoly_copy(B, &V)) {
+        mpoly_free(&U);
+        return 0;
+    }
+    S.m = mod;
+    S.prev = -1;
+    S.cur = A->deg;
+    S.lc = A->coef[A->deg];
+    S.res = mod->one;
+    while (V.deg != -1) {
+        if (V.deg >= MOD_HGCD_THRESHOLD && U.deg > V.deg) {
+            if (!_mpoly_hgcd(&U, &V, &S, &M)) goto error;
+            ok = _mmat_apply(&M, &U, &V, &C, &D);
+            _mmat_free(&M);
+            if (!ok) goto error;
+            mpoly_free(&U);
+            mpoly_free(&V);
+            U = C;
+            V = D;
+            if (V.deg == -1) break;
+        }
+        _res_step(&S, U.deg - V.deg, V.coef[V.deg]);
+        if (!_mod_divrem(U.coef, U.deg + 1, V.coef, V.deg + 1, NULL, mod)) goto error;
+        if (U.deg >= V.deg) U.deg = V.deg - 1;
+        mpoly_normalize(&U);
+        C = U;
+        U = V;
+        V = C;
+    }
+    /* The sequence ends with r[k] = U: res(r[k], 0) is 0 unless r[k] is a
+     * constant c, with res(r[k-1], c) = c**d[k-1] */
+    *r = (U.deg > 0) ? 0 : mod_mul(S.res, mod_pow(S.lc, S.prev, mod), mod);
+    mpoly_free(&U);
+    mpoly_free(&V);
+    return 1;
+error:
+    mpoly_free(&U);
+    mpoly_free(&V);
+    return 0;
+}
+
+/* disc(A) = (-1)**(n (n - 1) / 2) * res(A, A') / lc(A), with n = deg A.
+ * A' keeps the formal degree n - 1 in the Sylvester matrix even when p
+ * divides n, which multiplies the resultant by lc(A)**(n - 1 - deg A'). */
+int
+mpoly_discriminant(ModPolynomial *A, uint64_t *d)
+{
+    const Modulus *mod = &(A->mod);
+    ModPolynomial D;
+    uint64_t r, k = 0, lc;
+    int i, n = A->deg;
+    if (n < 1) {
+        return -1;
+    }
+    if (!mpoly_init(&D, mod, n - 1)) {
+        return 0;
+    }
+    for (i = 1; i <= n; ++i) {
+        k = mod_add(k, mod->one, mod);
+        D.coef[i - 1] = mod_mul(A->coef[i], k, mod);
+    }
+    mpoly_normalize(&D);
+    if (!mpoly_resultant(A, &D, &r)) {
+        mpoly_free(&D);
+        return 0;
+    }
+    lc = A->coef[n];
+    r = mod_mul(r, mod_mul(mod_pow(lc, n - 1 - D.deg, mod), mod_inv(lc, mod), mod), mod);
+    mpoly_free(&D);
+    *d = (n % 4 >= 2) ? mod_sub(0, r, mod) : r;
+    return 1;
+}
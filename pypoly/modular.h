@@ -0,0 +1,85 @@
+#ifndef MODULAR_H
+#define MODULAR_H
+
+#include <stdint.h>
+
+/* Arithmetic over Z/pZ, for odd primes p < 2**63.
+ * Residues are stored in Montgomery form (a * 2**64 mod p), so that
+ * modular multiplications need no division. */
+typedef struct {
+    uint64_t p;
+    uint64_t pinv;      // -p**-1 mod 2**64
+    uint64_t r2;        // 2**128 mod p
+    uint64_t one;       // 1 in Montgomery form
+    int ntt_order;      // Largest k such that 2**k divides p - 1
+    uint64_t root;      // Primitive 2**ntt_order-th root of unity (Montgomery)
+} Modulus;
+
+int modulus_init(Modulus *m, uint64_t p);
+
+uint64_t mod_from_uint(const Modulus *m, uint64_t a);
+
+uint64_t mod_to_uint(const Modulus *m, uint64_t a);
+
+/* Primes of the form c * 2**40 + 1 just below 2**62, usable for number
+ * theoretic transforms of sizes up to 2**40. They are used for
+ * multi-modular computations. */
+#define NTT_PRIMES_COUNT    24
+extern const uint64_t ntt_primes[NTT_PRIMES_COUNT];
+
+/* Polynomials over Z/pZ.
+ * Same conventions as Polynomial: "deg" is -1 for the zero polynomial and
+ * the leading coefficient of a non-zero polynomial is never zero. */
+typedef struct {
+    uint64_t *coef;
+    int deg;
+    int size;           // Allocated coefficients, deg + 1 when initialized
+    Modulus mod;
+} ModPolynomial;
+
+int mpoly_init(ModPolynomial *P, const Modulus *m, int deg);
+
+void mpoly_free(ModPolynomial *P);
+
+int mpoly_copy(ModPolynomial *A, ModPolynomial *P);
+
+int mpoly_equal(ModPolynomial *A, ModPolynomial *B);
+
+void mpoly_normalize(ModPolynomial *P);
+
+uint64_t mpoly_eval(ModPolynomial *P, uint64_t x);
+
+int mpoly_add(ModPolynomial *A, ModPolynomial *B, ModPolynomial *R);
+
+int mpoly_sub(ModPolynomial *A, ModPolynomial *B, ModPolynomial *R);
+
+int mpoly_neg(ModPolynomial *A, ModPolynomial *R);
+
+int mpoly_scal_multiply(ModPolynomial *A, uint64_t c, ModPolynomial *R);
+
+int mpoly_multiply(ModPolynomial *A, ModPolynomial *B, ModPolynomial *R);
+
+int mpoly_pow(ModPolynomial *A, unsigned long n, ModPolynomial *R);
+
+int mpoly_div(ModPolynomial *A, ModPolynomial *B, ModPolynomial *Q, ModPolynomial *R);
+
+int mpoly_gcd(ModPolynomial *A, ModPolynomial *B, ModPolynomial *P);
+
+/* The results are residues in Montgomery form. Large degrees use the
+ * half-GCD algorithm. */
+int mpoly_resultant(ModPolynomial *A, ModPolynomial *B, uint64_t *r);
+
+/* Returns -1 if deg A < 1 */
+int mpoly_discriminant(ModPolynomial *A, uint64_t *d);
+
+/* Chinese remainders: computes the mixed radix digits d of the unique
+ * x < prod(m) such that x = residues[i] mod m[i]:
+ *      x = d[0] + d[1] * m[0] + d[2] * m[0] * m[1] + ...
+ * The residues and the digits are plain (not Montgomery) integers.
+ * "inverses" holds the k * k table computed by crt_inverses. */
+int crt_inverses(const Modulus *m, int k, uint64_t *inverses);
+
+void crt_digits(const Modulus *m, int k, const uint64_t *inverses,
+                const uint64_t *residues, uint64_t *digits);
+
+#endif
@@ -0,0 +1,668 @@
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "multivariate.h"
+#include "parallel.h"
+
+#define MAX(a,b)    (((int)(a)>(int)(b))?(int)(a):(int)(b))
+#define MIN(a,b)    (((int)(a)<(int)(b))?(int)(a):(int)(b))
+
+/* Exponent of x{i} in the packed monomial m of a polynomial in n variables */
+#define Mono_Shift(n, i)    ((unsigned int)((n) - 1 - (i)) * MVPOLY_BITS(n))
+#define Mono_Mask(n)        ((n) == 1 ? UINT64_MAX : (UINT64_C(1) << MVPOLY_BITS(n)) - 1)
+#define Mono_Exp(m, n, i)   ((int)(((m) >> Mono_Shift(n, i)) & Mono_Mask(n)))
+
+/* Never a valid monomial (see MVPOLY_MAX_EXP): marks the empty slots of the
+ * hash tables */
+#define EMPTY_MONO          UINT64_MAX
+
+/* Number of coefficient products above which the multiplication is shared
+ * between threads */
+#define MVPOLY_PARALLEL_WORK    (1 << 20)
+
+typedef struct {
+    uint64_t mono;
+    Complex c;
+} MVTerm;
+
+int
+mvpoly_init(MVPolynomial *P, int nvars, size_t size)
+{
+    P->nvars = nvars;
+    P->len = 0;
+    P->size = size;
+    P->monos = NULL;
+    P->coef = NULL;
+    if (size > 0) {
+        /* A single block, the monomials followed by the coefficients */
+        if ((P->monos = poly_mem_calloc(size, sizeof(uint64_t) + sizeof(Complex))) == NULL) {
+            P->size = 0;
+            return 0;
+        }
+        P->coef = (Complex*)(P->monos + size);
+    }
+    return 1;
+}
+
+void
+mvpoly_free(MVPolynomial *P)
+{
+    poly_mem_free(P->monos, P->size * (sizeof(uint64_t) + sizeof(Complex)));
+    P->monos = NULL;
+    P->coef = NULL;
+    P->len = P->size = 0;
+}
+
+int
+mvpoly_copy(MVPolynomial *A, MVPolynomial *P)
+{
+    if (!mvpoly_init(P, A->nvars, A->len)) {
+        return 0;
+    }
+    if (A->len > 0) {
+        memcpy(P->monos, A->monos, A->len * sizeof(uint64_t));
+        memcpy(P->coef, A->coef, A->len * sizeof(Complex));
+    }
+    P->len = A->len;
+    return 1;
+}
+
+int
+mvpoly_equal(MVPolynomial *A, MVPolynomial *B)
+{
+    size_t i;
+    if (A->nvars != B->nvars || A->len != B->len) {
+        return 0;
+    }
+    for (i = 0; i < A->len; ++i) {
+        if (A->monos[i] != B->monos[i]
+                || A->coef[i].real != B->coef[i].real
+                || A->coef[i].imag != B->coef[i].imag) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void
+mvpoly_exponents(MVPolynomial *P, size_t i, int *exps)
+{
+    int v;
+    for (v = 0; v < P->nvars; ++v) {
+        exps[v] = Mono_Exp(P->monos[i], P->nvars, v);
+    }
+}
+
+/* Total degree, -1 for the zero polynomial */
+int
+mvpoly_degree(MVPolynomial *P)
+{
+    size_t i;
+    int v, d, deg = -1;
+    for (i = 0; i < P->len; ++i) {
+        for (v = 0, d = 0; v < P->nvars; ++v) {
+            d += Mono_Exp(P->monos[i], P->nvars, v);
+        }
+        if (d > deg) deg = d;
+    }
+    return deg;
+}
+
+/* Largest exponent of each variable */
+static void
+_max_exponents(MVPolynomial *P, int *maxe)
+{
+    size_t i;
+    int v, e;
+    for (v = 0; v < P->nvars; ++v) {
+        maxe[v] = 0;
+    }
+    for (i = 0; i < P->len; ++i) {
+        for (v = 0; v < P->nvars; ++v) {
+            e = Mono_Exp(P->monos[i], P->nvars, v);
+            if (e > maxe[v]) maxe[v] = e;
+        }
+    }
+}
+
+static size_t
+_mvpoly_monomial(void *ctx, size_t i, char *s)
+{
+    MVPolynomial *P = ctx;
+    size_t len = 0;
+    int v, e;
+    for (v = 0; v < P->nvars; ++v) {
+        if ((e = Mono_Exp(P->monos[i], P->nvars, v)) == 0) continue;
+        if (len > 0) len += sprintf(s + len, " * ");
+        len += sprintf(s + len, (e == 1) ? "x%d" : "x%d**%d", v, e);
+    }
+    return len;
+}
+
+/* Same representation as poly_to_string, with the variables x0, x1, ... */
+char*
+mvpoly_to_string(MVPolynomial *P)
+{
+    return poly_terms_to_string(P->coef, P->len, _mvpoly_monomial, P);
+}
+
+/**
+ * Construction from unsorted terms
+ */
+
+/* Sorts the terms by decreasing monomials: insertion sort for the small
+ * arrays, LSD radix sort on the bytes of the monomials otherwise, skipping
+ * the bytes which are the same for all the terms. */
+static int
+_sort_terms(MVTerm *t, size_t n)
+{
+    size_t i, j, counts[8][256], pos, c;
+    MVTerm *tmp, *src = t, *dst, *swap, x;
+    int k;
+    if (n < 64) {
+        for (i = 1; i < n; ++i) {
+            x = t[i];
+            for (j = i; j > 0 && t[j - 1].mono < x.mono; --j) {
+                t[j] = t[j - 1];
+            }
+            t[j] = x;
+        }
+        return 1;
+    }
+    if ((tmp = poly_mem_calloc(n, sizeof(MVTerm))) == NULL) {
+        return 0;
+    }
+    dst = tmp;
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < n; ++i) {
+        for (k = 0; k < 8; ++k) {
+            ++counts[k][(~t[i].mono >> (8 * k)) & 0xff];
+        }
+    }
+    for (k = 0; k < 8; ++k) {
+        if (counts[k][(~t[0].mono >> (8 * k)) & 0xff] == n) {
+            continue;
+        }
+        for (j = 0, pos = 0; j < 256; ++j) {
+            c = counts[k][j];
+            counts[k][j] = pos;
+            pos += c;
+        }
+        for (i = 0; i < n; ++i) {
+            dst[counts[k][(~src[i].mono >> (8 * k)) & 0xff]++] = src[i];
+        }
+        swap = src; src = dst; dst = swap;
+    }
+    if (src != t) {
+        memcpy(t, src, n * sizeof(MVTerm));
+    }
+    poly_mem_free(tmp, n * sizeof(MVTerm));
+    return 1;
+}
+
+/* R gets the n sorted terms, the coefficients of equal monomials being
+ * summed and the zero ones dropped */
+static int
+_terms_to_poly(const MVTerm *t, size_t n, int nvars, MVPolynomial *R)
+{
+    size_t i, j, count = 0;
+    for (i = 0; i < n; ++i) {
+        count += (i == 0 || t[i].mono != t[i - 1].mono);
+    }
+    if (!mvpoly_init(R, nvars, count)) {
+        return 0;
+    }
+    for (i = 0; i < n; i = j) {
+        Complex c = t[i].c;
+        for (j = i + 1; j < n && t[j].mono == t[i].mono; ++j) {
+            c.real += t[j].c.real;
+            c.imag += t[j].c.imag;
+        }
+        if (c.real != 0. || c.imag != 0.) {
+            R->monos[R->len] = t[i].mono;
+            R->coef[R->len++] = c;
+        }
+    }
+    return 1;
+}
+
+int
+mvpoly_from_terms(MVPolynomial *P, int nvars, const int *exps,
+                  const Complex *coefs, size_t n)
+{
+    MVTerm *t;
+    size_t i;
+    int v, res;
+    if ((t = poly_mem_calloc(n ? n : 1, sizeof(MVTerm))) == NULL) {
+        return 0;
+    }
+    for (i = 0; i < n; ++i) {
+        t[i].mono = 0;
+        t[i].c = coefs[i];
+        for (v = 0; v < nvars; ++v) {
+            int e = exps[i * nvars + v];
+            if (e < 0 || e > MVPOLY_MAX_EXP(nvars)) {
+                poly_mem_free(t, (n ? n : 1) * sizeof(MVTerm));
+                return -1;
+            }
+            t[i].mono |= (uint64_t)e << Mono_Shift(nvars, v);
+        }
+    }
+    res = _sort_terms(t, n) && _terms_to_poly(t, n, nvars, P);
+    poly_mem_free(t, (n ? n : 1) * sizeof(MVTerm));
+    return res;
+}
+
+int
+mvpoly_extend(MVPolynomial *A, int nvars, MVPolynomial *R)
+{
+    size_t i;
+    int v, e;
+    if (!mvpoly_init(R, nvars, A->len)) {
+        return 0;
+    }
+    for (i = 0; i < A->len; ++i) {
+        R->monos[i] = 0;
+        for (v = 0; v < A->nvars; ++v) {
+            if ((e = Mono_Exp(A->monos[i], A->nvars, v)) > MVPOLY_MAX_EXP(nvars)) {
+                mvpoly_free(R);
+                return -1;
+            }
+            R->monos[i] |= (uint64_t)e << Mono_Shift(nvars, v);
+        }
+        R->coef[i] = A->coef[i];
+    }
+    R->len = A->len;
+    return 1;
+}
+
+/**
+ * Arithmetic
+ */
+
+/* Merge of the sorted terms of A and s * B */
+static int
+_mvpoly_addsub(MVPolynomial *A, MVPolynomial *B, MVPolynomial *R, double s)
+{
+    size_t i = 0, j = 0;
+    Complex c;
+    if (!mvpoly_init(R, A->nvars, A->len + B->len)) {
+        return 0;
+    }
+    while (i < A->len || j < B->len) {
+        if (j == B->len || (i < A->len && A->monos[i] > B->monos[j])) {
+            R->monos[R->len] = A->monos[i];
+            R->coef[R->len++] = A->coef[i++];
+        } else if (i == A->len || B->monos[j] > A->monos[i]) {
+            R->monos[R->len] = B->monos[j];
+            R->coef[R->len++] = (Complex){s * B->coef[j].real, s * B->coef[j].imag};
+            ++j;
+        } else {
+            c.real = A->coef[i].real + s * B->coef[j].real;
+            c.imag = A->coef[i].imag + s * B->coef[j].imag;
+            if (c.real != 0. || c.imag != 0.) {
+                R->monos[R->len] = A->monos[i];
+                R->coef[R->len++] = c;
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return 1;
+}
+
+int
+mvpoly_add(MVPolynomial *A, MVPolynomial *B, MVPolynomial *R)
+{
+    return _mvpoly_addsub(A, B, R, 1.);
+}
+
+int
+mvpoly_sub(MVPolynomial *A, MVPolynomial *B, MVPolynomial *R)
+{
+    return _mvpoly_addsub(A, B, R, -1.);
+}
+
+int
+mvpoly_neg(MVPolynomial *A, MVPolynomial *R)
+{
+    return mvpoly_scal_multiply(A, (Complex){-1., 0.}, R);
+}
+
+int
+mvpoly_scal_multiply(MVPolynomial *A, Complex c, MVPolynomial *R)
+{
+    size_t i;
+    Complex t;
+    if (!mvpoly_init(R, A->nvars, (c.real == 0. && c.imag == 0.) ? 0 : A->len)) {
+        return 0;
+    }
+    for (i = 0; i < R->size; ++i) {
+        t.real = A->coef[i].real * c.real - A->coef[i].imag * c.imag;
+        t.imag = A->coef[i].real * c.imag + A->coef[i].imag * c.real;
+        if (t.real != 0. || t.imag != 0.) {
+            R->monos[R->len] = A->monos[i];
+            R->coef[R->len++] = t;
+        }
+    }
+    return 1;
+}
+
+/* Products of the terms [start, end) of A by the terms of B, accumulated in
+ * an open addressing hash table of the monomials, which is then sorted */
+static int
+_multiply_rows(MVPolynomial *A, size_t start, size_t end, MVPolynomial *B, MVPolynomial *R)
+{
+    size_t i, j, k, h, count = 0, cap = 64, products = (end - start) * B->len;
+    int bits = 6, res;
+    MVTerm *table, *grown;
+    /* The table starts with room for the products up to 2**16 of them */
+    while (cap < 2 * products && cap < (1 << 17)) {
+        cap *= 2;
+        ++bits;
+    }
+    if ((table = poly_mem_calloc(cap, sizeof(MVTerm))) == NULL) {
+        return 0;
+    }
+    for (h = 0; h < cap; ++h) table[h].mono = EMPTY_MONO;
+    for (i = start; i < end; ++i) {
+        const uint64_t ma = A->monos[i];
+        const Complex a = A->coef[i];
+        for (j = 0; j < B->len; ++j) {
+            const uint64_t m = ma + B->monos[j];
+            const Complex b = B->coef[j];
+            h = (size_t)((m * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - bits));
+            while (table[h].mono != m && table[h].mono != EMPTY_MONO) {
+                h = (h + 1) & (cap - 1);
+            }
+            if (table[h].mono == EMPTY_MONO) {
+                table[h].mono = m;
+                table[h].c = CZero;
+                if (2 * ++count > cap) {
+                    /* Rehash into a table twice as large */
+                    if ((grown = poly_mem_calloc(2 * cap, sizeof(MVTerm))) == NULL) {
+                        poly_mem_free(table, cap * sizeof(MVTerm));
+                        return 0;
+                    }
+                    for (k = 0; k < 2 * cap; ++k) grown[k].mono = EMPTY_MONO;
+                    ++bits;
+                    for (k = 0; k < cap; ++k) {
+                        if (table[k].mono == EMPTY_MONO) continue;
+                        h = (size_t)((table[k].mono * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - bits));
+                        while (grown[h].mono != EMPTY_MONO) h = (h + 1) & (2 * cap - 1);
+                        grown[h] = table[k];
+                    }
+                    poly_mem_free(table, cap * sizeof(MVTerm));
+                    table = grown;
+                    cap *= 2;
+                    h = (size_t)((m * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - bits));
+                    while (table[h].mono != m) h = (h + 1) & (cap - 1);
+                }
+            }
+            table[h].c.real += a.real * b.real - a.imag * b.imag;
+            table[h].c.imag += a.real * b.imag + a.imag * b.real;
+        }
+    }
+    for (h = 0, k = 0; h < cap; ++h) {
+        if (table[h].mono != EMPTY_MONO) table[k++] = table[h];
+    }
+    res = _sort_terms(table, k) && _terms_to_poly(table, k, A->nvars, R);
+    poly_mem_free(table, cap * sizeof(MVTerm));
+    return res;
+}
+
+typedef struct {
+    MVPolynomial *A, *B, *parts;
+    int chunks;
+    int failed;
+} MultiplyTask;
+
+static void
+_multiply_chunk(void *ctx, int start, int end)
+{
+    MultiplyTask *T = ctx;
+    int c;
+    for (c = start; c < end; ++c) {
+        size_t first = T->A->len * c / T->chunks, last = T->A->len * (c + 1) / T->chunks;
+        if (!_multiply_rows(T->A, first, last, T->B, T->parts + c)) {
+            mvpoly_init(T->parts + c, T->A->nvars, 0);
+            T->failed = 1;
+        }
+    }
+}
+
+/* The products are accumulated in hash tables. Large products are split by
+ * rows of A between threads, the partial results being summed afterwards:
+ * the rounding of the coefficients then depends on the number of threads. */
+int
+mvpoly_multiply(MVPolynomial *A, MVPolynomial *B, MVPolynomial *R)
+{
+    int v, chunks, maxa[MVPOLY_MAX_VARS], maxb[MVPOLY_MAX_VARS];
+    MVPolynomial parts[64], S;
+    MultiplyTask T;
+    size_t i;
+    if (A->len > B->len) {  // The rows are taken from the shortest operand
+        MVPolynomial *T = A;
+        A = B;
+        B = T;
+    }
+    if (A->len == 0) {
+        return mvpoly_init(R, B->nvars, 0);
+    }
+    _max_exponents(A, maxa);
+    _max_exponents(B, maxb);
+    for (v = 0; v < A->nvars; ++v) {
+        if (maxa[v] > MVPOLY_MAX_EXP(A->nvars) - maxb[v]) {
+            return -1;
+        }
+    }
+    if (A->len == 1) {
+        /* Adding a monomial keeps the order of the terms */
+        if (!mvpoly_scal_multiply(B, A->coef[0], R)) {
+            return 0;
+        }
+        for (i = 0; i < R->len; ++i) {
+            R->monos[i] += A->monos[0];
+        }
+        return 1;
+    }
+    chunks = (A->len < 64) ? (int)A->len : 64;
+    chunks = MIN(chunks, poly_get_num_threads());
+    if ((double)A->len * B->len < MVPOLY_PARALLEL_WORK || chunks < 2) {
+        return _multiply_rows(A, 0, A->len, B, R);
+    }
+    T.A = A;
+    T.B = B;
+    T.parts = parts;
+    T.chunks = chunks;
+    T.failed = 0;
+    poly_parallel_for(_multiply_chunk, &T, chunks, 1);
+    *R = parts[0];
+    for (v = 1; v < chunks; ++v) {
+        if (!T.failed && !mvpoly_add(R, parts + v, &S)) {
+            T.failed = 1;
+        }
+        if (!T.failed) {
+            mvpoly_free(R);
+            *R = S;
+        }
+        mvpoly_free(parts + v);
+    }
+    if (T.failed) {
+        mvpoly_free(R);
+        return 0;
+    }
+    return 1;
+}
+
+int
+mvpoly_pow(MVPolynomial *A, unsigned int n, MVPolynomial *R)
+{
+    int v, maxe[MVPOLY_MAX_VARS], res;
+    MVPolynomial B, S;
+    if (n == 0) {
+        int exps[MVPOLY_MAX_VARS] = {0};
+        return mvpoly_from_terms(R, A->nvars, exps, &COne, 1);
+    }
+    _max_exponents(A, maxe);
+    for (v = 0; v < A->nvars; ++v) {
+        if ((double)maxe[v] * n > MVPOLY_MAX_EXP(A->nvars)) {
+            return -1;
+        }
+    }
+    /* Binary powering, from the most significant bit of n */
+    if (!mvpoly_copy(A, R)) {
+        return 0;
+    }
+    for (v = 31; !(n >> v & 1); --v);
+    for (--v; v >= 0; --v) {
+        res = mvpoly_multiply(R, R, &S);
+        mvpoly_free(R);
+        if (res != 1) {
+            return res;
+        }
+        *R = S;
+        if (n >> v & 1) {
+            if ((res = mvpoly_multiply(R, A, &B)) != 1) {
+                mvpoly_free(R);
+                return res;
+            }
+            mvpoly_free(R);
+            *R = B;
+        }
+    }
+    return 1;
+}
+
+int
+mvpoly_derive(MVPolynomial *A, int var, unsigned int n, MVPolynomial *R)
+{
+    const unsigned int shift = Mono_Shift(A->nvars, var);
+    size_t i, count = 0;
+    unsigned int e, k;
+    double f;
+    for (i = 0; i < A->len; ++i) {
+        count += ((unsigned int)Mono_Exp(A->monos[i], A->nvars, var) >= n);
+    }
+    if (!mvpoly_init(R, A->nvars, count)) {
+        return 0;
+    }
+    /* Subtracting n from an exponent keeps the order of the terms */
+    for (i = 0; i < A->len; ++i) {
+        if ((e = Mono_Exp(A->monos[i], A->nvars, var)) < n) continue;
+        /* e * (e - 1) * ... * (e - n + 1), infinite beyond n = 170 */
+        for (k = 0, f = 1.; k < n && f <= DBL_MAX; ++k) {
+            f *= e - k;
+        }
+        R->monos[R->len] = A->monos[i] - ((uint64_t)n << shift);
+        R->coef[R->len].real = f * A->coef[i].real;
+        R->coef[R->len++].imag = f * A->coef[i].imag;
+    }
+    return 1;
+}
+
+/* Largest exponent for which mvpoly_eval tabulates the powers of a
+ * variable, larger ones being computed by binary powering */
+#define MVPOLY_EVAL_TABLE   (1 << 16)
+
+int
+mvpoly_eval(MVPolynomial *A, const Complex *xs, Complex *y)
+{
+    int v, e, maxe[MVPOLY_MAX_VARS];
+    size_t i, offsets[MVPOLY_MAX_VARS], total = 0;
+    Complex *powers, p, x, t, s = CZero;
+    _max_exponents(A, maxe);
+    for (v = 0; v < A->nvars; ++v) {
+        offsets[v] = total;
+        total += (maxe[v] <= MVPOLY_EVAL_TABLE) ? maxe[v] + 1 : 0;
+    }
+    if ((powers = poly_mem_calloc(total ? total : 1, sizeof(Complex))) == NULL) {
+        return 0;
+    }
+    for (v = 0; v < A->nvars; ++v) {
+        if (maxe[v] > MVPOLY_EVAL_TABLE) continue;
+        p = COne;
+        for (e = 0; e <= maxe[v]; ++e) {
+            powers[offsets[v] + e] = p;
+            t.real = p.real * xs[v].real - p.imag * xs[v].imag;
+            p.imag = p.real * xs[v].imag + p.imag * xs[v].real;
+            p.real = t.real;
+        }
+    }
+    for (i = 0; i < A->len; ++i) {
+        p = A->coef[i];
+        for (v = 0; v < A->nvars; ++v) {
+            if ((e = Mono_Exp(A->monos[i], A->nvars, v)) == 0) continue;
+            if (maxe[v] <= MVPOLY_EVAL_TABLE) {
+                x = powers[offsets[v] + e];
+            } else {
+                Complex b = xs[v];
+                for (x = COne; e > 0; e >>= 1) {
+                    if (e & 1) {
+                        t.real = x.real * b.real - x.imag * b.imag;
+                        x.imag = x.real * b.imag + x.imag * b.real;
+                        x.real = t.real;
+                    }
+                    t.real = b.real * b.real - b.imag * b.imag;
+                    b.imag = 2 * b.real * b.imag;
+                    b.real = t.real;
+                }
+            }
+            t.real = p.real * x.real - p.imag * x.imag;
+            p.imag = p.real * x.imag + p.imag * x.real;
+            p.real = t.real;
+        }
+        s.real += p.real;
+        s.imag += p.imag;
+    }
+    poly_mem_free(powers, (total ? total : 1) * sizeof(Complex));
+    *y = s;
+    return 1;
+}
+
+int
+mvpoly_from_poly(Polynomial *A, int nvars, int var, MVPolynomial *R)
+{
+    size_t count = 0;
+    int i;
+    if (A->deg > MVPOLY_MAX_EXP(nvars)) {
+        return -1;
+    }
+    for (i = 0; i <= A->deg; ++i) {
+        count += (A->coef[i].real != 0. || A->coef[i].imag != 0.);
+    }
+    if (!mvpoly_init(R, nvars, count)) {
+        return 0;
+    }
+    for (i = A->deg; i >= 0; --i) {
+        if (A->coef[i].real == 0. && A->coef[i].imag == 0.) continue;
+        R->monos[R->len] = (uint64_t)i << Mono_Shift(nvars, var);
+        R->coef[R->len++] = A->coef[i];
+    }
+    return 1;
+}
+
+int
+mvpoly_to_poly(MVPolynomial *A, int var, Polynomial *R)
+{
+    const unsigned int shift = Mono_Shift(A->nvars, var);
+    const uint64_t others = ~(Mono_Mask(A->nvars) << shift);
+    size_t i;
+    int deg = -1;
+    for (i = 0; i < A->len; ++i) {
+        if (A->monos[i] & others) {
+            return -1;
+        }
+        deg = MAX(deg, A->monos[i] >> shift);
+    }
+    if (!poly_init(R, deg)) {
+        return 0;
+    }
+    for (i = 0; i < A->len; ++i) {
+        poly_set_coef(R, (int)(A->monos[i] >> shift), A->coef[i]);
+    }
+    return 1;
+}
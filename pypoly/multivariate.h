@@ -0,0 +1,80 @@
+#ifndef MULTIVARIATE_H
+#define MULTIVARIATE_H
+
+#include <limits.h>
+#include <stdint.h>
+
+#include "polynomials.h"
+
+/* Sparse multivariate polynomials in the variables x0, ..., x{nvars - 1}.
+ * A polynomial is the list of its terms, sorted by decreasing monomials in
+ * the lexicographic order (x0 > x1 > ...), without zero coefficients.
+ * Monomials are packed into 64 bits integers, the exponent of x{i} taking
+ * MVPOLY_BITS(nvars) bits, those of x0 being the most significant ones: the
+ * lexicographic order is that of the integers, and the product of two
+ * monomials is their sum as long as no exponent exceeds MVPOLY_MAX_EXP.
+ *
+ * The operators follow the Polynomial conventions (destinations are not
+ * initialized beforehand, 0 is returned on memory allocation error), and
+ * return -1 when an exponent of the result would exceed MVPOLY_MAX_EXP.
+ * The operands of binary operators have the same number of variables, see
+ * mvpoly_extend. */
+#define MVPOLY_MAX_VARS     16
+#define MVPOLY_BITS(n)      (64 / (n))
+#define MVPOLY_MAX_EXP(n)   ((n) <= 2 ? INT_MAX : (1 << MVPOLY_BITS(n)) - 2)
+
+typedef struct {
+    uint64_t *monos;
+    Complex *coef;
+    size_t len;         // Number of terms
+    size_t size;        // Allocated terms
+    int nvars;
+} MVPolynomial;
+
+int mvpoly_init(MVPolynomial *P, int nvars, size_t size);
+
+void mvpoly_free(MVPolynomial *P);
+
+int mvpoly_copy(MVPolynomial *A, MVPolynomial *P);
+
+int mvpoly_equal(MVPolynomial *A, MVPolynomial *B);
+
+/* Terms coefs[i] * x0**exps[i * nvars] * ... in any order, like terms
+ * being summed */
+int mvpoly_from_terms(MVPolynomial *P, int nvars, const int *exps,
+                      const Complex *coefs, size_t n);
+
+void mvpoly_exponents(MVPolynomial *P, size_t i, int *exps);
+
+int mvpoly_degree(MVPolynomial *P);
+
+char* mvpoly_to_string(MVPolynomial *P);
+
+/* Same polynomial with nvars >= A->nvars variables */
+int mvpoly_extend(MVPolynomial *A, int nvars, MVPolynomial *R);
+
+int mvpoly_add(MVPolynomial *A, MVPolynomial *B, MVPolynomial *R);
+
+int mvpoly_sub(MVPolynomial *A, MVPolynomial *B, MVPolynomial *R);
+
+int mvpoly_neg(MVPolynomial *A, MVPolynomial *R);
+
+int mvpoly_scal_multiply(MVPolynomial *A, Complex c, MVPolynomial *R);
+
+int mvpoly_multiply(MVPolynomial *A, MVPolynomial *B, MVPolynomial *R);
+
+int mvpoly_pow(MVPolynomial *A, unsigned int n, MVPolynomial *R);
+
+/* n-th partial derivative with respect to x{var} */
+int mvpoly_derive(MVPolynomial *A, int var, unsigned int n, MVPolynomial *R);
+
+/* *y = A(xs[0], ..., xs[nvars - 1]) */
+int mvpoly_eval(MVPolynomial *A, const Complex *xs, Complex *y);
+
+/* Conversions from and to univariate polynomials in x{var}. mvpoly_to_poly
+ * returns -1 if another variable appears in A. */
+int mvpoly_from_poly(Polynomial *A, int nvars, int var, MVPolynomial *R);
+
+int mvpoly_to_poly(MVPolynomial *A, int var, Polynomial *R);
+
+#endif
@@ -0,0 +1,238 @@
+#include <stdlib.h>
+
+#include "parallel.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <unistd.h>
+#define PYPOLY_PTHREADS
+#endif
+
+/* Upper bound on the number of threads used by a single operation */
+#define MAX_THREADS     64
+
+static int num_threads = 0;     // 0 means "not initialized yet"
+
+int
+poly_get_num_threads(void)
+{
+    if (num_threads == 0) {
+        /* The PYPOLY_NUM_THREADS environment variable overrides the
+         * number of online processors. */
+        const char *env = getenv("PYPOLY_NUM_THREADS");
+        long n = 1;
+        if (env != NULL && atoi(env) > 0) {
+            n = atoi(env);
+#if defined(PYPOLY_PTHREADS) && defined(_SC_NPROCESSORS_ONLN)
+        } else {
+            n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        }
+        num_threads = (n < 1) ? 1 : (n > MAX_THREADS) ? MAX_THREADS : (int)n;
+    }
+    return num_threads;
+}
+
+void
+poly_set_num_threads(int n)
+{
+    num_threads = (n < 1) ? 1 : (n > MAX_THREADS) ? MAX_THREADS : n;
+}
+
+#ifdef PYPOLY_PTHREADS
+/* Cancellation flag of the job run by each thread */
+static pthread_key_t cancel_key;
+static pthread_once_t cancel_once = PTHREAD_ONCE_INIT;
+
+static void
+_make_cancel_key(void)
+{
+    pthread_key_create(&cancel_key, NULL);
+}
+
+static volatile int*
+_get_cancel_flag(void)
+{
+    pthread_once(&cancel_once, _make_cancel_key);
+    return pthread_getspecific(cancel_key);
+}
+
+static void
+_set_cancel_flag(volatile int *cancelled)
+{
+    pthread_once(&cancel_once, _make_cancel_key);
+    pthread_setspecific(cancel_key, (const void*)cancelled);
+}
+
+typedef struct {
+    poly_task task;
+    void *ctx;
+    int start, end;
+    volatile int *cancelled;
+} Chunk;
+
+static void*
+_run_chunk(void *arg)
+{
+    Chunk *c = arg;
+    _set_cancel_flag(c->cancelled);
+    c->task(c->ctx, c->start, c->end);
+    return NULL;
+}
+#else
+static volatile int *current_cancel_flag = NULL;
+
+#define _get_cancel_flag()      current_cancel_flag
+#define _set_cancel_flag(f)     (current_cancel_flag = (f))
+#endif
+
+int
+poly_cancelled(void)
+{
+    volatile int *cancelled = _get_cancel_flag();
+    return cancelled != NULL && *cancelled;
+}
+
+/* "grain" is the minimal number of items worth a thread of their own */
+void
+poly_parallel_for(poly_task task, void *ctx, int n, int grain)
+{
+    int nthreads = poly_get_num_threads();
+    if (grain < 1) grain = 1;
+    if (nthreads > n / grain) nthreads = n / grain;
+#ifdef PYPOLY_PTHREADS
+    if (nthreads > 1) {
+        Chunk chunks[MAX_THREADS];
+        pthread_t threads[MAX_THREADS];
+        int i, started = 0;
+        for (i = 0; i < nthreads; ++i) {
+            chunks[i].task = task;
+            chunks[i].ctx = ctx;
+            chunks[i].start = (int)((long long)n * i / nthreads);
+            chunks[i].end = (int)((long long)n * (i + 1) / nthreads);
+            chunks[i].cancelled = _get_cancel_flag();
+        }
+        /* Chunks which could not get a thread are run by the caller */
+        for (i = 1; i < nthreads; ++i) {
+            if (pthread_create(&threads[i], NULL, _run_chunk, &chunks[i]) != 0) break;
+            ++started;
+        }
+        task(ctx, chunks[0].start, chunks[0].end);
+        for (i = started + 1; i < nthreads; ++i) {
+            task(ctx, chunks[i].start, chunks[i].end);
+        }
+        for (i = 1; i <= started; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        return;
+    }
+#endif
+    if (n > 0) {
+        task(ctx, 0, n);
+    }
+}
+
+#ifdef PYPOLY_PTHREADS
+typedef struct Job {
+    poly_job run;
+    void *ctx;
+    volatile int *cancelled;
+    struct Job *next;
+} Job;
+
+/* FIFO queue of the jobs, shared by the workers */
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_ready = PTHREAD_COND_INITIALIZER;
+static Job *queue_head = NULL, *queue_tail = NULL;
+static pthread_t pool_threads[MAX_THREADS];
+static int pool_workers = 0, pool_closed = 0;
+
+static void*
+_pool_worker(void *arg)
+{
+    Job *job;
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&pool_lock);
+        while (queue_head == NULL && !pool_closed) {
+            pthread_cond_wait(&pool_ready, &pool_lock);
+        }
+        if (queue_head == NULL) {
+            /* Closed, and the queue is drained */
+            pthread_mutex_unlock(&pool_lock);
+            return NULL;
+        }
+        job = queue_head;
+        if ((queue_head = job->next) == NULL) {
+            queue_tail = NULL;
+        }
+        pthread_mutex_unlock(&pool_lock);
+        _set_cancel_flag(job->cancelled);
+        job->run(job->ctx);
+        _set_cancel_flag(NULL);
+        free(job);
+    }
+    return NULL;
+}
+#endif
+
+int
+poly_pool_submit(poly_job run, void *ctx, volatile int *cancelled)
+{
+#ifdef PYPOLY_PTHREADS
+    Job *job;
+    if ((job = malloc(sizeof(Job))) == NULL) {
+        return 0;
+    }
+    job->run = run;
+    job->ctx = ctx;
+    job->cancelled = cancelled;
+    job->next = NULL;
+    pthread_mutex_lock(&pool_lock);
+    if (pool_closed) {
+        pthread_mutex_unlock(&pool_lock);
+        free(job);
+        return -1;
+    }
+    /* A worker is started for each job until the pool is complete */
+    if (pool_workers < poly_get_num_threads()
+            && pthread_create(&pool_threads[pool_workers], NULL, _pool_worker, NULL) == 0) {
+        ++pool_workers;
+    }
+    if (pool_workers == 0) {
+        pthread_mutex_unlock(&pool_lock);
+        free(job);
+        return 0;
+    }
+    if (queue_tail == NULL) {
+        queue_head = job;
+    } else {
+        queue_tail->next = job;
+    }
+    queue_tail = job;
+    pthread_cond_signal(&pool_ready);
+    pthread_mutex_unlock(&pool_lock);
+#else
+    _set_cancel_flag(cancelled);
+    run(ctx);
+    _set_cancel_flag(NULL);
+#endif
+    return 1;
+}
+
+void
+poly_pool_shutdown(void)
+{
+#ifdef PYPOLY_PTHREADS
+    int i;
+    pthread_mutex_lock(&pool_lock);
+    pool_closed = 1;
+    pthread_cond_broadcast(&pool_ready);
+    pthread_mutex_unlock(&pool_lock);
+    /* No worker is started once closed */
+    for (i = 0; i < pool_workers; ++i) {
+        pthread_join(pool_threads[i], NULL);
+    }
+    pool_workers = 0;
+#endif
+}
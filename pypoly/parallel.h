@@ -0,0 +1,36 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+/* Minimal parallel-for helper used by the heavier kernels.
+ * The range [0, n) is split into contiguous chunks processed by up to
+ * poly_get_num_threads() threads, the calling thread included.
+ * Tasks must not touch Python objects: they generally run with the GIL
+ * released. On platforms without POSIX threads, everything runs serially. */
+typedef void (*poly_task)(void *ctx, int start, int end);
+
+void poly_parallel_for(poly_task task, void *ctx, int n, int grain);
+
+int poly_get_num_threads(void);
+
+void poly_set_num_threads(int n);
+
+/* Background jobs, run in submission order by a pool of up to
+ * poly_get_num_threads() threads started on first use (synchronously on
+ * platforms without POSIX threads). "cancelled" points to a flag which other
+ * threads may raise while the job is queued or running: the long kernels
+ * poll it through poly_cancelled() and then fail as on a memory allocation
+ * error. Returns 0 if the job could not be queued, -1 once the pool is shut
+ * down. */
+typedef void (*poly_job)(void *ctx);
+
+int poly_pool_submit(poly_job job, void *ctx, volatile int *cancelled);
+
+/* Runs the queued jobs and waits for the workers to exit, then refuses
+ * new jobs */
+void poly_pool_shutdown(void);
+
+/* Whether the job run by the calling thread (or by the caller of the
+ * poly_parallel_for it runs a chunk of) was cancelled */
+int poly_cancelled(void);
+
+#endif
@@ -0,0 +1,343 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "polyarray.h"
+#include "parallel.h"
+#include "simd.h"
+
+#define MAX(a,b)    (((int)(a)>(int)(b))?(int)(a):(int)(b))
+#define MIN(a,b)    (((int)(a)<(int)(b))?(int)(a):(int)(b))
+
+/* Number of coefficient operations above which the work is shared between
+ * threads */
+#define POLYARRAY_PARALLEL_WORK     (1 << 17)
+
+int
+polyarray_init(PolyArray *A, int count, int deg)
+{
+    A->count = count;
+    A->deg = deg;
+    A->coef = NULL;
+    A->size = (count > 0 && deg >= 0) ? (size_t)count * (deg + 1) : 0;
+    if (A->size > 0 && (A->coef = poly_mem_calloc(A->size, sizeof(Complex))) == NULL) {
+        A->size = 0;
+        return 0;
+    }
+    return 1;
+}
+
+void
+polyarray_free(PolyArray *A)
+{
+    poly_mem_free(A->coef, A->size * sizeof(Complex));
+    A->coef = NULL;
+    A->size = 0;
+}
+
+/* Lower the degree of A to the largest degree of its rows, moving the rows
+ * towards the beginning of the block. */
+void
+polyarray_trim(PolyArray *A)
+{
+    int p, deg = A->deg;
+    Complex *c;
+    for (; deg >= 0; --deg) {
+        for (p = 0; p < A->count; ++p) {
+            c = A->coef + (size_t)p * (A->deg + 1) + deg;
+            if (c->real != 0. || c->imag != 0.) break;
+        }
+        if (p < A->count) break;
+    }
+    if (deg == A->deg) {
+        return;
+    }
+    if (deg == -1) {
+        polyarray_free(A);
+    } else {
+        for (p = 1; p < A->count; ++p) {
+            memmove(A->coef + (size_t)p * (deg + 1), A->coef + (size_t)p * (A->deg + 1),
+                    (deg + 1) * sizeof(Complex));
+        }
+    }
+    A->deg = deg;
+}
+
+typedef struct {
+    PolyArray *A, *B, *R;
+    double sign;                // Addition (1) or subtraction (-1)
+    const double *factors;      // Derivation and integration factors
+    unsigned int n;
+    const Complex *xs;
+    int step;
+    Complex *ys;
+    int failed;                 // Set on memory allocation error
+} ArrayTask;
+
+/* Run "task" on the blocks of POLYARRAY_LANES rows out of "count", for
+ * "work" operations in total. */
+static void
+_polyarray_run(poly_task task, ArrayTask *T, int count, double work)
+{
+    int blocks = (count + POLYARRAY_LANES - 1) / POLYARRAY_LANES;
+    if (work < POLYARRAY_PARALLEL_WORK) {
+        task(T, 0, blocks);
+    } else {
+        poly_parallel_for(task, T, blocks, 1);
+    }
+}
+
+static void
+_addsub_chunk(void *ctx, int start, int end)
+{
+    ArrayTask *T = ctx;
+    const double s = T->sign;
+    const int na = T->A->deg + 1, nb = T->B->deg + 1, n = MIN(na, nb);
+    int p, k, last = MIN(end * POLYARRAY_LANES, T->R->count);
+    for (p = start * POLYARRAY_LANES; p < last; ++p) {
+        const Complex *a = PolyArray_Row(T->A, p), *b = PolyArray_Row(T->B, p);
+        Complex *r = PolyArray_Row(T->R, p);
+        for (k = 0; k < n; ++k) {
+            r[k].real = a[k].real + s * b[k].real;
+            r[k].imag = a[k].imag + s * b[k].imag;
+        }
+        for (k = n; k < na; ++k) {
+            r[k] = a[k];
+        }
+        for (k = n; k < nb; ++k) {
+            r[k].real = s * b[k].real;
+            r[k].imag = s * b[k].imag;
+        }
+    }
+}
+
+/* Number of rows of a result: a single row is broadcast to the other
+ * operand, whatever its number of rows (0 included) */
+#define _polyarray_count(A, B)      (((A)->count == 1) ? (B)->count : (A)->count)
+
+static int
+_polyarray_addsub(PolyArray *A, PolyArray *B, PolyArray *R, double sign)
+{
+    ArrayTask T = {A, B, R, sign, NULL, 0, NULL, 0, NULL, 0};
+    if (!polyarray_init(R, _polyarray_count(A, B), MAX(A->deg, B->deg))) {
+        return 0;
+    }
+    _polyarray_run(_addsub_chunk, &T, R->count, (double)R->count * (R->deg + 1));
+    polyarray_trim(R);
+    return 1;
+}
+
+int
+polyarray_add(PolyArray *A, PolyArray *B, PolyArray *R)
+{
+    return _polyarray_addsub(A, B, R, 1.);
+}
+
+int
+polyarray_sub(PolyArray *A, PolyArray *B, PolyArray *R)
+{
+    return _polyarray_addsub(A, B, R, -1.);
+}
+
+int
+polyarray_neg(PolyArray *A, PolyArray *R)
+{
+    size_t i, n = (size_t)A->count * (A->deg + 1);
+    if (!polyarray_init(R, A->count, A->deg)) {
+        return 0;
+    }
+    for (i = 0; i < n; ++i) {
+        R->coef[i].real = -A->coef[i].real;
+        R->coef[i].imag = -A->coef[i].imag;
+    }
+    return 1;
+}
+
+/* Products by blocks of rows: the coefficients of a block are transposed
+ * so that each vector lane holds one polynomial, then multiplied by
+ * simd_multiply_lanes, which accumulates the products a[i] * b[j] by
+ * increasing i like the Polynomial products of small degrees. */
+static void
+_multiply_chunk(void *ctx, int start, int end)
+{
+    ArrayTask *T = ctx;
+    const int L = POLYARRAY_LANES, na = T->A->deg + 1, nb = T->B->deg + 1, nr = na + nb - 1;
+    double *ar, *ai, *br, *bi, *rr, *ri;
+    int blk, first, lanes, l, k;
+    if ((ar = poly_mem_calloc(2 * (size_t)L * (na + nb + nr), sizeof(double))) == NULL) {
+        T->failed = 1;
+        return;
+    }
+    ai = ar + na * L;
+    br = ai + na * L;
+    bi = br + nb * L;
+    rr = bi + nb * L;
+    ri = rr + nr * L;
+    for (blk = start; blk < end; ++blk) {
+        first = blk * L;
+        lanes = MIN(L, T->R->count - first);
+        for (l = 0; l < L; ++l) {
+            /* Missing lanes of the last block repeat its first row */
+            const Complex *a = PolyArray_Row(T->A, first + (l < lanes ? l : 0));
+            const Complex *b = PolyArray_Row(T->B, first + (l < lanes ? l : 0));
+            for (k = 0; k < na; ++k) {
+                ar[k * L + l] = a[k].real;
+                ai[k * L + l] = a[k].imag;
+            }
+            for (k = 0; k < nb; ++k) {
+                br[k * L + l] = b[k].real;
+                bi[k * L + l] = b[k].imag;
+            }
+        }
+        simd_multiply_lanes(ar, ai, na, br, bi, nb, rr, ri);
+        for (l = 0; l < lanes; ++l) {
+            Complex *r = PolyArray_Row(T->R, first + l);
+            for (k = 0; k < nr; ++k) {
+                r[k].real = rr[k * L + l];
+                r[k].imag = ri[k * L + l];
+            }
+        }
+    }
+    poly_mem_free(ar, 2 * (size_t)L * (na + nb + nr) * sizeof(double));
+}
+
+int
+polyarray_multiply(PolyArray *A, PolyArray *B, PolyArray *R)
+{
+    ArrayTask T = {A, B, R, 0., NULL, 0, NULL, 0, NULL, 0};
+    int count = _polyarray_count(A, B);
+    if (A->deg == -1 || B->deg == -1) {
+        return polyarray_init(R, count, -1);
+    }
+    if (!polyarray_init(R, count, A->deg + B->deg)) {
+        return 0;
+    }
+    _polyarray_run(_multiply_chunk, &T, count, (double)count * (A->deg + 1) * (B->deg + 1));
+    if (T.failed) {
+        polyarray_free(R);
+        return 0;
+    }
+    polyarray_trim(R);
+    return 1;
+}
+
+static void
+_scale_chunk(void *ctx, int start, int end)
+{
+    ArrayTask *T = ctx;
+    const int shift = T->R->deg - T->A->deg;   // n for integration, -n for derivation
+    int p, k, last = MIN(end * POLYARRAY_LANES, T->R->count);
+    for (p = start * POLYARRAY_LANES; p < last; ++p) {
+        const Complex *a = PolyArray_Row(T->A, p);
+        Complex *r = PolyArray_Row(T->R, p);
+        if (shift < 0) {
+            for (k = 0; k <= T->R->deg; ++k) {
+                r[k].real = (a[k - shift].real == 0.) ? 0. : T->factors[k] * a[k - shift].real;
+                r[k].imag = (a[k - shift].imag == 0.) ? 0. : T->factors[k] * a[k - shift].imag;
+            }
+        } else {
+            for (k = shift; k <= T->R->deg; ++k) {
+                r[k].real = a[k - shift].real / T->factors[k];
+                r[k].imag = a[k - shift].imag / T->factors[k];
+            }
+        }
+    }
+}
+
+/* Derivation (sign < 0) or integration (sign > 0), n times: the factors
+ * (k + 1) * ... * (k + n) are shared by all the rows. */
+static int
+_polyarray_scale(PolyArray *A, unsigned int n, PolyArray *R, int sign)
+{
+    ArrayTask T = {A, NULL, R, 0., NULL, n, NULL, 0, NULL, 0};
+    double *factors;
+    int k, j, deg = (A->deg == -1) ? -1 : (sign < 0) ? MAX(-1, A->deg - (int)n) : A->deg + (int)n;
+    if (!polyarray_init(R, A->count, deg)) {
+        return 0;
+    }
+    if (deg == -1) {
+        return 1;
+    }
+    if ((factors = poly_mem_calloc(deg + 1, sizeof(double))) == NULL) {
+        polyarray_free(R);
+        return 0;
+    }
+    /* Updated from one degree to the next, as in poly_derive and
+     * poly_integrate (zero coefficients being skipped by _scale_chunk) */
+    factors[0] = 1.;
+    for (j = 2; j <= (int)n; ++j) factors[0] *= j;
+    if (n == 0) {
+        for (k = 1; k <= deg; ++k) factors[k] = 1.;
+    } else if (sign < 0) {
+        for (k = 1; k <= deg; ++k) factors[k] = factors[k - 1] / k * (k + n);
+    } else {
+        k = MIN(n, deg);
+        factors[k] = factors[0];
+        for (++k; k <= deg; ++k) factors[k] = factors[k - 1] / (k - n) * k;
+    }
+    T.factors = factors;
+    _polyarray_run(_scale_chunk, &T, A->count, (double)A->count * (deg + 1));
+    poly_mem_free(factors, (deg + 1) * sizeof(double));
+    return 1;
+}
+
+int
+polyarray_derive(PolyArray *A, unsigned int n, PolyArray *R)
+{
+    return _polyarray_scale(A, n, R, -1);
+}
+
+int
+polyarray_integrate(PolyArray *A, unsigned int n, PolyArray *R)
+{
+    return _polyarray_scale(A, n, R, 1);
+}
+
+/* Horner's method on a block of rows, one chain per lane. Real points only
+ * need real multiplications, as in poly_eval_real. */
+static void
+_eval_chunk(void *ctx, int start, int end)
+{
+    ArrayTask *T = ctx;
+    const int L = POLYARRAY_LANES, deg = T->A->deg;
+    const Complex *rows[POLYARRAY_LANES];
+    double xr[POLYARRAY_LANES], xi[POLYARRAY_LANES], sr[POLYARRAY_LANES], si[POLYARRAY_LANES], t;
+    int blk, first, lanes, l, k, real;
+    for (blk = start; blk < end; ++blk) {
+        first = blk * L;
+        lanes = MIN(L, T->A->count - first);
+        for (l = 0, real = 1; l < L; ++l) {
+            const Complex x = T->xs[(size_t)(first + (l < lanes ? l : 0)) * T->step];
+            rows[l] = PolyArray_Row(T->A, first + (l < lanes ? l : 0));
+            xr[l] = x.real;
+            xi[l] = x.imag;
+            sr[l] = si[l] = 0.;
+            if (x.imag != 0.) real = 0;
+        }
+        if (real) {
+            for (k = deg; k >= 0; --k) {
+                for (l = 0; l < L; ++l) {
+                    sr[l] = sr[l] * xr[l] + rows[l][k].real;
+                    si[l] = si[l] * xr[l] + rows[l][k].imag;
+                }
+            }
+        } else {
+            for (k = deg; k >= 0; --k) {
+                for (l = 0; l < L; ++l) {
+                    t = sr[l] * xr[l] - si[l] * xi[l] + rows[l][k].real;
+                    si[l] = sr[l] * xi[l] + si[l] * xr[l] + rows[l][k].imag;
+                    sr[l] = t;
+                }
+            }
+        }
+        for (l = 0; l < lanes; ++l) {
+            T->ys[first + l] = (Complex){sr[l], si[l]};
+        }
+    }
+}
+
+void
+polyarray_eval(PolyArray *A, const Complex *xs, int step, Complex *ys)
+{
+    ArrayTask T = {A, NULL, NULL, 0., NULL, 0, xs, step, ys, 0};
+    _polyarray_run(_eval_chunk, &T, A->count, (double)A->count * (A->deg + 1));
+}
@@ -0,0 +1,50 @@
+#ifndef POLYARRAY_H
+#define POLYARRAY_H
+
+#include "polynomials.h"
+#include "simd.h"
+
+/* Arrays of polynomials, stored in a single block of "count" rows of
+ * (deg + 1) coefficients. "deg" is the largest degree of the rows (-1 when
+ * they are all zero), the other rows being padded with zeros.
+ *
+ * The operators follow the Polynomial conventions (destinations are not
+ * initialized beforehand, 0 is returned on memory allocation error).
+ * The operands of the binary operators have either the same number of rows,
+ * or one of them has a single row which is then broadcast to the other.
+ * The kernels process the rows by blocks of POLYARRAY_LANES, one polynomial
+ * per vector lane, and large arrays are split between threads. */
+typedef struct {
+    Complex *coef;
+    int count;
+    int deg;
+    size_t size;        // Allocated coefficients
+} PolyArray;
+
+#define POLYARRAY_LANES     SIMD_EVAL_BATCH
+
+#define PolyArray_Row(A, i)                                                 \
+    ((A)->coef + ((A)->count == 1 ? 0 : (size_t)(i) * ((A)->deg + 1)))
+
+int polyarray_init(PolyArray *A, int count, int deg);
+
+void polyarray_free(PolyArray *A);
+
+void polyarray_trim(PolyArray *A);
+
+int polyarray_add(PolyArray *A, PolyArray *B, PolyArray *R);
+
+int polyarray_sub(PolyArray *A, PolyArray *B, PolyArray *R);
+
+int polyarray_neg(PolyArray *A, PolyArray *R);
+
+int polyarray_multiply(PolyArray *A, PolyArray *B, PolyArray *R);
+
+int polyarray_derive(PolyArray *A, unsigned int n, PolyArray *R);
+
+int polyarray_integrate(PolyArray *A, unsigned int n, PolyArray *R);
+
+/* ys[i] = A[i](xs[i * step]): step is 0 to evaluate all the rows at xs[0] */
+void polyarray_eval(PolyArray *A, const Complex *xs, int step, Complex *ys);
+
+#endif
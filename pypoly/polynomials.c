@@ -1,28 +1,25 @@
 #include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "polynomials.h"
+#include "parallel.h"
+#include "simd.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 /**
  * Generic helpers
  */
 
 #define MAX(a,b)    (((int)(a)>(int)(b))?(int)(a):(int)(b))
-
-/* strdup is not part of the C standard and might not be available */
-static inline char*
-strduplicate(const char *s)
-{
-    int len = strlen(s) + 1;
-    char *p;
-    if ((p = malloc(len * sizeof(char))) == NULL) {
-        return NULL;
-    }
-    return memcpy(p, s, len);
-}
-#define strdup strduplicate
+#define MIN(a,b)    (((int)(a)<(int)(b))?(int)(a):(int)(b))
 
 /**
  * Complex numbers
@@ -97,6 +94,103 @@ complex_div(Complex a, Complex b)
         --((P)->deg);                                                   \
     }
 
+/* The buffers may be shared by polynomials used from several threads */
+#if defined(__GNUC__)
+#define ATOMIC_ADD(x, v)    __atomic_add_fetch(&(x), (v), __ATOMIC_RELAXED)
+#define ATOMIC_SUB(x, v)    __atomic_sub_fetch(&(x), (v), __ATOMIC_ACQ_REL)
+#define ATOMIC_LOAD(x)      __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#else
+#define ATOMIC_ADD(x, v)    ((x) += (v))
+#define ATOMIC_SUB(x, v)    ((x) -= (v))
+#define ATOMIC_LOAD(x)      (x)
+#endif
+
+#define BUFFER_INCREF(b)    ATOMIC_ADD((b)->refs, 1)
+#define BUFFER_DECREF(b)    ATOMIC_SUB((b)->refs, 1)
+#define BUFFER_REFS(b)      ATOMIC_LOAD((b)->refs)
+
+/**
+ * Coefficients allocation
+ */
+#ifdef PYPOLY_VERSION
+#define DEFAULT_ALLOCATOR   {PyMem_RawCalloc, PyMem_RawRealloc, PyMem_RawFree}
+#else
+#define DEFAULT_ALLOCATOR   {calloc, realloc, free}
+#endif
+
+static const PolyAllocator default_allocator = DEFAULT_ALLOCATOR;
+static PolyAllocator allocator = DEFAULT_ALLOCATOR;
+static size_t allocated_bytes = 0;
+
+void
+poly_set_allocator(const PolyAllocator *A)
+{
+    allocator = (A == NULL) ? default_allocator : *A;
+}
+
+size_t
+poly_allocated_bytes(void)
+{
+    return ATOMIC_LOAD(allocated_bytes);
+}
+
+void*
+poly_mem_calloc(size_t count, size_t size)
+{
+    void *ptr;
+    if ((ptr = allocator.calloc(count, size)) != NULL) {
+        ATOMIC_ADD(allocated_bytes, count * size);
+    }
+    return ptr;
+}
+
+void*
+poly_mem_realloc(void *ptr, size_t old_size, size_t size)
+{
+    if ((ptr = allocator.realloc(ptr, size)) != NULL) {
+        ATOMIC_ADD(allocated_bytes, size);
+        ATOMIC_SUB(allocated_bytes, old_size);
+    }
+    return ptr;
+}
+
+void
+poly_mem_free(void *ptr, size_t size)
+{
+    if (ptr != NULL) {
+        allocator.free(ptr);
+        ATOMIC_SUB(allocated_bytes, size);
+    }
+}
+
+#define Buffer_Bytes(size)  (sizeof(PolyBuffer) + (size_t)(size) * sizeof(Complex))
+
+static PolyBuffer*
+_buffer_new(int size)
+{
+    PolyBuffer *buf = poly_mem_calloc(1, Buffer_Bytes(size));
+    if (buf != NULL) {
+        buf->refs = 1;
+        buf->size = size;
+    }
+    return buf;
+}
+
+static void
+_buffer_release(PolyBuffer *buf)
+{
+    if (buf != NULL && BUFFER_DECREF(buf) == 0) {
+        poly_mem_free(buf, Buffer_Bytes(buf->size));
+    }
+}
+
+/* Bytes allocated for the coefficients of P, views excluded */
+size_t
+poly_sizeof(Polynomial *P)
+{
+    return (P->buf == NULL) ? 0 : Buffer_Bytes(P->buf->size);
+}
+
 /* Create a Polynomial of degree "deg" at address pointed by P.
  * If "deg" is -1, no memory is allocated and the coefficients pointer
  * is set to NULL.
@@ -107,11 +201,13 @@ complex_div(Complex a, Complex b)
 int
 poly_init(Polynomial *P, int deg)
 {
-    if (deg == -1) {
-        P->coef = NULL;
-    } else if ((P->coef = calloc(deg + 1, sizeof(Complex))) == NULL) {
-        P->coef = NULL;
-        return 0;
+    P->coef = NULL;
+    P->buf = NULL;
+    if (deg != -1) {
+        if ((P->buf = _buffer_new(deg + 1)) == NULL) {
+            return 0;
+        }
+        P->coef = P->buf->data;
     }
     P->deg = deg;
     P->bloom = 0;
@@ -122,10 +218,30 @@ poly_init(Polynomial *P, int deg)
 void
 poly_free(Polynomial *P)
 {
-    free(P->coef);
+    _buffer_release(P->buf);
+    P->buf = NULL;
     P->coef = NULL;
 }
 
+/* Give P coefficients of its own before they get modified: shared buffers
+ * and views are replaced by a private copy. */
+int
+poly_unshare(Polynomial *P)
+{
+    PolyBuffer *buf;
+    if (P->coef == NULL || (P->buf != NULL && BUFFER_REFS(P->buf) == 1)) {
+        return 1;
+    }
+    if ((buf = _buffer_new(P->deg + 1)) == NULL) {
+        return 0;
+    }
+    memcpy(buf->data, P->coef, (P->deg + 1) * sizeof(Complex));
+    _buffer_release(P->buf);
+    P->buf = buf;
+    P->coef = buf->data;
+    return 1;
+}
+
 static inline void
 _poly_set_coef(Polynomial *P, int i, Complex c)
 {
@@ -144,7 +260,7 @@ _poly_incr_coef(Polynomial *P, int i, Complex c)
 void
 poly_set_coef(Polynomial *P, int i, Complex c)
 {
-    /* /!\ i should be <= allocated */
+    /* /!\ i should be <= allocated, and the coefficients not shared */
     _poly_set_coef(P, i, c);
     if (i > P->deg && !complex_iszero(c)) {
         P->deg = i;
@@ -154,6 +270,8 @@ poly_set_coef(Polynomial *P, int i, Complex c)
 }
 
 /* Reallocate memory for P (e.g. for setting a new coef. higher than previous degree)
+ * The allocation at least doubles when it grows, so that filling a
+ * polynomial by increasing indices costs amortized O(1) per coefficient.
  *
  * /!\ This function assumes poly_set_coef will be called afterwards
  * so that the degree gets properly computed.
@@ -161,14 +279,33 @@ poly_set_coef(Polynomial *P, int i, Complex c)
 int
 poly_realloc(Polynomial *P, int deg)
 {
-    Complex *coef = realloc(P->coef, (deg + 1) * sizeof(Complex));
-    if (coef == NULL) {
-        return 0;
+    PolyBuffer *buf = P->buf;
+    int size = (buf == NULL) ? 0 : buf->size;
+    if (deg >= size) {
+        size = (size > INT_MAX / 2) ? deg + 1 : MAX(deg + 1, 2 * size);
     }
-    if (deg > P->deg) {
-        memset(coef + P->deg + 1, 0, (deg - P->deg) * sizeof(Complex));
+    if (buf != NULL && BUFFER_REFS(buf) == 1) {
+        if (size != buf->size) {
+            if ((buf = poly_mem_realloc(buf, Buffer_Bytes(buf->size), Buffer_Bytes(size))) == NULL) {
+                return 0;
+            }
+            buf->size = size;
+        }
+        if (deg > P->deg) {
+            memset(buf->data + P->deg + 1, 0, (deg - P->deg) * sizeof(Complex));
+        }
+    } else {
+        /* Shared coefficients are copied rather than resized */
+        if ((buf = _buffer_new(size)) == NULL) {
+            return 0;
+        }
+        if (P->coef != NULL) {
+            memcpy(buf->data, P->coef, (MIN(deg, P->deg) + 1) * sizeof(Complex));
+        }
+        _buffer_release(P->buf);
     }
-    P->coef = coef;
+    P->buf = buf;
+    P->coef = buf->data;
     P->deg = deg;
     return 1;
 }
@@ -193,361 +330,3413 @@ poly_equal(Polynomial *P, Polynomial *Q)
  * Examples:
  *      -1 + 3 * X**2
  *      -1+2.5j + (1+3j) * X
- * We traverse the coefficients and append characters to a buffer.
- * A little bit messy, but it seems to work.
+ * We traverse the coefficients and append characters to an output buffer.
+ * The buffer either grows as needed (poly_to_string) or is flushed in chunks
+ * to a writer callback (poly_write), so the representation is never truncated
+ * and the formatting stays linear in the number of terms.
  */
-#define BUFFER_AVAILABLE(buffer, offset)           \
-    ((int)sizeof(buffer)>(int)(offset))?           \
-    ((int)sizeof(buffer)-(int)(offset))            \
-    : 0
-
 #define STR_UNKOWN              "X"
 #define STR_J                   "j"
-#define STR_TRUNCATED           "... [truncated]"
 
-char*
-poly_to_string(Polynomial *P)
-{
-    if (P->deg == -1) {
-        return strdup("0");
-    } else {
-        char buffer[2048] = "";
-        int i, multiplier, add_mult_sign, offset = 0;
-        double re, im;
-        for (i = 0; i <= P->deg; ++i) {
-            if (complex_iszero(P->coef[i])) {
-                continue;
-            }
+/* Upper bound on the number of characters needed to format a single term:
+ * two doubles (at most 24 characters each), an exponent and some separators. */
+#define TERM_MAXLEN             128
+#define WRITE_CHUNK             65536
 
-            multiplier = 1;
-            add_mult_sign = 1;
-            if (offset != 0) {
-                multiplier = (P->coef[i].real <= 0 && P->coef[i].imag <= 0) ? -1 : 1;
-                offset += snprintf(buffer + offset,
-                                   BUFFER_AVAILABLE(buffer, offset),
-                                   "%s", (multiplier == 1) ? " + " : " - ");
-            }
-            re = multiplier * P->coef[i].real;
-            im = multiplier * P->coef[i].imag;
-            if (P->coef[i].real == 0) {
-                if (P->coef[i].imag != 1) {
-                    offset += snprintf(buffer + offset,
-                                       BUFFER_AVAILABLE(buffer, offset),
-                                       "%g", im);
-                }
-                offset += snprintf(buffer + offset,
-                                   BUFFER_AVAILABLE(buffer, offset),
-                                   "%s", STR_J);
-            } else if (im == 0) {
-                if (re != 1 || i == 0) {
-                    offset += snprintf(buffer + offset,
-                                       BUFFER_AVAILABLE(buffer, offset),
-                                       "%g", re);
-                } else {
-                    add_mult_sign = 0;
-                }
-            } else {
-                offset += snprintf(buffer + offset,
-                                   BUFFER_AVAILABLE(buffer, offset),
-                                   i == 0 ? "%g%+g%s" : "(%g%+g%s)",
-                                   re, im, STR_J);
-            }
-            if (i == 1) {
-                offset += snprintf(buffer + offset,
-                                   BUFFER_AVAILABLE(buffer, offset),
-                                   "%s", add_mult_sign ? " * " STR_UNKOWN : STR_UNKOWN);
-            } else if (i > 1) {
-                offset += snprintf(buffer + offset,
-                                   BUFFER_AVAILABLE(buffer, offset),
-                                   "%s**%d", add_mult_sign ? " * " STR_UNKOWN : STR_UNKOWN, i);
-            }
-            if (offset > (int)sizeof(buffer)) {
-                memcpy(buffer + sizeof(buffer) - strlen(STR_TRUNCATED) - 1,
-                       STR_TRUNCATED, strlen(STR_TRUNCATED));
-                break;
-            }
+typedef struct {
+    char *data;
+    size_t len;
+    size_t size;
+    poly_writer write;      // If NULL, the buffer grows instead of flushing
+    void *ctx;
+} OutBuffer;
+
+/* Make room for "n" more characters. Returns 0 on failure. */
+static int
+outbuf_reserve(OutBuffer *b, size_t n)
+{
+    if (b->len + n <= b->size) {
+        return 1;
+    }
+    if (b->write != NULL) {
+        if (!b->write(b->ctx, b->data, b->len)) {
+            return 0;
         }
-        return strdup(buffer);
+        b->len = 0;
+        return 1;
     }
+    size_t size = 2 * b->size;
+    if (size < b->len + n) size = b->len + n;
+    char *data = realloc(b->data, size);
+    if (data == NULL) {
+        return 0;
+    }
+    b->data = data;
+    b->size = size;
+    return 1;
 }
 
-/* Polynomial evaluation at a given point using Horner's method.
- * Performs O(deg P) operations (naïve approach is quadratic).
- * See http://en.wikipedia.org/wiki/Horner%27s_method */
-Complex
-poly_eval(Polynomial *P, Complex c)
+/* The following helpers assume enough room was reserved beforehand */
+static inline void
+outbuf_puts(OutBuffer *b, const char *s)
 {
-    Complex result = CZero;
-    int i;
-    for (i = P->deg; i >= 0; --i) {
-        result = complex_add(complex_mult(result, c), P->coef[i]);
-    }
-    return result;
+    size_t len = strlen(s);
+    memcpy(b->data + b->len, s, len);
+    b->len += len;
 }
 
-/**
- * Polynomial operators
- * We use the following naming convention:
- *  A, B, C, ... for the operators parameters
- *  P, Q, R, ... for the result destination
- *
- * The operators should assume the destination polynomials were NOT initiliazed.
- * It is up to the operators to perform this initialization when relevant.
- */
-
-/* Copy polynomial pointed by A to the location pointed by P */
-int
-poly_copy(Polynomial *A, Polynomial *P)
+static inline void
+outbuf_int(OutBuffer *b, long long n, int sign)
 {
-    if (!poly_init(P, A->deg)) {
-        return 0;
+    char digits[24];
+    int i = 0;
+    unsigned long long u = (n < 0) ? -(unsigned long long)n : (unsigned long long)n;
+    do {
+        digits[i++] = '0' + (char)(u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (n < 0) {
+        b->data[b->len++] = '-';
+    } else if (sign) {
+        b->data[b->len++] = '+';
+    }
+    while (i > 0) {
+        b->data[b->len++] = digits[--i];
     }
-    memcpy(P->coef, A->coef, (A->deg + 1) * sizeof(Complex));
-    P->bloom = A->bloom;
-    return 1;
 }
 
-int
-poly_add(Polynomial *A, Polynomial *B, Polynomial *R)
+/* Append the shortest string which round-trips to the double "x".
+ * Integral values (the most common case) are formatted directly. */
+static void
+outbuf_double(OutBuffer *b, double x, int sign)
 {
-    if (!poly_init(R, MAX(A->deg, B->deg))) {
-        return 0;
+    if (x > -1e15 && x < 1e15 && x == (double)(long long)x
+            && !(x == 0. && signbit(x))) {
+        outbuf_int(b, (long long)x, sign);
+        return;
     }
-    int i;
-    for (i = 0; i <= MAX(A->deg, B->deg); ++i) {
-        _poly_set_coef(R, i, complex_add(Poly_GetCoef(A, i), Poly_GetCoef(B, i)));
+#ifdef PYPOLY_VERSION
+    char *repr = PyOS_double_to_string(x, 'r', 0, sign ? Py_DTSF_SIGN : 0, NULL);
+    if (repr != NULL) {
+        outbuf_puts(b, repr);
+        PyMem_Free(repr);
+        return;
     }
-    Poly_ResizeDown(R);
-    return 1;
+    PyErr_Clear();
+#endif
+    char s[32];
+    int precision;
+    for (precision = 15; precision < 17; ++precision) {
+        snprintf(s, sizeof(s), sign ? "%+.*g" : "%.*g", precision, x);
+        if (strtod(s, NULL) == x) break;
+    }
+    if (precision == 17) {
+        snprintf(s, sizeof(s), sign ? "%+.*g" : "%.*g", precision, x);
+    }
+    outbuf_puts(b, s);
 }
 
-int
-poly_sub(Polynomial *A, Polynomial *B, Polynomial *R)
+/* Terms c[i] * m_i, where "name" writes the monomial m_i (see
+ * poly_terms_to_string), m_i being X**i if "name" is NULL */
+static int
+_format_terms(OutBuffer *b, const Complex *c, size_t n, poly_monomial_namer name, void *ctx)
 {
-    if (!poly_init(R, MAX(A->deg, B->deg))) {
-        return 0;
+    char monomial[POLY_MONOMIAL_MAXLEN + 1];
+    size_t i, len;
+    int multiplier, add_mult_sign, first = 1;
+    double re, im;
+    for (i = 0; i < n; ++i) {
+        if (complex_iszero(c[i])) {
+            continue;
+        }
+        /* Powers of X when no name is given */
+        len = (name != NULL) ? name(ctx, i, monomial) : (i != 0);
+        if (!outbuf_reserve(b, TERM_MAXLEN + ((name != NULL) ? len : 0))) return 0;
+
+        multiplier = 1;
+        add_mult_sign = 1;
+        if (!first) {
+            multiplier = (c[i].real <= 0 && c[i].imag <= 0) ? -1 : 1;
+            outbuf_puts(b, (multiplier == 1) ? " + " : " - ");
+        }
+        first = 0;
+        re = multiplier * c[i].real;
+        im = multiplier * c[i].imag;
+        if (c[i].real == 0) {
+            if (c[i].imag != 1) {
+                outbuf_double(b, im, 0);
+            }
+            outbuf_puts(b, STR_J);
+        } else if (im == 0) {
+            if (re != 1 || len == 0) {
+                outbuf_double(b, re, 0);
+            } else {
+                add_mult_sign = 0;
+            }
+        } else {
+            if (len != 0) outbuf_puts(b, "(");
+            outbuf_double(b, re, 0);
+            outbuf_double(b, im, 1);
+            outbuf_puts(b, len == 0 ? STR_J : STR_J ")");
+        }
+        if (len != 0) {
+            if (add_mult_sign) outbuf_puts(b, " * ");
+            if (name != NULL) {
+                memcpy(b->data + b->len, monomial, len);
+                b->len += len;
+            } else {
+                outbuf_puts(b, STR_UNKOWN);
+                if (i > 1) {
+                    outbuf_puts(b, "**");
+                    outbuf_int(b, (long long)i, 0);
+                }
+            }
+        }
     }
-    int i;
-    for (i = 0; i <= MAX(A->deg, B->deg); ++i) {
-        _poly_set_coef(R, i, complex_sub(Poly_GetCoef(A, i), Poly_GetCoef(B, i)));
+    if (first) {
+        if (!outbuf_reserve(b, 1)) return 0;
+        outbuf_puts(b, "0");
     }
-    Poly_ResizeDown(R);
     return 1;
 }
 
-int
-poly_neg(Polynomial *A, Polynomial *Q)
+static int
+poly_format(Polynomial *P, OutBuffer *b)
 {
-    if (!poly_init(Q, A->deg)) {
-        return 0;
+    return _format_terms(b, P->coef, P->deg + 1, NULL, NULL);
+}
+
+char*
+poly_to_string(Polynomial *P)
+{
+    OutBuffer b = {NULL, 0, 0, NULL, NULL};
+    if (!outbuf_reserve(&b, 64) || !poly_format(P, &b) || !outbuf_reserve(&b, 1)) {
+        free(b.data);
+        return NULL;
     }
-    int i;
-    for (i = 0; i <= A->deg; ++i) {
-        _poly_set_coef(Q, i, complex_neg(A->coef[i]));
+    b.data[b.len] = '\0';
+    return b.data;
+}
+
+/* Same representation as poly_to_string, for the terms c[i] * m_i */
+char*
+poly_terms_to_string(const Complex *c, size_t n, poly_monomial_namer name, void *ctx)
+{
+    OutBuffer b = {NULL, 0, 0, NULL, NULL};
+    if (!outbuf_reserve(&b, 64) || !_format_terms(&b, c, n, name, ctx) || !outbuf_reserve(&b, 1)) {
+        free(b.data);
+        return NULL;
     }
-    return 1;
+    b.data[b.len] = '\0';
+    return b.data;
 }
 
+/* Stream the representation of P to "write", in chunks of at most
+ * WRITE_CHUNK characters. Returns 0 on failure (allocation or writer error). */
 int
-poly_scal_multiply(Polynomial *A, Complex c, Polynomial *R)
+poly_write(Polynomial *P, poly_writer write, void *ctx)
 {
-    if (complex_iszero(c)) {
-        poly_init(R, -1);
-        return 1;
-    }
-    if (!poly_init(R, A->deg)) {
+    int ret;
+    OutBuffer b = {NULL, 0, WRITE_CHUNK, write, ctx};
+    if ((b.data = malloc(WRITE_CHUNK)) == NULL) {
         return 0;
     }
-    int i;
-    for (i = 0; i <= A->deg; ++i) {
-        if (A->bloom & Poly_BloomMask(i)) {
-            _poly_set_coef(R, i, complex_mult(Poly_GetCoef(A, i), c));
-        }
-    }
-    return 1;
+    ret = poly_format(P, &b) && (b.len == 0 || write(ctx, b.data, b.len));
+    free(b.data);
+    return ret;
 }
 
-int
-poly_multiply(Polynomial *A, Polynomial *B, Polynomial *R)
+/* Polynomial evaluation at a given point using Horner's method.
+ * Performs O(deg P) operations (naïve approach is quadratic).
+ * See http://en.wikipedia.org/wiki/Horner%27s_method
+ *
+ * Each Horner step depends on the previous one, so above EVAL_SPLIT_CUTOFF
+ * the polynomial is split as sum(X**r * Q_r(X**EVAL_CHAINS)): the Q_r are
+ * evaluated by independent Horner chains, which the CPU runs in parallel. */
+#define EVAL_CHAINS         SIMD_EVAL_CHAINS
+#define EVAL_SPLIT_CUTOFF   32
+
+static Complex
+_eval_split(const Complex *c, int deg, Complex x)
 {
-    // TODO: implement faster algo
-    if (A->deg == -1 || B->deg == -1) {
-        poly_init(R, -1);
-        return 1;
-    }
-    if (!poly_init(R, A->deg + B->deg)) {
-        return 0;
+    double ar[EVAL_CHAINS] = {0}, ai[EVAL_CHAINS] = {0}, tr, ti, yr, yi;
+    int i, r, top = deg - deg % EVAL_CHAINS;
+    /* y = x**EVAL_CHAINS */
+    yr = x.real * x.real - x.imag * x.imag;
+    yi = 2. * x.real * x.imag;
+    tr = yr * yr - yi * yi;
+    yi = 2. * yr * yi;
+    yr = tr;
+    for (r = 0; r <= deg - top; ++r) {
+        ar[r] = c[top + r].real;
+        ai[r] = c[top + r].imag;
     }
-    int i, j;
-    for (i = 0; i <= A->deg + B->deg; ++i) {
-        for (j = 0; j <= i; ++j) {
-            if ((A->bloom & Poly_BloomMask(j)) && (B->bloom & Poly_BloomMask(i - j))) {
-                _poly_incr_coef(R, i, complex_mult(Poly_GetCoef(A, j), Poly_GetCoef(B, i - j)));
-            }
+    for (i = top - EVAL_CHAINS; i >= 0; i -= EVAL_CHAINS) {
+        for (r = 0; r < EVAL_CHAINS; ++r) {
+            tr = ar[r] * yr - ai[r] * yi + c[i + r].real;
+            ai[r] = ar[r] * yi + ai[r] * yr + c[i + r].imag;
+            ar[r] = tr;
         }
     }
-    return 1;
+    /* Horner's method on the chains, in x */
+    for (r = EVAL_CHAINS - 2, tr = ar[EVAL_CHAINS - 1], ti = ai[EVAL_CHAINS - 1]; r >= 0; --r) {
+        yr = tr * x.real - ti * x.imag + ar[r];
+        ti = tr * x.imag + ti * x.real + ai[r];
+        tr = yr;
+    }
+    return (Complex){tr, ti};
 }
 
-int
-poly_pow(Polynomial *A, unsigned int n, Polynomial *R)
+Complex
+poly_eval(Polynomial *P, Complex c)
 {
-    if (n == 0) {
-        int failure = 0;
-        Poly_InitConst(R, ((Complex){1, 0}), failure);
-        return !failure;
+    double re = 0., im = 0., t;
+    int i;
+    if (P->deg >= EVAL_SPLIT_CUTOFF) {
+        return _eval_split(P->coef, P->deg, c);
     }
-    if (n == 1) {
-        return poly_copy(A, R);
+    for (i = P->deg; i >= 0; --i) {
+        t = re * c.real - im * c.imag + P->coef[i].real;
+        im = re * c.imag + im * c.real + P->coef[i].imag;
+        re = t;
     }
-    Polynomial T;
-    if (!poly_multiply(A, A, &T)) return 0;
-    if (!poly_pow(&T, n >> 1, R)) {
-        poly_free(&T);
-        return 0;
+    return (Complex){re, im};
+}
+
+/* Evaluation at a real point: the real and imaginary parts of the result are
+ * two independent real Horner chains, with no complex multiplication. */
+static Complex
+_eval_real_split(const Complex *c, int deg, double x)
+{
+    double ar[EVAL_CHAINS] = {0}, ai[EVAL_CHAINS] = {0}, y = (x * x) * (x * x), tr, ti;
+    int i, r, top = deg - deg % EVAL_CHAINS;
+    for (r = 0; r <= deg - top; ++r) {
+        ar[r] = c[top + r].real;
+        ai[r] = c[top + r].imag;
     }
-    poly_free(&T);
-    if (n & 1) {
-        if (!poly_multiply(R, A, &T)) {
-            poly_free(R);
-            return 0;
+    for (i = top - EVAL_CHAINS; i >= 0; i -= EVAL_CHAINS) {
+        for (r = 0; r < EVAL_CHAINS; ++r) {
+            ar[r] = ar[r] * y + c[i + r].real;
+            ai[r] = ai[r] * y + c[i + r].imag;
         }
-        poly_free(R);
-        *R = T;
     }
-    return 1;
+    for (r = EVAL_CHAINS - 2, tr = ar[EVAL_CHAINS - 1], ti = ai[EVAL_CHAINS - 1]; r >= 0; --r) {
+        tr = tr * x + ar[r];
+        ti = ti * x + ai[r];
+    }
+    return (Complex){tr, ti};
 }
 
-int
-poly_derive(Polynomial *A, unsigned int n, Polynomial *R)
+Complex
+poly_eval_real(Polynomial *P, double x)
 {
-    if (!poly_init(R, MAX(-1, A->deg - (int)n))) {
-        return 0;
+    double re = 0., im = 0.;
+    int i;
+    if (P->deg >= EVAL_SPLIT_CUTOFF) {
+        return _eval_real_split(P->coef, P->deg, x);
     }
-    int i, j, multiplier;
-    for (i = 0; i <= R->deg; ++i) {
-        multiplier = 1;
-        for (j = i; j < i + (int)n; ++j) multiplier *= j + 1;
-        _poly_set_coef(R, i, complex_mult((Complex){(double)multiplier, 0}, A->coef[j]));
+    for (i = P->deg; i >= 0; --i) {
+        re = re * x + P->coef[i].real;
+        im = im * x + P->coef[i].imag;
     }
-    return 1;
+    return (Complex){re, im};
 }
 
+/* Evaluators: the coefficients are stored once in the order read by the
+ * split Horner chains, as separate real and imaginary rows of EVAL_CHAINS
+ * doubles, highest degree first. Real polynomials only keep the real
+ * parts and are evaluated at real points without complex arithmetic. */
 int
-poly_integrate(Polynomial *A, unsigned int n, Polynomial *R)
+poly_evaluator_init(Polynomial *P, PolyEvaluator *E)
 {
-    if (!poly_init(R, (A->deg == -1) ? -1 : A->deg + (int)n)) {
+    int i, rows = P->deg / EVAL_CHAINS + 1;
+    E->deg = P->deg;
+    E->rows = rows;
+    E->real = 1;
+    for (i = 0; i <= P->deg; ++i) {
+        if (P->coef[i].imag != 0.) E->real = 0;
+    }
+    E->re = poly_mem_calloc((size_t)rows * EVAL_CHAINS * (E->real ? 1 : 2), sizeof(double));
+    if (E->re == NULL) {
         return 0;
     }
-    int i, j, divisor;
-    for (i = n; i <= R->deg; ++i) {
-        divisor = 1;
-        for (j = i; j > i - (int)n; --j) divisor *= j;
-        _poly_set_coef(R, i, complex_div(A->coef[j], (Complex){(double)divisor, 0}));
+    E->im = E->real ? NULL : E->re + (size_t)rows * EVAL_CHAINS;
+    for (i = 0; i <= P->deg; ++i) {
+        size_t k = (size_t)(rows - 1 - i / EVAL_CHAINS) * EVAL_CHAINS + i % EVAL_CHAINS;
+        E->re[k] = P->coef[i].real;
+        if (!E->real) E->im[k] = P->coef[i].imag;
     }
     return 1;
 }
 
-/* Euclidean division of A by B.
- * If B is not zero, the resulting polynomials Q and R are defined by:
- *      A = B * Q + R, deg R < deg B
- * If B is zero, the operation is undefined and returns -1.
- */
-int
-poly_div(Polynomial *A, Polynomial *B, Polynomial *Q, Polynomial *R)
+size_t
+poly_evaluator_sizeof(const PolyEvaluator *E)
 {
-    if (B->deg == -1) {
-        return -1;  // Division by zero
+    return (E->re == NULL) ? 0 : (size_t)E->rows * EVAL_CHAINS * (E->real ? 1 : 2) * sizeof(double);
+}
+
+void
+poly_evaluator_free(PolyEvaluator *E)
+{
+    poly_mem_free(E->re, poly_evaluator_sizeof(E));
+    E->re = E->im = NULL;
+}
+
+static double
+_evaluator_real(const PolyEvaluator *E, double x)
+{
+    const double *restrict c = E->re;
+    double a[EVAL_CHAINS] = {0}, y = (x * x) * (x * x), t;
+    int j, r;
+    for (j = 0; j < E->rows; ++j) {
+        for (r = 0; r < EVAL_CHAINS; ++r) {
+            a[r] = a[r] * y + c[j * EVAL_CHAINS + r];
+        }
     }
-    Complex B_leadcoef = Poly_LeadCoef(B);
-    Polynomial T1, T2;  // Used as buffers
+    for (r = EVAL_CHAINS - 2, t = a[EVAL_CHAINS - 1]; r >= 0; --r) {
+        t = t * x + a[r];
+    }
+    return t;
+}
 
-    /* Polynomials coefficients MUST be initialized. */
-    if (Q != NULL) {
-        poly_init(Q, -1);
+Complex
+poly_evaluator_eval(const PolyEvaluator *E, Complex x)
+{
+    const double *restrict cr = E->re, *restrict ci = E->im;
+    double ar[EVAL_CHAINS] = {0}, ai[EVAL_CHAINS] = {0}, tr, ti, yr, yi;
+    int j, r;
+    if (E->deg == -1) {
+        return CZero;
     }
-    poly_init(R, -1);
-    poly_init(&T1, -1);
-    poly_init(&T2, -1);
+    if (E->real && x.imag == 0.) {
+        return (Complex){_evaluator_real(E, x.real), 0.};
+    }
+    yr = x.real * x.real - x.imag * x.imag;
+    yi = 2. * x.real * x.imag;
+    tr = yr * yr - yi * yi;
+    yi = 2. * yr * yi;
+    yr = tr;
+    for (j = 0; j < E->rows; ++j) {
+        for (r = 0; r < EVAL_CHAINS; ++r) {
+            tr = ar[r] * yr - ai[r] * yi + cr[j * EVAL_CHAINS + r];
+            ai[r] = ar[r] * yi + ai[r] * yr + (ci ? ci[j * EVAL_CHAINS + r] : 0.);
+            ar[r] = tr;
+        }
+    }
+    for (r = EVAL_CHAINS - 2, tr = ar[EVAL_CHAINS - 1], ti = ai[EVAL_CHAINS - 1]; r >= 0; --r) {
+        yr = tr * x.real - ti * x.imag + ar[r];
+        ti = tr * x.imag + ti * x.real + ai[r];
+        tr = yr;
+    }
+    return (Complex){tr, ti};
+}
 
-    if (Q != NULL && !poly_init(Q, A->deg)) goto error;
-    if (!poly_copy(A, R)) goto error;
+/* Real points are evaluated by batches of EVAL_BATCH, see simd_eval_batch */
+#define EVAL_BATCH  SIMD_EVAL_BATCH
 
-    while (R->deg - B->deg >= 0) {
-        if (!poly_init(&T1, R->deg - B->deg)) goto error;
-        _poly_set_coef(&T1, R->deg - B->deg,
-                      complex_div(Poly_LeadCoef(R), B_leadcoef));
+typedef struct {
+    const PolyEvaluator *E;
+    const Complex *xs;
+    Complex *ys;
+    int n;
+} EvalBatch;
 
-        if (Q != NULL) {
-            if (!poly_add(Q, &T1, &T2)) goto error;
-            poly_free(Q);
-            if (!poly_copy(&T2, Q)) goto error;
-            poly_free(&T2);
+static void
+_evaluator_chunk(void *ctx, int start, int end)
+{
+    EvalBatch *B = ctx;
+    double x[EVAL_BATCH], y[EVAL_BATCH];
+    int i, p, count, real;
+    for (i = start * EVAL_BATCH; i < end * EVAL_BATCH && i < B->n; i += EVAL_BATCH) {
+        if ((i - start * EVAL_BATCH) % (64 * EVAL_BATCH) == 0 && poly_cancelled()) {
+            return;
+        }
+        count = MIN(EVAL_BATCH, B->n - i);
+        for (p = 0, real = B->E->real; p < count; ++p) {
+            if (B->xs[i + p].imag != 0.) real = 0;
+        }
+        if (!real) {
+            for (p = 0; p < count; ++p) {
+                B->ys[i + p] = poly_evaluator_eval(B->E, B->xs[i + p]);
+            }
+            continue;
         }
+        for (p = 0; p < EVAL_BATCH; ++p) {
+            x[p] = (p < count) ? B->xs[i + p].real : 0.;
+        }
+        simd_eval_batch(B->E->re, B->E->rows, x, y);
+        for (p = 0; p < count; ++p) {
+            B->ys[i + p] = (Complex){y[p], 0.};
+        }
+    }
+}
 
-        if (!poly_multiply(&T1, B, &T2)) goto error;
-        poly_free(&T1);
-        if (!poly_sub(R, &T2, &T1)) goto error;
-        poly_free(&T2);
-        poly_free(R);
-        if(!poly_copy(&T1, R)) goto error;
-        poly_free(&T1);
+void
+poly_evaluator_eval_many(const PolyEvaluator *E, const Complex *xs, Complex *ys, int n)
+{
+    EvalBatch B = {E, xs, ys, n};
+    int i, batches = (n + EVAL_BATCH - 1) / EVAL_BATCH;
+    if (E->deg == -1) {
+        for (i = 0; i < n; ++i) ys[i] = CZero;
+    } else if ((double)n * E->deg < (1 << 20)) {
+        _evaluator_chunk(&B, 0, batches);
+    } else {
+        poly_parallel_for(_evaluator_chunk, &B, batches, 16);
+    }
+}
+
+/* Recompute the degree and the bloom filter of P after its coefficients
+ * were written directly. */
+static void
+_poly_normalize(Polynomial *P)
+{
+    int i;
+    Poly_ResizeDown(P);
+    P->bloom = 0;
+    for (i = 0; i <= P->deg; ++i) {
+        P->bloom |= Poly_BloomMask(i) * (uint32_t)!complex_iszero(P->coef[i]);
+    }
+}
+
+/* Make P a view on "coef", holding deg + 1 coefficients: P does not own them
+ * and must not be freed nor resized. */
+void
+poly_view(Polynomial *P, Complex *coef, int deg)
+{
+    P->coef = coef;
+    P->buf = NULL;
+    P->deg = deg;
+    _poly_normalize(P);
+}
+
+/* R = sum A[start + k * step] X**k for k < n, the indices being those of
+ * coefficients of A (step may be negative). */
+int
+poly_slice(Polynomial *A, int start, int step, int n, Polynomial *R)
+{
+    int k;
+    if (!poly_init(R, n - 1)) {
+        return 0;
+    }
+    if (step == 1) {
+        if (n > 0) memcpy(R->coef, A->coef + start, n * sizeof(Complex));
+    } else {
+        for (k = 0; k < n; ++k) {
+            R->coef[k] = A->coef[start + k * step];
+        }
     }
+    _poly_normalize(R);
     return 1;
-error:
-    if (Q != NULL) poly_free(Q);
-    poly_free(R);
-    poly_free(&T1);
-    poly_free(&T2);
-    return 0;
 }
 
-/* Greatest Common Divisor of A and B.
- *
- * Computes the polynomial of highest degree which divides both A and B.
- * We add the condition that its leading coefficient should be 1 in order
- * to have a uniquely defined GCD.
+/* Sets the coefficients start + k * step of P to values[k] for k < n, P
+ * being extended when the indices go past its degree. The indices must not
+ * be negative. */
+int
+poly_set_slice(Polynomial *P, int start, int step, const Complex *values, int n)
+{
+    int k, last = start + (n - 1) * step, top = MAX(start, last);
+    if (n <= 0) {
+        return 1;
+    }
+    if (top > P->deg ? !poly_realloc(P, top) : !poly_unshare(P)) {
+        return 0;
+    }
+    if (step == 1) {
+        memcpy(P->coef + start, values, n * sizeof(Complex));
+    } else {
+        for (k = 0; k < n; ++k) {
+            P->coef[start + k * step] = values[k];
+        }
+    }
+    for (k = 0; k < n; ++k) {
+        P->bloom |= Poly_BloomMask(start + k * step) * (uint32_t)!complex_iszero(values[k]);
+    }
+    Poly_ResizeDown(P);
+    return 1;
+}
+
+/**
+ * Small degree kernels
+ * Additions and products of polynomials of degree < SMALL_KERNEL_SIZE are
+ * dominated by the loop control and the bloom checks of the generic code.
+ * The kernels below are fully unrolled by the preprocessor for each number
+ * of coefficients, and picked through jump tables indexed by that number.
+ */
+#define SMALL_KERNEL_SIZE   17
+
+#define REP_1(M)    M(0)
+#define REP_2(M)    REP_1(M) M(1)
+#define REP_3(M)    REP_2(M) M(2)
+#define REP_4(M)    REP_3(M) M(3)
+#define REP_5(M)    REP_4(M) M(4)
+#define REP_6(M)    REP_5(M) M(5)
+#define REP_7(M)    REP_6(M) M(6)
+#define REP_8(M)    REP_7(M) M(7)
+#define REP_9(M)    REP_8(M) M(8)
+#define REP_10(M)   REP_9(M) M(9)
+#define REP_11(M)   REP_10(M) M(10)
+#define REP_12(M)   REP_11(M) M(11)
+#define REP_13(M)   REP_12(M) M(12)
+#define REP_14(M)   REP_13(M) M(13)
+#define REP_15(M)   REP_14(M) M(14)
+#define REP_16(M)   REP_15(M) M(15)
+#define REP_17(M)   REP_16(M) M(16)
+
+#define SMALL_ADD_TERM(i)                                                   \
+    r[i].real = a[i].real + b[i].real;                                      \
+    r[i].imag = a[i].imag + b[i].imag;
+#define SMALL_SUB_TERM(i)                                                   \
+    r[i].real = a[i].real - b[i].real;                                      \
+    r[i].imag = a[i].imag - b[i].imag;
+/* r[i + j] += s[i] * u[j] */
+#define SMALL_MUL_TERM(i)                                                   \
+    r[i].real += s[i].real * ur - s[i].imag * ui;                           \
+    r[i].imag += s[i].real * ui + s[i].imag * ur;
+
+/* Multiplication kernels: s has n coefficients, u has "nu" and r must be
+ * zeroed. The rows are accumulated by increasing index of s when "rev" is 0,
+ * and of u otherwise, so that results match the generic loops bit for bit
+ * for finite coefficients. Zero coefficients are multiplied through, which
+ * gives NaNs next to infinite ones: poly_multiply does not use the kernels
+ * for those. */
+#define DEFINE_SMALL_KERNELS(n)                                             \
+static void                                                                 \
+_small_add_##n(const Complex *a, const Complex *b, Complex *r)              \
+{                                                                           \
+    REP_##n(SMALL_ADD_TERM)                                                 \
+}                                                                           \
+static void                                                                 \
+_small_sub_##n(const Complex *a, const Complex *b, Complex *r)              \
+{                                                                           \
+    REP_##n(SMALL_SUB_TERM)                                                 \
+}                                                                           \
+static void                                                                 \
+_small_mul_##n(const Complex *s, const Complex *u, int nu, int rev,         \
+               Complex *out)                                                \
+{                                                                           \
+    int t, j;                                                               \
+    double ur, ui;                                                          \
+    Complex *r;                                                             \
+    for (t = 0; t < nu; ++t) {                                              \
+        j = rev ? nu - 1 - t : t;                                           \
+        ur = u[j].real;                                                     \
+        ui = u[j].imag;                                                     \
+        r = out + j;                                                        \
+        REP_##n(SMALL_MUL_TERM)                                             \
+    }                                                                       \
+}
+
+DEFINE_SMALL_KERNELS(1)
+DEFINE_SMALL_KERNELS(2)
+DEFINE_SMALL_KERNELS(3)
+DEFINE_SMALL_KERNELS(4)
+DEFINE_SMALL_KERNELS(5)
+DEFINE_SMALL_KERNELS(6)
+DEFINE_SMALL_KERNELS(7)
+DEFINE_SMALL_KERNELS(8)
+DEFINE_SMALL_KERNELS(9)
+DEFINE_SMALL_KERNELS(10)
+DEFINE_SMALL_KERNELS(11)
+DEFINE_SMALL_KERNELS(12)
+DEFINE_SMALL_KERNELS(13)
+DEFINE_SMALL_KERNELS(14)
+DEFINE_SMALL_KERNELS(15)
+DEFINE_SMALL_KERNELS(16)
+DEFINE_SMALL_KERNELS(17)
+
+#define SMALL_TABLE(prefix)                                                 \
+    { NULL, prefix##1, prefix##2, prefix##3, prefix##4, prefix##5,          \
+      prefix##6, prefix##7, prefix##8, prefix##9, prefix##10, prefix##11,  \
+      prefix##12, prefix##13, prefix##14, prefix##15, prefix##16, prefix##17 }
+
+typedef void (*small_addfunc)(const Complex*, const Complex*, Complex*);
+typedef void (*small_mulfunc)(const Complex*, const Complex*, int, int, Complex*);
+
+static const small_addfunc small_add[SMALL_KERNEL_SIZE + 1] = SMALL_TABLE(_small_add_);
+static const small_addfunc small_sub[SMALL_KERNEL_SIZE + 1] = SMALL_TABLE(_small_sub_);
+static const small_mulfunc small_mul[SMALL_KERNEL_SIZE + 1] = SMALL_TABLE(_small_mul_);
+
+/* R = A + B or A - B, when both degrees are < SMALL_KERNEL_SIZE */
+static int
+_small_add_sub(Polynomial *A, Polynomial *B, Polynomial *R, int sub)
+{
+    int i, n = MIN(A->deg, B->deg) + 1;
+    if (!poly_init(R, MAX(A->deg, B->deg))) {
+        return 0;
+    }
+    if (n > 0) {
+        (sub ? small_sub : small_add)[n](A->coef, B->coef, R->coef);
+    }
+    if (A->deg >= n) {
+        memcpy(R->coef + n, A->coef + n, (A->deg + 1 - n) * sizeof(Complex));
+    } else if (!sub) {
+        memcpy(R->coef + n, B->coef + n, (B->deg + 1 - n) * sizeof(Complex));
+    } else {
+        for (i = n; i <= B->deg; ++i) {
+            R->coef[i] = complex_neg(B->coef[i]);
+        }
+    }
+    _poly_normalize(R);
+    return 1;
+}
+
+/**
+ * Polynomial operators
+ * We use the following naming convention:
+ *  A, B, C, ... for the operators parameters
+ *  P, Q, R, ... for the result destination
  *
- * The algorithm is basically :
- *   # deg A >= deg B
- *   While B != 0
- *       A, B <= B, A % B   # Invariant: PGCD(A, B)
- *   P = A
+ * The operators should assume the destination polynomials were NOT initiliazed.
+ * It is up to the operators to perform this initialization when relevant.
  */
+
+/* Copy polynomial pointed by A to the location pointed by P.
+ * The coefficients are shared with A (see poly_unshare), only those of views
+ * are duplicated. */
 int
-poly_gcd(Polynomial *A, Polynomial *B, Polynomial *P)
+poly_copy(Polynomial *A, Polynomial *P)
 {
-    Polynomial R, T;
-    poly_init(P, -1);
-    poly_init(&R, -1);
-    poly_init(&T, -1);
+    if (A->deg == -1) {
+        /* Zero polynomials may still hold a buffer, which is not shared */
+        return poly_init(P, -1);
+    }
+    if (A->buf != NULL) {
+        BUFFER_INCREF(A->buf);
+        *P = *A;
+        return 1;
+    }
+    if (!poly_init(P, A->deg)) {
+        return 0;
+    }
+    if (A->deg >= 0) {
+        memcpy(P->coef, A->coef, (A->deg + 1) * sizeof(Complex));
+    }
+    P->bloom = A->bloom;
+    return 1;
+}
 
-    if (A->deg >= B->deg) {
-        if (!poly_copy(A, P)) goto error;
-        if (!poly_copy(B, &R)) goto error;
-    } else {
-        if (!poly_copy(B, P)) goto error;
-        if (!poly_copy(A, &R)) goto error;
+int
+poly_add(Polynomial *A, Polynomial *B, Polynomial *R)
+{
+    if (MAX(A->deg, B->deg) < SMALL_KERNEL_SIZE) {
+        return _small_add_sub(A, B, R, 0);
     }
-    while (R.deg != -1) {
-        if (!poly_copy(P, &T)) goto error;
-        poly_free(P);
-        if (!poly_copy(&R, P)) goto error;
-        poly_free(&R);
-        if (!poly_div(&T, P, NULL, &R)) goto error;
-        poly_free(&T);
+    if (!poly_init(R, MAX(A->deg, B->deg))) {
+        return 0;
+    }
+    int i;
+    for (i = 0; i <= MAX(A->deg, B->deg); ++i) {
+        _poly_set_coef(R, i, complex_add(Poly_GetCoef(A, i), Poly_GetCoef(B, i)));
     }
+    Poly_ResizeDown(R);
+    return 1;
+}
 
-    // Result normalization - could be faster.
-    Complex factor = complex_div((Complex){1, 0}, Poly_LeadCoef(P));
-    if (!poly_copy(P, &T)) goto error;
-    poly_free(P);
-    if (!poly_scal_multiply(&T, factor, P)) goto error;
-    poly_free(&T);
+int
+poly_sub(Polynomial *A, Polynomial *B, Polynomial *R)
+{
+    if (MAX(A->deg, B->deg) < SMALL_KERNEL_SIZE) {
+        return _small_add_sub(A, B, R, 1);
+    }
+    if (!poly_init(R, MAX(A->deg, B->deg))) {
+        return 0;
+    }
+    int i;
+    for (i = 0; i <= MAX(A->deg, B->deg); ++i) {
+        _poly_set_coef(R, i, complex_sub(Poly_GetCoef(A, i), Poly_GetCoef(B, i)));
+    }
+    Poly_ResizeDown(R);
+    return 1;
+}
+
+int
+poly_neg(Polynomial *A, Polynomial *Q)
+{
+    if (!poly_init(Q, A->deg)) {
+        return 0;
+    }
+    int i;
+    for (i = 0; i <= A->deg; ++i) {
+        _poly_set_coef(Q, i, complex_neg(A->coef[i]));
+    }
+    return 1;
+}
+
+int
+poly_scal_multiply(Polynomial *A, Complex c, Polynomial *R)
+{
+    if (complex_iszero(c)) {
+        poly_init(R, -1);
+        return 1;
+    }
+    if (!poly_init(R, A->deg)) {
+        return 0;
+    }
+    int i;
+    for (i = 0; i <= A->deg; ++i) {
+        if (A->bloom & Poly_BloomMask(i)) {
+            _poly_set_coef(R, i, complex_mult(Poly_GetCoef(A, i), c));
+        }
+    }
+    return 1;
+}
+
+/* R = sum(cs[i] * Ps[i], 0 <= i < n) + sum(ms[j] * X**ks[j], 0 <= j < m),
+ * each polynomial term being accumulated into R in a single pass over its
+ * coefficients. */
+int
+poly_linear_combination(Polynomial **Ps, const Complex *cs, int n,
+                        const Complex *ms, const int *ks, int m, Polynomial *R)
+{
+    int i, k, deg = -1;
+    Complex *r;
+    for (i = 0; i < n; ++i) {
+        deg = MAX(deg, Ps[i]->deg);
+    }
+    for (i = 0; i < m; ++i) {
+        deg = MAX(deg, ks[i]);
+    }
+    if (!poly_init(R, deg)) {
+        return 0;
+    }
+    r = R->coef;
+    for (i = 0; i < n; ++i) {
+        const Complex *a = Ps[i]->coef, x = cs[i];
+        if (x.real == 1. && x.imag == 0.) {
+            for (k = 0; k <= Ps[i]->deg; ++k) {
+                r[k].real += a[k].real;
+                r[k].imag += a[k].imag;
+            }
+        } else {
+            for (k = 0; k <= Ps[i]->deg; ++k) {
+                r[k].real += a[k].real * x.real - a[k].imag * x.imag;
+                r[k].imag += a[k].real * x.imag + a[k].imag * x.real;
+            }
+        }
+    }
+    for (i = 0; i < m; ++i) {
+        r[ks[i]].real += ms[i].real;
+        r[ks[i]].imag += ms[i].imag;
+    }
+    if (deg != -1) {
+        _poly_normalize(R);
+    }
+    return 1;
+}
+
+/* Check whether A is a monomial c * X**A->deg: the bloom filter settles it
+ * without reading the coefficients in most cases. */
+static int
+_poly_is_monomial(Polynomial *A)
+{
+    int i;
+    if (A->deg == -1 || A->bloom != (uint32_t)Poly_BloomMask(A->deg)) {
+        return 0;
+    }
+    for (i = A->deg - 32; i >= 0; i -= 32) {
+        if (!complex_iszero(A->coef[i])) return 0;
+    }
+    return 1;
+}
+
+/* If A is a monomial c * X**k, stores c**n into "c" and returns k * n, the
+ * degree of A**n. Returns -1 otherwise. */
+int
+poly_monomial_pow(Polynomial *A, unsigned int n, Complex *c)
+{
+    Complex x, p = COne;
+    unsigned int m;
+    if (!_poly_is_monomial(A)) {
+        return -1;
+    }
+    if (n == 1) {
+        *c = A->coef[A->deg];
+        return A->deg;
+    }
+    /* Inlined products: lazy sums of powers of X depend on this loop */
+    for (x = A->coef[A->deg], m = n; m > 0; m >>= 1) {
+        if (m & 1) {
+            p = (Complex){p.real * x.real - p.imag * x.imag,
+                          p.real * x.imag + p.imag * x.real};
+        }
+        x = (Complex){x.real * x.real - x.imag * x.imag, 2. * x.real * x.imag};
+    }
+    *c = p;
+    return A->deg * (int)n;
+}
+
+/* R = c * X**k * A */
+static int
+_poly_monomial_multiply(Polynomial *A, Complex c, int k, Polynomial *R)
+{
+    int i;
+    if (!poly_init(R, A->deg + k)) {
+        return 0;
+    }
+    for (i = 0; i <= A->deg; ++i) {
+        if (complex_iszero(A->coef[i])) continue;
+        R->coef[i + k].real = A->coef[i].real * c.real - A->coef[i].imag * c.imag;
+        R->coef[i + k].imag = A->coef[i].real * c.imag + A->coef[i].imag * c.real;
+    }
+    _poly_normalize(R);
+    return 1;
+}
+
+/* Multiplication kernel working on raw coefficient arrays.
+ * Computes the na + nb - 1 coefficients of a * b into r, using the
+ * schoolbook method for small sizes and Karatsuba's method otherwise.
+ * "w" is a scratch area of at least MUL_WORKSPACE(min(na, nb)) Complex,
+ * so that callers can preallocate all the memory they need at once.
+ * r must not overlap a, b or w.
+ * Products of operands from CANCEL_CHECK_SIZE coefficients give up early when
+ * the background job running them is cancelled (see poly_cancelled): the
+ * callers then discard r. */
+#define KARATSUBA_CUTOFF        32
+#define CANCEL_CHECK_SIZE       1024
+#define SIMD_CONVOLVE_CUTOFF    64
+#define MUL_WORKSPACE(n)        (10 * (size_t)(n) + 64)
+
+static void
+_mul_schoolbook(const Complex *a, int na, const Complex *b, int nb, Complex *r)
+{
+    int i, j;
+    Complex c;
+    if (na * nb >= SIMD_CONVOLVE_CUTOFF && simd_convolve(a, na, b, nb, r)) {
+        return;
+    }
+    memset(r, 0, (na + nb - 1) * sizeof(Complex));
+    for (i = 0; i < na; ++i) {
+        if (complex_iszero(a[i])) continue;
+        for (j = 0; j < nb; ++j) {
+            c = complex_mult(a[i], b[j]);
+            r[i + j].real += c.real;
+            r[i + j].imag += c.imag;
+        }
+    }
+}
+
+/* Karatsuba multiplication of two arrays of n coefficients */
+static void
+_mul_karatsuba(const Complex *a, const Complex *b, int n, Complex *r, Complex *w)
+{
+    if (n < KARATSUBA_CUTOFF) {
+        _mul_schoolbook(a, n, b, n, r);
+        return;
+    }
+    if (n >= CANCEL_CHECK_SIZE && poly_cancelled()) {
+        return;
+    }
+    int i, m = n / 2, h = n - m;
+    Complex *sa = w, *sb = w + h, *t = w + 2 * h;
+
+    /* r = a0 * b0 + X**(2m) * a1 * b1 */
+    _mul_karatsuba(a, b, m, r, w);
+    r[2 * m - 1] = CZero;
+    _mul_karatsuba(a + m, b + m, h, r + 2 * m, w);
+
+    /* t = (a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1 */
+    for (i = 0; i < h; ++i) {
+        sa[i] = (i < m) ? complex_add(a[i], a[m + i]) : a[m + i];
+        sb[i] = (i < m) ? complex_add(b[i], b[m + i]) : b[m + i];
+    }
+    _mul_karatsuba(sa, sb, h, t, t + 2 * h - 1);
+    for (i = 0; i < 2 * m - 1; ++i) {
+        t[i] = complex_sub(t[i], r[i]);
+    }
+    for (i = 0; i < 2 * h - 1; ++i) {
+        t[i] = complex_sub(t[i], r[2 * m + i]);
+    }
+    for (i = 0; i < 2 * h - 1; ++i) {
+        r[m + i] = complex_add(r[m + i], t[i]);
+    }
+}
+
+static void
+_poly_mul_kernel(const Complex *a, int na, const Complex *b, int nb,
+                 Complex *r, Complex *w)
+{
+    if (na > nb) {
+        const Complex *t = a;
+        int nt = na;
+        a = b; na = nb;
+        b = t; nb = nt;
+    }
+    if (na < KARATSUBA_CUTOFF) {
+        _mul_schoolbook(a, na, b, nb, r);
+    } else if (na == nb) {
+        _mul_karatsuba(a, b, na, r, w);
+    } else {
+        /* Unbalanced operands: multiply a by slices of b */
+        int i, off, len;
+        memset(r, 0, (na + nb - 1) * sizeof(Complex));
+        for (off = 0; off < nb; off += na) {
+            len = (nb - off < na) ? nb - off : na;
+            _poly_mul_kernel(a, na, b + off, len, w, w + na + len - 1);
+            for (i = 0; i < na + len - 1; ++i) {
+                r[off + i] = complex_add(r[off + i], w[i]);
+            }
+        }
+    }
+}
+
+static int
+_poly_is_finite(Polynomial *A)
+{
+    int i;
+    for (i = 0; i <= A->deg; ++i) {
+        if (!isfinite(A->coef[i].real) || !isfinite(A->coef[i].imag)) return 0;
+    }
+    return 1;
+}
+
+int
+poly_multiply(Polynomial *A, Polynomial *B, Polynomial *R)
+{
+    if (A->deg == -1 || B->deg == -1) {
+        poly_init(R, -1);
+        return 1;
+    }
+    if (!_poly_is_finite(A) || !_poly_is_finite(B)) {
+        /* Only the products of nonzero coefficients are accumulated: the
+         * kernels and shortcuts would spread inf * 0 = NaN everywhere */
+        int i, j;
+        if (!poly_init(R, A->deg + B->deg)) {
+            return 0;
+        }
+        for (i = 0; i <= A->deg; ++i) {
+            if (complex_iszero(A->coef[i])) continue;
+            for (j = 0; j <= B->deg; ++j) {
+                if (complex_iszero(B->coef[j])) continue;
+                _poly_incr_coef(R, i + j, complex_mult(A->coef[i], B->coef[j]));
+            }
+        }
+        _poly_normalize(R);
+        return 1;
+    }
+    if (B->deg > SMALL_KERNEL_SIZE && _poly_is_monomial(B)) {
+        return _poly_monomial_multiply(A, B->coef[B->deg], B->deg, R);
+    }
+    if (A->deg > SMALL_KERNEL_SIZE && _poly_is_monomial(A)) {
+        return _poly_monomial_multiply(B, A->coef[A->deg], A->deg, R);
+    }
+    if (!poly_init(R, A->deg + B->deg)) {
+        return 0;
+    }
+    if (MIN(A->deg, B->deg) >= SMALL_KERNEL_SIZE) {
+        size_t size = MUL_WORKSPACE(MIN(A->deg, B->deg) + 1);
+        Complex *w = poly_mem_calloc(size, sizeof(Complex));
+        if (w == NULL) {
+            poly_free(R);
+            return 0;
+        }
+        _poly_mul_kernel(A->coef, A->deg + 1, B->coef, B->deg + 1, R->coef, w);
+        poly_mem_free(w, size * sizeof(Complex));
+        if (poly_cancelled()) {
+            poly_free(R);
+            return 0;
+        }
+        _poly_normalize(R);
+        return 1;
+    }
+    if (B->deg < SMALL_KERNEL_SIZE) {
+        small_mul[B->deg + 1](B->coef, A->coef, A->deg + 1, 0, R->coef);
+        _poly_normalize(R);
+        return 1;
+    }
+    small_mul[A->deg + 1](A->coef, B->coef, B->deg + 1, 1, R->coef);
+    _poly_normalize(R);
+    return 1;
+}
+
+int
+poly_pow(Polynomial *A, unsigned int n, Polynomial *R)
+{
+    if (n == 0) {
+        int failure = 0;
+        Poly_InitConst(R, ((Complex){1, 0}), failure);
+        return !failure;
+    }
+    if (n == 1) {
+        return poly_copy(A, R);
+    }
+    Complex c;
+    int k = poly_monomial_pow(A, n, &c);
+    if (k != -1) {
+        if (!poly_init(R, k)) {
+            return 0;
+        }
+        poly_set_coef(R, k, c);
+        return 1;
+    }
+    Polynomial T;
+    if (poly_cancelled()) return 0;
+    if (!poly_multiply(A, A, &T)) return 0;
+    if (!poly_pow(&T, n >> 1, R)) {
+        poly_free(&T);
+        return 0;
+    }
+    poly_free(&T);
+    if (n & 1) {
+        if (!poly_multiply(R, A, &T)) {
+            poly_free(R);
+            return 0;
+        }
+        poly_free(R);
+        *R = T;
+    }
+    return 1;
+}
+
+/* The factors (i + 1) * ... * (i + n) of the derivatives, and i * ... *
+ * (i - n + 1) of the integrals, are updated from one coefficient to the
+ * next. They are divided by their lowest term before being multiplied by
+ * the new one, so that they are exact as long as they stay below 2**53 and
+ * only overflow if the factor itself does. The zero coefficients are
+ * skipped, the infinite factors would turn them into NaN. */
+int
+poly_derive(Polynomial *A, unsigned int n, Polynomial *R)
+{
+    if (n == 0) {
+        return poly_copy(A, R);
+    }
+    if (!poly_init(R, MAX(-1, A->deg - (int)n))) {
+        return 0;
+    }
+    int i;
+    double factor = 1.;
+    Complex a;
+    if (R->deg >= 0) {
+        for (i = 2; i <= (int)n; ++i) factor *= i;
+    }
+    for (i = 0; i <= R->deg; ++i) {
+        a = A->coef[i + n];
+        _poly_set_coef(R, i, ((Complex){(a.real == 0.) ? 0. : factor * a.real,
+                                        (a.imag == 0.) ? 0. : factor * a.imag}));
+        factor = factor / (i + 1) * (i + n + 1);
+    }
+    return 1;
+}
+
+int
+poly_integrate(Polynomial *A, unsigned int n, Polynomial *R)
+{
+    if (n == 0) {
+        return poly_copy(A, R);
+    }
+    if (!poly_init(R, (A->deg == -1) ? -1 : A->deg + (int)n)) {
+        return 0;
+    }
+    int i;
+    double divisor = 1.;
+    if (R->deg >= 0) {
+        for (i = 2; i <= (int)n; ++i) divisor *= i;
+    }
+    for (i = n; i <= R->deg; ++i) {
+        _poly_set_coef(R, i, complex_div(A->coef[i - n], (Complex){divisor, 0}));
+        divisor = divisor / (i + 1 - n) * (i + 1);
+    }
+    return 1;
+}
+
+/* Classical orthogonal polynomials, with their three-term recurrences
+ *      P_{n+1} = c_n * (a_n * X * P_n - b_n * P_{n-1})
+ * given U = P_{n-1} and V = P_n. The operations are those of the
+ * Polynomial expressions, in the same order, so that the results agree
+ * to the last bit. */
+int
+poly_orthogonal_next(OrthogonalFamily family, int n, Polynomial *U, Polynomial *V,
+                     Polynomial *R)
+{
+    double a, b, c, x;
+    int k;
+    switch (family) {
+        case POLY_CHEBYSHEV:
+            a = 2.; b = 1.; c = 1.;
+            break;
+        case POLY_LEGENDRE:
+            a = 2. * n + 1.; b = n; c = 1. / (n + 1);
+            break;
+        default:    // POLY_HERMITE
+            a = 1.; b = n; c = 1.;
+    }
+    if (!poly_init(R, V->deg + 1)) {
+        return 0;
+    }
+    for (k = 0; k <= R->deg; ++k) {
+        x = (k > 0) ? a * Poly_GetCoef(V, k - 1).real : 0.;
+        R->coef[k].real = c * (x - b * Poly_GetCoef(U, k).real);
+    }
+    _poly_normalize(R);
+    return 1;
+}
+
+/* Cyclotomic polynomials.
+ * With r the product of the distinct primes dividing n,
+ * PHI_n(X) = PHI_r(X**(n/r)) and, for r > 1, the Moebius formula gives
+ *      PHI_r(X) = prod_{d|r} (1 - X**d)**mu(r/d)
+ * Each factor is applied as a sparse power series update, truncated after
+ * degree phi(r)/2 since the coefficients are symmetric. The integer
+ * arithmetic wraps modulo 2**64, which is exact as long as the final
+ * coefficients fit in 64 bits. */
+int
+poly_cyclotomic(int n, Polynomial *R)
+{
+    int primes[10], np = 0, r = 1, phi = 1, m = n, p, i, j, d, mask, bits, half, s;
+    uint64_t *c;
+    if (n == 1) {
+        if (!poly_init(R, 1)) {
+            return 0;
+        }
+        poly_set_coef(R, 0, (Complex){-1., 0.});
+        poly_set_coef(R, 1, COne);
+        return 1;
+    }
+    for (p = 2; p <= m / p; ++p) {
+        if (m % p == 0) {
+            primes[np++] = p;
+            r *= p;
+            phi *= p - 1;
+            while (m % p == 0) m /= p;
+        }
+    }
+    if (m > 1) {
+        primes[np++] = m;
+        r *= m;
+        phi *= m - 1;
+    }
+    half = phi / 2;
+    if ((c = poly_mem_calloc(half + 1, sizeof(uint64_t))) == NULL) {
+        return 0;
+    }
+    c[0] = 1;
+    for (mask = 0; mask < (1 << np); ++mask) {
+        for (d = r, bits = 0, i = 0; i < np; ++i) {
+            if ((mask >> i) & 1) {
+                d /= primes[i];
+                ++bits;
+            }
+        }
+        if (d > half) continue;
+        if (bits & 1) {     // mu(r/d) = -1: division by 1 - X**d
+            for (j = d; j <= half; ++j) c[j] += c[j - d];
+        } else {            // mu(r/d) = 1: multiplication by 1 - X**d
+            for (j = half; j >= d; --j) c[j] -= c[j - d];
+        }
+    }
+    s = n / r;
+    if (!poly_init(R, phi * s)) {
+        poly_mem_free(c, (half + 1) * sizeof(uint64_t));
+        return 0;
+    }
+    for (i = 0; i <= phi; ++i) {
+        R->coef[i * s].real = (double)(int64_t)c[MIN(i, phi - i)];
+    }
+    poly_mem_free(c, (half + 1) * sizeof(uint64_t));
+    _poly_normalize(R);
+    return 1;
+}
+
+/* Taylor shift: computes R(X) = A(X + a).
+ *
+ * Small polynomials are shifted in place with repeated synthetic divisions.
+ * Above SHIFT_CUTOFF coefficients, we split A = A0 + X**m * A1 (m being a
+ * power of two) so that:
+ *      A(X + a) = A0(X + a) + (X + a)**m * A1(X + a)
+ * where the powers (X + a)**(2**k) are computed once by squaring. Using the
+ * multiplication kernel, this costs O(M(n) log n) operations.
+ * All the temporary storage lives in a single workspace allocation.
+ */
+#define SHIFT_CUTOFF    64
+
+static void
+_shift_horner(Complex *c, int n, Complex a)
+{
+    int i, j;
+    for (i = 0; i < n - 1; ++i) {
+        for (j = n - 2; j >= i; --j) {
+            c[j] = complex_add(c[j], complex_mult(a, c[j + 1]));
+        }
+    }
+}
+
+/* powers[k] holds the 2**k + 1 coefficients of (X + a)**(2**k) */
+static void
+_shift_rec(Complex *c, int n, Complex **powers, Complex *w)
+{
+    if (n <= SHIFT_CUTOFF) {
+        _shift_horner(c, n, powers[0][0]);
+        return;
+    }
+    int i, k = 0;
+    while ((2 << k) < n) ++k;
+    int m = 1 << k;
+    _shift_rec(c, m, powers, w);
+    _shift_rec(c + m, n - m, powers, w);
+    /* The product has exactly n coefficients */
+    _poly_mul_kernel(powers[k], m + 1, c + m, n - m, w, w + n);
+    for (i = 0; i < m; ++i) {
+        c[i] = complex_add(c[i], w[i]);
+    }
+    memcpy(c + m, w + m, (n - m) * sizeof(Complex));
+}
+
+int
+poly_shift(Polynomial *A, Complex a, Polynomial *R)
+{
+    if (!poly_copy(A, R) || !poly_unshare(R)) {
+        poly_free(R);
+        return 0;
+    }
+    int n = A->deg + 1;
+    if (n <= SHIFT_CUTOFF) {
+        _shift_horner(R->coef, n, a);
+        _poly_normalize(R);
+        return 1;
+    }
+    /* Workspace: the powers (X + a)**(2**k), then a product buffer and the
+     * multiplication kernel scratch area. */
+    int k, levels = 0;
+    size_t size = 0;
+    while ((1 << levels) < n) {
+        size += (1 << levels) + 1;
+        ++levels;
+    }
+    Complex *powers[32];
+    size_t bytes = (size + n + MUL_WORKSPACE(n)) * sizeof(Complex);
+    Complex *w = poly_mem_calloc(1, bytes);
+    if (w == NULL) {
+        poly_free(R);
+        return 0;
+    }
+    powers[0] = w;
+    powers[0][0] = a;
+    powers[0][1] = COne;
+    for (k = 1; k < levels; ++k) {
+        powers[k] = powers[k - 1] + (1 << (k - 1)) + 1;
+        _poly_mul_kernel(powers[k - 1], (1 << (k - 1)) + 1,
+                         powers[k - 1], (1 << (k - 1)) + 1,
+                         powers[k], w + size + n);
+    }
+    _shift_rec(R->coef, n, powers, w + size);
+    poly_mem_free(w, bytes);
+    _poly_normalize(R);
+    return 1;
+}
+
+/* Degree above which poly_shift is used when half of the derivatives are
+ * needed */
+#define TAYLOR_SHIFT_DEGREE     1024
+
+/* The first m coefficients of A(X + a), computed in place in the n
+ * coefficients c of A by m passes of Horner's scheme */
+static void
+_taylor_passes(Complex *c, int n, Complex a, int m)
+{
+    int i, j;
+    for (i = 0; i < MIN(m, n - 1); ++i) {
+        for (j = n - 2; j >= i; --j) {
+            c[j].real += a.real * c[j + 1].real - a.imag * c[j + 1].imag;
+            c[j].imag += a.real * c[j + 1].imag + a.imag * c[j + 1].real;
+        }
+    }
+}
+
+/* Derivatives of A at a: ds[j] = A^(j)(a) for j <= k.
+ * They are j! times the coefficients of A(X + a), of which only the first
+ * k + 1 are computed by as many passes of Horner's scheme, in O(k deg A)
+ * operations. poly_shift is used when many of them are needed at a high
+ * degree. */
+int
+poly_taylor(Polynomial *A, Complex a, int k, Complex *ds)
+{
+    int j, n = A->deg + 1, m = MIN(k + 1, n);
+    double factor = 1.;
+    Polynomial S;
+    Complex *c;
+    for (j = MAX(m, 0); j <= k; ++j) {
+        ds[j] = CZero;
+    }
+    if (m <= 0) {
+        return 1;
+    }
+    if (n > TAYLOR_SHIFT_DEGREE && 2 * m > n) {
+        if (!poly_shift(A, a, &S)) {
+            return 0;
+        }
+        for (j = 0; j < m; ++j) {
+            ds[j] = Poly_GetCoef(&S, j);
+        }
+        poly_free(&S);
+    } else {
+        if ((c = poly_mem_calloc(n, sizeof(Complex))) == NULL) {
+            return 0;
+        }
+        memcpy(c, A->coef, n * sizeof(Complex));
+        _taylor_passes(c, n, a, m);
+        memcpy(ds, c, m * sizeof(Complex));
+        poly_mem_free(c, n * sizeof(Complex));
+    }
+    for (j = 2; j < m; ++j) {
+        factor *= j;
+        ds[j] = (Complex){factor * ds[j].real, factor * ds[j].imag};
+    }
+    return 1;
+}
+
+typedef struct {
+    Polynomial *A;
+    const Complex *xs;
+    int k;
+    Complex *ds;
+    int failed;
+} TaylorBatch;
+
+static void
+_taylor_chunk(void *ctx, int start, int end)
+{
+    TaylorBatch *B = ctx;
+    int i;
+    for (i = start; i < end; ++i) {
+        if (!poly_taylor(B->A, B->xs[i], B->k, B->ds + (size_t)i * (B->k + 1))) {
+            B->failed = 1;
+        }
+    }
+}
+
+/* poly_taylor at each of the n points xs, the derivatives at xs[i] being
+ * stored from ds[i * (k + 1)] */
+int
+poly_taylor_many(Polynomial *A, const Complex *xs, int n, int k, Complex *ds)
+{
+    TaylorBatch B = {A, xs, k, ds, 0};
+    if ((double)n * (A->deg + 1) * MIN(k + 1, A->deg + 1) < (1 << 20)) {
+        _taylor_chunk(&B, 0, n);
+    } else {
+        poly_parallel_for(_taylor_chunk, &B, n, 16);
+    }
+    return !B.failed;
+}
+
+/* Composition: computes R(X) = A(B(X)).
+ *
+ * Same divide and conquer approach as for the Taylor shift:
+ *      A(B) = A0(B) + B**m * A1(B)
+ * with B**(2**k) computed once by squaring, for a total cost of
+ * O(M(deg A * deg B) log deg A) operations.
+ */
+
+/* Scratch space needed by _compose_rec for n coefficients of A */
+static size_t
+_compose_workspace(int n, int db)
+{
+    if (n <= 1) {
+        return 0;
+    }
+    int k = 0;
+    while ((2 << k) < n) ++k;
+    int m = 1 << k;
+    size_t hi = (size_t)(n - m - 1) * db + 1, prod = (size_t)(n - 1) * db + 1;
+    size_t rec = _compose_workspace(m, db), rec_hi = _compose_workspace(n - m, db);
+    size_t mul = MUL_WORKSPACE(MIN(m * db + 1, (n - m - 1) * db + 1));
+    if (rec_hi > rec) rec = rec_hi;
+    if (mul > rec) rec = mul;
+    return hi + prod + rec;
+}
+
+/* Writes the (n - 1) * db + 1 coefficients of c(B) into out.
+ * powers[k] holds the 2**k * db + 1 coefficients of B**(2**k). */
+static void
+_compose_rec(const Complex *c, int n, Complex **powers, int db,
+             Complex *out, Complex *w)
+{
+    if (n == 1) {
+        out[0] = c[0];
+        return;
+    }
+    int i, k = 0;
+    while ((2 << k) < n) ++k;
+    int m = 1 << k;
+    int nlo = (m - 1) * db + 1, nhi = (n - m - 1) * db + 1, nout = (n - 1) * db + 1;
+    Complex *hi = w, *prod = w + nhi;
+
+    _compose_rec(c, m, powers, db, out, w);
+    for (i = nlo; i < nout; ++i) {
+        out[i] = CZero;
+    }
+    _compose_rec(c + m, n - m, powers, db, hi, prod);
+    _poly_mul_kernel(powers[k], m * db + 1, hi, nhi, prod, prod + nout);
+    for (i = 0; i < nout; ++i) {
+        out[i] = complex_add(out[i], prod[i]);
+    }
+}
+
+int
+poly_compose(Polynomial *A, Polynomial *B, Polynomial *R)
+{
+    if (B->deg <= 0 || A->deg <= 0) {
+        int failure = 0;
+        Poly_InitConst(R, poly_eval(A, Poly_GetCoef(B, 0)), failure);
+        return !failure;
+    }
+    int n = A->deg + 1, db = B->deg;
+    if (!poly_init(R, A->deg * db)) {
+        return 0;
+    }
+    int k, levels = 0;
+    size_t size = 0;
+    while ((1 << levels) < n) {
+        size += (size_t)(1 << levels) * db + 1;
+        ++levels;
+    }
+    Complex *powers[32];
+    size_t scratch = _compose_workspace(n, db);
+    size_t squaring = MUL_WORKSPACE((size_t)(n / 2) * db + 1);
+    size_t bytes = (size + (scratch > squaring ? scratch : squaring)) * sizeof(Complex);
+    Complex *w = poly_mem_calloc(1, bytes);
+    if (w == NULL) {
+        poly_free(R);
+        return 0;
+    }
+    powers[0] = w;
+    memcpy(powers[0], B->coef, (db + 1) * sizeof(Complex));
+    for (k = 1; k < levels; ++k) {
+        int len = (1 << (k - 1)) * db + 1;
+        powers[k] = powers[k - 1] + len;
+        _poly_mul_kernel(powers[k - 1], len, powers[k - 1], len,
+                         powers[k], w + size);
+    }
+    _compose_rec(A->coef, n, powers, db, R->coef, w + size);
+    poly_mem_free(w, bytes);
+    _poly_normalize(R);
+    return 1;
+}
+
+/* Division kernel working on raw coefficient arrays.
+ * Computes the quotient (na - nb + 1 coefficients, if q is not NULL) and
+ * the remainder (nb - 1 coefficients) of the division of a by b, na >= nb.
+ * Long division is used when either the divisor or the quotient is short.
+ * Otherwise the quotient is obtained from the reversed polynomials:
+ *      rev(q) = rev(a) / rev(b)  mod X**(na - nb + 1)
+ * where the inverse of the power series rev(b) is computed with Newton's
+ * iteration, so that the division costs O(M(n)) operations.
+ * "w" is a scratch area of at least DIV_WORKSPACE(na) Complex.
+ * Outputs must not overlap a, b or w. */
+#define NEWTON_DIV_CUTOFF       32
+#define DIV_WORKSPACE(n)        (8 * (size_t)(n) + MUL_WORKSPACE(n))
+
+/* Inverse of the power series f (nf coefficients, f[0] != 0) modulo X**k */
+static void
+_series_inverse(const Complex *f, int nf, Complex *g, int k, Complex *w)
+{
+    int i, len = 1, nl, lf;
+    g[0] = complex_div(COne, f[0]);
+    while (len < k) {
+        nl = (2 * len < k) ? 2 * len : k;
+        lf = (nf < nl) ? nf : nl;
+        /* t = f * g, of which coefficients len..nl-1 are the error terms
+         * (the first ones are 1, 0, 0, ...) */
+        Complex *t = w, *u = w + lf + len - 1;
+        _poly_mul_kernel(f, lf, g, len, t, u + 2 * nl);
+        for (i = len; i < nl; ++i) {
+            t[i] = (i < lf + len - 1) ? complex_neg(t[i]) : CZero;
+        }
+        /* g = g * (2 - f * g), only the new coefficients are computed */
+        _poly_mul_kernel(g, nl - len, t + len, nl - len, u, u + 2 * nl);
+        memcpy(g + len, u, (nl - len) * sizeof(Complex));
+        len = nl;
+    }
+}
+
+static void
+_poly_divrem_kernel(const Complex *a, int na, const Complex *b, int nb,
+                    Complex *q, Complex *r, Complex *w)
+{
+    int i, j, dq = na - nb + 1;
+    if (nb - 1 < NEWTON_DIV_CUTOFF || dq < NEWTON_DIV_CUTOFF) {
+        Complex c, lead = b[nb - 1], *t = w;
+        memcpy(t, a, na * sizeof(Complex));
+        for (i = na - 1; i >= nb - 1; --i) {
+            c = complex_div(t[i], lead);
+            if (q != NULL) q[i - nb + 1] = c;
+            if (complex_iszero(c)) continue;
+            for (j = 0; j < nb - 1; ++j) {
+                t[i - nb + 1 + j] = complex_sub(t[i - nb + 1 + j], complex_mult(c, b[j]));
+            }
+        }
+        memcpy(r, t, (nb - 1) * sizeof(Complex));
+        return;
+    }
+    Complex *rb = w, *inv = rb + dq, *ra = inv + dq, *qq = ra + dq;
+    Complex *scratch = qq + dq;
+    for (i = 0; i < dq; ++i) {
+        rb[i] = (i < nb) ? b[nb - 1 - i] : CZero;
+        ra[i] = a[na - 1 - i];
+    }
+    _series_inverse(rb, dq, inv, dq, scratch);
+    _poly_mul_kernel(ra, dq, inv, dq, scratch, scratch + 2 * dq);
+    for (i = 0; i < dq; ++i) {
+        qq[i] = scratch[dq - 1 - i];
+    }
+    if (q != NULL) {
+        memcpy(q, qq, dq * sizeof(Complex));
+    }
+    /* r = a - b * q */
+    _poly_mul_kernel(b, nb, qq, dq, scratch, scratch + na);
+    for (i = 0; i < nb - 1; ++i) {
+        r[i] = complex_sub(a[i], scratch[i]);
+    }
+}
+
+/* Division of a (na coefficients) by the binomial l X**d + b0, 0 < d < na.
+ * Each residue class of the indices modulo d is reduced on its own:
+ *      t[i] = a[i] - (b0 / l) * t[i + d],  q[i - d] = t[i] / l
+ * the remainder being t[0], ..., t[d - 1]. For d = 1 this is synthetic
+ * division, the remainder being A(-b0 / l), and monomial divisors (b0 = 0)
+ * only shift the coefficients. q may be NULL. */
+static void
+_poly_div_binomial(const Complex *a, int na, int d, Complex l, Complex b0,
+                   Complex *q, Complex *r)
+{
+    const Complex x = complex_neg(complex_div(b0, l)), il = complex_div(COne, l);
+    int c, i;
+    double u, tr, ti;
+    if (complex_iszero(b0)) {
+        if (q != NULL) {
+            for (i = d; i < na; ++i) {
+                q[i - d].real = a[i].real * il.real - a[i].imag * il.imag;
+                q[i - d].imag = a[i].real * il.imag + a[i].imag * il.real;
+            }
+        }
+        memcpy(r, a, d * sizeof(Complex));
+        return;
+    }
+    for (c = 0; c < d; ++c) {
+        tr = ti = 0.;
+        for (i = c + (na - 1 - c) / d * d; i >= d; i -= d) {
+            u = a[i].real + x.real * tr - x.imag * ti;
+            ti = a[i].imag + x.real * ti + x.imag * tr;
+            tr = u;
+            if (q != NULL) {
+                q[i - d].real = tr * il.real - ti * il.imag;
+                q[i - d].imag = tr * il.imag + ti * il.real;
+            }
+        }
+        r[c].real = a[c].real + x.real * tr - x.imag * ti;
+        r[c].imag = a[c].imag + x.real * ti + x.imag * tr;
+    }
+}
+
+/* Euclidean division of A by B.
+ * If B is not zero, the resulting polynomials Q and R are defined by:
+ *      A = B * Q + R, deg R < deg B
+ * If B is zero, the operation is undefined and returns -1.
+ */
+int
+poly_div(Polynomial *A, Polynomial *B, Polynomial *Q, Polynomial *R)
+{
+    if (B->deg == -1) {
+        return -1;  // Division by zero
+    }
+    Complex B_leadcoef = Poly_LeadCoef(B);
+    Polynomial T1, T2;  // Used as buffers
+    int d;
+
+    /* Linear, monomial and binomial divisors l X**d + b0 */
+    for (d = B->deg - 1; d > 0 && complex_iszero(B->coef[d]); --d);
+    if (d == 0 && A->deg >= B->deg) {
+        d = B->deg;
+        if (Q != NULL) poly_init(Q, -1);
+        poly_init(R, -1);
+        if ((Q != NULL && !poly_init(Q, A->deg - d)) || !poly_init(R, d - 1)) {
+            if (Q != NULL) poly_free(Q);
+            poly_free(R);
+            return 0;
+        }
+        _poly_div_binomial(A->coef, A->deg + 1, d, B_leadcoef, B->coef[0],
+                           (Q != NULL) ? Q->coef : NULL, R->coef);
+        if (Q != NULL) _poly_normalize(Q);
+        _poly_normalize(R);
+        return 1;
+    }
+
+    /* Polynomials coefficients MUST be initialized. */
+    if (Q != NULL) {
+        poly_init(Q, -1);
+    }
+    poly_init(R, -1);
+    poly_init(&T1, -1);
+    poly_init(&T2, -1);
+
+    if (Q != NULL && !poly_init(Q, A->deg)) goto error;
+    if (!poly_copy(A, R)) goto error;
+
+    while (R->deg - B->deg >= 0) {
+        if (poly_cancelled()) goto error;
+        if (!poly_init(&T1, R->deg - B->deg)) goto error;
+        _poly_set_coef(&T1, R->deg - B->deg,
+                      complex_div(Poly_LeadCoef(R), B_leadcoef));
+
+        if (Q != NULL) {
+            if (!poly_add(Q, &T1, &T2)) goto error;
+            poly_free(Q);
+            if (!poly_copy(&T2, Q)) goto error;
+            poly_free(&T2);
+        }
+
+        if (!poly_multiply(&T1, B, &T2)) goto error;
+        poly_free(&T1);
+        if (!poly_sub(R, &T2, &T1)) goto error;
+        poly_free(&T2);
+        if (T1.deg == R->deg) {
+            /* The leading coefficients may not cancel exactly after
+             * rounding, which would never end the loop */
+            poly_set_coef(&T1, T1.deg, CZero);
+        }
+        poly_free(R);
+        if(!poly_copy(&T1, R)) goto error;
+        poly_free(&T1);
+    }
+    return 1;
+error:
+    if (Q != NULL) poly_free(Q);
+    poly_free(R);
+    poly_free(&T1);
+    poly_free(&T2);
+    return 0;
+}
+
+/* Greatest Common Divisor of A and B.
+ *
+ * Computes the polynomial of highest degree which divides both A and B.
+ * We add the condition that its leading coefficient should be 1 in order
+ * to have a uniquely defined GCD.
+ *
+ * The algorithm is basically :
+ *   # deg A >= deg B
+ *   While B != 0
+ *       A, B <= B, A % B   # Invariant: PGCD(A, B)
+ *   P = A
+ */
+int
+poly_gcd(Polynomial *A, Polynomial *B, Polynomial *P)
+{
+    Polynomial R, T;
+    poly_init(P, -1);
+    poly_init(&R, -1);
+    poly_init(&T, -1);
+
+    if (A->deg >= B->deg) {
+        if (!poly_copy(A, P)) goto error;
+        if (!poly_copy(B, &R)) goto error;
+    } else {
+        if (!poly_copy(B, P)) goto error;
+        if (!poly_copy(A, &R)) goto error;
+    }
+    while (R.deg != -1) {
+        if (!poly_copy(P, &T)) goto error;
+        poly_free(P);
+        if (!poly_copy(&R, P)) goto error;
+        poly_free(&R);
+        if (!poly_div(&T, P, NULL, &R)) goto error;
+        poly_free(&T);
+    }
+    poly_free(&R);
+
+    // Result normalization - could be faster.
+    Complex factor = complex_div((Complex){1, 0}, Poly_LeadCoef(P));
+    if (!poly_copy(P, &T)) goto error;
+    poly_free(P);
+    if (!poly_scal_multiply(&T, factor, P)) goto error;
+    poly_free(&T);
+    return 1;
+error:
+    poly_free(P);
+    poly_free(&T);
+    poly_free(&R);
+    return 0;
+}
+
+/* Resultant of A and B, along the remainder sequence of Euclid's algorithm:
+ *      res(A, B) = (-1)**(deg A * deg B) * lc(B)**(deg A - deg R) * res(B, R)
+ * with R = A % B, down to res(A, c) = c**(deg A) for a constant c.
+ *
+ * The remainders are computed in place in two buffers, without the
+ * intermediate polynomials of poly_gcd, and rescaled by powers of 2. The
+ * product is kept as a mantissa and a binary exponent, since it easily
+ * overflows a double on the way even when the resultant itself does not.
+ *
+ * The half-GCD algorithm is not used here: its truncated divisions are
+ * numerically unstable on floats (see mpoly_resultant for the exact one).
+ */
+/* t[j] -= c * b[j] for j < n. The arithmetic is inlined: in the Python
+ * build, the complex_* operations are function calls. */
+static void
+_submul(Complex *t, Complex c, const Complex *b, int n)
+{
+    const double cr = c.real, ci = c.imag;
+    int j;
+    for (j = 0; j < n; ++j) {
+        t[j].real -= cr * b[j].real - ci * b[j].imag;
+        t[j].imag -= cr * b[j].imag + ci * b[j].real;
+    }
+}
+
+static void
+_scaled_mult(Complex *m, long *e, Complex c)
+{
+    int k;
+    *m = complex_mult(*m, c);
+    frexp(fmax(fabs(m->real), fabs(m->imag)), &k);
+    m->real = ldexp(m->real, -k);
+    m->imag = ldexp(m->imag, -k);
+    *e += k;
+}
+
+int
+poly_resultant(Polynomial *A, Polynomial *B, Complex *r)
+{
+    Complex *u, *v, *t, mant = COne, c, l;
+    long e = 0;
+    int du = A->deg, dv = B->deg, i, j, k;
+    if (du == -1 || dv == -1) {
+        *r = CZero;
+        return 1;
+    }
+    if (du < dv) {
+        Polynomial *T = A;
+        A = B;
+        B = T;
+        du = A->deg;
+        dv = B->deg;
+        if (du & dv & 1) mant = complex_neg(mant);
+    }
+    if ((u = poly_mem_calloc(du + dv + 2, sizeof(Complex))) == NULL) {
+        return 0;
+    }
+    v = u + du + 1;
+    memcpy(u, A->coef, (du + 1) * sizeof(Complex));
+    memcpy(v, B->coef, (dv + 1) * sizeof(Complex));
+    for (;;) {
+        l = v[dv];
+        if (dv == 0) {
+            for (k = 0; k < du; ++k) _scaled_mult(&mant, &e, l);
+            break;
+        }
+        /* u = u % v */
+        for (i = du; i >= dv; --i) {
+            c = complex_div(u[i], l);
+            u[i] = CZero;
+            _submul(u + i - dv, c, v, dv);
+        }
+        for (i = dv - 1; i >= 0 && u[i].real == 0. && u[i].imag == 0.; --i);
+        if (i == -1) {
+            mant = CZero;
+            break;
+        }
+        if (du & dv & 1) mant = complex_neg(mant);
+        for (k = i; k < du; ++k) _scaled_mult(&mant, &e, l);
+        /* res(v, 2**s u) = 2**(s dv) res(v, u): the remainder is scaled
+         * exactly to coefficients below 1 */
+        for (j = 0, c.real = 0.; j <= i; ++j) {
+            c.real = fmax(c.real, fmax(fabs(u[j].real), fabs(u[j].imag)));
+        }
+        frexp(c.real, &k);
+        for (j = 0; j <= i; ++j) {
+            u[j].real = ldexp(u[j].real, -k);
+            u[j].imag = ldexp(u[j].imag, -k);
+        }
+        e += (long)k * dv;
+        du = dv;
+        dv = i;
+        t = u;
+        u = v;
+        v = t;
+    }
+    poly_mem_free((u < v) ? u : v, (A->deg + B->deg + 2) * sizeof(Complex));
+    e = (e > INT_MAX / 2) ? INT_MAX / 2 : (e < INT_MIN / 2) ? INT_MIN / 2 : e;
+    r->real = ldexp(mant.real, (int)e);
+    r->imag = ldexp(mant.imag, (int)e);
+    return 1;
+}
+
+/* disc(A) = (-1)**(n (n - 1) / 2) * res(A, A') / lc(A), with n = deg A.
+ * Returns -1 for constant polynomials. */
+int
+poly_discriminant(Polynomial *A, Complex *d)
+{
+    Polynomial D;
+    Complex r;
+    int n = A->deg;
+    if (n < 1) {
+        return -1;
+    }
+    if (!poly_derive(A, 1, &D)) {
+        return 0;
+    }
+    if (!poly_resultant(A, &D, &r)) {
+        poly_free(&D);
+        return 0;
+    }
+    poly_free(&D);
+    r = complex_div(r, Poly_LeadCoef(A));
+    *d = (n % 4 >= 2) ? complex_neg(r) : r;
+    return 1;
+}
+
+/* Square-free factorization, with Yun's algorithm:
+ *      a0 = gcd(A, A'), b1 = A / a0, c1 = A' / a0, d1 = c1 - b1'
+ *      a[i] = gcd(b[i], d[i]), b[i+1] = b[i] / a[i], c[i+1] = d[i] / a[i],
+ *      d[i+1] = c[i+1] - b[i+1]'
+ * until b[i] = 1, a[i] being the product of the roots of multiplicity i.
+ *
+ * All the steps work on raw arrays in a single workspace. The GCDs are
+ * approximate: a remainder is taken as zero when its coefficients are below
+ * tol times the size of the terms it was computed from. Rounding errors
+ * grow exponentially along Euclid's algorithm for most polynomials of high
+ * degree, and a missed GCD looks like coprime inputs: the result is only
+ * kept if the multiplicities add up to deg A and the roots of each factor
+ * are roots of A with the found multiplicity, up to tol. Otherwise, the
+ * multiple roots are found as clusters of the computed roots of A. */
+
+static double
+_max_abs(const Complex *c, int n)
+{
+    double m = 0., a;
+    int i;
+    for (i = 0; i < n; ++i) {
+        a = fabs(c[i].real);
+        m = (a > m) ? a : m;
+        a = fabs(c[i].imag);
+        m = (a > m) ? a : m;
+    }
+    return m;
+}
+
+/* Degree of c once the leading coefficients below tol are dropped */
+static int
+_trim_degree(const Complex *c, int deg, double tol)
+{
+    while (deg >= 0 && fmax(fabs(c[deg].real), fabs(c[deg].imag)) <= tol) {
+        --deg;
+    }
+    return deg;
+}
+
+static void
+_make_monic(Complex *c, int deg)
+{
+    Complex l = complex_div(COne, c[deg]);
+    int i;
+    for (i = 0; i < deg; ++i) {
+        c[i] = complex_mult(c[i], l);
+    }
+    c[deg] = COne;
+}
+
+/* Monic GCD of u and v, computed in place: both are overwritten, and *g
+ * points to the one holding the result. */
+static int
+_gcd_approx(Complex *u, int du, Complex *v, int dv, double tol, Complex **g)
+{
+    Complex *t, c, l;
+    double scale, qmax;
+    int i, j, k;
+    if (du < dv) {
+        t = u; u = v; v = t;
+        k = du; du = dv; dv = k;
+    }
+    while (dv > 0) {
+        scale = _max_abs(u, du + 1);
+        l = complex_div(COne, v[dv]);
+        for (i = du, qmax = 0.; i >= dv; --i) {
+            c = complex_mult(u[i], l);
+            qmax = fmax(qmax, fmax(fabs(c.real), fabs(c.imag)));
+            _submul(u + i - dv, c, v, dv);
+        }
+        /* The rounding errors on u - q v scale with |u| + |q| |v| */
+        scale = fmax(scale, qmax * _max_abs(v, dv + 1));
+        if (_max_abs(u, dv) <= tol * scale) {
+            break;
+        }
+        k = _trim_degree(u, dv - 1, tol * scale);
+        frexp(_max_abs(u, k + 1), &i);
+        c.real = ldexp(1., -i);
+        for (j = 0; j <= k; ++j) {
+            u[j].real *= c.real;
+            u[j].imag *= c.real;
+        }
+        t = u; u = v; v = t;
+        du = dv;
+        dv = k;
+    }
+    /* v is the last non-zero remainder, a constant for coprime inputs */
+    _make_monic(v, dv);
+    *g = v;
+    return dv;
+}
+
+/* Exact division a / b, the quotient replacing a. Long division costs
+ * deg(a / b) * deg(b) <= (deg A / 2)**2 operations, less than the Newton
+ * iteration of poly_div up to large degrees. */
+static int
+_exact_div(Complex *a, int na, const Complex *b, int nb, Complex *q)
+{
+    Complex l = complex_div(COne, b[nb - 1]);
+    int i;
+    for (i = na - 1; i >= nb - 1; --i) {
+        q[i - nb + 1] = complex_mult(a[i], l);
+        _submul(a + i - nb + 1, q[i - nb + 1], b, nb - 1);
+    }
+    memcpy(a, q, (na - nb + 1) * sizeof(Complex));
+    return na - nb;
+}
+
+/* d = c - b', returns the degree of d */
+static int
+_yun_difference(const Complex *c, int dc, const Complex *b, int db, double tol, Complex *d)
+{
+    int i, n = (dc > db - 1) ? dc : db - 1;
+    double scale = fmax(_max_abs(c, dc + 1), db * _max_abs(b, db + 1));
+    for (i = 0; i <= n; ++i) {
+        d[i] = (i <= dc) ? c[i] : CZero;
+        if (i < db) {
+            d[i] = complex_sub(d[i], complex_mult((Complex){i + 1., 0.}, b[i + 1]));
+        }
+    }
+    return (_max_abs(d, n + 1) <= tol * scale) ? -1 : _trim_degree(d, n, 0.);
+}
+
+/* The m first coefficients of A(X + a) in w, or of rev(A)(X + 1 / a) if
+ * |a| > 1, rev(A) = X**deg A * A(1 / X) having the inverse roots with the
+ * same multiplicities: Horner's scheme is only accurate for |a| <= 1.
+ * Returns a or 1 / a. */
+static Complex
+_taylor_at(Polynomial *A, Complex a, int m, Complex *w)
+{
+    const int n = A->deg;
+    int i;
+    if (hypot(a.real, a.imag) <= 1.) {
+        memcpy(w, A->coef, (n + 1) * sizeof(Complex));
+    } else {
+        for (i = 0; i <= n; ++i) {
+            w[i] = A->coef[n - i];
+        }
+        a = complex_div(COne, a);
+    }
+    _taylor_passes(w, n + 1, a, m);
+    return a;
+}
+
+/* Newton's iteration on A^(m-1), of which a root of multiplicity m of A is
+ * a simple root: the mean of a cluster of computed roots, or a root of an
+ * approximate factor, is only accurate to a fraction of the digits. */
+static Complex
+_refine_root(Polynomial *A, Complex a, int m, Complex *w)
+{
+    const int inverse = hypot(a.real, a.imag) > 1.;
+    Complex x, step;
+    int it;
+    for (it = 0; it < 5; ++it) {
+        x = _taylor_at(A, a, m + 1, w);
+        if (complex_iszero(w[m])) {
+            break;
+        }
+        step = complex_div(w[m - 1], complex_mult((Complex){m, 0.}, w[m]));
+        x = complex_sub(x, step);
+        /* Stay on the same side, as a step may cross the unit circle */
+        a = inverse ? complex_div(COne, x) : x;
+        if (hypot(step.real, step.imag) <= DBL_EPSILON * hypot(x.real, x.imag)
+                || inverse != (hypot(a.real, a.imag) > 1.)) {
+            break;
+        }
+    }
+    return a;
+}
+
+/* Relative backward errors of a as a root of A of multiplicities 1 to m:
+ * beta[j - 1] = sum(|t_i| (1 + |a|)**i, i < j) / norm, the t_i being the
+ * coefficients of A(X + a), is the size of the perturbation of A making a a
+ * root of multiplicity j, relative to the coefficients of A (norm). The
+ * reversed polynomial is used for |a| > 1, which has the same coefficients.
+ * w has room for the deg A + 1 coefficients, and m <= deg A + 1. */
+static void
+_root_backward_errors(Polynomial *A, double norm, Complex a, int m, Complex *w, double *beta)
+{
+    double s = 0., r = 1., x;
+    int i;
+    a = _taylor_at(A, a, m, w);
+    x = 1. + hypot(a.real, a.imag);
+    for (i = 0; i < m; ++i) {
+        s += hypot(w[i].real, w[i].imag) * r;
+        r *= x;
+        beta[i] = s / norm;
+    }
+}
+
+/* Whether the roots of each factors[i] are roots of A of multiplicity
+ * exactly mult[i], up to tol: Euclid's algorithm may miss a GCD of
+ * polynomials with many roots, its errors growing with the length of the
+ * remainder sequence. Returns 0 on memory errors, -1 if a root fails. */
+static int
+_squarefree_certify(Polynomial *A, double tol, Polynomial *factors, const int *mult,
+                    int count, Complex *z, Complex *w, double *beta)
+{
+    const int n = A->deg;
+    const double norm = _max_abs(A->coef, n + 1);
+    int i, j, k;
+    for (i = 0; i < count; ++i) {
+        k = mult[i];
+        if (!poly_roots(factors + i, z, 1)) {
+            return 0;
+        }
+        for (j = 0; j < factors[i].deg; ++j) {
+            _root_backward_errors(A, norm, _refine_root(A, z[j], k, w), MIN(k + 1, n), w, beta);
+            if (beta[k - 1] > tol || (k < n && beta[k] <= tol)) {
+                return -1;
+            }
+        }
+    }
+    return 1;
+}
+
+/* Largest multiple roots found by _squarefree_clusters */
+#define CLUSTER_MAX_SIZE    64
+
+typedef struct {
+    double dist;
+    int index;
+} RootNeighbor;
+
+static int
+_root_arg_cmp(const void *x, const void *y)
+{
+    const Complex *a = x, *b = y;
+    double u = atan2(a->imag, a->real), v = atan2(b->imag, b->real);
+    return (u > v) - (u < v);
+}
+
+/* Coefficients p of the monic polynomial of the d roots r, which are
+ * reordered: sorted by argument, they are multiplied in bit-reversed order,
+ * so that the roots of the partial products are spread around the origin
+ * and their coefficients stay of the size of the final ones. */
+static void
+_poly_from_roots(Complex *r, int d, Complex *p)
+{
+    int i, j, k, t = 0, bits = 0;
+    Complex x;
+    qsort(r, d, sizeof(Complex), _root_arg_cmp);
+    while ((1 << bits) < d) ++bits;
+    p[0] = COne;
+    for (i = 0; i < (1 << bits); ++i) {
+        for (j = 0, k = 0; k < bits; ++k) {
+            j |= ((i >> k) & 1) << (bits - 1 - k);
+        }
+        if (j >= d) continue;
+        /* p *= X - r[j] */
+        x = r[j];
+        p[t + 1] = p[t];
+        for (k = t; k > 0; --k) {
+            p[k].real = p[k - 1].real - (x.real * p[k].real - x.imag * p[k].imag);
+            p[k].imag = p[k - 1].imag - (x.real * p[k].imag + x.imag * p[k].real);
+        }
+        p[0] = (Complex){x.imag * p[0].imag - x.real * p[0].real,
+                         -(x.real * p[0].imag + x.imag * p[0].real)};
+        ++t;
+    }
+}
+
+/* Square-free factorization from the computed roots of A, the roots of a
+ * multiple root being scattered around it: the largest group of the m
+ * roots closest to a root, separated from the next one by 4 times its
+ * radius and whose mean is a root of multiplicity m of A up to tol, is
+ * taken as this multiple root. The factors are then the monic polynomials
+ * of the roots sharing each multiplicity.
+ * z, w and centers have room for deg A + 1 values, beta for deg A + 1
+ * doubles and flags for deg A ints. */
+static int
+_squarefree_clusters(Polynomial *A, double tol, Complex *z, Complex *w, double *beta,
+                     Complex *centers, int *flags, Polynomial *factors, int *mult, int *count)
+{
+    const int n = A->deg;
+    const double norm = _max_abs(A->coef, n + 1);
+    RootNeighbor nb[CLUSTER_MAX_SIZE];
+    Complex c, a, center;
+    double d, delta;
+    int i, j, k, m, best, len, nc = 0, maxmult = 1, real = 1;
+    if (!poly_roots(A, z, 1)) {
+        return 0;
+    }
+    /* flags[i] is set once the root i joins a cluster, whose center and
+     * multiplicity then go to centers[nc] and z[nc], nc <= i */
+    for (i = 0; i < n; ++i) {
+        flags[i] = 0;
+    }
+    for (i = 0; i < n; ++i) {
+        if (flags[i]) continue;
+        /* The closest free roots, sorted by insertion */
+        for (j = 0, len = 0; j < n; ++j) {
+            if (j == i || flags[j]) continue;
+            d = hypot(z[j].real - z[i].real, z[j].imag - z[i].imag);
+            if (len == CLUSTER_MAX_SIZE && d >= nb[len - 1].dist) continue;
+            for (k = (len < CLUSTER_MAX_SIZE) ? len++ : len - 1; k > 0 && nb[k - 1].dist > d; --k) {
+                nb[k] = nb[k - 1];
+            }
+            nb[k] = (RootNeighbor){d, j};
+        }
+        c = z[i];
+        best = 1;
+        for (m = 2, a = z[i]; m <= len + 1; ++m) {
+            a.real += z[nb[m - 2].index].real;
+            a.imag += z[nb[m - 2].index].imag;
+            if (m - 1 < len) {
+                delta = nb[m - 1].dist;
+            } else if (len < CLUSTER_MAX_SIZE) {
+                delta = INFINITY;
+            } else {
+                break;
+            }
+            if (delta < 4 * nb[m - 2].dist) continue;
+            center = _refine_root(A, (Complex){a.real / m, a.imag / m}, m, w);
+            _root_backward_errors(A, norm, center, m, w, beta);
+            if (beta[m - 1] <= tol) {
+                c = center;
+                best = m;
+            }
+        }
+        for (k = 0; k < best - 1; ++k) {
+            flags[nb[k].index] = -1;
+        }
+        flags[i] = -1;
+        centers[nc] = c;
+        z[nc] = (Complex){best, 0.};
+        ++nc;
+        maxmult = (best > maxmult) ? best : maxmult;
+    }
+    for (i = 0; i <= n; ++i) {
+        if (A->coef[i].imag != 0.) real = 0;
+    }
+    for (m = 1; m <= maxmult; ++m) {
+        for (i = 0, k = 0; i < nc; ++i) {
+            if ((int)z[i].real == m) w[k++] = centers[i];
+        }
+        if (k == 0) continue;
+        if (!poly_init(factors + *count, k)) {
+            for (i = 0; i < *count; ++i) poly_free(factors + i);
+            *count = 0;
+            return 0;
+        }
+        _poly_from_roots(w, k, factors[*count].coef);
+        if (real) {
+            for (i = 0; i <= k; ++i) factors[*count].coef[i].imag = 0.;
+        }
+        _poly_normalize(factors + *count);
+        mult[(*count)++] = m;
+    }
+    return 1;
+}
+int
+poly_squarefree(Polynomial *A, double tol, Polynomial *factors, int *mult, int *count)
+{
+    const int n = A->deg;
+    Complex *mem, *b, *c, *d, *u, *v, *q, *g;
+    int i, k, db, dc, dd, dg, rest, status = 1;
+    *count = 0;
+    if (n == -1) {
+        return -1;
+    }
+    if (n == 0) {
+        return 1;
+    }
+    if ((mem = poly_mem_calloc(6 * (size_t)(n + 1), sizeof(Complex))) == NULL) {
+        return 0;
+    }
+    b = mem;
+    c = b + n + 1;
+    d = c + n + 1;
+    u = d + n + 1;
+    v = u + n + 1;
+    q = v + n + 1;
+
+    /* a0 = gcd(A, A') */
+    memcpy(b, A->coef, (n + 1) * sizeof(Complex));
+    for (i = 0; i < n; ++i) {
+        c[i] = complex_mult((Complex){i + 1., 0.}, A->coef[i + 1]);
+    }
+    memcpy(u, b, (n + 1) * sizeof(Complex));
+    memcpy(v, c, n * sizeof(Complex));
+    dg = _gcd_approx(u, n, v, n - 1, tol, &g);
+    db = _exact_div(b, n + 1, g, dg + 1, q);
+    dc = _exact_div(c, n, g, dg + 1, q);
+    dd = _yun_difference(c, dc, b, db, tol, d);
+
+    /* The roots of b[k] have multiplicities of at least k, and add up to
+     * "rest": b[k]**k is the whole rest once k * deg b[k] reaches it, and
+     * going past it means a GCD was missed. */
+    for (k = 1, rest = n; db > 0; ++k) {
+        if (k * db > rest) {
+            status = -1;
+            break;
+        }
+        if (dd == -1 || k * db == rest) {
+            /* gcd(b, 0) = b */
+            _make_monic(b, db);
+            g = b;
+            dg = db;
+        } else {
+            memcpy(u, b, (db + 1) * sizeof(Complex));
+            memcpy(v, d, (dd + 1) * sizeof(Complex));
+            dg = _gcd_approx(u, db, v, dd, tol, &g);
+        }
+        if (dg > 0) {
+            if (!poly_init(factors + *count, dg)) {
+                status = 0;
+                break;
+            }
+            memcpy(factors[*count].coef, g, (dg + 1) * sizeof(Complex));
+            _poly_normalize(factors + *count);
+            mult[(*count)++] = k;
+            rest -= k * dg;
+        }
+        if (g == b) {
+            break;
+        }
+        db = _exact_div(b, db + 1, g, dg + 1, q);
+        dc = (dd == -1) ? -1 : _exact_div(d, dd + 1, g, dg + 1, q);
+        memcpy(c, d, (dc + 1) * sizeof(Complex));
+        dd = _yun_difference(c, dc, b, db, tol, d);
+    }
+    if (status == 1) {
+        status = (rest == 0) ? _squarefree_certify(A, tol, factors, mult, *count, b, c, (double *)d) : -1;
+    }
+    if (status != 1) {
+        for (i = 0; i < *count; ++i) poly_free(factors + i);
+        *count = 0;
+    }
+    if (status == -1) {
+        status = _squarefree_clusters(A, tol, b, c, (double *)d, u, (int *)q, factors, mult, count);
+    }
+    poly_mem_free(mem, 6 * (size_t)(n + 1) * sizeof(Complex));
+    return status;
+}
+
+/* Interpolation: computes the polynomial R of degree < n such that
+ * R(xs[i]) = ys[i] for all i.
+ *
+ * Small problems use Newton's divided differences, in O(n**2) operations.
+ * Larger ones use the subproduct tree M = prod (X - xs[i]):
+ *  - the values M'(xs[i]) are obtained by reducing M' down the tree,
+ *  - the weights ys[i] / M'(xs[i]) are then recombined up the tree,
+ *    each node being  left * M_right + right * M_left.
+ * With the fast multiplication and division kernels, this costs
+ * O(M(n) log n) operations.
+ *
+ * The tree is only accurate for points spread around a circle, such as
+ * roots of unity: otherwise the values M'(xs[i]) are lost in the rounding
+ * errors, and divided differences are used at all sizes.
+ *
+ * Returns -1 if two abscissas are equal.
+ */
+#define INTERPOLATE_CUTOFF      128
+
+/* Largest relative error accepted on the values M'(xs[i]) of the tree */
+#define INTERPOLATE_TREE_TOL    1e-8
+
+/* The order of the abscissas does not change the result, but it matters a lot
+ * for the numerical stability: both algorithms are run on a reordered copy.
+ *
+ * Newton's divided differences use a Leja ordering: each point maximizes
+ * the product of its distances to the previous ones. */
+static void
+_leja_order(const Complex *xs, int n, int *order, double *logprod)
+{
+    int i, j, best = 0;
+    for (i = 0; i < n; ++i) {
+        order[i] = i;
+        if (hypot(xs[i].real, xs[i].imag) > hypot(xs[best].real, xs[best].imag)) best = i;
+    }
+    for (i = 0; i < n; ++i) {
+        int t = order[i];
+        order[i] = order[best];
+        order[best] = t;
+        best = i + 1;
+        for (j = i + 1; j < n; ++j) {
+            Complex d = complex_sub(xs[order[j]], xs[order[i]]);
+            logprod[order[j]] = ((i == 0) ? 0. : logprod[order[j]])
+                                + log(hypot(d.real, d.imag));
+            if (logprod[order[j]] > logprod[order[best]]) best = j;
+        }
+    }
+}
+
+/* The subproduct tree groups consecutive points: the points are sorted by
+ * argument around their centroid, then interleaved recursively (like the
+ * bit-reversal permutation used by FFTs) so that every subtree samples the
+ * whole set. For roots of unity, the tree nodes become binomials. */
+typedef struct {
+    double angle, dist;
+    int index;
+} PointKey;
+
+static int
+_pointkey_cmp(const void *a, const void *b)
+{
+    const PointKey *p = a, *q = b;
+    if (p->angle != q->angle) return (p->angle < q->angle) ? -1 : 1;
+    if (p->dist != q->dist) return (p->dist < q->dist) ? -1 : 1;
+    return p->index - q->index;
+}
+
+static void
+_spread_order(const int *sorted, int n, int stride, int *out, int *pos)
+{
+    if (n <= 0) {
+        return;
+    }
+    if (n == 1) {
+        out[(*pos)++] = sorted[0];
+        return;
+    }
+    _spread_order(sorted, (n + 1) / 2, 2 * stride, out, pos);
+    _spread_order(sorted + stride, n / 2, 2 * stride, out, pos);
+}
+
+static int
+_interpolate_newton(const Complex *xs, const Complex *ys, int n, Complex *c, Complex *d)
+{
+    int i, j;
+    Complex den;
+    memcpy(d, ys, n * sizeof(Complex));
+    for (j = 1; j < n; ++j) {
+        for (i = n - 1; i >= j; --i) {
+            den = complex_sub(xs[i], xs[i - j]);
+            if (complex_iszero(den)) {
+                return -1;
+            }
+            d[i] = complex_div(complex_sub(d[i], d[i - 1]), den);
+        }
+    }
+    /* Newton form to monomial basis, in Horner fashion */
+    memset(c, 0, n * sizeof(Complex));
+    c[0] = d[n - 1];
+    for (j = n - 2; j >= 0; --j) {
+        for (i = n - 1 - j; i >= 1; --i) {
+            c[i] = complex_sub(c[i - 1], complex_mult(xs[j], c[i]));
+        }
+        c[0] = complex_add(complex_neg(complex_mult(xs[j], c[0])), d[j]);
+    }
+    return 1;
+}
+
+/* Node i of level j of the subproduct tree covers xs[i * 2**j, ...].
+ * Returns -1 if the values M'(xs[i]) are not accurate. */
+#define TREE_COUNT(n, j, i)     (((n) - ((i) << (j)) < (1 << (j))) ? (n) - ((i) << (j)) : (1 << (j)))
+#define TREE_NODES(n, j)        ((((n) - 1) >> (j)) + 1)
+#define TREE_NODE(tree, j, i)   ((tree)[j] + (size_t)(i) * ((1 << (j)) + 1))
+
+static int
+_interpolate_tree(const Complex *xs, const Complex *ys, int n, Complex *c)
+{
+    int i, j, k, levels = 0, ret = 1;
+    double r, bound;
+    size_t size = 0;
+    while ((1 << levels) < n) ++levels;
+    for (j = 0; j <= levels; ++j) {
+        size += (size_t)TREE_NODES(n, j) * ((1 << j) + 1);
+    }
+    Complex *tree[32], *cur, *nxt, *tmp, *prod, *w;
+    size_t scratch = DIV_WORKSPACE(n + 1);
+    size += 4 * (size_t)n + 2 + scratch;
+    if ((tree[0] = poly_mem_calloc(size, sizeof(Complex))) == NULL) {
+        return 0;
+    }
+    for (j = 1; j <= levels; ++j) {
+        tree[j] = TREE_NODE(tree, j - 1, TREE_NODES(n, j - 1));
+    }
+    cur = TREE_NODE(tree, levels, 1);
+    nxt = cur + n;
+    prod = nxt + n;
+    w = prod + 2 * n + 2;
+
+    /* Subproduct tree */
+    for (i = 0; i < n; ++i) {
+        TREE_NODE(tree, 0, i)[0] = complex_neg(xs[i]);
+        TREE_NODE(tree, 0, i)[1] = COne;
+    }
+    for (j = 1; j <= levels; ++j) {
+        for (i = 0; i < TREE_NODES(n, j); ++i) {
+            int cl = TREE_COUNT(n, j - 1, 2 * i);
+            if (2 * i + 1 < TREE_NODES(n, j - 1)) {
+                _poly_mul_kernel(TREE_NODE(tree, j - 1, 2 * i), cl + 1,
+                                 TREE_NODE(tree, j - 1, 2 * i + 1),
+                                 TREE_COUNT(n, j - 1, 2 * i + 1) + 1,
+                                 TREE_NODE(tree, j, i), w);
+            } else {
+                memcpy(TREE_NODE(tree, j, i), TREE_NODE(tree, j - 1, 2 * i),
+                       (cl + 1) * sizeof(Complex));
+            }
+        }
+    }
+
+    /* Remainder tree: values of M' at the abscissas */
+    for (k = 0; k < n; ++k) {
+        cur[k] = complex_mult((Complex){k + 1, 0}, TREE_NODE(tree, levels, 0)[k + 1]);
+    }
+    for (j = levels; j >= 1; --j) {
+        for (i = 0; i < TREE_NODES(n, j - 1); ++i) {
+            int cp = TREE_COUNT(n, j, i / 2), cc = TREE_COUNT(n, j - 1, i);
+            Complex *parent = cur + ((size_t)(i / 2) << j), *child = nxt + ((size_t)i << (j - 1));
+            if (cp > cc) {
+                _poly_divrem_kernel(parent, cp, TREE_NODE(tree, j - 1, i), cc + 1,
+                                    NULL, child, w);
+            } else {
+                memcpy(child, parent, cp * sizeof(Complex));
+            }
+        }
+        tmp = cur; cur = nxt; nxt = tmp;
+    }
+    /* The remainders lose about eps * sum |M'_k| r**k, r = max |xs[i]|, which
+     * is tiny for points spread around a circle but exceeds M'(xs[i]) by
+     * orders of magnitude for points on a line: Newton's divided differences
+     * are used instead. */
+    for (i = 0, r = 0.; i < n; ++i) {
+        r = fmax(r, hypot(xs[i].real, xs[i].imag));
+    }
+    for (k = n - 1, bound = 0.; k >= 0; --k) {
+        const Complex m = TREE_NODE(tree, levels, 0)[k + 1];
+        bound = bound * r + (k + 1) * hypot(m.real, m.imag);
+    }
+    bound *= n * DBL_EPSILON / INTERPOLATE_TREE_TOL;
+    for (i = 0; i < n; ++i) {
+        if (!(hypot(cur[i].real, cur[i].imag) > bound)) {
+            ret = -1;
+            goto done;
+        }
+        cur[i] = complex_div(ys[i], cur[i]);
+    }
+
+    /* Linear combination up the tree */
+    for (j = 0; j < levels; ++j) {
+        for (i = 0; i < TREE_NODES(n, j + 1); ++i) {
+            int cl = TREE_COUNT(n, j, 2 * i);
+            Complex *left = cur + ((size_t)(2 * i) << j), *parent = nxt + ((size_t)i << (j + 1));
+            if (2 * i + 1 < TREE_NODES(n, j)) {
+                int cr = TREE_COUNT(n, j, 2 * i + 1);
+                Complex *right = left + (1 << j);
+                _poly_mul_kernel(left, cl, TREE_NODE(tree, j, 2 * i + 1), cr + 1, prod, w);
+                _poly_mul_kernel(right, cr, TREE_NODE(tree, j, 2 * i), cl + 1,
+                                 prod + cl + cr, w);
+                for (k = 0; k < cl + cr; ++k) {
+                    parent[k] = complex_add(prod[k], prod[cl + cr + k]);
+                }
+            } else {
+                memcpy(parent, left, cl * sizeof(Complex));
+            }
+        }
+        tmp = cur; cur = nxt; nxt = tmp;
+    }
+    memcpy(c, cur, n * sizeof(Complex));
+done:
+    poly_mem_free(tree[0], size * sizeof(Complex));
+    return ret;
+}
+
+int
+poly_interpolate(const Complex *xs, const Complex *ys, int n, Polynomial *R)
+{
+    int i, ret = -1, *order;
+    if (!poly_init(R, n - 1)) {
+        return 0;
+    }
+    if (n == 0) {
+        return 1;
+    }
+    /* Reordered copies of the points, the ordering and scratch space */
+    size_t bytes = 3 * (size_t)n * sizeof(Complex) + n * (sizeof(int) + sizeof(PointKey));
+    Complex *px = poly_mem_calloc(1, bytes);
+    if (px == NULL) {
+        poly_free(R);
+        return 0;
+    }
+    Complex *py = px + n, *d = py + n;
+    PointKey *keys = (PointKey*)(d + n);
+    order = (int*)(keys + n);
+    if (n > INTERPOLATE_CUTOFF) {
+        Complex center = CZero;
+        for (i = 0; i < n; ++i) {
+            center = complex_add(center, xs[i]);
+        }
+        center.real /= n;
+        center.imag /= n;
+        for (i = 0; i < n; ++i) {
+            Complex z = complex_sub(xs[i], center);
+            keys[i].angle = atan2(z.imag, z.real);
+            keys[i].dist = hypot(z.real, z.imag);
+            keys[i].index = i;
+        }
+        qsort(keys, n, sizeof(PointKey), _pointkey_cmp);
+        int *sorted = (int*)d, pos = 0;
+        for (i = 0; i < n; ++i) {
+            sorted[i] = keys[i].index;
+        }
+        _spread_order(sorted, n, 1, order, &pos);
+        for (i = 0; i < n; ++i) {
+            px[i] = xs[order[i]];
+            py[i] = ys[order[i]];
+        }
+        ret = _interpolate_tree(px, py, n, R->coef);
+    }
+    if (ret == -1) {
+        /* Equal abscissas are only reported from exact comparisons here */
+        _leja_order(xs, n, order, (double*)keys);
+        for (i = 0; i < n; ++i) {
+            px[i] = xs[order[i]];
+            py[i] = ys[order[i]];
+        }
+        ret = _interpolate_newton(px, py, n, R->coef, d);
+    }
+    poly_mem_free(px, bytes);
+    if (ret != 1) {
+        poly_free(R);
+        return ret;
+    }
+    _poly_normalize(R);
+    return 1;
+}
+
+/* Roots: simultaneous approximation of all the roots of P with the
+ * Ehrlich-Aberth iteration:
+ *      z_k <- z_k - N_k / (1 - N_k * sum_{j != k} 1 / (z_k - z_j))
+ * where N_k = P(z_k) / P'(z_k) is the Newton correction.
+ *
+ * The initial approximations are spread on circles whose radii come from
+ * the Newton polygon of the moduli of the coefficients (see D. A. Bini,
+ * "Numerical computation of polynomial zeros by means of Aberth's method").
+ * All the estimates are updated at once from the previous ones, so that the
+ * Horner/derivative pairs are computed for batches of points in a structure
+ * of arrays layout the compiler can vectorize, and so that the batches can
+ * be processed by several threads for high degrees.
+ * Estimates of modulus greater than 1 are evaluated on the reversed
+ * polynomial, for numerical stability. An estimate stops moving once
+ * |P(z)| is below the bound (4n + 1) eps sum |a_i| |z|**i of the rounding
+ * errors of Horner's scheme.
+ */
+#define ROOTS_MAX_ITERATIONS    500
+#define ROOTS_PARALLEL_DEGREE   512
+#define ROOTS_GRAIN             128
+
+typedef struct {
+    int n;
+    const double *ar, *ai, *am;     // Coefficients and their moduli
+    const double *rr, *ri, *rm;     // Same for the reversed polynomial
+    double *zr, *zi;                // Current estimates
+    double *wr, *wi;                // Corrections
+    char *done;
+    /* Scratch arrays, each chunk of estimates uses its own range */
+    double *xr, *xi, *xm, *pr, *pi, *dr, *di, *e;
+    int *idx;
+} AberthState;
+
+/* Horner evaluation of the polynomial a of degree n and of its derivative
+ * at the m points x, along with the error bound sum |a_i| |x|**i. */
+static void
+_horner_pairs(const double *restrict ar, const double *restrict ai,
+              const double *restrict am, int n,
+              const double *restrict xr, const double *restrict xi,
+              const double *restrict xm, int m,
+              double *restrict pr, double *restrict pi,
+              double *restrict dr, double *restrict di, double *restrict e)
+{
+    int i, k;
+    double t;
+    for (k = 0; k < m; ++k) {
+        pr[k] = ar[n];
+        pi[k] = ai[n];
+        dr[k] = di[k] = 0.;
+        e[k] = am[n];
+    }
+    for (i = n - 1; i >= 0; --i) {
+        for (k = 0; k < m; ++k) {
+            t = dr[k] * xr[k] - di[k] * xi[k] + pr[k];
+            di[k] = dr[k] * xi[k] + di[k] * xr[k] + pi[k];
+            dr[k] = t;
+            t = pr[k] * xr[k] - pi[k] * xi[k] + ar[i];
+            pi[k] = pr[k] * xi[k] + pi[k] * xr[k] + ai[i];
+            pr[k] = t;
+            e[k] = e[k] * xm[k] + am[i];
+        }
+    }
+}
+
+static void
+_aberth_chunk(void *ctx, int start, int end)
+{
+    AberthState *S = ctx;
+    int i, j, k, m, ninner, n = S->n;
+    double *xr = S->xr + start, *xi = S->xi + start, *xm = S->xm + start;
+    double *pr = S->pr + start, *pi = S->pi + start, *dr = S->dr + start;
+    double *di = S->di + start, *e = S->e + start;
+    int *idx = S->idx + start;
+
+    /* Gather the moving estimates: inner ones first, then the outer ones
+     * as their inverses. */
+    for (m = 0, k = start; k < end; ++k) {
+        if (!S->done[k] && hypot(S->zr[k], S->zi[k]) <= 1.) idx[m++] = k;
+    }
+    ninner = m;
+    for (k = start; k < end; ++k) {
+        if (!S->done[k] && hypot(S->zr[k], S->zi[k]) > 1.) idx[m++] = k;
+    }
+    for (i = 0; i < m; ++i) {
+        double r = S->zr[idx[i]], s = S->zi[idx[i]], d = r * r + s * s;
+        if (i < ninner) {
+            xr[i] = r;
+            xi[i] = s;
+        } else {
+            xr[i] = r / d;
+            xi[i] = -s / d;
+        }
+        xm[i] = hypot(xr[i], xi[i]);
+    }
+    _horner_pairs(S->ar, S->ai, S->am, n, xr, xi, xm, ninner, pr, pi, dr, di, e);
+    _horner_pairs(S->rr, S->ri, S->rm, n, xr + ninner, xi + ninner, xm + ninner,
+                  m - ninner, pr + ninner, pi + ninner, dr + ninner, di + ninner,
+                  e + ninner);
+
+    for (i = 0; i < m; ++i) {
+        Complex z, p = {pr[i], pi[i]}, dp = {dr[i], di[i]}, N, s = CZero;
+        k = idx[i];
+        z.real = S->zr[k];
+        z.imag = S->zi[k];
+        S->wr[k] = S->wi[k] = 0.;
+        if (hypot(p.real, p.imag) <= (4 * n + 1) * DBL_EPSILON * e[i]) {
+            S->done[k] = 1;
+            continue;
+        }
+        if (complex_iszero(dp)) {
+            /* Stationary point, just move away from it */
+            S->wr[k] = (1. + hypot(z.real, z.imag)) * 1e-3;
+            S->wi[k] = S->wr[k];
+            continue;
+        }
+        N = complex_div(p, dp);
+        if (i >= ninner) {
+            /* P(z) / P'(z) = z / (n - y Q'(y) / Q(y)), with y = 1 / z */
+            Complex y = {xr[i], xi[i]};
+            N = complex_div(z, complex_sub((Complex){n, 0},
+                                           complex_mult(y, complex_div(COne, N))));
+        }
+        for (j = 0; j < k; ++j) {
+            double a = z.real - S->zr[j], b = z.imag - S->zi[j], d = a * a + b * b;
+            s.real += a / d;
+            s.imag -= b / d;
+        }
+        for (j = k + 1; j < n; ++j) {
+            double a = z.real - S->zr[j], b = z.imag - S->zi[j], d = a * a + b * b;
+            s.real += a / d;
+            s.imag -= b / d;
+        }
+        N = complex_div(N, complex_sub(COne, complex_mult(N, s)));
+        S->wr[k] = N.real;
+        S->wi[k] = N.imag;
+    }
+}
+
+/* Initial approximations from the upper convex hull of (i, log |a_i|) */
+static void
+_aberth_start(AberthState *S, int *hull)
+{
+    int i, j, l, h = 0, n = S->n;
+    for (i = 0; i <= n; ++i) {
+        if (S->am[i] == 0.) continue;
+        while (h >= 2) {
+            int p = hull[h - 2], q = hull[h - 1];
+            /* Pop q if it lies below the segment (p, i) */
+            if ((log(S->am[q]) - log(S->am[p])) * (i - p)
+                    <= (log(S->am[i]) - log(S->am[p])) * (q - p)) {
+                --h;
+            } else {
+                break;
+            }
+        }
+        hull[h++] = i;
+    }
+    for (l = 0, j = 0; j < h - 1; ++j) {
+        int m = hull[j + 1] - hull[j];
+        double u = exp((log(S->am[hull[j]]) - log(S->am[hull[j + 1]])) / m);
+        for (i = 0; i < m; ++i, ++l) {
+            double angle = 2 * M_PI * i / m + 2 * M_PI * j / n + 0.7;
+            S->zr[l] = u * cos(angle);
+            S->zi[l] = u * sin(angle);
+        }
+    }
+}
+
+/* Stores the deg P roots of P (not zero) in "roots".
+ * Threads are used for high degrees when "parallel" is set. */
+int
+poly_roots(Polynomial *P, Complex *roots, int parallel)
+{
+    int i, it, k, low = 0, n;
+    if (P->deg == -1) {
+        return -1;
+    }
+    /* Roots at zero are exact */
+    while (complex_iszero(P->coef[low])) {
+        roots[low++] = CZero;
+    }
+    n = P->deg - low;
+    if (n == 0) {
+        return 1;
+    }
+    if (n == 1) {
+        roots[low] = complex_neg(complex_div(P->coef[low], P->coef[low + 1]));
+        return 1;
+    }
+    AberthState S;
+    size_t bytes = (6 * (size_t)(n + 1) + 12 * (size_t)n) * sizeof(double)
+                   + n * (sizeof(int) + 1) + (n + 1) * sizeof(int);
+    double *mem = poly_mem_calloc(1, bytes);
+    if (mem == NULL) {
+        return 0;
+    }
+    double *ar = mem, *ai = ar + n + 1, *am = ai + n + 1;
+    double *rr = am + n + 1, *ri = rr + n + 1, *rm = ri + n + 1;
+    S.n = n;
+    S.ar = ar; S.ai = ai; S.am = am;
+    S.rr = rr; S.ri = ri; S.rm = rm;
+    S.zr = rm + n + 1;
+    S.zi = S.zr + n;
+    S.wr = S.zi + n;
+    S.wi = S.wr + n;
+    S.xr = S.wi + n;
+    S.xi = S.xr + n;
+    S.xm = S.xi + n;
+    S.pr = S.xm + n;
+    S.pi = S.pr + n;
+    S.dr = S.pi + n;
+    S.di = S.dr + n;
+    S.e = S.di + n;
+    S.idx = (int*)(S.e + n);
+    int *hull = S.idx + n;
+    S.done = (char*)(hull + n + 1);
+    for (i = 0; i <= n; ++i) {
+        ar[i] = rr[n - i] = P->coef[low + i].real;
+        ai[i] = ri[n - i] = P->coef[low + i].imag;
+        am[i] = rm[n - i] = hypot(ar[i], ai[i]);
+    }
+    for (i = 0; i < n; ++i) {
+        S.done[i] = 0;
+    }
+    _aberth_start(&S, hull);
+
+    for (it = 0; it < ROOTS_MAX_ITERATIONS; ++it) {
+        if (parallel && n >= ROOTS_PARALLEL_DEGREE) {
+            poly_parallel_for(_aberth_chunk, &S, n, ROOTS_GRAIN);
+        } else {
+            _aberth_chunk(&S, 0, n);
+        }
+        for (k = 0, i = 0; i < n; ++i) {
+            S.zr[i] -= S.wr[i];
+            S.zi[i] -= S.wi[i];
+            k += S.done[i];
+        }
+        if (k == n) break;
+    }
+    for (i = 0; i < n; ++i) {
+        roots[low + i].real = S.zr[i];
+        roots[low + i].imag = S.zi[i];
+    }
+    poly_mem_free(mem, bytes);
+    return 1;
+}
+
+/**
+ * Chebyshev series
+ * A series sum(c[k] * T_k) is stored in a Polynomial structure, the
+ * coefficients being those of the T_k instead of the X**k.
+ */
+
+/* Clenshaw's algorithm, b[k] = c[k] + 2x b[k+1] - b[k+2].
+ * Near x = s = +-1, Reinsch's variant propagates g[k] = b[k] - s b[k+1]
+ * instead, which avoids the O(n**2) growth of the rounding errors:
+ *      g[k] = c[k] + 2(x - s) b[k+1] + s g[k+1],   b[k] = g[k] + s b[k+1] */
+#define CHEB_REINSCH(x)     (fabs((x).real) > .5)
+
+Complex
+cheb_eval(Polynomial *C, Complex x)
+{
+    Complex b1 = CZero, b2 = CZero, t, x2 = {2. * x.real, 2. * x.imag};
+    int k;
+    if (C->deg == -1) {
+        return CZero;
+    }
+    if (CHEB_REINSCH(x)) {
+        double s = (x.real > 0.) ? 1. : -1.;
+        Complex xs = {x.real - s, x.imag}, xs2 = {2. * xs.real, 2. * xs.imag};
+        /* b1 = b[k+1], b2 = g[k+1] */
+        for (k = C->deg; k >= 1; --k) {
+            t = complex_add(complex_add(C->coef[k], complex_mult(xs2, b1)),
+                            (Complex){s * b2.real, s * b2.imag});
+            b2 = t;
+            b1 = complex_add(t, (Complex){s * b1.real, s * b1.imag});
+        }
+        return complex_add(complex_add(C->coef[0], complex_mult(xs, b1)),
+                           (Complex){s * b2.real, s * b2.imag});
+    }
+    for (k = C->deg; k >= 1; --k) {
+        t = complex_sub(complex_add(C->coef[k], complex_mult(x2, b1)), b2);
+        b2 = b1;
+        b1 = t;
+    }
+    return complex_sub(complex_add(C->coef[0], complex_mult(x, b1)), b2);
+}
+
+/* Both recurrences run on CHEB_BATCH points at once, in a structure of
+ * arrays layout: the inner loops get vectorized by the compiler. */
+#define CHEB_BATCH      8
+
+static void
+_clenshaw_batch(const Complex *c, int deg, const double *restrict xr,
+                const double *restrict xi, double *restrict yr, double *restrict yi)
+{
+    double b1r[CHEB_BATCH] = {0}, b1i[CHEB_BATCH] = {0};
+    double b2r[CHEB_BATCH] = {0}, b2i[CHEB_BATCH] = {0};
+    double tr, ti;
+    int j, k;
+    for (k = deg; k >= 1; --k) {
+        const double cr = c[k].real, ci = c[k].imag;
+        for (j = 0; j < CHEB_BATCH; ++j) {
+            tr = cr + 2. * (xr[j] * b1r[j] - xi[j] * b1i[j]) - b2r[j];
+            ti = ci + 2. * (xr[j] * b1i[j] + xi[j] * b1r[j]) - b2i[j];
+            b2r[j] = b1r[j];
+            b2i[j] = b1i[j];
+            b1r[j] = tr;
+            b1i[j] = ti;
+        }
+    }
+    for (j = 0; j < CHEB_BATCH; ++j) {
+        yr[j] = c[0].real + xr[j] * b1r[j] - xi[j] * b1i[j] - b2r[j];
+        yi[j] = c[0].imag + xr[j] * b1i[j] + xi[j] * b1r[j] - b2i[j];
+    }
+}
+
+/* Reinsch's variant, s[j] = +-1 and xr[j] already shifted by -s[j] */
+static void
+_reinsch_batch(const Complex *c, int deg, const double *restrict xr,
+               const double *restrict xi, const double *restrict s,
+               double *restrict yr, double *restrict yi)
+{
+    double br[CHEB_BATCH] = {0}, bi[CHEB_BATCH] = {0};
+    double gr[CHEB_BATCH] = {0}, gi[CHEB_BATCH] = {0};
+    int j, k;
+    for (k = deg; k >= 1; --k) {
+        const double cr = c[k].real, ci = c[k].imag;
+        for (j = 0; j < CHEB_BATCH; ++j) {
+            gr[j] = cr + 2. * (xr[j] * br[j] - xi[j] * bi[j]) + s[j] * gr[j];
+            gi[j] = ci + 2. * (xr[j] * bi[j] + xi[j] * br[j]) + s[j] * gi[j];
+            br[j] = gr[j] + s[j] * br[j];
+            bi[j] = gi[j] + s[j] * bi[j];
+        }
+    }
+    for (j = 0; j < CHEB_BATCH; ++j) {
+        yr[j] = c[0].real + xr[j] * br[j] - xi[j] * bi[j] + s[j] * gr[j];
+        yi[j] = c[0].imag + xr[j] * bi[j] + xi[j] * br[j] + s[j] * gi[j];
+    }
+}
+
+typedef struct {
+    Polynomial *C;
+    const Complex *xs;
+    Complex *ys;
+    int n;
+} ChebBatch;
+
+/* The points of each chunk are dispatched between two batches, according
+ * to the recurrence used */
+typedef struct {
+    double xr[CHEB_BATCH], xi[CHEB_BATCH], s[CHEB_BATCH];
+    double yr[CHEB_BATCH], yi[CHEB_BATCH];
+    int index[CHEB_BATCH], count;
+} ChebLanes;
+
+static void
+_cheb_flush(ChebBatch *B, ChebLanes *L, int reinsch)
+{
+    int j;
+    for (j = L->count; j < CHEB_BATCH; ++j) {
+        L->xr[j] = L->xi[j] = L->s[j] = 0.;
+    }
+    if (reinsch) {
+        _reinsch_batch(B->C->coef, B->C->deg, L->xr, L->xi, L->s, L->yr, L->yi);
+    } else {
+        _clenshaw_batch(B->C->coef, B->C->deg, L->xr, L->xi, L->yr, L->yi);
+    }
+    for (j = 0; j < L->count; ++j) {
+        B->ys[L->index[j]].real = L->yr[j];
+        B->ys[L->index[j]].imag = L->yi[j];
+    }
+    L->count = 0;
+}
+
+static void
+_cheb_eval_chunk(void *ctx, int start, int end)
+{
+    ChebBatch *B = ctx;
+    ChebLanes lanes[2];
+    int i, r;
+    lanes[0].count = lanes[1].count = 0;
+    for (i = start * CHEB_BATCH; i < end * CHEB_BATCH && i < B->n; ++i) {
+        Complex x = B->xs[i];
+        ChebLanes *L = lanes + (r = CHEB_REINSCH(x));
+        L->s[L->count] = r ? ((x.real > 0.) ? 1. : -1.) : 0.;
+        L->xr[L->count] = x.real - L->s[L->count];
+        L->xi[L->count] = x.imag;
+        L->index[L->count] = i;
+        if (++(L->count) == CHEB_BATCH) _cheb_flush(B, L, r);
+    }
+    for (r = 0; r < 2; ++r) {
+        if (lanes[r].count) _cheb_flush(B, lanes + r, r);
+    }
+}
+
+/* Evaluation of a series at n points, spread across threads when the
+ * work is large enough */
+void
+cheb_eval_many(Polynomial *C, const Complex *xs, Complex *ys, int n)
+{
+    ChebBatch B = {C, xs, ys, n};
+    int i, batches = (n + CHEB_BATCH - 1) / CHEB_BATCH;
+    if (C->deg == -1) {
+        for (i = 0; i < n; ++i) ys[i] = CZero;
+        return;
+    }
+    if ((double)n * C->deg < (1 << 20)) {
+        _cheb_eval_chunk(&B, 0, batches);
+    } else {
+        poly_parallel_for(_cheb_eval_chunk, &B, batches, 16);
+    }
+}
+
+/* Conversion from the monomial basis.
+ * With x = (z + 1/z) / 2, T_k(x) = (z**k + z**-k) / 2 so that the Chebyshev
+ * coefficients of A are read from the Laurent polynomial
+ *      z**d A(x) = sum(a[k] * q**k * z**(d - k)),  q = (1 + z**2) / 2
+ * The sum is computed by splitting the a[k] in halves, the powers
+ * q**(2**j) being precomputed. All terms have non-negative weights, which
+ * keeps the conversion well conditioned. */
+#define CHEB_CUTOFF     16
+
+static int
+_cheb_compose_rec(const Complex *a, int n, Polynomial *qpows, Polynomial *S)
+{
+    int i, j, h, m;
+    if (n <= CHEB_CUTOFF) {
+        /* Horner's scheme: S_i = S_{i-1} * q + a[n - 1 - i] * z**i */
+        if (!poly_init(S, 2 * n - 2)) {
+            return 0;
+        }
+        S->coef[0] = a[n - 1];
+        for (i = 1; i < n; ++i) {
+            for (j = 2 * i; j >= 0; --j) {
+                Complex t = (j <= 2 * i - 2) ? S->coef[j] : CZero;
+                if (j >= 2) t = complex_add(t, S->coef[j - 2]);
+                S->coef[j] = (Complex){t.real / 2., t.imag / 2.};
+            }
+            S->coef[i] = complex_add(S->coef[i], a[n - 1 - i]);
+        }
+        _poly_normalize(S);
+        return 1;
+    }
+    /* S(a, n) = z**m * S(a, h) + q**h * S(a + h, m) */
+    for (h = 1, j = 0; 2 * h < n; h *= 2, ++j);
+    m = n - h;
+    Polynomial L, H, T;
+    if (!_cheb_compose_rec(a, h, qpows, &L)) {
+        return 0;
+    }
+    if (!_cheb_compose_rec(a + h, m, qpows, &H)) {
+        poly_free(&L);
+        return 0;
+    }
+    i = poly_multiply(qpows + j, &H, &T);
+    poly_free(&H);
+    if (!i || !poly_init(S, MAX(L.deg + m, T.deg))) {
+        if (i) poly_free(&T);
+        poly_free(&L);
+        return 0;
+    }
+    for (i = 0; i <= T.deg; ++i) S->coef[i] = Poly_GetCoef(&T, i);
+    for (i = 0; i <= L.deg; ++i) S->coef[i + m] = complex_add(S->coef[i + m], L.coef[i]);
+    poly_free(&L);
+    poly_free(&T);
+    _poly_normalize(S);
+    return 1;
+}
+
+/* Powers P**(2**j) for 2**j < n, with pows[0] = P */
+static int
+_square_powers(Polynomial *P, int n, Polynomial **pows)
+{
+    int j, count;
+    for (count = 1; (1 << count) < n; ++count);
+    if ((*pows = malloc(count * sizeof(Polynomial))) == NULL) {
+        return 0;
+    }
+    (*pows)[0] = *P;
+    for (j = 1; j < count; ++j) {
+        if (!poly_multiply(*pows + j - 1, *pows + j - 1, *pows + j)) {
+            while (--j > 0) poly_free(*pows + j);
+            free(*pows);
+            return 0;
+        }
+    }
+    return count;
+}
+
+int
+cheb_from_poly(Polynomial *A, Polynomial *C)
+{
+    Polynomial q, S, *qpows;
+    int k, count, d = A->deg;
+    if (d <= 0) {
+        return poly_copy(A, C);
+    }
+    if (!poly_init(&q, 2)) {
+        return 0;
+    }
+    poly_set_coef(&q, 0, (Complex){.5, 0.});
+    poly_set_coef(&q, 2, (Complex){.5, 0.});
+    if (!(count = _square_powers(&q, d + 1, &qpows))) {
+        poly_free(&q);
+        return 0;
+    }
+    k = _cheb_compose_rec(A->coef, d + 1, qpows, &S);
+    while (--count >= 0) poly_free(qpows + count);
+    free(qpows);
+    if (!k || !poly_init(C, d)) {
+        if (k) poly_free(&S);
+        return 0;
+    }
+    C->coef[0] = Poly_GetCoef(&S, d);
+    for (k = 1; k <= d; ++k) {
+        Complex t = Poly_GetCoef(&S, d + k);
+        C->coef[k] = (Complex){2. * t.real, 2. * t.imag};
+    }
+    poly_free(&S);
+    _poly_normalize(C);
+    return 1;
+}
+
+/* Conversion to the monomial basis.
+ * With h a power of two and m <= h, T_{h+j} = 2 T_h T_j - T_{h-j} gives
+ *      sum(c[k] T_k) = sum(c'[k] T_k, k < h) + 2 T_h sum(c''[j] T_j, j < m)
+ * where c'[h-j] = c[h-j] - c[h+j], c''[0] = c[h] / 2 and c''[j] = c[h+j]. */
+static int
+_cheb_expand_rec(const Complex *c, int n, Polynomial *tpows, Polynomial *P)
+{
+    int i, j, h, m;
+    if (n <= CHEB_CUTOFF) {
+        /* Clenshaw's algorithm on polynomial coefficients */
+        Complex *b = poly_mem_calloc(2 * (size_t)(n + 1), sizeof(Complex)), *b1 = b, *b2 = b + n + 1, *t;
+        if (b == NULL || !poly_init(P, n - 1)) {
+            poly_mem_free(b, 2 * (size_t)(n + 1) * sizeof(Complex));
+            return 0;
+        }
+        for (i = n - 1; i >= 1; --i) {
+            /* b2 <- c[i] + 2 X b1 - b2, then swap */
+            for (j = n - i; j >= 1; --j) {
+                b2[j] = complex_sub((Complex){2. * b1[j - 1].real, 2. * b1[j - 1].imag}, b2[j]);
+            }
+            b2[0] = complex_sub(c[i], b2[0]);
+            t = b1; b1 = b2; b2 = t;
+        }
+        P->coef[0] = complex_sub(c[0], b2[0]);
+        for (j = 1; j < n; ++j) {
+            P->coef[j] = complex_sub(b1[j - 1], b2[j]);
+        }
+        poly_mem_free(b, 2 * (size_t)(n + 1) * sizeof(Complex));
+        _poly_normalize(P);
+        return 1;
+    }
+    for (h = 1, j = 0; 2 * h < n; h *= 2, ++j);
+    m = n - h;
+    Complex *low = poly_mem_calloc(n, sizeof(Complex)), *high = low + h;
+    Polynomial L, H, T;
+    if (low == NULL) {
+        return 0;
+    }
+    memcpy(low, c, n * sizeof(Complex));
+    for (i = 1; i < m; ++i) {
+        low[h - i] = complex_sub(low[h - i], c[h + i]);
+    }
+    high[0] = (Complex){c[h].real / 2., c[h].imag / 2.};
+    if (!_cheb_expand_rec(low, h, tpows, &L)) {
+        poly_mem_free(low, (size_t)n * sizeof(Complex));
+        return 0;
+    }
+    if (!_cheb_expand_rec(high, m, tpows, &H)) {
+        poly_mem_free(low, (size_t)n * sizeof(Complex));
+        poly_free(&L);
+        return 0;
+    }
+    poly_mem_free(low, (size_t)n * sizeof(Complex));
+    i = poly_multiply(tpows + j, &H, &T);
+    poly_free(&H);
+    if (!i || !poly_init(P, MAX(L.deg, T.deg))) {
+        if (i) poly_free(&T);
+        poly_free(&L);
+        return 0;
+    }
+    for (i = 0; i <= P->deg; ++i) {
+        Complex t = Poly_GetCoef(&T, i);
+        P->coef[i] = complex_add(Poly_GetCoef(&L, i), (Complex){2. * t.real, 2. * t.imag});
+    }
+    poly_free(&L);
+    poly_free(&T);
+    _poly_normalize(P);
+    return 1;
+}
+
+int
+cheb_to_poly(Polynomial *C, Polynomial *P)
+{
+    Polynomial *tpows;
+    int j, count, res;
+    if (C->deg < CHEB_CUTOFF) {
+        return (C->deg == -1) ? poly_init(P, -1) : _cheb_expand_rec(C->coef, C->deg + 1, NULL, P);
+    }
+    /* T_{2**j} polynomials, T_{2h} = 2 T_h**2 - 1 */
+    for (count = 1; (1 << count) < C->deg + 1; ++count);
+    if ((tpows = malloc(count * sizeof(Polynomial))) == NULL) {
+        return 0;
+    }
+    if (!poly_init(tpows, 1)) {
+        free(tpows);
+        return 0;
+    }
+    poly_set_coef(tpows, 1, COne);
+    for (j = 1; j < count; ++j) {
+        Polynomial S;
+        if (!poly_multiply(tpows + j - 1, tpows + j - 1, &S)) break;
+        if (!poly_scal_multiply(&S, (Complex){2., 0.}, tpows + j)) {
+            poly_free(&S);
+            break;
+        }
+        poly_free(&S);
+        poly_set_coef(tpows + j, 0, complex_sub(tpows[j].coef[0], COne));
+    }
+    res = (j == count) && _cheb_expand_rec(C->coef, C->deg + 1, tpows, P);
+    while (--j >= 0) poly_free(tpows + j);
+    free(tpows);
+    return res;
+}
+
+/* Discrete Fourier transform, y[k] = sum(x[j] * exp(sign * 2i pi j k / n)).
+ * Radix-2 when n is a power of two, Bluestein's algorithm otherwise. */
+static void
+_fft_radix2(Complex *a, int n, int sign)
+{
+    int i, j, len, k;
+    Complex u, v, w;
+    for (i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            u = a[i];
+            a[i] = a[j];
+            a[j] = u;
+        }
+    }
+    for (len = 2; len <= n; len <<= 1) {
+        for (k = 0; k < len / 2; ++k) {
+            w = (Complex){cos(2. * M_PI * k / len), sign * sin(2. * M_PI * k / len)};
+            for (i = k; i < n; i += len) {
+                u = a[i];
+                v = complex_mult(a[i + len / 2], w);
+                a[i] = complex_add(u, v);
+                a[i + len / 2] = complex_sub(u, v);
+            }
+        }
+    }
+}
+
+static int
+_fft(Complex *a, int n, int sign)
+{
+    int i, m;
+    if ((n & (n - 1)) == 0) {
+        _fft_radix2(a, n, sign);
+        return 1;
+    }
+    for (m = 1; m < 2 * n - 1; m <<= 1);
+    Complex *chirp = poly_mem_calloc((size_t)n + 2 * (size_t)m, sizeof(Complex));
+    if (chirp == NULL) {
+        return 0;
+    }
+    Complex *u = chirp + n, *v = u + m;
+    for (i = 0; i < n; ++i) {
+        /* exp(sign * i pi j**2 / n), with j**2 reduced modulo 2n */
+        double t = M_PI * (double)(((long long)i * i) % (2 * (long long)n)) / n;
+        chirp[i] = (Complex){cos(t), sign * sin(t)};
+    }
+    memset(u, 0, 2 * (size_t)m * sizeof(Complex));
+    for (i = 0; i < n; ++i) {
+        u[i] = complex_mult(a[i], chirp[i]);
+        v[i] = (Complex){chirp[i].real, -chirp[i].imag};
+        if (i) v[m - i] = v[i];
+    }
+    _fft_radix2(u, m, -1);
+    _fft_radix2(v, m, -1);
+    for (i = 0; i < m; ++i) {
+        u[i] = complex_mult(u[i], v[i]);
+    }
+    _fft_radix2(u, m, 1);
+    for (i = 0; i < n; ++i) {
+        Complex t = complex_mult(u[i], chirp[i]);
+        a[i] = (Complex){t.real / m, t.imag / m};
+    }
+    poly_mem_free(chirp, ((size_t)n + 2 * (size_t)m) * sizeof(Complex));
+    return 1;
+}
+
+/* Interpolation at the Chebyshev points x[j] = cos(pi (j + 1/2) / n),
+ * through a DCT-II computed with a FFT of size 2n on the even extension
+ * of the values. */
+int
+cheb_from_values(const Complex *ys, int n, Polynomial *C)
+{
+    int j;
+    if (!poly_init(C, n - 1)) {
+        return 0;
+    }
+    if (n == 0) {
+        return 1;
+    }
+    Complex *w = poly_mem_calloc(2 * (size_t)n, sizeof(Complex));
+    if (w == NULL) {
+        poly_free(C);
+        return 0;
+    }
+    for (j = 0; j < n; ++j) {
+        w[j] = w[2 * n - 1 - j] = ys[j];
+    }
+    if (!_fft(w, 2 * n, -1)) {
+        poly_mem_free(w, 2 * (size_t)n * sizeof(Complex));
+        poly_free(C);
+        return 0;
+    }
+    for (j = 0; j < n; ++j) {
+        double t = -M_PI * j / (2. * n), s = ((j == 0) ? 1. : 2.) / (2. * n);
+        Complex c = complex_mult(w[j], (Complex){cos(t), sin(t)});
+        C->coef[j] = (Complex){s * c.real, s * c.imag};
+    }
+    poly_mem_free(w, 2 * (size_t)n * sizeof(Complex));
+    _poly_normalize(C);
+    return 1;
+}
+
+/* Values at the n Chebyshev points (DCT-III), requires deg < n:
+ *      y[j] = (U[j] + V[j]) / 2
+ * with U and V the DFTs of c[k] exp(+- i pi k / 2n) */
+int
+cheb_values(Polynomial *C, int n, Complex *ys)
+{
+    int j, k;
+    Complex *u = poly_mem_calloc(4 * (size_t)n, sizeof(Complex)), *v = u + 2 * n;
+    if (u == NULL) {
+        return 0;
+    }
+    for (k = 0; k <= C->deg; ++k) {
+        double t = M_PI * k / (2. * n);
+        u[k] = complex_mult(C->coef[k], (Complex){cos(t), sin(t)});
+        v[k] = complex_mult(C->coef[k], (Complex){cos(t), -sin(t)});
+    }
+    if (!_fft(u, 2 * n, 1) || !_fft(v, 2 * n, -1)) {
+        poly_mem_free(u, 4 * (size_t)n * sizeof(Complex));
+        return 0;
+    }
+    for (j = 0; j < n; ++j) {
+        Complex y = complex_add(u[j], v[j]);
+        ys[j] = (Complex){y.real / 2., y.imag / 2.};
+    }
+    poly_mem_free(u, 4 * (size_t)n * sizeof(Complex));
+    return 1;
+}
+
+/* Legendre series: P_n(cos t) = sum(a[k] a[n-k] cos((n - 2k) t), k = 0..n)
+ * with a[k] = binomial(2k, k) / 4**k, which gives the (triangular) change
+ * of basis matrix:
+ *      P_n = sum(w(m) a[(n-m)/2] a[(n+m)/2] T_m, m = n, n-2, ...)
+ * w(0) = 1, w(m) = 2 otherwise. */
+static double*
+_legendre_weights(int n)
+{
+    double *a = poly_mem_calloc(n + 1, sizeof(double));
+    int k;
+    if (a != NULL) {
+        a[0] = 1.;
+        for (k = 1; k <= n; ++k) a[k] = a[k - 1] * (2. * k - 1.) / (2. * k);
+    }
+    return a;
+}
+
+int
+cheb_from_legendre(const Complex *l, int n, Polynomial *C)
+{
+    int m, k;
+    double *a, w;
+    if (!poly_init(C, n - 1)) {
+        return 0;
+    }
+    if (n == 0) {
+        return 1;
+    }
+    if ((a = _legendre_weights(n)) == NULL) {
+        poly_free(C);
+        return 0;
+    }
+    for (k = 0; k < n; ++k) {
+        for (m = k; m >= 0; m -= 2) {
+            w = ((m == 0) ? 1. : 2.) * a[(k - m) / 2] * a[(k + m) / 2];
+            C->coef[m].real += w * l[k].real;
+            C->coef[m].imag += w * l[k].imag;
+        }
+    }
+    poly_mem_free(a, (n + 1) * sizeof(double));
+    _poly_normalize(C);
+    return 1;
+}
+
+/* Back substitution in the triangular system above, l has deg + 1 entries */
+int
+cheb_to_legendre(Polynomial *C, Complex *l)
+{
+    int m, k;
+    double *a, w;
+    Complex *c;
+    if (C->deg == -1) {
+        return 1;
+    }
+    if ((a = _legendre_weights(C->deg)) == NULL) {
+        return 0;
+    }
+    if ((c = poly_mem_calloc(C->deg + 1, sizeof(Complex))) == NULL) {
+        poly_mem_free(a, (C->deg + 1) * sizeof(double));
+        return 0;
+    }
+    memcpy(c, C->coef, (C->deg + 1) * sizeof(Complex));
+    for (k = C->deg; k >= 0; --k) {
+        w = ((k == 0) ? 1. : 2.) * a[0] * a[k];
+        l[k] = (Complex){c[k].real / w, c[k].imag / w};
+        for (m = k - 2; m >= 0; m -= 2) {
+            w = ((m == 0) ? 1. : 2.) * a[(k - m) / 2] * a[(k + m) / 2];
+            c[m].real -= w * l[k].real;
+            c[m].imag -= w * l[k].imag;
+        }
+    }
+    poly_mem_free(a, (C->deg + 1) * sizeof(double));
+    poly_mem_free(c, (C->deg + 1) * sizeof(Complex));
     return 1;
-error:
-    poly_free(P);
-    poly_free(&T);
-    poly_free(&R);
-    return 0;
 }
@@ -1,6 +1,7 @@
 #ifndef POLYNOMIALS_H
 #define POLYNOMIALS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifndef PYPOLY_VERSION
@@ -13,15 +14,50 @@ typedef struct {
 #define Complex Py_complex
 #endif
 
+/* Reference counted storage of the coefficients.
+ * poly_copy only takes a new reference on the buffer of its source, the
+ * coefficients being duplicated by poly_unshare before they get modified
+ * (copy on write). */
+typedef struct {
+    size_t refs;
+    int size;           // Allocated coefficients, grown geometrically
+    Complex data[];
+} PolyBuffer;
+
+/* Allocator of the coefficients: the PyMem_Raw* functions in the Python
+ * module, those of the C library otherwise. poly_set_allocator(NULL) restores
+ * the default one. The allocator may only be changed while no coefficients
+ * are allocated, and its functions must be thread safe. */
+typedef struct {
+    void *(*calloc)(size_t count, size_t size);
+    void *(*realloc)(void *ptr, size_t size);
+    void (*free)(void *ptr);
+} PolyAllocator;
+
+void poly_set_allocator(const PolyAllocator *A);
+
+/* Number of bytes currently allocated for coefficients */
+size_t poly_allocated_bytes(void);
+
+/* Allocation functions of the coefficients, given the sizes of the blocks */
+void *poly_mem_calloc(size_t count, size_t size);
+
+void *poly_mem_realloc(void *ptr, size_t old_size, size_t size);
+
+void poly_mem_free(void *ptr, size_t size);
+
 /* Polynomial structure.
  * A Polynomial is represented as a basic array.
  * Since a Complex generally takes 8 bytes of memory, the coefficients will take
  * (1 + degree) * 8 bytes of memory. This shouldn't be a problem in common
- * use cases. */
+ * use cases.
+ * "coef" points to the data of "buf", except for views (see poly_view), whose
+ * buffer is NULL. */
 typedef struct {
     Complex* coef;
     int deg;
     uint32_t bloom;
+    PolyBuffer *buf;
 } Polynomial;
 
 int poly_init(Polynomial *P, int deg);
@@ -30,16 +66,59 @@ void poly_free(Polynomial *P);
 
 int poly_copy(Polynomial *P, Polynomial *R);
 
+int poly_unshare(Polynomial *P);
+
+size_t poly_sizeof(Polynomial *P);
+
+void poly_view(Polynomial *P, Complex *coef, int deg);
+
 int poly_equal(Polynomial *P, Polynomial *Q);
 
 char* poly_to_string(Polynomial *P);
 
+/* Writes the monomial of the term i into "s", returning its length (at most
+ * POLY_MONOMIAL_MAXLEN), or 0 for the constant term */
+#define POLY_MONOMIAL_MAXLEN    512
+typedef size_t (*poly_monomial_namer)(void *ctx, size_t i, char *s);
+
+char* poly_terms_to_string(const Complex *c, size_t n, poly_monomial_namer name, void *ctx);
+
+/* Output callback used by poly_write, receiving successive chunks of the
+ * string representation. It should return 0 on failure. */
+typedef int (*poly_writer)(void *ctx, const char *data, size_t len);
+
+int poly_write(Polynomial *P, poly_writer write, void *ctx);
+
 void poly_set_coef(Polynomial *P, int i, Complex c);
 
 int poly_realloc(Polynomial *P, int deg);
 
+int poly_slice(Polynomial *A, int start, int step, int n, Polynomial *R);
+
+int poly_set_slice(Polynomial *P, int start, int step, const Complex *values, int n);
+
 Complex poly_eval(Polynomial *P, Complex c);
 
+Complex poly_eval_real(Polynomial *P, double x);
+
+/* Evaluation form of a polynomial, prepared once for repeated evaluations */
+typedef struct {
+    double *re, *im;    // Coefficients in the order read by the evaluation chains
+    int deg;
+    int rows;
+    int real;           // All the coefficients are real, im is NULL
+} PolyEvaluator;
+
+int poly_evaluator_init(Polynomial *P, PolyEvaluator *E);
+
+void poly_evaluator_free(PolyEvaluator *E);
+
+size_t poly_evaluator_sizeof(const PolyEvaluator *E);
+
+Complex poly_evaluator_eval(const PolyEvaluator *E, Complex x);
+
+void poly_evaluator_eval_many(const PolyEvaluator *E, const Complex *xs, Complex *ys, int n);
+
 int poly_add(Polynomial *A, Polynomial *B, Polynomial *R);
 
 int poly_sub(Polynomial *A, Polynomial *B, Polynomial *R);
@@ -48,18 +127,79 @@ int poly_neg(Polynomial *A, Polynomial *R);
 
 int poly_scal_multiply(Polynomial *A, Complex c, Polynomial *R);
 
+int poly_linear_combination(Polynomial **Ps, const Complex *cs, int n,
+                            const Complex *ms, const int *ks, int m, Polynomial *R);
+
 int poly_multiply(Polynomial *A, Polynomial *B, Polynomial *R);
 
 int poly_pow(Polynomial *A, unsigned int n, Polynomial *R);
 
+int poly_monomial_pow(Polynomial *A, unsigned int n, Complex *c);
+
 int poly_derive(Polynomial *A, unsigned int n, Polynomial *R);
 
 int poly_integrate(Polynomial *A, unsigned int n, Polynomial *R);
 
+/* Classical orthogonal polynomials families */
+typedef enum {
+    POLY_CHEBYSHEV,     // Chebyshev polynomials of the first kind
+    POLY_LEGENDRE,
+    POLY_HERMITE        // Probabilists' Hermite polynomials
+} OrthogonalFamily;
+
+int poly_orthogonal_next(OrthogonalFamily family, int n, Polynomial *U, Polynomial *V,
+                         Polynomial *R);
+
+int poly_cyclotomic(int n, Polynomial *R);
+
+int poly_shift(Polynomial *A, Complex a, Polynomial *R);
+
+int poly_taylor(Polynomial *A, Complex a, int k, Complex *ds);
+
+int poly_taylor_many(Polynomial *A, const Complex *xs, int n, int k, Complex *ds);
+
+int poly_compose(Polynomial *A, Polynomial *B, Polynomial *R);
+
 int poly_div(Polynomial *A, Polynomial *B, Polynomial *Q, Polynomial *R);
 
 int poly_gcd(Polynomial *A, Polynomial *B, Polynomial *P);
 
+int poly_resultant(Polynomial *A, Polynomial *B, Complex *r);
+
+/* Returns -1 if deg A < 1 */
+int poly_discriminant(Polynomial *A, Complex *d);
+
+/* A = lc(A) * prod(factors[i]**mult[i]), the factors being monic,
+ * square-free and pairwise coprime, up to the relative tolerance tol on the
+ * coefficients of A: a root of multiplicity m of A is a root of
+ * multiplicity m, but not m + 1, of a polynomial at this distance from A.
+ * "factors" and "mult" must have room for deg A entries. Returns -1 if A is
+ * zero. */
+#define POLY_SQUAREFREE_TOL     1e-6
+
+int poly_squarefree(Polynomial *A, double tol, Polynomial *factors, int *mult, int *count);
+
+int poly_interpolate(const Complex *xs, const Complex *ys, int n, Polynomial *R);
+
+int poly_roots(Polynomial *P, Complex *roots, int parallel);
+
+/* Chebyshev series sum(C->coef[k] * T_k), stored in Polynomial structures */
+Complex cheb_eval(Polynomial *C, Complex x);
+
+void cheb_eval_many(Polynomial *C, const Complex *xs, Complex *ys, int n);
+
+int cheb_from_poly(Polynomial *A, Polynomial *C);
+
+int cheb_to_poly(Polynomial *C, Polynomial *P);
+
+int cheb_from_values(const Complex *ys, int n, Polynomial *C);
+
+int cheb_values(Polynomial *C, int n, Complex *ys);
+
+int cheb_from_legendre(const Complex *l, int n, Polynomial *C);
+
+int cheb_to_legendre(Polynomial *C, Complex *l);
+
 /* Common Macros / inline helpers */
 
 /* Check if a complex number equals (0,0).
@@ -0,0 +1,397 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rational.h"
+
+#define MAX(a,b)    (((int)(a)>(int)(b))?(int)(a):(int)(b))
+
+/* The operators reduce their results early once num.deg + den.deg exceeds
+ * RATFUNC_REDUCE_DEGREE and twice its value after the last reduction of the
+ * operands: the GCD computations are amortized by the growth of the
+ * degrees, which stays bounded when the fractions do simplify. */
+#define RATFUNC_REDUCE_DEGREE   32
+
+static int
+_poly_is_one(Polynomial *P)
+{
+    return P->deg == 0 && P->coef[0].real == 1. && P->coef[0].imag == 0.;
+}
+
+/* Scales num and den so that den gets monic */
+static int
+_ratfunc_monic(RationalFunction *A)
+{
+    Complex l = Poly_LeadCoef(&A->den), c;
+    Polynomial N, D;
+    double m = l.real * l.real + l.imag * l.imag;
+    if (l.real == 1. && l.imag == 0.) {
+        return 1;
+    }
+    c.real = l.real / m;
+    c.imag = -l.imag / m;
+    if (!poly_scal_multiply(&A->num, c, &N)) {
+        return 0;
+    }
+    if (!poly_scal_multiply(&A->den, c, &D)) {
+        poly_free(&N);
+        return 0;
+    }
+    poly_free(&A->num);
+    poly_free(&A->den);
+    A->num = N;
+    A->den = D;
+    return 1;
+}
+
+/* Common end of the operators: R->num and R->den are set, R->reduced_deg
+ * holds that of the operands. Constant denominators and zero numerators are
+ * normalized right away, large degrees trigger a reduction. */
+static int
+_ratfunc_finish(RationalFunction *R)
+{
+    const int deg = R->num.deg + R->den.deg;
+    int failure = 0;
+    if (R->num.deg == -1 && R->den.deg > 0) {
+        poly_free(&R->den);
+        Poly_InitConst(&R->den, ((Complex){1, 0}), failure)
+    }
+    if (failure || (R->den.deg == 0 && !_ratfunc_monic(R))) {
+        ratfunc_free(R);
+        return 0;
+    }
+    if (R->den.deg == 0) {
+        R->reduced = 1;
+        R->reduced_deg = R->num.deg;
+    } else if (deg > RATFUNC_REDUCE_DEGREE && deg > 2 * R->reduced_deg) {
+        if (!ratfunc_reduce(R)) {
+            ratfunc_free(R);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int
+ratfunc_init(RationalFunction *R, Polynomial *N, Polynomial *D)
+{
+    if (D->deg == -1) {
+        return -1;
+    }
+    if (!poly_copy(N, &R->num)) {
+        return 0;
+    }
+    if (!poly_copy(D, &R->den)) {
+        poly_free(&R->num);
+        return 0;
+    }
+    R->reduced = 0;
+    R->reduced_deg = N->deg + D->deg;
+    return _ratfunc_finish(R);
+}
+
+void
+ratfunc_free(RationalFunction *R)
+{
+    poly_free(&R->num);
+    poly_free(&R->den);
+}
+
+int
+ratfunc_copy(RationalFunction *A, RationalFunction *R)
+{
+    if (!poly_copy(&A->num, &R->num)) {
+        return 0;
+    }
+    if (!poly_copy(&A->den, &R->den)) {
+        poly_free(&R->num);
+        return 0;
+    }
+    R->reduced = A->reduced;
+    R->reduced_deg = A->reduced_deg;
+    return 1;
+}
+
+int
+ratfunc_reduce(RationalFunction *A)
+{
+    Polynomial G, N, D, T;
+    if (A->reduced) {
+        return 1;
+    }
+    if (!poly_gcd(&A->num, &A->den, &G)) {
+        return 0;
+    }
+    if (G.deg > 0) {
+        if (!poly_div(&A->num, &G, &N, &T)) {
+            poly_free(&G);
+            return 0;
+        }
+        poly_free(&T);
+        if (!poly_div(&A->den, &G, &D, &T)) {
+            poly_free(&N);
+            poly_free(&G);
+            return 0;
+        }
+        poly_free(&T);
+        poly_free(&A->num);
+        poly_free(&A->den);
+        A->num = N;
+        A->den = D;
+    }
+    poly_free(&G);
+    if (!_ratfunc_monic(A)) {
+        return 0;
+    }
+    A->reduced = 1;
+    A->reduced_deg = A->num.deg + A->den.deg;
+    return 1;
+}
+
+int
+ratfunc_equal(RationalFunction *A, RationalFunction *B, int *eq)
+{
+    if (!ratfunc_reduce(A) || !ratfunc_reduce(B)) {
+        return 0;
+    }
+    *eq = poly_equal(&A->num, &B->num) && poly_equal(&A->den, &B->den);
+    return 1;
+}
+
+/* "num" alone for a denominator 1, "(num) / (den)" otherwise */
+char*
+ratfunc_to_string(RationalFunction *A)
+{
+    char *num, *den, *s;
+    if ((num = poly_to_string(&A->num)) == NULL || _poly_is_one(&A->den)) {
+        return num;
+    }
+    if ((den = poly_to_string(&A->den)) == NULL) {
+        free(num);
+        return NULL;
+    }
+    if ((s = malloc(strlen(num) + strlen(den) + 8)) != NULL) {
+        sprintf(s, "(%s) / (%s)", num, den);
+    }
+    free(num);
+    free(den);
+    return s;
+}
+
+/* Sum (sign > 0) or difference, the common denominator being kept when the
+ * operands share it */
+static int
+_ratfunc_addsub(RationalFunction *A, RationalFunction *B, RationalFunction *R, int sign)
+{
+    Polynomial T1, T2;
+    int res;
+    R->reduced = 0;
+    R->reduced_deg = MAX(A->reduced_deg, B->reduced_deg);
+    if (poly_equal(&A->den, &B->den)) {
+        res = (sign > 0) ? poly_add(&A->num, &B->num, &R->num)
+                         : poly_sub(&A->num, &B->num, &R->num);
+        if (!res) {
+            return 0;
+        }
+        if (!poly_copy(&A->den, &R->den)) {
+            poly_free(&R->num);
+            return 0;
+        }
+        return _ratfunc_finish(R);
+    }
+    if (!poly_multiply(&A->num, &B->den, &T1)) {
+        return 0;
+    }
+    if (!poly_multiply(&B->num, &A->den, &T2)) {
+        poly_free(&T1);
+        return 0;
+    }
+    res = (sign > 0) ? poly_add(&T1, &T2, &R->num) : poly_sub(&T1, &T2, &R->num);
+    poly_free(&T1);
+    poly_free(&T2);
+    if (!res) {
+        return 0;
+    }
+    if (!poly_multiply(&A->den, &B->den, &R->den)) {
+        poly_free(&R->num);
+        return 0;
+    }
+    return _ratfunc_finish(R);
+}
+
+int
+ratfunc_add(RationalFunction *A, RationalFunction *B, RationalFunction *R)
+{
+    return _ratfunc_addsub(A, B, R, 1);
+}
+
+int
+ratfunc_sub(RationalFunction *A, RationalFunction *B, RationalFunction *R)
+{
+    return _ratfunc_addsub(A, B, R, -1);
+}
+
+int
+ratfunc_neg(RationalFunction *A, RationalFunction *R)
+{
+    if (!poly_neg(&A->num, &R->num)) {
+        return 0;
+    }
+    if (!poly_copy(&A->den, &R->den)) {
+        poly_free(&R->num);
+        return 0;
+    }
+    R->reduced = A->reduced;
+    R->reduced_deg = A->reduced_deg;
+    return 1;
+}
+
+/* Cross products, skipping those of a numerator by the same denominator */
+int
+ratfunc_multiply(RationalFunction *A, RationalFunction *B, RationalFunction *R)
+{
+    Polynomial *N1 = &A->num, *N2 = &B->num, *D1 = &A->den, *D2 = &B->den;
+    Polynomial one;
+    int failure = 0;
+    Poly_InitConst(&one, ((Complex){1, 0}), failure)
+    if (failure) {
+        return 0;
+    }
+    if (poly_equal(N1, D2)) {
+        N1 = D2 = &one;
+    }
+    if (poly_equal(N2, D1)) {
+        N2 = D1 = &one;
+    }
+    R->reduced = 0;
+    R->reduced_deg = MAX(A->reduced_deg, B->reduced_deg);
+    if (!poly_multiply(N1, N2, &R->num)) {
+        poly_free(&one);
+        return 0;
+    }
+    if (!poly_multiply(D1, D2, &R->den)) {
+        poly_free(&R->num);
+        poly_free(&one);
+        return 0;
+    }
+    poly_free(&one);
+    return _ratfunc_finish(R);
+}
+
+int
+ratfunc_divide(RationalFunction *A, RationalFunction *B, RationalFunction *R)
+{
+    RationalFunction I = *B;    // Shares the polynomials of B
+    if (B->num.deg == -1) {
+        return -1;
+    }
+    I.num = B->den;
+    I.den = B->num;
+    return ratfunc_multiply(A, &I, R);
+}
+
+/* Powers of coprime polynomials stay coprime: the reduced state is kept */
+int
+ratfunc_pow(RationalFunction *A, int n, RationalFunction *R)
+{
+    Polynomial *N = &A->num, *D = &A->den;
+    unsigned int m = (unsigned int)n;
+    if (n < 0) {
+        if (A->num.deg == -1) {
+            return -1;
+        }
+        N = &A->den;
+        D = &A->num;
+        m = 0u - m;
+    }
+    if (!poly_pow(N, m, &R->num)) {
+        return 0;
+    }
+    if (!poly_pow(D, m, &R->den)) {
+        poly_free(&R->num);
+        return 0;
+    }
+    if (!_ratfunc_monic(R)) {
+        ratfunc_free(R);
+        return 0;
+    }
+    R->reduced = A->reduced;
+    R->reduced_deg = R->num.deg + R->den.deg;
+    return _ratfunc_finish(R);
+}
+
+/* Horner's method on both polynomials in the same loop. Outside of the unit
+ * disk, the reversed polynomials are evaluated at 1 / x instead, which
+ * avoids overflowing on large x:
+ *      N(x) / D(x) = x**(dn - dd) * rev(N)(1 / x) / rev(D)(1 / x) */
+int
+ratfunc_eval(RationalFunction *A, Complex x, Complex *y)
+{
+    const Complex *n, *d;
+    double nr = 0., ni = 0., dr = 0., di = 0., xr = x.real, xi = x.imag, t, m;
+    int k, dn, dd, inverted;
+    if (!ratfunc_reduce(A)) {
+        return 0;
+    }
+    n = A->num.coef;
+    d = A->den.coef;
+    dn = A->num.deg;
+    dd = A->den.deg;
+    if ((inverted = (xr * xr + xi * xi > 1.))) {
+        /* 1 / x, scaled to avoid overflowing on |x|**2 */
+        if (fabs(xr) >= fabs(xi)) {
+            t = xi / xr;
+            m = xr + xi * t;
+            xr = 1. / m;
+            xi = -t / m;
+        } else {
+            t = xr / xi;
+            m = xr * t + xi;
+            xr = t / m;
+            xi = -1. / m;
+        }
+        for (k = 0; k <= MAX(dn, dd); ++k) {
+            if (k <= dn) {
+                t = nr * xr - ni * xi + n[k].real;
+                ni = nr * xi + ni * xr + n[k].imag;
+                nr = t;
+            }
+            if (k <= dd) {
+                t = dr * xr - di * xi + d[k].real;
+                di = dr * xi + di * xr + d[k].imag;
+                dr = t;
+            }
+        }
+    } else {
+        for (k = MAX(dn, dd); k >= 0; --k) {
+            t = nr * xr - ni * xi + (k <= dn ? n[k].real : 0.);
+            ni = nr * xi + ni * xr + (k <= dn ? n[k].imag : 0.);
+            nr = t;
+            t = dr * xr - di * xi + (k <= dd ? d[k].real : 0.);
+            di = dr * xi + di * xr + (k <= dd ? d[k].imag : 0.);
+            dr = t;
+        }
+    }
+    if ((m = dr * dr + di * di) == 0.) {
+        return -1;
+    }
+    t = (nr * dr + ni * di) / m;
+    ni = (ni * dr - nr * di) / m;
+    nr = t;
+    if (inverted && dn != -1) {
+        /* Multiplication by x**(dn - dd), 1 / x being in (xr, xi) */
+        if (dn > dd) {
+            xr = x.real;
+            xi = x.imag;
+        }
+        for (k = abs(dn - dd); k > 0; --k) {
+            t = nr * xr - ni * xi;
+            ni = nr * xi + ni * xr;
+            nr = t;
+        }
+    }
+    y->real = nr;
+    y->imag = ni;
+    return 1;
+}
@@ -0,0 +1,53 @@
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include "polynomials.h"
+
+/* Rational functions num / den.
+ * The fraction is only reduced (common factors removed by poly_gcd, monic
+ * denominator) on demand by ratfunc_reduce, the operators keeping their
+ * results unreduced unless their degree grows too much (see
+ * RATFUNC_REDUCE_DEGREE in rational.c).
+ *
+ * The operators follow the Polynomial conventions (destinations are not
+ * initialized beforehand, 0 is returned on memory allocation error), and
+ * return -1 on division by zero. */
+typedef struct {
+    Polynomial num;
+    Polynomial den;
+    int reduced;        // Set when num and den are known coprime, den monic
+    int reduced_deg;    // num.deg + den.deg after the last reduction
+} RationalFunction;
+
+/* R = N / D, the polynomials being copied */
+int ratfunc_init(RationalFunction *R, Polynomial *N, Polynomial *D);
+
+void ratfunc_free(RationalFunction *R);
+
+int ratfunc_copy(RationalFunction *A, RationalFunction *R);
+
+/* Reduces A in place */
+int ratfunc_reduce(RationalFunction *A);
+
+/* Equality of the reduced fractions, A and B being reduced if needed */
+int ratfunc_equal(RationalFunction *A, RationalFunction *B, int *eq);
+
+char* ratfunc_to_string(RationalFunction *A);
+
+int ratfunc_add(RationalFunction *A, RationalFunction *B, RationalFunction *R);
+
+int ratfunc_sub(RationalFunction *A, RationalFunction *B, RationalFunction *R);
+
+int ratfunc_neg(RationalFunction *A, RationalFunction *R);
+
+int ratfunc_multiply(RationalFunction *A, RationalFunction *B, RationalFunction *R);
+
+int ratfunc_divide(RationalFunction *A, RationalFunction *B, RationalFunction *R);
+
+int ratfunc_pow(RationalFunction *A, int n, RationalFunction *R);
+
+/* *y = A(x), the numerator and denominator being evaluated in a single pass.
+ * Returns -1 if x is a root of the denominator. */
+int ratfunc_eval(RationalFunction *A, Complex x, Complex *y);
+
+#endif
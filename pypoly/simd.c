@@ -0,0 +1,327 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PYPOLY_X86_SIMD
+#include <immintrin.h>
+/* The AVX-512 instruction set includes fused multiply-adds, which the
+ * compiler must not use: they would change the rounding of the results. */
+#define TARGET_AVX2     __attribute__((target("avx2")))
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#define TARGET_AVX512   __attribute__((target("avx512f")))
+#else
+#define TARGET_AVX512   __attribute__((target("avx512f"), optimize("fp-contract=off")))
+#endif
+#endif
+
+static SimdLevel level = -1;    // -1 means "not initialized yet"
+
+SimdLevel
+simd_level(void)
+{
+    if ((int)level == -1) {
+        SimdLevel best = SIMD_NONE;
+        const char *env = getenv("PYPOLY_SIMD");
+#ifdef PYPOLY_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            best = SIMD_AVX512;
+        } else if (__builtin_cpu_supports("avx2")) {
+            best = SIMD_AVX2;
+        }
+#endif
+        if (env != NULL && strcmp(env, "none") == 0) {
+            best = SIMD_NONE;
+        } else if (env != NULL && strcmp(env, "avx2") == 0 && best > SIMD_AVX2) {
+            best = SIMD_AVX2;
+        }
+        level = best;
+    }
+    return level;
+}
+
+/**
+ * Convolution
+ * The outputs are computed by blocks of CONV_BLOCK, which stay in registers
+ * while the whole of a is scanned. b is padded with na - 1 zeros on the left
+ * and enough zeros on the right so that the blocks never need bound checks:
+ *   r[k] = sum(a[i] * bp[k - i + na - 1], 0 <= i < na)
+ */
+#define CONV_BLOCK      16
+#define CONV_STACK      1024    // Doubles of workspace taken from the stack
+
+#define CONVOLVE_BODY                                                       \
+    int k0, i, l;                                                           \
+    for (k0 = 0; k0 < nr; k0 += CONV_BLOCK) {                               \
+        double sr[CONV_BLOCK] = {0}, si[CONV_BLOCK] = {0};                  \
+        for (i = 0; i < na; ++i) {                                          \
+            const double xr = ar[i], xi = ai[i];                            \
+            const double *yr = br + k0 - i + na - 1;                        \
+            const double *yi = bi + k0 - i + na - 1;                        \
+            for (l = 0; l < CONV_BLOCK; ++l) {                              \
+                sr[l] += xr * yr[l] - xi * yi[l];                           \
+                si[l] += xr * yi[l] + xi * yr[l];                           \
+            }                                                               \
+        }                                                                   \
+        memcpy(rr + k0, sr, sizeof(sr));                                    \
+        memcpy(ri + k0, si, sizeof(si));                                    \
+    }
+
+#define CONVOLVE_ARGS                                                       \
+    const double *restrict ar, const double *restrict ai, int na,           \
+    const double *restrict br, const double *restrict bi, int nr,           \
+    double *restrict rr, double *restrict ri
+
+typedef void (*convolve_func)(CONVOLVE_ARGS);
+
+static void
+_convolve_c(CONVOLVE_ARGS)
+{
+    CONVOLVE_BODY
+}
+
+#ifdef PYPOLY_X86_SIMD
+/* Same computation written with intrinsics, "w" doubles per vector: left to
+ * itself, the compiler vectorizes the loop on i rather than the block. */
+#define CONVOLVE_VECTOR_BODY(vec, w, set1, loadu, storeu, setzero, add, sub, mul) \
+    int k0, i, l;                                                           \
+    for (k0 = 0; k0 < nr; k0 += CONV_BLOCK) {                               \
+        vec sr[CONV_BLOCK / w], si[CONV_BLOCK / w], xr, xi, yr, yi;         \
+        for (l = 0; l < CONV_BLOCK / w; ++l) {                              \
+            sr[l] = si[l] = setzero();                                      \
+        }                                                                   \
+        for (i = 0; i < na; ++i) {                                          \
+            const double *pr = br + k0 - i + na - 1;                        \
+            const double *pi = bi + k0 - i + na - 1;                        \
+            xr = set1(ar[i]);                                               \
+            xi = set1(ai[i]);                                               \
+            for (l = 0; l < CONV_BLOCK / w; ++l) {                          \
+                yr = loadu(pr + l * w);                                     \
+                yi = loadu(pi + l * w);                                     \
+                sr[l] = add(sr[l], sub(mul(xr, yr), mul(xi, yi)));          \
+                si[l] = add(si[l], add(mul(xr, yi), mul(xi, yr)));          \
+            }                                                               \
+        }                                                                   \
+        for (l = 0; l < CONV_BLOCK / w; ++l) {                              \
+            storeu(rr + k0 + l * w, sr[l]);                                 \
+            storeu(ri + k0 + l * w, si[l]);                                 \
+        }                                                                   \
+    }
+
+TARGET_AVX2 static void
+_convolve_avx2(CONVOLVE_ARGS)
+{
+    CONVOLVE_VECTOR_BODY(__m256d, 4, _mm256_set1_pd, _mm256_loadu_pd,
+                         _mm256_storeu_pd, _mm256_setzero_pd, _mm256_add_pd,
+                         _mm256_sub_pd, _mm256_mul_pd)
+}
+
+TARGET_AVX512 static void
+_convolve_avx512(CONVOLVE_ARGS)
+{
+    CONVOLVE_VECTOR_BODY(__m512d, 8, _mm512_set1_pd, _mm512_loadu_pd,
+                         _mm512_storeu_pd, _mm512_setzero_pd, _mm512_add_pd,
+                         _mm512_sub_pd, _mm512_mul_pd)
+}
+#endif
+
+int
+simd_convolve(const Complex *a, int na, const Complex *b, int nb, Complex *r)
+{
+    static convolve_func convolve = NULL;
+    double stack[CONV_STACK], *w = stack, *ar, *ai, *br, *bi, *rr, *ri;
+    int i, nr = na + nb - 1;
+    int npad = (nr + CONV_BLOCK - 1) / CONV_BLOCK * CONV_BLOCK;
+    size_t size = 2 * ((size_t)na + (size_t)(npad + na - 1) + (size_t)npad);
+    if (convolve == NULL) {
+        switch (simd_level()) {
+#ifdef PYPOLY_X86_SIMD
+        case SIMD_AVX512:
+            convolve = _convolve_avx512;
+            break;
+        case SIMD_AVX2:
+            convolve = _convolve_avx2;
+            break;
+#endif
+        default:
+            convolve = _convolve_c;
+        }
+    }
+    if (size > CONV_STACK && (w = poly_mem_calloc(size, sizeof(double))) == NULL) {
+        return 0;
+    }
+    ar = w;
+    ai = ar + na;
+    br = ai + na;
+    bi = br + npad + na - 1;
+    rr = bi + npad + na - 1;
+    ri = rr + npad;
+    memset(br, 0, 2 * (size_t)(npad + na - 1) * sizeof(double));
+    for (i = 0; i < na; ++i) {
+        ar[i] = a[i].real;
+        ai[i] = a[i].imag;
+    }
+    for (i = 0; i < nb; ++i) {
+        br[na - 1 + i] = b[i].real;
+        bi[na - 1 + i] = b[i].imag;
+    }
+    convolve(ar, ai, na, br, bi, nr, rr, ri);
+    for (i = 0; i < nr; ++i) {
+        r[i].real = rr[i];
+        r[i].imag = ri[i];
+    }
+    if (w != stack) {
+        poly_mem_free(w, size * sizeof(double));
+    }
+    return 1;
+}
+
+/**
+ * Batched evaluation
+ * The SIMD_EVAL_CHAINS chains of all the points are updated together.
+ */
+#define EVAL_BATCH_BODY                                                     \
+    double a[SIMD_EVAL_CHAINS][SIMD_EVAL_BATCH] = {{0}};                    \
+    double x4[SIMD_EVAL_BATCH];                                             \
+    int j, r, p;                                                            \
+    for (p = 0; p < SIMD_EVAL_BATCH; ++p) {                                 \
+        x4[p] = (x[p] * x[p]) * (x[p] * x[p]);                              \
+    }                                                                       \
+    for (j = 0; j < rows; ++j) {                                            \
+        for (r = 0; r < SIMD_EVAL_CHAINS; ++r) {                            \
+            const double k = c[j * SIMD_EVAL_CHAINS + r];                   \
+            for (p = 0; p < SIMD_EVAL_BATCH; ++p) {                         \
+                a[r][p] = a[r][p] * x4[p] + k;                              \
+            }                                                               \
+        }                                                                   \
+    }                                                                       \
+    for (p = 0; p < SIMD_EVAL_BATCH; ++p) {                                 \
+        y[p] = a[SIMD_EVAL_CHAINS - 1][p];                                  \
+    }                                                                       \
+    for (r = SIMD_EVAL_CHAINS - 2; r >= 0; --r) {                           \
+        for (p = 0; p < SIMD_EVAL_BATCH; ++p) {                             \
+            y[p] = y[p] * x[p] + a[r][p];                                   \
+        }                                                                   \
+    }
+
+#define EVAL_BATCH_ARGS                                                     \
+    const double *restrict c, int rows,                                     \
+    const double *restrict x, double *restrict y
+
+typedef void (*eval_batch_func)(EVAL_BATCH_ARGS);
+
+static void
+_eval_batch_c(EVAL_BATCH_ARGS)
+{
+    EVAL_BATCH_BODY
+}
+
+#ifdef PYPOLY_X86_SIMD
+TARGET_AVX2 static void
+_eval_batch_avx2(EVAL_BATCH_ARGS)
+{
+    EVAL_BATCH_BODY
+}
+
+TARGET_AVX512 static void
+_eval_batch_avx512(EVAL_BATCH_ARGS)
+{
+    EVAL_BATCH_BODY
+}
+#endif
+
+void
+simd_eval_batch(const double *c, int rows, const double *x, double *y)
+{
+    static eval_batch_func eval_batch = NULL;
+    if (eval_batch == NULL) {
+        switch (simd_level()) {
+#ifdef PYPOLY_X86_SIMD
+        case SIMD_AVX512:
+            eval_batch = _eval_batch_avx512;
+            break;
+        case SIMD_AVX2:
+            eval_batch = _eval_batch_avx2;
+            break;
+#endif
+        default:
+            eval_batch = _eval_batch_c;
+        }
+    }
+    eval_batch(c, rows, x, y);
+}
+
+/**
+ * Products of polynomials stored in SIMD_EVAL_BATCH lanes
+ */
+#define MULTIPLY_LANES_BODY                                                 \
+    int i, j, l;                                                            \
+    memset(rr, 0, (size_t)(na + nb - 1) * SIMD_EVAL_BATCH * sizeof(double));\
+    memset(ri, 0, (size_t)(na + nb - 1) * SIMD_EVAL_BATCH * sizeof(double));\
+    for (i = 0; i < na; ++i) {                                              \
+        const double *xr = ar + i * SIMD_EVAL_BATCH;                        \
+        const double *xi = ai + i * SIMD_EVAL_BATCH;                        \
+        for (j = 0; j < nb; ++j) {                                          \
+            const double *yr = br + j * SIMD_EVAL_BATCH;                    \
+            const double *yi = bi + j * SIMD_EVAL_BATCH;                    \
+            double *zr = rr + (i + j) * SIMD_EVAL_BATCH;                    \
+            double *zi = ri + (i + j) * SIMD_EVAL_BATCH;                    \
+            for (l = 0; l < SIMD_EVAL_BATCH; ++l) {                         \
+                zr[l] += xr[l] * yr[l] - xi[l] * yi[l];                     \
+                zi[l] += xr[l] * yi[l] + xi[l] * yr[l];                     \
+            }                                                               \
+        }                                                                   \
+    }
+
+#define MULTIPLY_LANES_ARGS                                                 \
+    const double *restrict ar, const double *restrict ai, int na,           \
+    const double *restrict br, const double *restrict bi, int nb,           \
+    double *restrict rr, double *restrict ri
+
+typedef void (*multiply_lanes_func)(MULTIPLY_LANES_ARGS);
+
+static void
+_multiply_lanes_c(MULTIPLY_LANES_ARGS)
+{
+    MULTIPLY_LANES_BODY
+}
+
+#ifdef PYPOLY_X86_SIMD
+TARGET_AVX2 static void
+_multiply_lanes_avx2(MULTIPLY_LANES_ARGS)
+{
+    MULTIPLY_LANES_BODY
+}
+
+TARGET_AVX512 static void
+_multiply_lanes_avx512(MULTIPLY_LANES_ARGS)
+{
+    MULTIPLY_LANES_BODY
+}
+#endif
+
+void
+simd_multiply_lanes(const double *ar, const double *ai, int na,
+                    const double *br, const double *bi, int nb,
+                    double *rr, double *ri)
+{
+    static multiply_lanes_func multiply_lanes = NULL;
+    if (multiply_lanes == NULL) {
+        switch (simd_level()) {
+#ifdef PYPOLY_X86_SIMD
+        case SIMD_AVX512:
+            multiply_lanes = _multiply_lanes_avx512;
+            break;
+        case SIMD_AVX2:
+            multiply_lanes = _multiply_lanes_avx2;
+            break;
+#endif
+        default:
+            multiply_lanes = _multiply_lanes_c;
+        }
+    }
+    multiply_lanes(ar, ai, na, br, bi, nb, rr, ri);
+}
@@ -0,0 +1,46 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "polynomials.h"
+
+/* Vectorized kernels.
+ * Polynomial.coef interleaves real and imaginary parts, which costs shuffles
+ * to vectorize complex products. The kernels below rather work on the
+ * coefficients split into a real and an imaginary array ("structure of
+ * arrays"): the conversion is done at their boundaries only, in O(n), while
+ * the kernels themselves perform O(n**2) operations.
+ *
+ * Each kernel exists in AVX-512, AVX2 and portable C flavours, the best one
+ * for the running CPU is selected at the first call. The PYPOLY_SIMD
+ * environment variable ("avx512", "avx2" or "none") caps that selection.
+ * All flavours perform the same floating point operations in the same order,
+ * so that results do not depend on the CPU. */
+typedef enum {
+    SIMD_NONE,
+    SIMD_AVX2,
+    SIMD_AVX512
+} SimdLevel;
+
+SimdLevel simd_level(void);
+
+/* Computes the na + nb - 1 coefficients of a * b into r, accumulating the
+ * products a[i] * b[k - i] by increasing i. r must not overlap a or b.
+ * Returns 0 on memory allocation error, leaving r untouched. */
+int simd_convolve(const Complex *a, int na, const Complex *b, int nb, Complex *r);
+
+/* Horner's method on SIMD_EVAL_BATCH real points at once, for polynomials
+ * laid out in rows of SIMD_EVAL_CHAINS coefficients in x**SIMD_EVAL_CHAINS,
+ * highest row first (see PolyEvaluator). */
+#define SIMD_EVAL_CHAINS    4
+#define SIMD_EVAL_BATCH     8
+
+void simd_eval_batch(const double *c, int rows, const double *x, double *y);
+
+/* Products of SIMD_EVAL_BATCH pairs of polynomials at once, the coefficient
+ * k of polynomial l being stored at index k * SIMD_EVAL_BATCH + l of the
+ * arrays. The products a[i] * b[j] are accumulated by increasing i. */
+void simd_multiply_lanes(const double *ar, const double *ai, int na,
+                         const double *br, const double *bi, int nb,
+                         double *rr, double *ri);
+
+#endif
@@ -15,7 +15,9 @@ long_description = open(os.path.join(os.path.dirname(__file__), "README.rst")).r
 
 _pypoly_module = Extension(
                     "_pypoly",
-                    ["pypoly/polynomials.c", "pypoly/_pypoly.c"],
+                    ["pypoly/polynomials.c", "pypoly/parallel.c", "pypoly/simd.c",
+                     "pypoly/modular.c", "pypoly/polyarray.c", "pypoly/multivariate.c",
+                     "pypoly/rational.c", "pypoly/matrix.c", "pypoly/_pypoly.c"],
                     define_macros=[
                         ('PYPOLY_VERSION', __version__)])
 
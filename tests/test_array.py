@@ -0,0 +1,75 @@
+import random
+import unittest
+
+from pypoly import *
+
+
+class PolynomialArrayTestCase(unittest.TestCase):
+    def setUp(self):
+        random.seed(0)
+        self.polys = [Polynomial(*[random.randint(-9, 9) + 1j * random.randint(-9, 9)
+                                   for _ in range(random.randint(0, 12))])
+                      for _ in range(21)]
+        self.others = [Polynomial(*[random.randint(-9, 9) for _ in range(random.randint(0, 5))])
+                       for _ in range(21)]
+        self.A = PolynomialArray(self.polys)
+        self.B = PolynomialArray(self.others)
+
+    def test_init(self):
+        A = PolynomialArray([X, 2, X**3 - 1j, 0])
+        self.assertEqual(len(A), 4)
+        self.assertEqual(A.degree, 3)
+        self.assertEqual(list(A), [X, Polynomial(2), X**3 - 1j, Polynomial()])
+        self.assertEqual(len(PolynomialArray([])), 0)
+        self.assertEqual(PolynomialArray([0, 0]).degree, -1)
+        self.assertEqual(list(self.A), self.polys)
+        self.assertRaises(TypeError, PolynomialArray, [X, "X"])
+        self.assertRaises(TypeError, PolynomialArray, 1)
+
+    def test_repr(self):
+        self.assertEqual(repr(PolynomialArray([X, 1])), "PolynomialArray([X, 1])")
+
+    def test_views(self):
+        A = PolynomialArray([X**2, X + 1])
+        P = A[-1]
+        self.assertEqual(P, X + 1)
+        self.assertEqual(P.degree, 1)
+        self.assertRaises(IndexError, A.__getitem__, 2)
+        P[3] = 1
+        self.assertEqual(P, X**3 + X + 1)
+        self.assertEqual(A[1], X + 1)
+        del A
+        self.assertEqual(P * P, (X**3 + X + 1)**2)
+
+    def test_operators(self):
+        for op in (lambda a, b: a + b, lambda a, b: a - b, lambda a, b: a * b):
+            self.assertEqual(list(op(self.A, self.B)),
+                             [op(P, Q) for P, Q in zip(self.polys, self.others)])
+            self.assertEqual(list(op(self.A, X - 2)), [op(P, X - 2) for P in self.polys])
+            self.assertEqual(list(op(3j, self.B)), [op(3j, Q) for Q in self.others])
+        self.assertEqual(list(-self.A), [-P for P in self.polys])
+        self.assertEqual((self.A - self.A).degree, -1)
+        for op in (lambda a, b: a + b, lambda a, b: a * b, lambda a, b: b - a):
+            self.assertEqual(len(op(PolynomialArray([]), X)), 0)
+            self.assertEqual(list(op(PolynomialArray([X]), X)), [op(X, X)])
+        self.assertRaises(ValueError, lambda: self.A + PolynomialArray([X, X]))
+        self.assertRaises(TypeError, lambda: self.A + "X")
+
+    def test_derive_integrate(self):
+        for n in (0, 1, 3, 7):
+            self.assertEqual(list(self.A >> n), [P >> n for P in self.polys])
+            self.assertEqual(list(self.A << n), [P << n for P in self.polys])
+
+    def test_eval(self):
+        for x in (0, 2, -1.5, 0.5 - 2j):
+            for y, P in zip(self.A(x), self.polys):
+                self.assertAlmostEqual(y, P(x), places=6)
+        xs = [random.uniform(-2, 2) + 1j * random.uniform(-1, 1) for _ in self.polys]
+        for y, P, x in zip(self.A.eval_points(xs), self.polys, xs):
+            self.assertAlmostEqual(y, P(x), places=6)
+        self.assertEqual(PolynomialArray([])(1), [])
+        self.assertRaises(ValueError, self.A.eval_points, [1, 2])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,84 @@
+import math
+import random
+import unittest
+
+from pypoly import *
+
+
+def direct(coefs, x):
+    return math.fsum(c * math.cos(k * math.acos(x)) for k, c in enumerate(coefs))
+
+class ChebyshevSeriesTestCase(unittest.TestCase):
+    def setUp(self):
+        random.seed(0)
+        self.coefs = [random.uniform(-1, 1) for _ in range(40)]
+        self.S = ChebyshevSeries(*self.coefs)
+
+    def test_init(self):
+        S = ChebyshevSeries(1, 2, 0)
+        self.assertEqual(S.degree, 1)
+        self.assertEqual(S[1], 2.)
+        self.assertEqual(S[5], 0.)
+        self.assertEqual(S[2**40], 0.)
+        self.assertRaises(IndexError, lambda: S[-1])
+        self.assertRaises(IndexError, lambda: S[-10**6])
+        self.assertEqual(ChebyshevSeries().degree, -1)
+
+    def test_repr(self):
+        self.assertEqual(repr(ChebyshevSeries(1, 2, 3j)), "ChebyshevSeries(1.0, 2.0, 3j)")
+
+    def test_eval(self):
+        for x in (-1., -0.99, -0.3, 0., 0.5, 0.999, 1.):
+            self.assertAlmostEqual(self.S(x), direct(self.coefs, x), places=12)
+        self.assertEqual(ChebyshevSeries()(0.5), 0.)
+
+    def test_eval_complex(self):
+        z = complex(0.3, 0.2)
+        self.assertAlmostEqual(self.S(z), self.S.to_polynomial()(z), places=8)
+
+    def test_eval_many(self):
+        xs = [random.uniform(-1, 1) for _ in range(101)]
+        self.assertEqual(self.S.eval_many(xs), [self.S(x) for x in xs])
+
+    def test_to_polynomial(self):
+        self.assertEqual(ChebyshevSeries(0, 0, 0, 1).to_polynomial(), chebyshev(3))
+        S = ChebyshevSeries(*self.coefs[:16])
+        P = S.to_polynomial()
+        for x in (-0.7, 0.1, 0.9):
+            self.assertAlmostEqual(P(x), S(x), places=10)
+
+    def test_from_polynomial(self):
+        self.assertEqual(ChebyshevSeries.from_polynomial(chebyshev(5)),
+                         ChebyshevSeries(0, 0, 0, 0, 0, 1))
+        P = Polynomial(*[random.uniform(-1, 1) for _ in range(200)])
+        S = ChebyshevSeries.from_polynomial(P)
+        for x in (-0.7, 0.1, 0.9):
+            self.assertAlmostEqual(S(x), P(x), places=10)
+
+    def test_values(self):
+        n = 100
+        S = ChebyshevSeries(*[random.uniform(-1, 1) for _ in range(n)])
+        values = S.values()
+        points = ChebyshevSeries.points(n)
+        for j in (0, 17, n - 1):
+            self.assertAlmostEqual(values[j], S(points[j]), places=10)
+        T = ChebyshevSeries.from_values(values)
+        for k in range(n):
+            self.assertAlmostEqual(T[k], S[k], places=12)
+
+    def test_values_odd_sizes(self):
+        for n in (1, 3, 7, 12):
+            values = [random.uniform(-1, 1) for _ in range(n)]
+            S = ChebyshevSeries.from_values(values)
+            for v, x in zip(values, ChebyshevSeries.points(n)):
+                self.assertAlmostEqual(S(x), v, places=12)
+
+    def test_legendre(self):
+        self.assertEqual(ChebyshevSeries.from_legendre([0, 0, 0, 0, 0, 1]).to_polynomial(),
+                         legendre(5))
+        for a, b in zip(ChebyshevSeries(0, 0, 0, 0, 1).to_legendre(),
+                        [-1. / 15, 0, -16. / 21, 0, 64. / 35]):
+            self.assertAlmostEqual(a, b, places=14)
+        L = ChebyshevSeries.from_legendre(self.S.to_legendre())
+        for k in range(40):
+            self.assertAlmostEqual(L[k], self.coefs[k], places=12)
@@ -0,0 +1,106 @@
+import unittest
+
+from pypoly import *
+
+
+EXPRESSIONS = (
+    lambda P, Q: 1 + X + X**2 + X**3 + X**4 + X**5 + X**15,
+    lambda P, Q: 3 * P - Q * 2j + P / 4 - 1,
+    lambda P, Q: (P + Q) * (P - Q) - P**2 + Q**2,
+    lambda P, Q: -(P * X**20) + 7 * X**3 * X**2 - (1 - Q)**3,
+    lambda P, Q: (P * Q + P * Q) * (X**40 + 2),
+)
+
+
+class LazyTestCase(unittest.TestCase):
+    def setUp(self):
+        self.P = Polynomial(*range(-10, 30))
+        self.Q = Polynomial(2, 0, -1j, 5)
+        self.previous = lazy(True)
+
+    def tearDown(self):
+        lazy(self.previous)
+
+    def test_mode(self):
+        self.assertIs(lazy(True), True)
+        self.assertIsInstance(X + 1, LazyPolynomial)
+        self.assertIsInstance(-X, LazyPolynomial)
+        self.assertIsInstance(X**2, LazyPolynomial)
+        E = X * X
+        self.assertIs(lazy(False), True)
+        self.assertIsInstance(X + 1, Polynomial)
+        self.assertIsInstance(E + 1, Polynomial)
+        self.assertEqual(E + 1, X**2 + 1)
+
+    def test_values(self):
+        for expr in EXPRESSIONS:
+            E = expr(self.P, self.Q)
+            lazy(False)
+            expected = expr(self.P, self.Q)
+            lazy(True)
+            self.assertEqual(E.evaluate(), expected)
+            self.assertIsInstance(E.evaluate(), Polynomial)
+
+    def test_shared_sums(self):
+        E = X + 1
+        for _ in range(50):
+            E = E + E
+        self.assertEqual(E, 2**50 * (X + 1))
+        E = X
+        for _ in range(5):
+            E = E * E + E
+        self.assertEqual(E.degree, 32)
+
+    def test_deep_products(self):
+        def chains():
+            U = V = X
+            for i in range(3000):
+                U = U * (0.5 * X + 0.5)
+                V = (V + i) * X if i % 2 else V**1 - X
+            return U, V
+        U, V = chains()
+        lazy(False)
+        expected = chains()
+        lazy(True)
+        self.assertEqual(U.evaluate(), expected[0])
+        self.assertEqual(V.evaluate(), expected[1])
+        W = X
+        for _ in range(3000):
+            W = W * X
+        self.assertEqual(W, X**1000 * X**1000 * X**1001)
+
+    def test_polynomial_interface(self):
+        E = 2 * X**3 - 1
+        self.assertEqual(repr(E), "-1 + 2 * X**3")
+        self.assertEqual(E.degree, 3)
+        self.assertEqual(E[3], 2.)
+        self.assertEqual(E(2), 15.)
+        self.assertEqual(E >> 1, 6 * X**2)
+        self.assertEqual(divmod(E, X), (2 * X**2, Polynomial(-1)))
+        self.assertEqual(gcd(E, E * (X + 1)), E / 2)
+        self.assertTrue(E != X)
+        self.assertEqual(list(PolynomialArray([E, X + 1])), [E, X + 1])
+
+    def test_operands(self):
+        # The operands are taken when the expression is built
+        P = Polynomial(0, 1)
+        E = P * 2
+        F = P * P + 3 * P**2
+        G = P * X**3
+        P[0] = 1
+        P[3] = 2
+        self.assertEqual(E, 2 * X)
+        self.assertEqual(F, 4 * X**2)
+        self.assertEqual(G, X**4)
+        self.assertEqual(P * 2, 2 + 2 * X + 4 * X**3)
+
+    def test_errors(self):
+        self.assertRaises(ZeroDivisionError, lambda: X / 0)
+        self.assertRaises(TypeError, lambda: X + "X")
+        self.assertRaises(TypeError, lambda: 1 / X)
+        self.assertRaises(ValueError, lambda: X**5000)
+        self.assertRaises(TypeError, LazyPolynomial)
+
+
+if __name__ == '__main__':
+    unittest.main()
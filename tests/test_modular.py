@@ -0,0 +1,129 @@
+import random
+import unittest
+
+from pypoly import *
+
+
+def convolve(a, b):
+    r = [0] * (len(a) + len(b) - 1)
+    for i, x in enumerate(a):
+        for j, y in enumerate(b):
+            r[i + j] += x * y
+    return r
+
+def coefficients(P):
+    return [P[i] for i in range(P.degree + 1)]
+
+class ModPolynomialTestCase(unittest.TestCase):
+    def test_init(self):
+        P = ModPolynomial(7, 8, -1, 14)
+        self.assertEqual(coefficients(P), [1, 6])
+        self.assertEqual(P.degree, 1)
+        self.assertEqual(P.modulus, 7)
+        self.assertEqual(ModPolynomial(7, 0, 7).degree, -1)
+
+    def test_invalid_modulus(self):
+        for p in (2, 9, 1, 2**63 + 29):
+            self.assertRaises(ValueError, ModPolynomial, p, 1)
+
+    def test_repr(self):
+        self.assertEqual(repr(ModPolynomial(7, 1, 0, 3)), "1 + 3 * X**2 (mod 7)")
+        self.assertEqual(repr(ModPolynomial(7)), "0 (mod 7)")
+
+    def test_arithmetic(self):
+        P, Q = ModPolynomial(7, 1, 2), ModPolynomial(7, 6, 5, 1)
+        self.assertEqual(P + Q, ModPolynomial(7, 0, 0, 1))
+        self.assertEqual(P - Q, ModPolynomial(7, 2, 4, 6))
+        self.assertEqual(-P, ModPolynomial(7, 6, 5))
+        self.assertEqual(P * Q, ModPolynomial(7, 6, 3, 4, 2))
+        self.assertEqual(3 * P + 1, ModPolynomial(7, 4, 6))
+        self.assertEqual(P(3), 0)
+
+    def test_frobenius(self):
+        X7 = ModPolynomial(7, 0, 1)
+        self.assertEqual((X7 + 1)**7, X7**7 + 1)
+
+    def test_different_moduli(self):
+        self.assertRaises(ValueError, lambda: ModPolynomial(7, 1) + ModPolynomial(11, 1))
+
+    def test_large_multiply(self):
+        random.seed(0)
+        for p in (7, 998244353, 4611615649683210241):
+            a = [random.randrange(p) for _ in range(300)]
+            b = [random.randrange(p) for _ in range(200)]
+            self.assertEqual(
+                coefficients(ModPolynomial(p, *a) * ModPolynomial(p, *b)),
+                [c % p for c in convolve(a, b)])
+
+    def test_divmod(self):
+        random.seed(1)
+        p = 1000000007
+        for na, nb in ((10, 3), (500, 200), (100, 150)):
+            A = ModPolynomial(p, *[random.randrange(p) for _ in range(na)])
+            B = ModPolynomial(p, *[random.randrange(1, p) for _ in range(nb)])
+            Q, R = divmod(A, B)
+            self.assertEqual(Q * B + R, A)
+            self.assertTrue(R.degree < B.degree)
+            self.assertEqual(A // B, Q)
+            self.assertEqual(A % B, R)
+
+    def test_division_by_zero(self):
+        self.assertRaises(ZeroDivisionError, divmod, ModPolynomial(7, 1), ModPolynomial(7))
+
+    def test_gcd(self):
+        p = 1000000007
+        G = ModPolynomial(p, 3, 1)
+        A, B = ModPolynomial(p, 1, 2, 3) * G, ModPolynomial(p, 5, 0, 1, 7) * G
+        self.assertEqual(A.gcd(B), G)
+        self.assertEqual(A.gcd(ModPolynomial(p)), A * pow(3, p - 2, p))
+
+    def test_resultant(self):
+        P = ModPolynomial(7, 2, 3, 1)   # (X + 1) (X + 2)
+        self.assertEqual(P.resultant(ModPolynomial(7, 3, 1)), 2)
+        self.assertEqual(P.resultant(ModPolynomial(7, 1, 1)), 0)
+        self.assertEqual(P.resultant(ModPolynomial(7, 5)), 4)
+        self.assertRaises(ValueError, P.resultant, ModPolynomial(11, 1))
+
+    def test_large_resultant(self):
+        # Large enough for the half-GCD algorithm, against the product of
+        # A over the roots of B
+        random.seed(4)
+        p = 1000003
+        roots = random.sample(range(p), 4500)
+        factors = [ModPolynomial(p, -r, 1) for r in roots]
+        while len(factors) > 1:
+            factors = [factors[i] * factors[i + 1] if i + 1 < len(factors) else factors[i]
+                       for i in range(0, len(factors), 2)]
+        A = ModPolynomial(p, *[random.randrange(p) for _ in range(5000)])
+        expected = 1
+        for r in roots:
+            expected = expected * A(r) % p
+        self.assertEqual(factors[0].resultant(A), expected)
+
+    def test_discriminant(self):
+        for p in (3, 5, 1000003):
+            a, b, c, d = 2, 1, p - 1, 1
+            D = b**2 * c**2 - 4 * a * c**3 - 4 * b**3 * d - 27 * a**2 * d**2 + 18 * a * b * c * d
+            self.assertEqual(ModPolynomial(p, d, c, b, a).discriminant(), D % p)
+        self.assertEqual(ModPolynomial(7, 1, 0, 1).discriminant(), 3)
+        self.assertRaises(ValueError, ModPolynomial(7, 3).discriminant)
+
+class CRTTestCase(unittest.TestCase):
+    def test_crt(self):
+        random.seed(2)
+        coefs = [random.randrange(-10**30, 10**30) for _ in range(20)]
+        moduli = (4611615649683210241, 4611613450659954689)
+        self.assertEqual(crt(*[ModPolynomial(p, *coefs) for p in moduli]), coefs)
+
+    def test_same_moduli(self):
+        self.assertRaises(ValueError, crt, ModPolynomial(7, 1), ModPolynomial(7, 2))
+
+    def test_int_multiply(self):
+        random.seed(3)
+        for na, nb, bits in ((1, 1, 10), (40, 70, 64), (300, 200, 500)):
+            a = [random.randrange(-2**bits, 2**bits) for _ in range(na)]
+            b = [random.randrange(-2**bits, 2**bits) for _ in range(nb)]
+            self.assertEqual(int_multiply(a, b), convolve(a, b))
+
+    def test_int_multiply_empty(self):
+        self.assertEqual(int_multiply([], [1, 2]), [])
@@ -1,3 +1,5 @@
+import sys
+import tracemalloc
 import unittest
 
 from pypoly import *
@@ -30,5 +32,144 @@ class GCDTestCase(unittest.TestCase):
             gcd((1 + X)**2 * (2 + X) * (4 + X), (1 + X) * (2 + X) * (3 + X)),
             (1 + X) * (2 + X))
 
+class RootsManyTestCase(unittest.TestCase):
+    def test_empty(self):
+        self.assertEqual(roots_many([]), [])
+
+    def test_polynomials(self):
+        roots = roots_many([X**2 - 4, X + 1, Polynomial(3)])
+        self.assertEqual(len(roots), 3)
+        self.assertEqual(sorted(round(z.real, 9) for z in roots[0]), [-2, 2])
+        self.assertEqual(roots[1], [-1])
+        self.assertEqual(roots[2], [])
+
+    def test_error_type(self):
+        with self.assertRaises(TypeError):
+            roots_many([X, 1])
+
+class OrthogonalTestCase(unittest.TestCase):
+    def test_chebyshev(self):
+        self.assertEqual(chebyshev(0), 1)
+        self.assertEqual(chebyshev(5), 5 * X - 20 * X**3 + 16 * X**5)
+
+    def test_legendre(self):
+        self.assertEqual(legendre(5), (63 * X**5 - 70 * X**3 + 15 * X) / 8)
+
+    def test_hermite(self):
+        self.assertEqual(hermite(5), X**5 - 10 * X**3 + 15 * X)
+
+    def test_recurrence(self):
+        U, V = chebyshev(498), chebyshev(499)
+        self.assertEqual(V.degree, 499)
+        self.assertEqual(chebyshev(500), 2 * X * V - U)
+
+    def test_upto(self):
+        for family, family_upto in ((chebyshev, chebyshev_upto),
+                                    (legendre, legendre_upto),
+                                    (hermite, hermite_upto)):
+            polys = family_upto(1030)
+            self.assertEqual(len(polys), 1031)
+            for n in (0, 1, 7, 1024, 1030):
+                self.assertEqual(polys[n], family(n))
+
+    def test_copies(self):
+        P = chebyshev(3)
+        P[0] = 1
+        self.assertEqual(chebyshev(3), 4 * X**3 - 3 * X)
+
+    def test_negative(self):
+        self.assertRaises(ValueError, legendre, -1)
+
+class CyclotomicTestCase(unittest.TestCase):
+    def test_small(self):
+        self.assertEqual(cyclotomic(1), X - 1)
+        self.assertEqual(cyclotomic(12), X**4 - X**2 + 1)
+
+    def test_non_squarefree(self):
+        self.assertEqual(cyclotomic(9), X**6 + X**3 + 1)
+        self.assertEqual(cyclotomic(1024), X**512 + 1)
+
+    def test_coefficients(self):
+        P = cyclotomic(105)
+        self.assertEqual(P.degree, 48)
+        self.assertEqual(P[7], -2)
+        self.assertEqual(cyclotomic(30030)(1), 1)
+
+    def test_product(self):
+        n = 840
+        P = Polynomial(1)
+        for d in range(1, n + 1):
+            if n % d == 0:
+                P *= cyclotomic(d)
+        self.assertEqual(P, X**n - 1)
+
+    def test_copies(self):
+        P = cyclotomic(5)
+        P[0] = 2
+        self.assertEqual(cyclotomic(5), 1 + X + X**2 + X**3 + X**4)
+
+    def test_invalid(self):
+        self.assertRaises(ValueError, cyclotomic, 0)
+
+class MemoryTestCase(unittest.TestCase):
+    def test_allocated_bytes(self):
+        before = allocated_bytes()
+        P = Polynomial(*range(1, 1001))
+        Q = +P
+        self.assertGreaterEqual(allocated_bytes() - before, 16000)
+        del P, Q
+        self.assertEqual(allocated_bytes(), before)
+
+    def test_sizeof(self):
+        P = Polynomial(*range(1, 1001))
+        self.assertGreaterEqual(sys.getsizeof(P) - sys.getsizeof(X), 15000)
+        self.assertGreaterEqual(sys.getsizeof(PolynomialArray([P, P])), 32000)
+        self.assertGreaterEqual(sys.getsizeof(P.compile()) - sys.getsizeof(X.compile()), 7000)
+        M = ModPolynomial(7, *range(1, 1001))
+        self.assertGreaterEqual(sys.getsizeof(M) - sys.getsizeof(ModPolynomial(7, 1)), 7000)
+
+    def test_allocated_bytes_compiled(self):
+        before = allocated_bytes()
+        C = Polynomial(*range(1, 1001)).compile()
+        M = ModPolynomial(7, *range(1, 1001)) ** 2
+        self.assertGreaterEqual(allocated_bytes() - before, 8000 + 15000)
+        del C, M
+        self.assertEqual(allocated_bytes(), before)
+
+    def test_allocated_bytes_gcd(self):
+        R = RationalFunction(X**2 - 1, X - 1)
+        before = allocated_bytes()
+        for _ in range(100):
+            gcd(X**6 - 1, X**12 - 1)
+            divmod(X**12 - 1, X**7 + 3 * X + 1)
+            (R + 1).reduce()
+            R * R == R**2
+        self.assertEqual(allocated_bytes(), before)
+
+    def test_allocated_bytes_workspaces(self):
+        P = Polynomial(*range(1, 301))
+        M = ModPolynomial(7, *range(1, 301))
+        before = allocated_bytes()
+        P * P, P.shift(0.5), P.compose(X + 1), P.taylor(0.5, 3), P.roots()
+        ((X**2 - 1)**3 * (X + 2)).squarefree()
+        Polynomial.interpolate(list(range(100)), [1.] * 100)
+        S = ChebyshevSeries.from_polynomial(P)
+        S.values(), S.to_polynomial(), ChebyshevSeries.from_legendre(S.to_legendre())
+        divmod(M * M, M)
+        x, y = MultiPolynomial(2, {(1, 0): 1}), MultiPolynomial(2, {(0, 1): 1})
+        ((x + y + 1)**10)(1, 2)
+        PolynomialArray([P, P]) * PolynomialArray([P, P])
+        del S, x, y
+        self.assertEqual(allocated_bytes(), before)
+
+    def test_tracemalloc(self):
+        tracemalloc.start()
+        try:
+            before = tracemalloc.get_traced_memory()[0]
+            P = Polynomial(*range(1, 5001))
+            self.assertGreaterEqual(tracemalloc.get_traced_memory()[0] - before, 80000)
+        finally:
+            tracemalloc.stop()
+
 if __name__ == '__main__':
     unittest.main()
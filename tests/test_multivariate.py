@@ -0,0 +1,103 @@
+import random
+import unittest
+
+from pypoly import *
+
+
+def dict_multiply(a, b):
+    r = {}
+    for ea, ca in a.items():
+        for eb, cb in b.items():
+            e = tuple(i + j for i, j in zip(ea, eb))
+            r[e] = r.get(e, 0) + ca * cb
+    return {e: c for e, c in r.items() if c != 0}
+
+class MultiPolynomialTestCase(unittest.TestCase):
+    def test_init(self):
+        P = MultiPolynomial(2, {(1, 0): 2, (0, 3): 1, (0, 0): 0})
+        self.assertEqual(P.terms(), {(1, 0): 2, (0, 3): 1})
+        self.assertEqual(len(P), 2)
+        self.assertEqual(P.nvars, 2)
+        self.assertEqual(P.degree, 3)
+        self.assertEqual(MultiPolynomial(1, {2: 1}).terms(), {(2,): 1})
+        self.assertEqual([type(c) for c in P.terms().values()], [float, float])
+        self.assertIsInstance(MultiPolynomial(1, {2: 1j}).terms()[2,], complex)
+        self.assertEqual(MultiPolynomial(3).degree, -1)
+
+    def test_invalid_init(self):
+        self.assertRaises(ValueError, MultiPolynomial, 0)
+        self.assertRaises(ValueError, MultiPolynomial, 17)
+        self.assertRaises(ValueError, MultiPolynomial, 2, {(1, 2, 3): 1})
+        self.assertRaises(ValueError, MultiPolynomial, 2, {(1, -1): 1})
+        self.assertRaises(ValueError, MultiPolynomial, 4, {(2**16, 0, 0, 0): 1})
+        self.assertRaises(TypeError, MultiPolynomial, 2, {(1, 0): "a"})
+
+    def test_repr(self):
+        x, y = MultiPolynomial.variables(2)
+        self.assertEqual(repr(x**2 * y - 3 * y + 1), "x0**2 * x1 - 3 * x1 + 1")
+        self.assertEqual(repr(x - x), "0")
+
+    def test_arithmetic(self):
+        x, y, z = MultiPolynomial.variables(3)
+        P = (x + y) * (x - y)
+        self.assertEqual(P, x**2 - y**2)
+        self.assertEqual(P + y**2 - x**2, 0)
+        self.assertEqual(-P + 1, 1 - P)
+        self.assertEqual(2 * z * P, P * z * 2)
+        self.assertEqual(len((x + y + z + 1)**4), 35)
+        self.assertEqual((x + 1)**0, 1)
+
+    def test_different_nvars(self):
+        x, = MultiPolynomial.variables(1)
+        u, v = MultiPolynomial.variables(2)
+        self.assertEqual(x + v, u + v)
+        self.assertEqual((x * v).nvars, 2)
+
+    def test_large_multiply(self):
+        random.seed(0)
+        for n in (10, 400):
+            a = {(random.randrange(50), random.randrange(50), random.randrange(50)):
+                 random.randrange(-9, 10) for _ in range(n)}
+            b = {(random.randrange(50), random.randrange(50), random.randrange(50)):
+                 random.randrange(-9, 10) for _ in range(n)}
+            R = MultiPolynomial(3, a) * MultiPolynomial(3, b)
+            self.assertEqual(R.terms(), dict_multiply(
+                {e: c for e, c in a.items() if c != 0},
+                {e: c for e, c in b.items() if c != 0}))
+
+    def test_exponent_overflow(self):
+        x, y, z = MultiPolynomial.variables(3)
+        self.assertRaises(OverflowError, pow, x, 2**21)
+        self.assertRaises(OverflowError, lambda: x**(2**20) * x**(2**20))
+        u, v = MultiPolynomial.variables(2)
+        self.assertEqual((u**(2**30)).degree, 2**30)
+
+    def test_call(self):
+        x, y = MultiPolynomial.variables(2)
+        P = x**3 * y - 2 * y**2 + 1j
+        self.assertEqual(P(2, 3), 24 - 18 + 1j)
+        self.assertEqual(P([2, 3]), P(2, 3))
+        self.assertEqual((x**1000 * y)(1j, 2), 2)
+        self.assertIsInstance((x * y + 1)(2, 3), float)
+        self.assertIsInstance(P(2, 3), complex)
+        self.assertRaises(TypeError, P, 1)
+        self.assertRaises(TypeError, P, 1, "a")
+
+    def test_derive(self):
+        x, y = MultiPolynomial.variables(2)
+        P = x**3 * y**2 + x * y + 5
+        self.assertEqual(P.derive(0), 3 * x**2 * y**2 + y)
+        self.assertEqual(P.derive(1, 2), 2 * x**3)
+        self.assertEqual(P.derive(0, 4), 0)
+        self.assertRaises(ValueError, P.derive, 2)
+        self.assertRaises(ValueError, P.derive, 0, -1)
+
+    def test_polynomial_conversion(self):
+        P = 1 + 2 * X + 3 * X**5
+        Q = MultiPolynomial.from_polynomial(P, 3, 1)
+        x, y, z = MultiPolynomial.variables(3)
+        self.assertEqual(Q, 1 + 2 * y + 3 * y**5)
+        self.assertEqual(Q.to_polynomial(1), P)
+        self.assertEqual(MultiPolynomial.from_polynomial(P).to_polynomial(), P)
+        self.assertEqual((x - x).to_polynomial(2), Polynomial())
+        self.assertRaises(ValueError, (x + y).to_polynomial, 0)
@@ -1,7 +1,11 @@
+import cmath
+import math
+import random
 import unittest
 import sys
+from array import array
 
-from pypoly import Polynomial, X
+from pypoly import Polynomial, PolynomialArray, X
 
 class ComparisonTestCase(unittest.TestCase):
     def test_same_obj(self):
@@ -78,6 +82,11 @@ class SubstractionTestCase(unittest.TestCase):
         self.assertEqual(Polynomial(1, 2, 0.5) - Polynomial(2, 3),
             -1 - X + 0.5 * X**2)
 
+    def test_longer_operand(self):
+        self.assertEqual(Polynomial(1, 2) - Polynomial(2, 2, 1j, 4),
+            -1 - 1j * X**2 - 4 * X**3)
+        self.assertEqual((X**16 + X) - (X**16 - 2), X + 2)
+
     def test_error_incompatible(self):
         with self.assertRaises(TypeError):
             X - {}
@@ -90,6 +99,47 @@ class MultiplicationTestCase(unittest.TestCase):
         self.assertEqual((1 + X + 2 * X**2) * (complex(-2, 1) * X - 2),
             -2 + complex(-4, 1) * X + (-6+1j) * X**2 + complex(-4, 2) * X**3)
 
+    def test_unbalanced(self):
+        P, Q = Polynomial(*range(1, 18)), Polynomial(*range(1, 101))
+        expected = Polynomial(*[sum((i + 1) * (k - i + 1)
+                                    for i in range(max(0, k - 99), min(k, 16) + 1))
+                                for k in range(116)])
+        self.assertEqual(P * Q, expected)
+        self.assertEqual(Q * P, expected)
+        self.assertEqual((P - 1j) * (X**40 + 1), (X**40 + 1) * (P - 1j))
+
+    def test_non_finite(self):
+        # Zero coefficients do not multiply infinite ones
+        inf = float('inf')
+        P = inf * X
+        self.assertEqual(P.degree, 1)
+        self.assertEqual(P[0], 0)
+        self.assertEqual(P[1].real, inf)
+        P = X**3 * Polynomial(1, 0, inf)
+        self.assertEqual([P[k] for k in range(5)], [0, 0, 0, 1, 0])
+        self.assertEqual(P[5].real, inf)
+        P = X**20 * Polynomial(1, 0, inf)
+        self.assertEqual(P[0], 0)
+        self.assertEqual(P[22].real, inf)
+        # Above the small kernels, and with monomials
+        P = (X**30 + inf) * (X**30 + 1)
+        self.assertEqual([P[k] for k in range(1, 30)] + [P[60]], [0] * 29 + [1])
+        self.assertEqual([P[0].real, P[30].real], [inf, inf])
+        P = Polynomial(*[0] * 20 + [inf]) * (X**30 + 1)
+        self.assertEqual([P[k] for k in range(21, 50)], [0] * 29)
+        self.assertEqual([P[20].real, P[50].real], [inf, inf])
+
+    def test_rounding(self):
+        # Products are accumulated in the order of the shortest operand
+        a = [complex(1. / (i + 1), (-1)**i / (i + 3.)) for i in range(24)]
+        b = [complex(k / 7., 1. / (k + 2)) for k in range(300)]
+        expected = [0j] * 323
+        for i in range(24):
+            for j in range(300):
+                expected[i + j] += a[i] * b[j]
+        R = Polynomial(*b) * Polynomial(*a)
+        self.assertEqual([R[k] for k in range(323)], expected)
+
     def test_error_incompatible(self):
         with self.assertRaises(TypeError):
             X * {}
@@ -143,6 +193,31 @@ class DivmodTestCase(unittest.TestCase):
         with self.assertRaises(ZeroDivisionError):
             X % 0
 
+    def test_linear_divisor(self):
+        P = 3 * X**4 - 2j * X**2 + X - 5
+        Q, R = divmod(P, X - 2)
+        self.assertEqual(R, P(2))
+        self.assertEqual(Q * (X - 2) + R, P)
+        Q, R = divmod(P, 2 * X + 1j)
+        self.assertAlmostEqual(R[0], P(-0.5j))
+        self.assertEqual(R.degree, 0)
+        self.assertEqual(divmod(X, X - 1), (1, 1))
+
+    def test_monomial_divisor(self):
+        P = 1 + 2 * X + 3 * X**2 + 4 * X**5
+        self.assertEqual(divmod(P, X**2), (3 + 4 * X**3, 1 + 2 * X))
+        self.assertEqual(divmod(P, 2 * X**5), (2, 1 + 2 * X + 3 * X**2))
+        self.assertEqual(P % X**6, P)
+
+    def test_binomial_divisor(self):
+        self.assertEqual(divmod(X**12 - 1, X**4 - 1), (X**8 + X**4 + 1, 0))
+        P = sum((k + 1) * X**k for k in range(20))
+        for B in (X**3 - 1, X**7 + 2j, 4 * X**5 - 3):
+            Q, R = divmod(P, B)
+            self.assertLess(R.degree, B.degree)
+            D = Q * B + R - P
+            self.assertTrue(all(abs(D[k]) < 1e-9 for k in range(D.degree + 1)))
+
 class SequenceTestCase(unittest.TestCase):
     def test_get_item(self):
         self.assertEqual((1 + 2 * X + 3 * X**2)[1], 2)
@@ -174,6 +249,41 @@ class SequenceTestCase(unittest.TestCase):
         self.assertEqual(P, 1 + 2 * X + 3 * X**2)
         self.assertEqual(P.degree, 2)
 
+    def test_assign_item_copy(self):
+        P = 1 + 2 * X + 3 * X**2
+        Q, R = +P, P**1
+        Q[1] = 5
+        R[8] = 1
+        self.assertEqual(P, 1 + 2 * X + 3 * X**2)
+        self.assertEqual(Q, 1 + 5 * X + 3 * X**2)
+        self.assertEqual(R, 1 + 2 * X + 3 * X**2 + X**8)
+
+    def test_get_slice(self):
+        P = 1 + 2 * X + 3 * X**2 + 4 * X**3
+        self.assertEqual(P[1:3], 2 + 3 * X)
+        self.assertEqual(P[::2], 1 + 3 * X)
+        self.assertEqual(P[::-1], 4 + 3 * X + 2 * X**2 + X**3)
+        self.assertEqual(P[5:], 0)
+
+    def test_assign_slice(self):
+        P = 1 + 2 * X + 3 * X**2
+        P[1:3] = [5, 6j]
+        self.assertEqual(P, 1 + 5 * X + 6j * X**2)
+        P[4:] = array('d', [1., 2.])
+        self.assertEqual(P, 1 + 5 * X + 6j * X**2 + X**4 + 2 * X**5)
+        P[1::2] = (0, 0, 0)
+        self.assertEqual(P, 1 + 6j * X**2 + X**4)
+        self.assertEqual(P.degree, 4)
+        with self.assertRaises(ValueError):
+            P[0:2] = [1]
+
+    def test_assign_item_growth(self):
+        P = Polynomial()
+        for i in range(1000):
+            P[i] = i + 1
+        self.assertEqual(P.degree, 999)
+        self.assertEqual(P(1), 500500)
+
 class CallTestCase(unittest.TestCase):
     def test_constant(self):
         self.assertEqual(Polynomial(1, 0, 0)(2), 1)
@@ -181,10 +291,67 @@ class CallTestCase(unittest.TestCase):
     def test_polynomials(self):
         self.assertEqual(Polynomial(1, 2, 3)(2), 17)
 
+    def test_high_degree(self):
+        coefs = [(-1)**k / (k + 1.) + 1j * k / 100. for k in range(100)]
+        for x in (0.5, -0.9, 0.3 + 0.8j):
+            expected = 0
+            for a in reversed(coefs):
+                expected = expected * x + a
+            self.assertAlmostEqual(Polynomial(*coefs)(x), expected)
+
+    def test_real_points(self):
+        P = Polynomial(1, -2j, 0.5)
+        for x in (2, 2., True, -3, 0.25):
+            self.assertEqual(P(x), P(complex(x)))
+        self.assertEqual(type(Polynomial(1, 2)(3)), float)
+        self.assertEqual(X(1e200), 1e200)
+
+    def test_error_arguments(self):
+        with self.assertRaises(TypeError):
+            X()
+        with self.assertRaises(TypeError):
+            X(1, 2)
+        with self.assertRaises(TypeError):
+            X(x=1)
+        with self.assertRaises(TypeError):
+            X("1")
+        with self.assertRaises(OverflowError):
+            X(10**400)
+
     def test_error_incompatible(self):
         with self.assertRaises(TypeError):
             Polynomial({})
 
+class CompileTestCase(unittest.TestCase):
+    def test_zero(self):
+        C = Polynomial().compile()
+        self.assertEqual(C(3), 0)
+        self.assertEqual(C.eval_many([]), [])
+
+    def test_polynomials(self):
+        for P in ((X + 1)**5, (X / 2 - 1j)**40, Polynomial(*range(1, 78))):
+            C = P.compile()
+            self.assertEqual(C.degree, P.degree)
+            for x in (0, 0.5, -0.9, 1.5, 0.2 - 0.7j):
+                self.assertAlmostEqual(C(x) / P(x), 1)
+
+    def test_arguments(self):
+        C = Polynomial(1, 2, 3).compile()
+        self.assertEqual(C(2), 17)
+        self.assertEqual(C(2.), 17)
+        self.assertEqual(C(1j), -2 + 2j)
+        with self.assertRaises(TypeError):
+            C()
+        with self.assertRaises(TypeError):
+            C(x=1)
+
+    def test_eval_many(self):
+        P = Polynomial(*[1. / (k + 1) for k in range(50)])
+        xs = [k / 37. - 1 for k in range(75)] + [0.5j]
+        self.assertEqual(len(P.compile().eval_many(xs)), len(xs))
+        for y, x in zip(P.compile().eval_many(xs), xs):
+            self.assertAlmostEqual(y, P(x))
+
 class DerivationTestCase(unittest.TestCase):
     def test_derive_zero(self):
         self.assertEqual(Polynomial(0) >> 1, 0)
@@ -198,6 +365,19 @@ class DerivationTestCase(unittest.TestCase):
     def test_zero(self):
         self.assertEqual(Polynomial(1, 2, 3) >> 0, Polynomial(1, 2, 3))
 
+    def test_high_order(self):
+        self.assertEqual(X**20 >> 15, 20274183401472000 * X**5)
+
+    def test_overflow(self):
+        # 199! / 50! is just below the largest double, 200! / 50! above
+        P = X**199 >> 149
+        self.assertEqual(P.degree, 50)
+        self.assertAlmostEqual(P[50] / (math.factorial(199) // math.factorial(50)), 1.)
+        P = X**200 >> 150
+        self.assertEqual(P[50], math.inf)
+        self.assertEqual([P[i] for i in range(50)], [0] * 50)
+        self.assertEqual(list(PolynomialArray([X**200]) >> 150), [P])
+
     def test_error_negative(self):
         with self.assertRaises(TypeError):
             X >> -1
@@ -215,9 +395,252 @@ class IntegrationTestCase(unittest.TestCase):
     def test_zero(self):
         self.assertEqual(Polynomial(1, 2, 3) << 0, Polynomial(1, 2, 3))
 
+    def test_high_order(self):
+        self.assertEqual((X**5 << 15) >> 15, X**5)
+
     def test_error_negative(self):
         with self.assertRaises(TypeError):
             X << -1
 
+class ShiftTestCase(unittest.TestCase):
+    def test_zero(self):
+        self.assertEqual(Polynomial().shift(2), 0)
+
+    def test_polynomials(self):
+        self.assertEqual((1 + X**2).shift(1), 2 + 2 * X + X**2)
+
+    def test_large(self):
+        P = Polynomial(*(1. / (i + 1) for i in range(200)))
+        Q = P.shift(0.25)
+        for x in (-0.5, 0, 0.5):
+            self.assertAlmostEqual(Q(x), P(x + 0.25))
+
+    def test_error_incompatible(self):
+        with self.assertRaises(TypeError):
+            X.shift(X)
+
+class TaylorTestCase(unittest.TestCase):
+    def test_zero(self):
+        self.assertEqual(Polynomial().taylor(1, 2), [0, 0, 0])
+
+    def test_polynomials(self):
+        P = 1 + X**3 - 2 * X**5
+        self.assertEqual(P.taylor(2, 6), [(P >> k)(2) for k in range(7)])
+        self.assertEqual(P.taylor(1j, 0), [P(1j)])
+
+    def test_large(self):
+        P = Polynomial(*(1. / (i + 1) for i in range(200)))
+        for d, e in zip(P.taylor(0.25, 20), [(P >> k)(0.25) for k in range(21)]):
+            self.assertAlmostEqual(d / e, 1)
+
+    def test_many(self):
+        P = 1 + X**3 - 2 * X**5
+        self.assertEqual(P.taylor_many([0, 2, 1j], 3), [P.taylor(x, 3) for x in (0, 2, 1j)])
+        self.assertEqual(P.taylor_many([], 3), [])
+
+    def test_error_negative(self):
+        with self.assertRaises(ValueError):
+            X.taylor(0, -1)
+
+class ComposeTestCase(unittest.TestCase):
+    def test_constant(self):
+        self.assertEqual((1 + X + X**2).compose(2), 7)
+
+    def test_polynomials(self):
+        self.assertEqual((1 + X**2).compose(X - 1), 2 - 2 * X + X**2)
+
+    def test_large(self):
+        P = Polynomial(*(1. / (i + 1) for i in range(100)))
+        Q = P.compose(0.5 * X**2 - 0.25j)
+        for x in (-0.5, 0, 0.5):
+            self.assertAlmostEqual(Q(x), P(0.5 * x**2 - 0.25j))
+
+    def test_error_incompatible(self):
+        with self.assertRaises(TypeError):
+            X.compose({})
+
+class InterpolationTestCase(unittest.TestCase):
+    def test_empty(self):
+        self.assertEqual(Polynomial.interpolate([], []), 0)
+
+    def test_polynomials(self):
+        self.assertEqual(
+            Polynomial.interpolate([0, 1, 2, 3], [1, 3, 9, 19]),
+            1 + 2 * X**2)
+
+    def test_buffers(self):
+        P = Polynomial.interpolate(array('d', [-1, 0, 1]), array('d', [2, 1, 2]))
+        self.assertEqual(P, 1 + X**2)
+
+    def test_large(self):
+        n = 300
+        P = Polynomial(*(1. / (i + 1) for i in range(n)))
+        xs = [cmath.exp(2j * cmath.pi * k / n) for k in range(n)]
+        Q = Polynomial.interpolate(xs, [P(x) for x in xs])
+        self.assertEqual(Q.degree, n - 1)
+        for i in range(n):
+            self.assertAlmostEqual(Q[i], P[i])
+
+    def test_large_real(self):
+        # The subproduct tree loses the values M'(x) for points on a line
+        for n in (129, 150, 400):
+            chebyshev = [math.cos(math.pi * (k + 0.5) / n) for k in range(n)]
+            equispaced = [-1 + 2. * k / (n - 1) for k in range(n)]
+            for xs in (chebyshev, equispaced, range(n)):
+                self.assertEqual(Polynomial.interpolate(xs, [1.] * n), 1)
+            P = 1 + 2 * X - X**3
+            self.assertEqual(Polynomial.interpolate(range(n), [P(x) for x in range(n)]), P)
+
+    def test_error_length(self):
+        with self.assertRaises(ValueError):
+            Polynomial.interpolate([0, 1], [1])
+
+    def test_error_duplicate(self):
+        with self.assertRaises(ValueError):
+            Polynomial.interpolate([0, 1, 0], [1, 2, 3])
+        with self.assertRaises(ValueError):
+            Polynomial.interpolate(list(range(200)) + [3], [1] * 201)
+
+class RootsTestCase(unittest.TestCase):
+    def assertRootsAlmostEqual(self, roots, expected):
+        key = lambda z: (round(z.real, 6), round(z.imag, 6))
+        self.assertEqual(len(roots), len(expected))
+        for z, w in zip(sorted(roots, key=key), sorted(expected, key=key)):
+            self.assertAlmostEqual(z, w)
+
+    def test_constant(self):
+        self.assertEqual(Polynomial(2).roots(), [])
+
+    def test_zero_roots(self):
+        self.assertEqual((X**3).roots(), [0, 0, 0])
+
+    def test_polynomials(self):
+        self.assertRootsAlmostEqual(
+            ((X - 1) * (X - 2) * (X + 4j)).roots(), [1, 2, -4j])
+
+    def test_high_degree(self):
+        n = 1000
+        self.assertRootsAlmostEqual(
+            (X**n - 1).roots(),
+            [cmath.exp(2j * cmath.pi * k / n) for k in range(n)])
+
+    def test_error_zero(self):
+        with self.assertRaises(ValueError):
+            Polynomial(0).roots()
+
+class ResultantTestCase(unittest.TestCase):
+    def test_resultant(self):
+        self.assertEqual(((X - 1) * (X - 2)).resultant(X - 3), 2)
+        self.assertEqual((X - 3).resultant((X - 1) * (X - 2)), 2)
+        self.assertEqual((X**3 + 1).resultant(X**3 + 2), 1)
+        self.assertEqual(X.resultant(3), 3)
+        self.assertEqual((X**2 - 1).resultant(X + 1), 0)
+        self.assertEqual(X.resultant(0), 0)
+
+    def test_large_values(self):
+        R = (3 * (X - 1)**40).resultant(2 * (X + 1)**10)
+        self.assertAlmostEqual(R / (3.**10 * 2.**440), 1, places=5)
+
+    def test_discriminant(self):
+        self.assertEqual((X**2 + 5 * X + 1).discriminant(), 21)
+        self.assertEqual((2 * X**2 + 5 * X + 1).discriminant(), 17)
+        self.assertAlmostEqual((X**3 - 2 * X + 1).discriminant(), 5)
+        self.assertEqual((X - 4).discriminant(), 1)
+        self.assertRaises(ValueError, Polynomial(3).discriminant)
+
+class SquarefreeTestCase(unittest.TestCase):
+    def assertFactorsAlmostEqual(self, factors, expected):
+        self.assertEqual([m for F, m in factors], [m for F, m in expected])
+        for (F, m), (G, n) in zip(factors, expected):
+            self.assertEqual(F.degree, G.degree)
+            for i in range(F.degree + 1):
+                self.assertAlmostEqual(F[i], G[i])
+
+    def test_squarefree(self):
+        P = 3 * (X - 1)**3 * (X + 2)**2 * (X - 5)
+        self.assertFactorsAlmostEqual(P.squarefree(), [(X - 5, 1), (X + 2, 2), (X - 1, 3)])
+        self.assertFactorsAlmostEqual(((X**2 + 1)**4 * (X - 1j)**2).squarefree(),
+                                      [(X + 1j, 4), (X - 1j, 6)])
+        self.assertFactorsAlmostEqual((X**4 - 1).squarefree(), [(X**4 - 1, 1)])
+
+    def test_constant(self):
+        self.assertEqual(Polynomial(2).squarefree(), [])
+        self.assertEqual((2 * X**3).squarefree(), [(X, 3)])
+        self.assertRaises(ValueError, Polynomial().squarefree)
+
+    def test_high_degree(self):
+        P = (X**250 - 1)**2 * (X**500 + 2)
+        self.assertFactorsAlmostEqual(P.squarefree(), [(X**500 + 2, 1), (X**250 - 1, 2)])
+        self.assertFactorsAlmostEqual(((X**5 - 1)**2 * (X - 3)).squarefree(),
+                                      [(X - 3, 1), (X**5 - 1, 2)])
+        P = (X**300 + 2)**3 * (X**200 - 5)
+        self.assertFactorsAlmostEqual(P.squarefree(), [(X**200 - 5, 1), (X**300 + 2, 3)])
+
+    def test_random(self):
+        # Euclid's algorithm loses the GCDs of such polynomials
+        rng = random.Random(1)
+        def poly(n):
+            return Polynomial(*[rng.uniform(-1, 1) for _ in range(n + 1)])
+        B = poly(1000)
+        self.assertEqual([(F.degree, m) for F, m in (B * B).squarefree()], [(1000, 2)])
+        C, D = poly(400), poly(300)
+        factors = (C**2 * D**3 * (X - 1)).squarefree()
+        self.assertEqual([(F.degree, m) for F, m in factors], [(1, 1), (400, 2), (300, 3)])
+        self.assertAlmostEqual(factors[0][0](1), 0)
+
+    def test_tolerance(self):
+        P = (X - 1) * (X - 1.01)
+        self.assertEqual([m for F, m in P.squarefree()], [1])
+        self.assertEqual([m for F, m in P.squarefree(1e-3)], [2])
+
+class EvalMatrixTestCase(unittest.TestCase):
+    @staticmethod
+    def matrix(rows):
+        data = array('d', [x for row in rows for x in row])
+        return memoryview(data).cast('B').cast('d', [len(rows), len(rows)])
+
+    @staticmethod
+    def horner(P, rows):
+        n = len(rows)
+        R = [[0] * n for i in range(n)]
+        for k in range(P.degree, -1, -1):
+            R = [[sum(R[i][l] * rows[l][j] for l in range(n)) for j in range(n)]
+                 for i in range(n)]
+            for i in range(n):
+                R[i][i] += P[k]
+        return R
+
+    def assertMatrixAlmostEqual(self, A, B, places=7):
+        self.assertEqual(len(A), len(B))
+        for a, b in zip(A, B):
+            for x, y in zip(a, b):
+                self.assertAlmostEqual(x, y, places=places)
+
+    def test_eval_matrix(self):
+        M = [[1., 2.], [3., 4.]]
+        self.assertEqual((X**2).eval_matrix(self.matrix(M)), [[7, 10], [15, 22]])
+        self.assertEqual((X**2 - 5 * X - 2).eval_matrix(self.matrix(M)), [[0, 0], [0, 0]])
+        self.assertEqual(Polynomial(3).eval_matrix(self.matrix(M)), [[3, 0], [0, 3]])
+        self.assertEqual(Polynomial().eval_matrix(self.matrix(M)), [[0, 0], [0, 0]])
+
+    def test_complex(self):
+        M = [[0.5, 0.], [0.3, -0.7]]
+        P = (1 + 1j) * X**5 - 2 * X**3 + 1j
+        self.assertMatrixAlmostEqual(P.eval_matrix(self.matrix(M)), self.horner(P, M))
+
+    def test_high_degree(self):
+        n = 9
+        M = [[((3 * i + 7 * j) % 11 - 5) / 40. for j in range(n)] for i in range(n)]
+        P = Polynomial(*[(-1)**k / (k + 1) for k in range(60)])
+        self.assertMatrixAlmostEqual(P.eval_matrix(self.matrix(M)), self.horner(P, M))
+
+    def test_errors(self):
+        self.assertRaises(TypeError, X.eval_matrix, [[1, 2], [3, 4]])
+        self.assertRaises(TypeError, X.eval_matrix, array('d', [1, 2, 3, 4]))
+        self.assertRaises(TypeError, X.eval_matrix,
+                          memoryview(array('f', [1, 2, 3, 4])).cast('B').cast('f', [2, 2]))
+        self.assertRaises(ValueError, X.eval_matrix,
+                          memoryview(array('d', range(6))).cast('B').cast('d', [2, 3]))
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,64 @@
+import unittest
+
+from pypoly import *
+
+
+class RationalFunctionTestCase(unittest.TestCase):
+    def test_init(self):
+        R = RationalFunction(X**2 - 1, X - 1)
+        self.assertEqual(R.numerator, X**2 - 1)
+        self.assertEqual(R.denominator, X - 1)
+        self.assertEqual(RationalFunction(X).denominator, 1)
+        self.assertEqual(RationalFunction(6, 2).numerator, 3)
+        self.assertEqual(RationalFunction(0, X).denominator, 1)
+        self.assertRaises(ZeroDivisionError, RationalFunction, X, 0)
+        self.assertRaises(TypeError, RationalFunction, "X")
+
+    def test_reduce(self):
+        R = RationalFunction(2 * X**2 - 2, 2 * X - 2)
+        self.assertIs(R.reduce(), R)
+        self.assertEqual(R.numerator, X + 1)
+        self.assertEqual(R.denominator, 1)
+
+    def test_repr(self):
+        self.assertEqual(repr(RationalFunction(1, X + 1)), "(1) / (1 + X)")
+        self.assertEqual(repr(RationalFunction(X, 2)), "0.5 * X")
+
+    def test_equality(self):
+        R = RationalFunction(X**2 - 1, X - 1)
+        self.assertEqual(R, X + 1)
+        self.assertEqual(X + 1, R)
+        self.assertNotEqual(R, X)
+        self.assertEqual(RationalFunction(X, 2 * X), 0.5)
+
+    def test_arithmetic(self):
+        A, B = RationalFunction(X, X + 1), RationalFunction(1, X)
+        self.assertEqual(A + B, RationalFunction(X**2 + X + 1, X**2 + X))
+        self.assertEqual(A - B, RationalFunction(X**2 - X - 1, X**2 + X))
+        self.assertEqual(A * B, RationalFunction(1, X + 1))
+        self.assertEqual(A / B, RationalFunction(X**2, X + 1))
+        self.assertEqual(-A + A, 0)
+        self.assertEqual(A**2 * A**-2, 1)
+        self.assertEqual(1 / A, 1 + B)
+        self.assertEqual(X / A, X + 1)
+        self.assertRaises(ZeroDivisionError, lambda: A / 0)
+        self.assertRaises(ZeroDivisionError, pow, A - A, -1)
+
+    def test_call(self):
+        R = RationalFunction(X**2 - 1, X - 1)
+        self.assertEqual(R(1), 2)
+        self.assertEqual(R(3j), 1 + 3j)
+        S = RationalFunction(1, X) + RationalFunction(1, X + 1)
+        self.assertAlmostEqual(S(4), 0.45)
+        self.assertAlmostEqual(S(1e200) / 2e-200, 1)
+        self.assertIsInstance(S(4), float)
+        self.assertIsInstance(R(3j), complex)
+        self.assertRaises(ZeroDivisionError, S, -1)
+
+    def test_early_reduction(self):
+        R = RationalFunction(1)
+        for k in range(1, 100):
+            R = R * RationalFunction(X + k, X + k + 1)
+            R = R * RationalFunction(X - k, X - k)
+        self.assertLess(R.numerator.degree + R.denominator.degree, 70)
+        self.assertEqual(R, RationalFunction(X + 1, X + 100))
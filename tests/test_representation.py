@@ -1,3 +1,4 @@
+import io
 import unittest
 
 import pypoly
@@ -39,17 +40,34 @@ class RepresentationTestCase(unittest.TestCase):
             repr(pypoly.Polynomial(1, -3, 0, complex(0, -0.2))),
             "1 - 3 * X - 0.2j * X**3")
 
-    def test_overflow(self):
-        """We use a finite buffer (typically, 2048 chars) to construct the repr
-        of a polynomial. The representation should be truncated to prevent buffer
-        overflow."""
+    def test_shortest_roundtrip(self):
+        self.assertEqual(
+            repr(pypoly.Polynomial(0.1, 1. / 3, complex(1e-20, 2.5e300))),
+            "0.1 + 0.3333333333333333 * X + (1e-20+2.5e+300j) * X**2")
+
+    def test_no_truncation(self):
         long_repr = repr(pypoly.Polynomial(*(1 for _ in range(1000))))
-        self.assertEqual(len(long_repr), 2047)
         self.assertEqual(
             long_repr,
-            ("1 + X + " + " + ".join("X**%d" % i for i in range(2, 1000)))[:2032]
-            + "... [truncated]"
-        )
+            "1 + X + " + " + ".join("X**%d" % i for i in range(2, 1000)))
+
+class WriteTestCase(unittest.TestCase):
+
+    def test_write(self):
+        P = pypoly.Polynomial(-1, 0, complex(1, 3))
+        f = io.StringIO()
+        self.assertEqual(P.write(f), None)
+        self.assertEqual(f.getvalue(), repr(P))
+
+    def test_write_chunks(self):
+        P = pypoly.Polynomial(*range(1, 20001))
+        f = io.StringIO()
+        P.write(f)
+        self.assertEqual(f.getvalue(), repr(P))
+
+    def test_write_error(self):
+        with self.assertRaises(AttributeError):
+            pypoly.X.write(None)
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,68 @@
+import asyncio
+import concurrent.futures
+import os
+import subprocess
+import sys
+import time
+import unittest
+
+from pypoly import *
+
+
+class SubmitTestCase(unittest.TestCase):
+    def test_operations(self):
+        self.assertEqual(submit("multiply", X + 1, X - 1).result(10), X**2 - 1)
+        self.assertEqual(submit("multiply", X, 2).result(10), 2 * X)
+        self.assertEqual(submit("divmod", X**3 + 2, X + 1).result(10), (X**2 - X + 1, 1))
+        self.assertEqual(submit("pow", X + 1, 3).result(10), (X + 1)**3)
+        self.assertEqual(submit("gcd", X**2 - 1, (X + 1)**2, X**3 + 1).result(10), X + 1)
+        self.assertEqual(submit("eval_many", X**2 + 1, [0, 2, 1j]).result(10), [1, 5, 0])
+
+    def test_future(self):
+        f = submit("multiply", X, X)
+        self.assertIsInstance(f, concurrent.futures.Future)
+        self.assertEqual(concurrent.futures.wait([f], 10).done, {f})
+
+        async def main():
+            return await asyncio.wrap_future(submit("pow", X - 1, 2))
+        self.assertEqual(asyncio.run(main()), X**2 - 2 * X + 1)
+
+    def test_operands_copied(self):
+        P = 1 + X
+        f = submit("multiply", P, P)
+        P[0] = 2
+        self.assertEqual(f.result(10), 1 + 2 * X + X**2)
+
+    def test_errors(self):
+        self.assertIsInstance(submit("divmod", X, 0).exception(10), ZeroDivisionError)
+        self.assertRaises(ValueError, submit, "add", X, X)
+        self.assertRaises(TypeError, submit, "multiply", X)
+        self.assertRaises(TypeError, submit, "gcd", X)
+        self.assertRaises(TypeError, submit, "multiply", X, "X")
+        self.assertRaises(ValueError, submit, "pow", X, 2000)
+        self.assertRaises(TypeError, submit)
+
+    def test_cancel(self):
+        P = Polynomial(*[1.] * 200000)
+        f = submit("multiply", P, P)
+        time.sleep(0.1)
+        self.assertTrue(f.cancel())
+        self.assertTrue(f.cancelled())
+        # The product is interrupted, the next job does not wait for it
+        self.assertEqual(submit("multiply", X, X).result(10), X**2)
+
+    def test_exit(self):
+        # The pending jobs complete before the interpreter is finalized
+        code = ("from pypoly import *\n"
+                "P = Polynomial(*[1.] * 20000)\n"
+                "for _ in range(4):\n"
+                "    submit('multiply', P, P).add_done_callback("
+                "lambda f: print(f.result().degree))\n")
+        env = dict(os.environ, PYTHONPATH=os.pathsep.join(sys.path))
+        out = subprocess.run([sys.executable, "-c", code], env=env, timeout=60,
+                             stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        self.assertEqual(out.returncode, 0, out.stderr)
+        self.assertEqual(out.stdout.split(), [b"39998"] * 4)
+
+if __name__ == '__main__':
+    unittest.main()